@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -42,7 +43,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -201,8 +202,12 @@ MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	_resamplerQuality = parseRateConverterQuality(ConfMan.get("audio_resampler"));
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_channelStatus[i].handle.store(i + 1);
+	}
 }
 
 MixerImpl::~MixerImpl() {
@@ -251,6 +256,84 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	// Publish the new channel, the handle being stored last
+	Common::StackLock commandLock(_commandMutex);
+	ChannelStatus &status = _channelStatus[index];
+	status.id.store(chan->getId());
+	status.type.store(chan->getType());
+	status.volume.store(chan->getVolume());
+	status.balance.store(chan->getBalance());
+	status.rate.store(chan->getRate());
+	status.nativeRate.store(chan->getRate());
+	status.handle.store(chanHandle._val);
+}
+
+void MixerImpl::removeChannel(int index) {
+	// Store a value that can never match a handle of this slot
+	_channelStatus[index].handle.store(index + 1);
+
+	delete _channels[index];
+	_channels[index] = nullptr;
+}
+
+bool MixerImpl::isSlotActive(int index) const {
+	return _channelStatus[index].handle.load() % NUM_CHANNELS == (uint32)index;
+}
+
+bool MixerImpl::isHandleActive(SoundHandle handle) const {
+	return _channelStatus[handle._val % NUM_CHANNELS].handle.load() == handle._val;
+}
+
+void MixerImpl::queueCommand(ChannelCommand::Type type, SoundHandle handle, uint32 value) {
+	ChannelCommand cmd;
+	cmd.type = type;
+	cmd.handle = handle._val;
+	cmd.value = value;
+
+	{
+		Common::StackLock commandLock(_commandMutex);
+		if (_commands.push(cmd))
+			return;
+	}
+
+	// The queue only fills up when the audio callback is not running, so
+	// apply the pending commands here. The locks must be taken in the same
+	// order as in insertChannel().
+	Common::StackLock lock(_mutex);
+	Common::StackLock commandLock(_commandMutex);
+	processCommands();
+	applyCommand(cmd);
+}
+
+void MixerImpl::processCommands() {
+	ChannelCommand cmd;
+	while (_commands.pop(cmd))
+		applyCommand(cmd);
+}
+
+void MixerImpl::applyCommand(const ChannelCommand &cmd) {
+	// The channel may have been stopped after the command was queued
+	const int index = cmd.handle % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case ChannelCommand::kSetVolume:
+		_channels[index]->setVolume((byte)cmd.value);
+		break;
+	case ChannelCommand::kSetBalance:
+		_channels[index]->setBalance((int8)cmd.value);
+		break;
+	case ChannelCommand::kSetRate:
+		_channels[index]->setRate(cmd.value);
+		break;
+	case ChannelCommand::kResetRate:
+		_channels[index]->resetRate();
+		break;
+	default:
+		break;
+	}
 }
 
 void MixerImpl::playStream(
@@ -292,7 +375,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resamplerQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -308,6 +391,8 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	processCommands();
+
 	//  zero the buf
 	memset(buf, 0, len);
 
@@ -325,8 +410,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				removeChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -341,20 +425,16 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i] != nullptr && !_channels[i]->isPermanent())
+			removeChannel(i);
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i] != nullptr && _channels[i]->getId() == id)
+			removeChannel(i);
 	}
 }
 
@@ -366,8 +446,7 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	removeChannel(index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
@@ -386,67 +465,69 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock commandLock(_commandMutex);
+		if (!isHandleActive(handle))
+			return;
+		_channelStatus[handle._val % NUM_CHANNELS].volume.store(volume);
+	}
 
-	_channels[index]->setVolume(volume);
+	queueCommand(ChannelCommand::kSetVolume, handle, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!isHandleActive(handle))
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _channelStatus[handle._val % NUM_CHANNELS].volume.load();
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock commandLock(_commandMutex);
+		if (!isHandleActive(handle))
+			return;
+		_channelStatus[handle._val % NUM_CHANNELS].balance.store(balance);
+	}
 
-	_channels[index]->setBalance(balance);
+	queueCommand(ChannelCommand::kSetBalance, handle, (uint8)balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!isHandleActive(handle))
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _channelStatus[handle._val % NUM_CHANNELS].balance.load();
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock commandLock(_commandMutex);
+		if (!isHandleActive(handle))
+			return;
+		_channelStatus[handle._val % NUM_CHANNELS].rate.store(rate);
+	}
 
-	_channels[index]->setRate(rate);
+	queueCommand(ChannelCommand::kSetRate, handle, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (!isHandleActive(handle))
 		return 0;
-	
-	return _channels[index]->getRate();
+
+	return _channelStatus[handle._val % NUM_CHANNELS].rate.load();
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock commandLock(_commandMutex);
+		if (!isHandleActive(handle))
+			return;
+		ChannelStatus &status = _channelStatus[handle._val % NUM_CHANNELS];
+		status.rate.store(status.nativeRate.load());
+	}
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-	
-	_channels[index]->resetRate();
+	queueCommand(ChannelCommand::kResetRate, handle, 0);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -504,41 +585,33 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (isSlotActive(i) && _channelStatus[i].id.load() == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	if (isHandleActive(handle))
+		return _channelStatus[handle._val % NUM_CHANNELS].id.load();
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return isHandleActive(handle);
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (isSlotActive(i) && _channelStatus[i].type.load() == type)
 			return true;
 	return false;
 }
@@ -573,7 +646,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
@@ -582,7 +655,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -23,8 +23,11 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
+#include "common/spsc_queue.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -58,16 +61,60 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
+	/**
+	 * A channel setting change requested by an engine thread, applied to
+	 * the channel by the audio callback.
+	 */
+	struct ChannelCommand {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kSetRate,
+			kResetRate
+		};
+
+		Type type;
+		uint32 handle;
+		uint32 value;
+	};
+
+	/**
+	 * Channel state published for engine threads, so that querying a
+	 * channel does not need to wait for the audio callback to finish.
+	 * 'handle' holds the handle of the channel in the slot, or a value
+	 * which never maps to the slot when it is empty.
+	 */
+	struct ChannelStatus {
+		Common::Atomic<uint32> handle;
+		Common::Atomic<int32> id;
+		Common::Atomic<int32> type;
+		Common::Atomic<uint32> volume;
+		Common::Atomic<int32> balance;
+		Common::Atomic<uint32> rate;
+		Common::Atomic<uint32> nativeRate;
+	};
+
+	/** Guards the channels, held by the audio callback while mixing. */
 	Common::Mutex _mutex;
 
+	/**
+	 * Serializes the producers of _commands and the updates of
+	 * _channelStatus. Never taken by the audio callback.
+	 */
+	Common::Mutex _commandMutex;
+	Common::SPSCQueue<ChannelCommand, COMMAND_QUEUE_SIZE> _commands;
+	ChannelStatus _channelStatus[NUM_CHANNELS];
+
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
 	bool _mixerReady;
 	uint32 _handleSeed;
+	RateConverterQuality _resamplerQuality;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
@@ -138,6 +185,14 @@ public:
 
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	void removeChannel(int index);
+
+	bool isSlotActive(int index) const;
+	bool isHandleActive(SoundHandle handle) const;
+
+	void queueCommand(ChannelCommand::Type type, SoundHandle handle, uint32 value);
+	void processCommands();
+	void applyCommand(const ChannelCommand &cmd);
 
 public:
 	/**
@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+/**
+ * Multiply sixteen samples by the interleaved volumes in @p vol, divide the
+ * products by Mixer::kMaxMixerVolume (rounding towards zero, like the
+ * scalar code) and add the result to @p dst with signed saturation.
+ */
+static FORCEINLINE __m256i avx2_mixSamples(__m256i dst, __m256i src, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(src, vol);
+	const __m256i hi = _mm256_mulhi_epi16(src, vol);
+	// The unpack and pack operations work per 128-bit lane, so the
+	// sample order is restored by the final pack.
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+
+	const __m256i bias = _mm256_set1_epi32(255);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), bias)), 8);
+
+	return _mm256_adds_epi16(dst, _mm256_packs_epi32(p0, p1));
+}
+
+static FORCEINLINE __m256i avx2_swapPairs(__m256i x) {
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static FORCEINLINE __m256i avx2_duplicateSamples(__m128i x) {
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(x, x)), _mm_unpackhi_epi16(x, x), 1);
+}
+
+// Returns the number of frames mixed; the remainder is left to the caller.
+template<bool inStereo, bool reverseStereo>
+static uint mixAVX2Impl(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR) {
+	// After swapping the input pairs the right sample ends up first
+	const __m256i vol = reverseStereo ? _mm256_set1_epi32((volL << 16) | volR) : _mm256_set1_epi32((volR << 16) | volL);
+	uint i = 0;
+
+	if (inStereo) {
+		for (; i + 8 <= frames; i += 8) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)src);
+			if (reverseStereo)
+				s = avx2_swapPairs(s);
+			__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, avx2_mixSamples(d, s, vol));
+			src += 16;
+			dst += 16;
+		}
+	} else {
+		for (; i + 8 <= frames; i += 8) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)src);
+			__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, avx2_mixSamples(d, avx2_duplicateSamples(s), vol));
+			src += 8;
+			dst += 16;
+		}
+	}
+
+	return i;
+}
+
+void SampleMix::mixAVX2(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo) {
+	uint done;
+	if (inStereo) {
+		if (reverseStereo)
+			done = mixAVX2Impl<true, true>(dst, src, frames, volL, volR);
+		else
+			done = mixAVX2Impl<true, false>(dst, src, frames, volL, volR);
+	} else {
+		done = mixAVX2Impl<false, false>(dst, src, frames, volL, volR);
+	}
+
+	// Mix the remaining frames
+	mixGeneric(dst + done * 2, src + done * (inStereo ? 2 : 1), frames - done, volL, volR, inStereo, reverseStereo);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
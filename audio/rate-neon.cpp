@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Audio {
+
+/**
+ * Multiply four samples by the interleaved volumes in @p vol and divide
+ * the products by Mixer::kMaxMixerVolume, rounding towards zero like the
+ * scalar code.
+ */
+static FORCEINLINE int16x4_t neon_scaleSamples(int16x4_t src, int16x4_t vol) {
+	int32x4_t p = vmull_s16(src, vol);
+	p = vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(255)));
+	return vqmovn_s32(vshrq_n_s32(p, 8));
+}
+
+static FORCEINLINE int16x8_t neon_mixSamples(int16x8_t dst, int16x8_t src, int16x4_t vol) {
+	const int16x8_t scaled = vcombine_s16(neon_scaleSamples(vget_low_s16(src), vol), neon_scaleSamples(vget_high_s16(src), vol));
+	return vqaddq_s16(dst, scaled);
+}
+
+// Returns the number of frames mixed; the remainder is left to the caller.
+template<bool inStereo, bool reverseStereo>
+static uint mixNEONImpl(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR) {
+	// After swapping the input pairs the right sample ends up first
+	const int16x4_t vol = reverseStereo ?
+		vreinterpret_s16_u32(vdup_n_u32((volL << 16) | volR)) :
+		vreinterpret_s16_u32(vdup_n_u32((volR << 16) | volL));
+	uint i = 0;
+
+	if (inStereo) {
+		for (; i + 4 <= frames; i += 4) {
+			int16x8_t s = vld1q_s16(src);
+			if (reverseStereo)
+				s = vrev32q_s16(s);
+			vst1q_s16(dst, neon_mixSamples(vld1q_s16(dst), s, vol));
+			src += 8;
+			dst += 8;
+		}
+	} else {
+		for (; i + 8 <= frames; i += 8) {
+			const int16x8_t mono = vld1q_s16(src);
+			const int16x8x2_t s = vzipq_s16(mono, mono);
+			vst1q_s16(dst, neon_mixSamples(vld1q_s16(dst), s.val[0], vol));
+			vst1q_s16(dst + 8, neon_mixSamples(vld1q_s16(dst + 8), s.val[1], vol));
+			src += 8;
+			dst += 16;
+		}
+	}
+
+	return i;
+}
+
+void SampleMix::mixNEON(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo) {
+	uint done;
+	if (inStereo) {
+		if (reverseStereo)
+			done = mixNEONImpl<true, true>(dst, src, frames, volL, volR);
+		else
+			done = mixNEONImpl<true, false>(dst, src, frames, volL, volR);
+	} else {
+		done = mixNEONImpl<false, false>(dst, src, frames, volL, volR);
+	}
+
+	// Mix the remaining frames
+	mixGeneric(dst + done * 2, src + done * (inStereo ? 2 : 1), frames - done, volL, volR, inStereo, reverseStereo);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
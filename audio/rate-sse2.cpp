@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Audio {
+
+/**
+ * Multiply eight samples by the interleaved volumes in @p vol, divide the
+ * products by Mixer::kMaxMixerVolume (rounding towards zero, like the
+ * scalar code) and add the result to @p dst with signed saturation.
+ */
+static FORCEINLINE __m128i sse2_mixSamples(__m128i dst, __m128i src, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(src, vol);
+	const __m128i hi = _mm_mulhi_epi16(src, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+	const __m128i bias = _mm_set1_epi32(255);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), 8);
+
+	return _mm_adds_epi16(dst, _mm_packs_epi32(p0, p1));
+}
+
+static FORCEINLINE __m128i sse2_swapPairs(__m128i x) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// Returns the number of frames mixed; the remainder is left to the caller.
+template<bool inStereo, bool reverseStereo>
+static uint mixSSE2Impl(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR) {
+	// After swapping the input pairs the right sample ends up first
+	const __m128i vol = reverseStereo ? _mm_set1_epi32((volL << 16) | volR) : _mm_set1_epi32((volR << 16) | volL);
+	uint i = 0;
+
+	if (inStereo) {
+		for (; i + 4 <= frames; i += 4) {
+			__m128i s = _mm_loadu_si128((const __m128i *)src);
+			if (reverseStereo)
+				s = sse2_swapPairs(s);
+			__m128i d = _mm_loadu_si128((const __m128i *)dst);
+			_mm_storeu_si128((__m128i *)dst, sse2_mixSamples(d, s, vol));
+			src += 8;
+			dst += 8;
+		}
+	} else {
+		for (; i + 8 <= frames; i += 8) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)src);
+			__m128i d0 = _mm_loadu_si128((const __m128i *)dst);
+			__m128i d1 = _mm_loadu_si128((const __m128i *)(dst + 8));
+			_mm_storeu_si128((__m128i *)dst, sse2_mixSamples(d0, _mm_unpacklo_epi16(s, s), vol));
+			_mm_storeu_si128((__m128i *)(dst + 8), sse2_mixSamples(d1, _mm_unpackhi_epi16(s, s), vol));
+			src += 8;
+			dst += 16;
+		}
+	}
+
+	return i;
+}
+
+void SampleMix::mixSSE2(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo) {
+	uint done;
+	if (inStereo) {
+		if (reverseStereo)
+			done = mixSSE2Impl<true, true>(dst, src, frames, volL, volR);
+		else
+			done = mixSSE2Impl<true, false>(dst, src, frames, volL, volR);
+	} else {
+		done = mixSSE2Impl<false, false>(dst, src, frames, volL, volR);
+	}
+
+	// Mix the remaining frames
+	mixGeneric(dst + done * 2, src + done * (inStereo ? 2 : 1), frames - done, volL, volR, inStereo, reverseStereo);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -29,7 +29,10 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/str.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -45,6 +48,189 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Number of frames the converters resample before handing them over to
+ * SampleMix. This keeps the volume and mixing loop long enough to benefit
+ * from the SIMD kernels while the frame buffer still fits on the stack.
+ */
+enum {
+	kMixBatchSize = 256
+};
+
+/**
+ * Parameters of the windowed-sinc resampler. Each output sample is computed
+ * from SINC_TAPS input samples, using the coefficient set of the nearest of
+ * SINC_PHASES fractional positions between two input samples.
+ *
+ * Downsampling uses the bank with the highest of SINC_CUTOFF_STEPS cutoffs
+ * which still lies below the Nyquist frequency of the output rate.
+ */
+enum {
+	SINC_TAPS = 16,
+	SINC_PHASE_BITS = 7,
+	SINC_PHASES = (1 << SINC_PHASE_BITS),
+	SINC_COEF_BITS = 14,
+	SINC_CUTOFF_STEPS = 16,
+	// One extra phase covers the position right on the next input sample
+	SINC_BANK_SIZE = (SINC_PHASES + 1) * SINC_TAPS
+};
+
+/**
+ * Precomputed polyphase filter banks shared by all sinc resamplers.
+ *
+ * The filters are Blackman-windowed sinc low-passes. All banks are built
+ * at once when the first sinc converter is created, so that changing the
+ * rate of a playing stream only selects another bank on the mixer thread.
+ */
+class SincFilter {
+public:
+	/**
+	 * Build the filter banks, if not done yet. This is not thread safe;
+	 * the mixer creates its channels with its lock held.
+	 */
+	static void init();
+
+	/** Return the filter bank to use for the given conversion. */
+	static const int16 *getBank(st_rate_t inRate, st_rate_t outRate);
+
+	/** Return the SINC_TAPS coefficients for @p phase in [0, SINC_PHASES]. */
+	static const int16 *getPhase(const int16 *bank, uint phase) { return bank + phase * SINC_TAPS; }
+
+private:
+	static void computeBank(int16 *bank, double cutoff);
+
+	static int16 *_banks;
+};
+
+int16 *SincFilter::_banks = nullptr;
+
+void SincFilter::init() {
+	if (_banks)
+		return;
+
+	// Cutoffs are in cycles per input sample, leaving room for the
+	// transition band. The last bank is used for upsampling.
+	int16 *banks = new int16[SINC_CUTOFF_STEPS * SINC_BANK_SIZE];
+	for (uint step = 0; step < SINC_CUTOFF_STEPS; step++)
+		computeBank(banks + step * SINC_BANK_SIZE, 0.5 * 0.9 * (step + 1) / SINC_CUTOFF_STEPS);
+	_banks = banks;
+}
+
+const int16 *SincFilter::getBank(st_rate_t inRate, st_rate_t outRate) {
+	assert(_banks);
+	uint step = (uint)MIN<uint64>((uint64)outRate * SINC_CUTOFF_STEPS / inRate, SINC_CUTOFF_STEPS);
+	return _banks + (MAX<uint>(step, 1) - 1) * SINC_BANK_SIZE;
+}
+
+void SincFilter::computeBank(int16 *bank, double cutoff) {
+	const double halfWidth = SINC_TAPS / 2;
+	for (uint phase = 0; phase <= SINC_PHASES; phase++) {
+		const double t = (double)phase / SINC_PHASES;
+		double taps[SINC_TAPS];
+		double sum = 0.0;
+
+		for (uint k = 0; k < SINC_TAPS; k++) {
+			// Distance of the tap from the output position, in input samples
+			const double x = (double)k - (halfWidth - 1) - t;
+			const double arg = 2.0 * M_PI * cutoff * x;
+			const double sinc = (x == 0.0) ? 1.0 : sin(arg) / arg;
+			const double window = 0.42 + 0.5 * cos(M_PI * x / halfWidth) + 0.08 * cos(2.0 * M_PI * x / halfWidth);
+			taps[k] = sinc * window;
+			sum += taps[k];
+		}
+
+		// Normalize each phase to unity gain, so that DC passes unchanged
+		int16 *coefs = bank + phase * SINC_TAPS;
+		int total = 0;
+		for (uint k = 0; k < SINC_TAPS; k++) {
+			coefs[k] = (int16)floor(taps[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += coefs[k];
+		}
+		coefs[SINC_TAPS / 2 - (phase < SINC_PHASES / 2 ? 1 : 0)] += (1 << SINC_COEF_BITS) - total;
+	}
+}
+
+static inline st_sample_t applySincFilter(const st_sample_t *history, const int16 *coefs) {
+	int acc = 1 << (SINC_COEF_BITS - 1);
+	for (uint k = 0; k < SINC_TAPS; k++)
+		acc += history[k] * coefs[k];
+	return (st_sample_t)CLIP<int>(acc >> SINC_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+// Initialize this to nullptr at the start
+SampleMix::MixFunc SampleMix::mixFunc = nullptr;
+
+void SampleMix::mixMono(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo) {
+	for (uint i = 0; i < frames; i++) {
+		st_sample_t inL, inR;
+		inL = *src++;
+		inR = (inStereo ? *src++ : inL);
+
+		st_sample_t outL, outR;
+		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		// Output mono channel
+		clampedAdd(dst[i], (outL + outR) / 2);
+	}
+}
+
+void SampleMix::mixGeneric(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo) {
+	const int left = reverseStereo ? 1 : 0;
+
+	for (uint i = 0; i < frames; i++) {
+		st_sample_t inL, inR;
+		inL = *src++;
+		inR = (inStereo ? *src++ : inL);
+
+		st_sample_t outL, outR;
+		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		// Output left channel
+		clampedAdd(dst[left    ], outL);
+
+		// Output right channel
+		clampedAdd(dst[left ^ 1], outR);
+
+		dst += 2;
+	}
+}
+
+void SampleMix::mix(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (frames == 0)
+		return;
+
+	if (!outStereo) {
+		mixMono(dst, src, frames, volL, volR, inStereo);
+		return;
+	}
+
+	// If no function has been selected yet, detect and select
+	if (!mixFunc) {
+		mixFunc = mixGeneric;
+		// The SIMD kernels rely on signed saturation, which does not match
+		// the clamping done for unsigned output.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) mixFunc = mixNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) mixFunc = mixSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) mixFunc = mixAVX2;
+#endif
+#endif
+	}
+
+	// The SIMD kernels multiply by the volume as a signed 16-bit value
+	if (volL > 0x7FFF || volR > 0x7FFF)
+		mixGeneric(dst, src, frames, volL, volR, inStereo, reverseStereo);
+	else
+		mixFunc(dst, src, frames, volL, volR, inStereo, reverseStereo);
+}
+
 template<bool inStereo, bool outStereo, bool reverseStereo>
 class RateConverter_Impl : public RateConverter {
 private:
@@ -76,18 +262,39 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	/** Resampling algorithm used when the rates differ */
+	RateConverterQuality _quality;
+
+	/** Filter bank of the sinc resampler for the current rates */
+	const int16 *_sincBank;
+
+	/**
+	 * The last SINC_TAPS input samples of the left/right channel, stored
+	 * twice so that the filter can always read them contiguously.
+	 */
+	st_sample_t _historyL[2 * SINC_TAPS], _historyR[2 * SINC_TAPS];
+
+	/** Position of the oldest sample in the history buffers */
+	uint _historyPos;
+
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	int sincConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+
+	void updateSincBank() {
+		if (_quality == kRateConverterSinc)
+			_sincBank = SincFilter::getBank(_inRate, _outRate);
+	}
 
 public:
-	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
+	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, RateConverterQuality quality);
 	virtual ~RateConverter_Impl() {}
 
 	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
 
-	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
-	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; updateSincBank(); }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; updateSincBank(); }
 
 	st_rate_t getInputRate() const override { return _inRate; }
 	st_rate_t getOutputRate() const override { return _outRate; }
@@ -112,30 +319,13 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 				return (outBuffer - outStart) / (outStereo ? 2 : 1);
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+		// Mix as much of the buffered data as fits into the output buffer
+		uint frames = MIN<uint>(_bufferSize / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		SampleMix::mix(outBuffer, _bufferPos, frames, volL, volR, inStereo, outStereo, reverseStereo);
 
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		_bufferPos += frames * (inStereo ? 2 : 1);
+		_bufferSize -= frames * (inStereo ? 2 : 1);
+		outBuffer += frames * (outStereo ? 2 : 1);
 	}
 
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
@@ -151,57 +341,128 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
+	// Resampled frames are collected here before being mixed in one go
+	st_sample_t frames[kMixBatchSize * (inStereo ? 2 : 1)];
+
 	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
-			}
+		uint numFrames = 0;
+		uint maxFrames = MIN<uint>(kMixBatchSize, (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		bool endOfStream = false;
+
+		while (numFrames < maxFrames) {
+			// Read enough input samples so that _outPos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfStream = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_outPos--;
+
+				if (_outPos >= 0) {
+					_bufferPos += (inStereo ? 2 : 1);
+				}
+			} while (_outPos >= 0);
+
+			if (endOfStream)
+				break;
+
+			frames[numFrames * (inStereo ? 2 : 1)] = *_bufferPos++;
+			if (inStereo)
+				frames[numFrames * 2 + 1] = *_bufferPos++;
+			numFrames++;
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_outPos--;
+			// Increment output position
+			_outPos += outPos_inc;
+		}
 
-			if (_outPos >= 0) {
-				_bufferPos += (inStereo ? 2 : 1);
-			}
-		} while (_outPos >= 0);
+		SampleMix::mix(outBuffer, frames, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
 
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
+		if (endOfStream)
+			break;
+	}
+	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+}
 
-		// Increment output position
-		_outPos += outPos_inc;
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	// How much to increment _outPosFrac by
+	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+	st_sample_t *outStart, *outEnd;
+	outStart = outBuffer;
+	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
+	// Interpolated frames are collected here before being mixed in one go
+	st_sample_t frames[kMixBatchSize * (inStereo ? 2 : 1)];
+
+	while (outBuffer < outEnd) {
+		uint numFrames = 0;
+		uint maxFrames = MIN<uint>(kMixBatchSize, (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		bool endOfStream = false;
+
+		while (numFrames < maxFrames) {
+			// Read enough input samples so that _outPosFrac < 0
+			while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfStream = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_inLastL = _inCurL;
+				_inCurL = *_bufferPos++;
+
+				if (inStereo) {
+					_inLastR = _inCurR;
+					_inCurR = *_bufferPos++;
+				}
+
+				_outPosFrac -= FRAC_ONE_LOW;
+			}
 
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+			if (endOfStream)
+				break;
 
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+			// Loop as long as the _outPos trails behind, and as long as there is
+			// still space in the batch.
+			while (_outPosFrac < (frac_t)FRAC_ONE_LOW && numFrames < maxFrames) {
+				// Interpolate
+				frames[numFrames * (inStereo ? 2 : 1)] = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				if (inStereo)
+					frames[numFrames * 2 + 1] = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+				numFrames++;
 
-			outBuffer += 1;
+				// Increment output position
+				_outPosFrac += outPos_inc;
+			}
 		}
+
+		SampleMix::mix(outBuffer, frames, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
+
+		if (endOfStream)
+			break;
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::sincConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
@@ -209,68 +470,68 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 	outStart = outBuffer;
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
+	// Filtered frames are collected here before being mixed in one go
+	st_sample_t frames[kMixBatchSize * (inStereo ? 2 : 1)];
+
 	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPosFrac < 0
-		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+		uint numFrames = 0;
+		uint maxFrames = MIN<uint>(kMixBatchSize, (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		bool endOfStream = false;
+
+		while (numFrames < maxFrames) {
+			// Shift input samples into the history until _outPosFrac < 1
+			while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+				// Check if we have to refill the buffer
+				if (_bufferSize == 0) {
+					_bufferPos = _buffer;
+					_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+					if (_bufferSize <= 0) {
+						endOfStream = true;
+						break;
+					}
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_historyL[_historyPos] = _historyL[_historyPos + SINC_TAPS] = *_bufferPos++;
+				if (inStereo)
+					_historyR[_historyPos] = _historyR[_historyPos + SINC_TAPS] = *_bufferPos++;
+				_historyPos = (_historyPos + 1) % SINC_TAPS;
+
+				_outPosFrac -= FRAC_ONE_LOW;
 			}
 
-			_bufferSize -= (inStereo ? 2 : 1);
-			_inLastL = _inCurL;
-			_inCurL = *_bufferPos++;
+			if (endOfStream)
+				break;
 
-			if (inStereo) {
-				_inLastR = _inCurR;
-				_inCurR = *_bufferPos++;
-			}
+			// The output position lies between the two samples in the
+			// middle of the history, so the filter adds a delay of
+			// SINC_TAPS / 2 - 1 input samples.
+			while (_outPosFrac < (frac_t)FRAC_ONE_LOW && numFrames < maxFrames) {
+				const uint phase = (_outPosFrac + (1 << (FRAC_BITS_LOW - SINC_PHASE_BITS - 1))) >> (FRAC_BITS_LOW - SINC_PHASE_BITS);
+				const int16 *coefs = SincFilter::getPhase(_sincBank, phase);
 
-			_outPosFrac -= FRAC_ONE_LOW;
-		}
+				frames[numFrames * (inStereo ? 2 : 1)] = applySincFilter(_historyL + _historyPos, coefs);
+				if (inStereo)
+					frames[numFrames * 2 + 1] = applySincFilter(_historyR + _historyPos, coefs);
+				numFrames++;
 
-		// Loop as long as the _outPos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
-			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
+				// Increment output position
+				_outPosFrac += outPos_inc;
 			}
-
-			// Increment output position
-			_outPosFrac += outPos_inc;
 		}
+
+		SampleMix::mix(outBuffer, frames, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
+
+		if (endOfStream)
+			break;
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, RateConverterQuality quality) :
 	_inRate(inputRate),
 	_outRate(outputRate),
 	_outPos(1),
@@ -279,8 +540,19 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inLastR(0),
 	_inCurL(0),
 	_inCurR(0),
+	_quality(quality),
+	_sincBank(nullptr),
+	_historyPos(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr) {
+	memset(_historyL, 0, sizeof(_historyL));
+	memset(_historyR, 0, sizeof(_historyR));
+
+	if (_quality == kRateConverterSinc) {
+		SincFilter::init();
+		updateSincBank();
+	}
+}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
@@ -288,6 +560,8 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 
 	if (_inRate == _outRate) {
 		return copyConvert(input, outBuffer, numSamples, volL, volR);
+	} else if (_quality == kRateConverterSinc) {
+		return sincConvert(input, outBuffer, numSamples, volL, volR);
 	} else {
 		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
 			return simpleConvert(input, outBuffer, numSamples, volL, volR);
@@ -297,20 +571,26 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+RateConverterQuality parseRateConverterQuality(const Common::String &name) {
+	if (name.equalsIgnoreCase("sinc"))
+		return kRateConverterSinc;
+	return kRateConverterLinear;
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality) {
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
-				return new RateConverter_Impl<true, true, true>(inRate, outRate);
+				return new RateConverter_Impl<true, true, true>(inRate, outRate, quality);
 			else
-				return new RateConverter_Impl<true, true, false>(inRate, outRate);
+				return new RateConverter_Impl<true, true, false>(inRate, outRate, quality);
 		} else
-			return new RateConverter_Impl<true, false, false>(inRate, outRate);
+			return new RateConverter_Impl<true, false, false>(inRate, outRate, quality);
 	} else {
 		if (outStereo) {
-			return new RateConverter_Impl<false, true, false>(inRate, outRate);
+			return new RateConverter_Impl<false, true, false>(inRate, outRate, quality);
 		} else
-			return new RateConverter_Impl<false, false, false>(inRate, outRate);
+			return new RateConverter_Impl<false, false, false>(inRate, outRate, quality);
 	}
 }
 
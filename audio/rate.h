@@ -24,6 +24,10 @@
 
 #include "common/frac.h"
 
+namespace Common {
+class String;
+}
+
 namespace Audio {
 /**
  * @defgroup audio_rate Sample rate
@@ -104,7 +108,22 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * Resampling algorithms available to makeRateConverter().
+ */
+enum RateConverterQuality {
+	/** Linear interpolation. Cheap, but lets through audible aliasing. */
+	kRateConverterLinear,
+	/** Windowed-sinc polyphase filter. About six times the cost of linear interpolation. */
+	kRateConverterSinc
+};
+
+/**
+ * Parse the value of the "audio_resampler" config key.
+ */
+RateConverterQuality parseRateConverterQuality(const Common::String &name);
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterQuality quality = kRateConverterLinear);
 
 /** @} */
 } // End of namespace Audio
@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/rate.h"
+
+class MixerTestSuite;
+class RateConverterTestSuite;
+
+namespace Audio {
+
+/**
+ * Volume scaling and saturated mixing kernels used by the rate converters.
+ *
+ * The converters produce frames at the output rate but before volume
+ * scaling; SampleMix then applies the channel volumes and adds the result
+ * into the mixer buffer. SIMD implementations are selected at runtime,
+ * in the same way as Graphics::BlendBlit does it.
+ */
+class SampleMix {
+private:
+	typedef void (*MixFunc)(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo);
+
+#ifdef SCUMMVM_NEON
+	static void mixNEON(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void mixSSE2(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void mixAVX2(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo);
+#endif
+	static void mixGeneric(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool reverseStereo);
+	static void mixMono(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo);
+
+	static MixFunc mixFunc;
+	friend class ::MixerTestSuite;
+	friend class ::RateConverterTestSuite;
+
+public:
+	/**
+	 * Scale @p frames frames from @p src by the channel volumes and add
+	 * them to @p dst with clamping.
+	 *
+	 * @param dst           Output buffer, stereo if @p outStereo is set.
+	 * @param src           Input frames, stereo if @p inStereo is set.
+	 * @param frames        Number of frames to process.
+	 * @param volL          Left volume, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param volR          Right volume, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param reverseStereo Swap the left and right output channels.
+	 */
+	static void mix(st_sample_t *dst, const st_sample_t *src, uint frames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo);
+};
+
+} // End of namespace Audio
+
+#endif
@@ -172,6 +172,18 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the size and last modification time of the file referred by
+	 * this node. The time is only compared for equality, so any unit
+	 * which changes whenever the file is modified will do.
+	 *
+	 * @note By default, this method returns false, meaning the information
+	 *       is not available.
+	 *
+	 * @return bool true if size and modificationTime were set, false otherwise.
+	 */
+	virtual bool getFileInfo(int64 &size, int64 &modificationTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +194,17 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance corresponding to the file
+	 * referred by this node, which the backend may map into memory. Only
+	 * used for game data, which is not modified while the stream exists.
+	 *
+	 * @note By default, this method returns createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
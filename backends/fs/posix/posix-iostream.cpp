@@ -25,6 +25,17 @@
 
 #include <sys/stat.h>
 
+#ifdef HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/vfs.h>
+#elif defined(__APPLE__)
+#include <sys/mount.h>
+#endif
+#endif
+
 PosixIoStream *PosixIoStream::makeFromPath(const Common::String &path, bool writeMode) {
 #if defined(HAS_FOPEN64)
 	FILE *handle = fopen64(path.c_str(), writeMode ? "wb" : "rb");
@@ -58,3 +69,82 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+#ifdef HAS_MMAP
+
+// Small files are read as quickly as they are mapped, and mappings use up
+// whole pages
+#define POSIX_MAPPED_MIN_SIZE (64 * 1024)
+
+// Limit the size of mappings on 32-bit hosts, where many large files
+// would quickly exhaust the address space
+#define POSIX_MAPPED_MAX_SIZE (sizeof(void *) >= 8 ? 0xFFFFFFFFU : 64 * 1024 * 1024U)
+
+// Accessing a mapping raises SIGBUS when the file has gone away, which
+// happens all the time with network shares and removable media. Only map
+// files on file systems known to be local and fixed.
+static bool isFixedLocalFilesystem(int fd) {
+#if defined(__linux__) || defined(__ANDROID__)
+	struct statfs sfs;
+	if (fstatfs(fd, &sfs) == -1)
+		return false;
+
+	switch ((uint32)sfs.f_type) {
+	case 0xEF53:		// ext2, ext3 and ext4
+	case 0x58465342:	// XFS
+	case 0x9123683E:	// Btrfs
+	case 0xF2F52010:	// F2FS
+	case 0x2FC12FC1:	// ZFS
+	case 0x01021994:	// tmpfs
+	case 0x794C7630:	// overlayfs
+		return true;
+	default:
+		return false;
+	}
+#elif defined(__APPLE__)
+	struct statfs sfs;
+	if (fstatfs(fd, &sfs) == -1 || !(sfs.f_flags & MNT_LOCAL))
+		return false;
+#ifdef MNT_REMOVABLE
+	if (sfs.f_flags & MNT_REMOVABLE)
+		return false;
+#endif
+	return true;
+#else
+	return false;
+#endif
+}
+
+PosixMappedStream *PosixMappedStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || !isFixedLocalFilesystem(fd) ||
+	        st.st_size < POSIX_MAPPED_MIN_SIZE || (uint64)st.st_size > POSIX_MAPPED_MAX_SIZE) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after closing the descriptor
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMappedStream(mapping, st.st_size);
+}
+
+PosixMappedStream::PosixMappedStream(void *mapping, uint32 size) :
+		Common::MemoryReadStream((const byte *)mapping, size),
+		_mapping(mapping),
+		_mappingSize(size) {
+}
+
+PosixMappedStream::~PosixMappedStream() {
+	munmap(_mapping, _mappingSize);
+}
+
+#endif
@@ -23,6 +23,7 @@
 #define BACKENDS_FS_POSIX_POSIXIOSTREAM_H
 
 #include "backends/fs/stdiostream.h"
+#include "common/memstream.h"
 
 /**
  * A file input / output stream using POSIX interfaces
@@ -35,4 +36,31 @@ public:
 	int64 size() const override;
 };
 
+#ifdef HAS_MMAP
+/**
+ * A read-only file stream which maps the whole file into memory, so that
+ * its contents can be accessed with getBufferPtr() without copying.
+ *
+ * The file must not be truncated while the stream exists, as accessing
+ * the mapping past the end of the file raises SIGBUS.
+ */
+class PosixMappedStream final : public Common::MemoryReadStream {
+public:
+	/**
+	 * Map the file at @p path. Returns nullptr if the file cannot be
+	 * opened, is not a regular file of a size worth mapping, or is not
+	 * stored on a fixed local file system, in which case the caller
+	 * should fall back to PosixIoStream.
+	 */
+	static PosixMappedStream *makeFromPath(const Common::String &path);
+	~PosixMappedStream();
+
+private:
+	PosixMappedStream(void *mapping, uint32 size);
+
+	void *_mapping;
+	uint32 _mappingSize;
+};
+#endif
+
 #endif
@@ -30,7 +30,9 @@
 #include "graphics/opengl/debug.h"
 
 #include "common/array.h"
+#include "common/config-manager.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/translation.h"
 #include "common/algorithm.h"
 #include "common/file.h"
@@ -70,7 +72,10 @@ namespace OpenGL {
 
 OpenGLGraphicsManager::OpenGLGraphicsManager()
 	: _currentState(), _oldState(), _transactionMode(kTransactionNone), _screenChangeID(1 << (sizeof(int) * 8 - 2)),
-	  _pipeline(nullptr), _stretchMode(STRETCH_FIT),
+	  _pipeline(nullptr), _asyncPresent(ConfMan.getBool("async_present")),
+	  _presentPool(nullptr), _presentTask(nullptr), _presentPending(false),
+	  _gameStaging(), _gameStagingDirty(), _gamePaletteDirty(false), _presentCursorPos(), _presentCursorVisible(false),
+	  _stretchMode(STRETCH_FIT),
 	  _defaultFormat(), _defaultFormatAlpha(), _targetBuffer(nullptr),
 	  _gameScreen(nullptr), _overlay(nullptr),
 	  _cursor(nullptr), _cursorMask(nullptr),
@@ -93,6 +98,11 @@ OpenGLGraphicsManager::OpenGLGraphicsManager()
 }
 
 OpenGLGraphicsManager::~OpenGLGraphicsManager() {
+	waitForPresent();
+	delete _presentTask;
+	delete _presentPool;
+	_gameStaging.free();
+
 	delete _gameScreen;
 	delete _overlay;
 	delete _cursor;
@@ -136,6 +146,8 @@ bool OpenGLGraphicsManager::hasFeature(OSystem::Feature f) const {
 }
 
 void OpenGLGraphicsManager::setFeatureState(OSystem::Feature f, bool enable) {
+	waitForPresent();
+
 	switch (f) {
 	case OSystem::kFeatureAspectRatioCorrection:
 		assert(_transactionMode != kTransactionNone);
@@ -382,6 +394,8 @@ bool OpenGLGraphicsManager::loadShader(const Common::Path &fileName) {
 void OpenGLGraphicsManager::beginGFXTransaction() {
 	assert(_transactionMode == kTransactionNone);
 
+	waitForPresent();
+
 	// Start a transaction.
 	_oldState = _currentState;
 	_transactionMode = kTransactionActive;
@@ -540,8 +554,13 @@ OSystem::TransactionError OpenGLGraphicsManager::endGFXTransaction() {
 #else
 		_gameScreen->fill(0);
 #endif
+
+		_gameStaging.free();
+		_gameStagingDirty.clear();
 	}
 
+	setupAsyncPresent();
+
 	// Update our display area and cursor scaling. This makes sure we pick up
 	// aspect ratio correction and game screen changes correctly.
 	recalculateDisplayAreas();
@@ -586,14 +605,31 @@ int16 OpenGLGraphicsManager::getHeight() const {
 }
 
 void OpenGLGraphicsManager::copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+	if (_gameStaging.getPixels()) {
+		_gameStaging.copyRectToSurface(buf, pitch, x, y, w, h);
+		_gameStagingDirty.add(Common::Rect(x, y, x + w, y + h));
+		return;
+	}
+
 	_gameScreen->copyRectToTexture(x, y, w, h, buf, pitch);
 }
 
 void OpenGLGraphicsManager::fillScreen(uint32 col) {
+	if (_gameStaging.getPixels()) {
+		fillScreen(Common::Rect(_gameStaging.w, _gameStaging.h), col);
+		return;
+	}
+
 	_gameScreen->fill(col);
 }
 
 void OpenGLGraphicsManager::fillScreen(const Common::Rect &r, uint32 col) {
+	if (_gameStaging.getPixels()) {
+		_gameStaging.fillRect(r, col);
+		_gameStagingDirty.add(r);
+		return;
+	}
+
 	_gameScreen->fill(r, col);
 }
 
@@ -618,8 +654,8 @@ void OpenGLGraphicsManager::renderCursor() {
 		_targetBuffer->enableBlend(Framebuffer::kBlendModeMaskAlphaAndInvertByColor);
 
 		_pipeline->drawTexture(_cursorMask->getGLTexture(),
-							   _cursorX - _cursorHotspotXScaled + _shakeOffsetScaled.x,
-							   _cursorY - _cursorHotspotYScaled + _shakeOffsetScaled.y,
+							   _presentCursorPos.x - _cursorHotspotXScaled + _shakeOffsetScaled.x,
+							   _presentCursorPos.y - _cursorHotspotYScaled + _shakeOffsetScaled.y,
 							   _cursorWidthScaled, _cursorHeightScaled);
 
 		_targetBuffer->enableBlend(Framebuffer::kBlendModeAdditive);
@@ -627,8 +663,8 @@ void OpenGLGraphicsManager::renderCursor() {
 		_targetBuffer->enableBlend(Framebuffer::kBlendModePremultipliedTransparency);
 
 	_pipeline->drawTexture(_cursor->getGLTexture(),
-						   _cursorX - _cursorHotspotXScaled + _shakeOffsetScaled.x,
-						   _cursorY - _cursorHotspotYScaled + _shakeOffsetScaled.y,
+						   _presentCursorPos.x - _cursorHotspotXScaled + _shakeOffsetScaled.x,
+						   _presentCursorPos.y - _cursorHotspotYScaled + _shakeOffsetScaled.y,
 						   _cursorWidthScaled, _cursorHeightScaled);
 }
 
@@ -637,6 +673,11 @@ void OpenGLGraphicsManager::updateScreen() {
 		return;
 	}
 
+	// Engine logic for the next frame may only run while this frame is
+	// presented, so wait for the previous one now.
+	waitForPresent();
+	flushGameStaging();
+
 #ifdef USE_OSD
 	if (_osdMessageChangeRequest) {
 		osdMessageUpdateSurface();
@@ -668,12 +709,35 @@ void OpenGLGraphicsManager::updateScreen() {
 		return;
 	}
 
+	// Take the state changed by the engine thread while presenting.
+	_presentCursorPos = Common::Point(_cursorX, _cursorY);
+	_presentCursorVisible = _cursorVisible;
+	_cursorNeedsRedraw = false;
+	_forceRedraw = false;
+
+	if (_gameStaging.getPixels() && setContextCurrent(false)) {
+		_presentPending = true;
+		_presentTask->run(presentFrameProc, this);
+	} else {
+		presentFrame();
+	}
+}
+
+void OpenGLGraphicsManager::presentFrameProc(void *data) {
+	OpenGLGraphicsManager *manager = (OpenGLGraphicsManager *)data;
+
+	manager->setContextCurrent(true);
+	manager->presentFrame();
+	manager->setContextCurrent(false);
+}
+
+void OpenGLGraphicsManager::presentFrame() {
 	// Update changes to textures.
 	_gameScreen->updateGLTexture();
-	if (_cursorVisible && _cursor) {
+	if (_presentCursorVisible && _cursor) {
 		_cursor->updateGLTexture();
 	}
-	if (_cursorVisible && _cursorMask) {
+	if (_presentCursorVisible && _cursorMask) {
 		_cursorMask->updateGLTexture();
 	}
 	_overlay->updateGLTexture();
@@ -697,7 +761,7 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 
 	// Don't draw cursor if it's not visible or there is none
-	bool drawCursor = _cursorVisible && _cursor;
+	bool drawCursor = _presentCursorVisible && _cursor;
 
 	// Alpha blending is disabled when drawing the screen
 	_targetBuffer->enableBlend(Framebuffer::kBlendModeOpaque);
@@ -792,16 +856,81 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 #endif
 
-	_cursorNeedsRedraw = false;
-	_forceRedraw = false;
 	refreshScreen();
 }
 
+void OpenGLGraphicsManager::waitForPresent() const {
+	if (!_presentPending) {
+		return;
+	}
+
+	_presentTask->wait();
+	_presentPending = false;
+	setContextCurrent(true);
+}
+
+void OpenGLGraphicsManager::setupAsyncPresent() {
+	// The render thread owns the context while it presents a frame, which
+	// only works if the backend can move the context between threads.
+	if (!_asyncPresent || !_gameScreen || !setContextCurrent(true)) {
+		_asyncPresent = false;
+		_gameStaging.free();
+		return;
+	}
+
+	if (!_presentPool) {
+		// One thread for the calling thread and one for rendering.
+		_presentPool = new Common::ThreadPool(2);
+		if (!_presentPool->isMultiThreaded()) {
+			delete _presentPool;
+			_presentPool = nullptr;
+			_asyncPresent = false;
+			return;
+		}
+
+		_presentTask = new Common::TaskGroup(*_presentPool);
+	}
+
+	if (!_gameStaging.getPixels()) {
+		_gameStaging.copyFrom(*_gameScreen->getSurface());
+		_gameStagingDirty.clear();
+		_gameStagingDirty.setSize(_gameStaging.w, _gameStaging.h);
+	}
+}
+
+void OpenGLGraphicsManager::flushGameStaging() {
+	if (_gamePaletteDirty) {
+		_gameScreen->setPalette(0, 256, _gamePalette);
+		updateCursorPalette();
+		_gamePaletteDirty = false;
+	}
+
+	if (!_gameStaging.getPixels() || _gameStagingDirty.empty()) {
+		return;
+	}
+
+	const Common::Array<Common::Rect> &rects = _gameStagingDirty.getRects();
+	for (Common::Array<Common::Rect>::const_iterator i = rects.begin(); i != rects.end(); ++i) {
+		_gameScreen->copyRectToTexture(i->left, i->top, i->width(), i->height(),
+		                               _gameStaging.getBasePtr(i->left, i->top), _gameStaging.pitch);
+	}
+	_gameStagingDirty.clear();
+}
+
 Graphics::Surface *OpenGLGraphicsManager::lockScreen() {
+	if (_gameStaging.getPixels()) {
+		return &_gameStaging;
+	}
+
 	return _gameScreen->getSurface();
 }
 
 void OpenGLGraphicsManager::unlockScreen() {
+	if (_gameStaging.getPixels()) {
+		_gameStagingDirty.add(Common::Rect(_gameStaging.w, _gameStaging.h));
+		return;
+	}
+
 	_gameScreen->flagDirty();
 }
 
@@ -832,14 +961,18 @@ Graphics::PixelFormat OpenGLGraphicsManager::getOverlayFormat() const {
 }
 
 void OpenGLGraphicsManager::copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {
+	waitForPresent();
 	_overlay->copyRectToTexture(x, y, w, h, buf, pitch);
 }
 
 void OpenGLGraphicsManager::clearOverlay() {
+	waitForPresent();
 	_overlay->fill(0);
 }
 
 void OpenGLGraphicsManager::grabOverlay(Graphics::Surface &surface) const {
+	waitForPresent();
+
 	const Graphics::Surface *overlayData = _overlay->getSurface();
 
 	assert(surface.w >= overlayData->w);
@@ -886,7 +1019,24 @@ void multiplyColorWithAlpha(const byte *src, byte *dst, const uint w, const uint
 } // End of anonymous namespace
 
 
+void OpenGLGraphicsManager::showOverlay(bool inGUI) {
+	waitForPresent();
+	WindowedGraphicsManager::showOverlay(inGUI);
+}
+
+void OpenGLGraphicsManager::hideOverlay() {
+	waitForPresent();
+	WindowedGraphicsManager::hideOverlay();
+}
+
+void OpenGLGraphicsManager::setShakePos(int shakeXOffset, int shakeYOffset) {
+	waitForPresent();
+	WindowedGraphicsManager::setShakePos(shakeXOffset, shakeYOffset);
+}
+
 void OpenGLGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) {
+	waitForPresent();
+
 	_cursorUseKey = (mask == nullptr);
 	if (_cursorUseKey)
 		_cursorKeyColor = keycolor;
@@ -1127,6 +1277,7 @@ void OpenGLGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int
 void OpenGLGraphicsManager::setCursorPalette(const byte *colors, uint start, uint num) {
 	// FIXME: For some reason client code assumes that usage of this function
 	// automatically enables the cursor palette.
+	waitForPresent();
 	_cursorPaletteEnabled = true;
 
 	memcpy(_cursorPalette + start * 3, colors, num * 3);
@@ -1218,6 +1369,8 @@ void OpenGLGraphicsManager::osdMessageUpdateSurface() {
 
 void OpenGLGraphicsManager::displayActivityIconOnOSD(const Graphics::Surface *icon) {
 #ifdef USE_OSD
+	waitForPresent();
+
 	if (_osdIconSurface) {
 		delete _osdIconSurface;
 		_osdIconSurface = nullptr;
@@ -1253,6 +1406,14 @@ void OpenGLGraphicsManager::setPalette(const byte *colors, uint start, uint num)
 	assert(_gameScreen->hasPalette());
 
 	memcpy(_gamePalette + start * 3, colors, num * 3);
+
+	// The palette is applied with the next frame while the render thread
+	// might still be using the game screen.
+	if (_gameStaging.getPixels()) {
+		_gamePaletteDirty = true;
+		return;
+	}
+
 	_gameScreen->setPalette(start, num, colors);
 
 	// We might need to update the cursor palette here.
@@ -1266,6 +1427,8 @@ void OpenGLGraphicsManager::grabPalette(byte *colors, uint start, uint num) cons
 }
 
 void OpenGLGraphicsManager::handleResizeImpl(const int width, const int height) {
+	waitForPresent();
+
 	// Setup backbuffer size.
 	_targetBuffer->setSize(width, height);
 
@@ -1321,6 +1484,8 @@ void OpenGLGraphicsManager::notifyContextCreate(ContextType type,
 	Framebuffer *target,
 	const Graphics::PixelFormat &defaultFormat,
 	const Graphics::PixelFormat &defaultFormatAlpha) {
+	waitForPresent();
+
 	// Set up the target: backbuffer usually
 	delete _targetBuffer;
 	_targetBuffer = target;
@@ -1420,6 +1585,8 @@ void OpenGLGraphicsManager::notifyContextCreate(ContextType type,
 }
 
 void OpenGLGraphicsManager::notifyContextDestroy() {
+	waitForPresent();
+
 	if (_gameScreen) {
 		_gameScreen->destroy();
 	}
@@ -1740,6 +1907,8 @@ const Graphics::Font *OpenGLGraphicsManager::getFontOSD() const {
 #endif
 
 bool OpenGLGraphicsManager::saveScreenshot(const Common::Path &filename) const {
+	waitForPresent();
+
 	const uint width  = _windowWidth;
 	const uint height = _windowHeight;
 
@@ -29,8 +29,14 @@
 #include "common/mutex.h"
 #include "common/ustr.h"
 
+#include "graphics/dirtyregion.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class TaskGroup;
+class ThreadPool;
+} // End of namespace Common
+
 namespace Graphics {
 class Font;
 } // End of namespace Graphics
@@ -120,6 +126,11 @@ public:
 	void clearOverlay() override;
 	void grabOverlay(Graphics::Surface &surface) const override;
 
+	void showOverlay(bool inGUI) override;
+	void hideOverlay() override;
+
+	void setShakePos(int shakeXOffset, int shakeYOffset) override;
+
 	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) override;
 	void setCursorPalette(const byte *colors, uint start, uint num) override;
 
@@ -280,6 +291,24 @@ protected:
 	 */
 	virtual void refreshScreen() = 0;
 
+	/**
+	 * Make the OpenGL context current on the calling thread, or release it
+	 * from the calling thread. This is used to present frames on a render
+	 * thread.
+	 *
+	 * @param current Whether to make the context current or to release it.
+	 * @return true on success, false if the context cannot be moved between
+	 *         threads.
+	 */
+	virtual bool setContextCurrent(bool current) const { return false; }
+
+	/**
+	 * Wait for the frame presented on the render thread to finish and take
+	 * the OpenGL context back. This must be called before touching any GL
+	 * object or any state used for drawing.
+	 */
+	void waitForPresent() const;
+
 	/**
 	 * Saves a screenshot of the entire window, excluding window decorations.
 	 *
@@ -301,6 +330,65 @@ private:
 	 */
 	void initializeGLContext();
 
+	//
+	// Pipelined presentation
+	//
+
+	/**
+	 * Set up presenting frames on a render thread if it was requested and
+	 * the backend supports it.
+	 */
+	void setupAsyncPresent();
+
+	/**
+	 * Copy the changes to the staged game screen and palette into the game
+	 * screen.
+	 */
+	void flushGameStaging();
+
+	/**
+	 * Upload the changed textures, draw the frame and swap the buffers.
+	 */
+	void presentFrame();
+	static void presentFrameProc(void *data);
+
+	/**
+	 * Whether presenting frames on a render thread was requested.
+	 */
+	bool _asyncPresent;
+
+	/**
+	 * Pool holding the render thread, and the task of the frame presented
+	 * on it.
+	 */
+	Common::ThreadPool *_presentPool;
+	Common::TaskGroup *_presentTask;
+
+	/**
+	 * Whether a frame is being presented on the render thread.
+	 */
+	mutable bool _presentPending;
+
+	/**
+	 * The game screen contents written by the engine while frames are
+	 * presented on the render thread, and the areas changed since the last
+	 * frame.
+	 */
+	Graphics::Surface _gameStaging;
+	Graphics::DirtyRegion _gameStagingDirty;
+
+	/**
+	 * Whether _gamePalette changed since the last frame while frames are
+	 * presented on the render thread.
+	 */
+	bool _gamePaletteDirty;
+
+	/**
+	 * The mouse position and visibility used for drawing the current frame.
+	 */
+	Common::Point _presentCursorPos;
+	bool _presentCursorVisible;
+
 	/**
 	 * OpenGL pipeline used for rendering.
 	 */
@@ -30,6 +30,7 @@
 #include "common/endian.h"
 #include "common/rect.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 
 #include "graphics/blit.h"
 
@@ -43,12 +44,20 @@ GLTexture::GLTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
 	  _texCoords(), _glFilter(GL_NEAREST),
-	  _glTexture(0) {
+	  _glTexture(0), _pixelBuffers(), _pixelBufferSizes(), _nextPixelBuffer(0) {
 	create();
 }
 
 GLTexture::~GLTexture() {
 	GL_CALL_SAFE(glDeleteTextures, (1, &_glTexture));
+#ifdef USE_GLAD
+	// The ring buffers are created lazily, so any of them may be missing
+	for (uint i = 0; i < kPixelBufferCount; ++i) {
+		if (_pixelBuffers[i]) {
+			GL_CALL_SAFE(glDeleteBuffers, (1, &_pixelBuffers[i]));
+		}
+	}
+#endif
 }
 
 void GLTexture::enableLinearFiltering(bool enable) {
@@ -113,6 +122,17 @@ void GLTexture::setWrapMode(WrapMode wrapMode) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+	for (uint i = 0; i < kPixelBufferCount; ++i) {
+#ifdef USE_GLAD
+		if (_pixelBuffers[i]) {
+			GL_CALL(glDeleteBuffers(1, &_pixelBuffers[i]));
+		}
+#endif
+		_pixelBuffers[i] = 0;
+		_pixelBufferSizes[i] = 0;
+	}
+	_nextPixelBuffer = 0;
 }
 
 void GLTexture::create() {
@@ -196,29 +216,133 @@ bool GLTexture::setSize(uint width, uint height) {
 }
 
 void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &src) {
+	Common::Array<Common::Rect> areas;
+	areas.push_back(area);
+	updateAreas(areas, src);
+}
+
+void GLTexture::updateAreas(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
+	if (areas.empty()) {
+		return;
+	}
+
 	// Set the texture on the active texture unit.
 	bind();
 
-	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
+	const uint bpp = src.format.bytesPerPixel;
+	if (OpenGLContext.unpackSubImageSupported && src.pitch % bpp == 0) {
+		if (updateAreasThroughPixelBuffer(areas, src)) {
+			return;
+		}
+
+		// GL_UNPACK_ROW_LENGTH lets us upload exactly the dirty rects
+		// straight from the surface.
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / bpp));
+		for (Common::Array<Common::Rect>::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+			GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, i->left, i->top, i->width(), i->height(),
+			                        _glFormat, _glType, src.getBasePtr(i->left, i->top)));
+		}
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		return;
+	}
+
+	// Without GL_UNPACK_ROW_LENGTH (OpenGL ES 1.0 and 2.0 without
+	// EXT_unpack_subimage) it is not possible to specify a pitch to
+	// glTexSubImage2D. Thus we always update the whole texture lines of the
+	// changed areas. Copying each area to a temporary buffer would be the
+	// alternative, but that is more complicated. Using glTexSubImage2D per
+	// line changed is much slower, so we do not use that either.
 	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	// Areas side by side share lines, so merge the line ranges first to
+	// upload every line only once.
+	Common::Array<Common::Rect> lines;
+	for (Common::Array<Common::Rect>::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+		lines.push_back(Common::Rect(0, i->top, src.w, i->bottom));
+	}
+	Common::sort(lines.begin(), lines.end(), [](const Common::Rect &a, const Common::Rect &b) {
+		return a.top < b.top;
+	});
+
+	Common::Rect range = lines[0];
+	for (uint i = 1; i <= lines.size(); ++i) {
+		if (i < lines.size() && lines[i].top <= range.bottom) {
+			range.bottom = MAX(range.bottom, lines[i].bottom);
+			continue;
+		}
+
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, range.top, src.w, range.height(),
+		                        _glFormat, _glType, src.getBasePtr(0, range.top)));
+
+		if (i < lines.size()) {
+			range = lines[i];
+		}
+	}
+}
+
+bool GLTexture::updateAreasThroughPixelBuffer(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
+#ifdef USE_GLAD
+	if (!OpenGLContext.pixelBufferObjectSupported) {
+		return false;
+	}
+
+	// The areas are packed tightly one after the other into a buffer of the
+	// ring. With several buffers the driver can still read the previous
+	// frames' data while we fill the next one, so the upload does not stall
+	// the CPU.
+	const uint bpp = src.format.bytesPerPixel;
+	uint size = 0;
+	for (Common::Array<Common::Rect>::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+		size += i->width() * i->height() * bpp;
+	}
+
+	const uint index = _nextPixelBuffer;
+	_nextPixelBuffer = (_nextPixelBuffer + 1) % kPixelBufferCount;
+
+	if (!_pixelBuffers[index]) {
+		GL_CALL(glGenBuffers(1, &_pixelBuffers[index]));
+		_pixelBufferSizes[index] = 0;
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[index]));
+	if (size > _pixelBufferSizes[index]) {
+		GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+		_pixelBufferSizes[index] = size;
+	}
+
+	byte *dst;
+	GL_ASSIGN(dst, (byte *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	if (!dst) {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	for (Common::Array<Common::Rect>::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+		const uint lineSize = i->width() * bpp;
+		const byte *line = (const byte *)src.getBasePtr(i->left, i->top);
+		for (int y = i->top; y < i->bottom; ++y) {
+			memcpy(dst, line, lineSize);
+			dst += lineSize;
+			line += src.pitch;
+		}
+	}
+
+	GLboolean unmapped;
+	GL_ASSIGN(unmapped, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+	if (unmapped) {
+		// With a bound pixel buffer the data pointer is an offset into it.
+		uintptr offset = 0;
+		for (Common::Array<Common::Rect>::const_iterator i = areas.begin(); i != areas.end(); ++i) {
+			GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, i->left, i->top, i->width(), i->height(),
+			                        _glFormat, _glType, (const void *)offset));
+			offset += i->width() * i->height() * bpp;
+		}
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+	return unmapped;
+#else
+	return false;
+#endif
 }
 
 //
@@ -226,7 +350,7 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyRegion() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -267,23 +391,18 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 }
 
 void Surface::addDirtyArea(const Common::Rect &r) {
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
-	}
+	_dirtyRegion.setSize(getWidth(), getHeight());
+	_dirtyRegion.add(r);
 }
 
-Common::Rect Surface::getDirtyArea() const {
+const Common::Array<Common::Rect> &Surface::getDirtyRects() {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
-	} else {
-		return _dirtyArea;
+		_dirtyRegion.clear();
+		_dirtyRegion.setSize(getWidth(), getHeight());
+		_dirtyRegion.add(Common::Rect(getWidth(), getHeight()));
 	}
+
+	return _dirtyRegion.getRects();
 }
 
 //
@@ -343,45 +462,51 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	_uploadRects = getDirtyRects();
 
-	updateGLTexture(dirtyArea);
+	updateGLTexture(_uploadRects);
 }
 
-void Texture::updateGLTexture(Common::Rect &dirtyArea) {
+void Texture::updateGLTexture(Common::Array<Common::Rect> &dirtyRects) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
 	if (_glTexture.isLinearFilteringEnabled()) {
-		if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
-			uint height = dirtyArea.height();
+		for (Common::Array<Common::Rect>::iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+			extendForLinearFiltering(*i);
+		}
+	}
 
-			const byte *src = (const byte *)_textureData.getBasePtr(_userPixelData.w - 1, dirtyArea.top);
-			byte *dst = (byte *)_textureData.getBasePtr(_userPixelData.w, dirtyArea.top);
+	_glTexture.updateAreas(dirtyRects, _textureData);
 
-			while (height-- > 0) {
-				memcpy(dst, src, _textureData.format.bytesPerPixel);
-				dst += _textureData.pitch;
-				src += _textureData.pitch;
-			}
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
+}
 
-			// Extend the dirty area.
-			++dirtyArea.right;
-		}
+void Texture::extendForLinearFiltering(Common::Rect &dirtyArea) {
+	if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
+		uint height = dirtyArea.height();
 
-		if (dirtyArea.bottom == _userPixelData.h && _userPixelData.h != _textureData.h) {
-			const byte *src = (const byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h - 1);
-			byte *dst = (byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h);
-			memcpy(dst, src, dirtyArea.width() * _textureData.format.bytesPerPixel);
+		const byte *src = (const byte *)_textureData.getBasePtr(_userPixelData.w - 1, dirtyArea.top);
+		byte *dst = (byte *)_textureData.getBasePtr(_userPixelData.w, dirtyArea.top);
 
-			// Extend the dirty area.
-			++dirtyArea.bottom;
+		while (height-- > 0) {
+			memcpy(dst, src, _textureData.format.bytesPerPixel);
+			dst += _textureData.pitch;
+			src += _textureData.pitch;
 		}
+
+		// Extend the dirty area.
+		++dirtyArea.right;
 	}
 
-	_glTexture.updateArea(dirtyArea, _textureData);
+	if (dirtyArea.bottom == _userPixelData.h && _userPixelData.h != _textureData.h) {
+		const byte *src = (const byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h - 1);
+		byte *dst = (byte *)_textureData.getBasePtr(dirtyArea.left, _userPixelData.h);
+		memcpy(dst, src, dirtyArea.width() * _textureData.format.bytesPerPixel);
 
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
+		// Extend the dirty area.
+		++dirtyArea.bottom;
+	}
 }
 
 FakeTexture::FakeTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -463,12 +588,15 @@ void FakeTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> &dirtyRects = getDirtyRects();
+	for (Common::Array<Common::Rect>::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		const Common::Rect &dirtyArea = *i;
 
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
 	Texture::updateGLTexture();
@@ -520,25 +648,28 @@ void TextureRGB555::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> &dirtyRects = getDirtyRects();
+	for (Common::Array<Common::Rect>::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		const Common::Rect &dirtyArea = *i;
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
-	const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
+		const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint16 color = *src++;
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
-		}
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
 
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -562,23 +693,26 @@ void TextureRGBA8888Swap::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Common::Array<Common::Rect> &dirtyRects = getDirtyRects();
+	for (Common::Array<Common::Rect>::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		const Common::Rect &dirtyArea = *i;
 
-	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
+		uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
 
-	const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
+		const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint32 color = *src++;
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint32 color = *src++;
 
-			*dst++ = SWAP_BYTES_32(color);
-		}
+				*dst++ = SWAP_BYTES_32(color);
+			}
 
-		src = (const uint32 *)((const byte *)src + srcAdd);
-		dst = (uint32 *)((byte *)dst + dstAdd);
+			src = (const uint32 *)((const byte *)src + srcAdd);
+			dst = (uint32 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
@@ -629,46 +763,49 @@ void ScaledTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	_uploadRects = getDirtyRects();
+	for (Common::Array<Common::Rect>::iterator i = _uploadRects.begin(); i != _uploadRects.end(); ++i) {
+		Common::Rect &dirtyArea = *i;
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		uint srcPitch = _rgbData.pitch;
+		byte *dst;
+		uint dstPitch;
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+		if (_convData) {
+			dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			dstPitch = _convData->pitch;
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+			applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+			src = dst;
+			srcPitch = dstPitch;
+		}
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+		dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		dstPitch = outSurf->pitch;
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
+	}
 
 	// Do generic handling of updating the texture.
-	Texture::updateGLTexture(dirtyArea);
+	Texture::updateGLTexture(_uploadRects);
 }
 
 void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
@@ -683,6 +820,7 @@ void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
 
 	if (!_scaler) {
 		_scaler = scalerPlugin.createInstance(_format);
+		_scaler->setBands(ThreadPoolMan.getThreadCount() + 1);
 	}
 	_scaler->setFactor(scaleFactor);
 
@@ -703,7 +841,7 @@ TextureCLUT8GPU::TextureCLUT8GPU()
 	: _clut8Texture(GL_ALPHA, GL_ALPHA, GL_UNSIGNED_BYTE),
 	  _paletteTexture(GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE),
 	  _target(new TextureTarget()), _clut8Pipeline(new CLUT8LookUpPipeline()),
-	  _clut8Vertices(), _clut8Data(), _userPixelData(), _palette(),
+	  _lookUpRects(), _clut8Data(), _userPixelData(), _palette(),
 	  _paletteDirty(false) {
 	// Allocate space for 256 colors.
 	_paletteTexture.setSize(256, 1);
@@ -768,19 +906,6 @@ void TextureCLUT8GPU::allocate(uint width, uint height) {
 	// Create a sub-buffer for raw access.
 	_userPixelData = _clut8Data.getSubArea(Common::Rect(width, height));
 
-	// Setup structures for internal rendering to _glTexture.
-	_clut8Vertices[0] = 0;
-	_clut8Vertices[1] = 0;
-
-	_clut8Vertices[2] = width;
-	_clut8Vertices[3] = 0;
-
-	_clut8Vertices[4] = 0;
-	_clut8Vertices[5] = height;
-
-	_clut8Vertices[6] = width;
-	_clut8Vertices[7] = height;
-
 	// The whole texture is dirty after we changed the size. This fixes
 	// multiple texture size changes without any actual update in between.
 	// Without this we might try to write a too big texture into the GL
@@ -824,11 +949,12 @@ const GLTexture &TextureCLUT8GPU::getGLTexture() const {
 }
 
 void TextureCLUT8GPU::updateGLTexture() {
-	const bool needLookUp = Surface::isDirty() || _paletteDirty;
+	_lookUpRects.clear();
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		_lookUpRects = getDirtyRects();
+		_clut8Texture.updateAreas(_lookUpRects, _clut8Data);
 		clearDirty();
 	}
 
@@ -845,10 +971,14 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 		_paletteTexture.updateArea(Common::Rect(256, 1), palSurface);
 		_paletteDirty = false;
+
+		// A palette change means we need to look up the whole surface.
+		_lookUpRects.clear();
+		_lookUpRects.push_back(Common::Rect(_userPixelData.w, _userPixelData.h));
 	}
 
 	// In case any data changed, do color look up and store result in _target.
-	if (needLookUp) {
+	if (!_lookUpRects.empty()) {
 		lookUpColors();
 	}
 }
@@ -857,8 +987,11 @@ void TextureCLUT8GPU::lookUpColors() {
 	// Setup pipeline to do color look up.
 	_clut8Pipeline->activate();
 
-	// Do color look up.
-	_clut8Pipeline->drawTexture(_clut8Texture, _clut8Vertices);
+	// Do color look up. The target keeps its contents between frames and
+	// blending is disabled, so only the changed areas need to be drawn.
+	for (Common::Array<Common::Rect>::const_iterator i = _lookUpRects.begin(); i != _lookUpRects.end(); ++i) {
+		_clut8Pipeline->drawTexture(_clut8Texture, i->left, i->top, i->width(), i->height(), *i);
+	}
 
 	_clut8Pipeline->deactivate();
 }
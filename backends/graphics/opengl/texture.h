@@ -25,9 +25,11 @@
 #include "graphics/opengl/system_headers.h"
 #include "graphics/opengl/context.h"
 
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 class Scaler;
@@ -114,6 +116,15 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Copy the image data of several areas to the texture in one batch.
+	 *
+	 * @param areas    The areas to update.
+	 * @param src      Surface for the whole texture containing the pixel data
+	 *                 to upload.
+	 */
+	void updateAreas(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -147,6 +158,16 @@ public:
 	 */
 	GLuint getGLTexture() const { return _glTexture; }
 private:
+	/**
+	 * Upload the areas through the next pixel buffer of the staging ring.
+	 *
+	 * @return Whether the upload was done.
+	 */
+	bool updateAreasThroughPixelBuffer(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+
+	/** Number of pixel buffers in the staging ring. */
+	static const uint kPixelBufferCount = 3;
+
 	const GLenum _glIntFormat;
 	const GLenum _glFormat;
 	const GLenum _glType;
@@ -158,6 +179,10 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+
+	GLuint _pixelBuffers[kPixelBufferCount];
+	uint _pixelBufferSizes[kPixelBufferCount];
+	uint _nextPixelBuffer;
 };
 
 /**
@@ -224,7 +249,7 @@ public:
 	void fill(const Common::Rect &r, uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyRegion.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -264,13 +289,19 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyRegion.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+
+	/**
+	 * @return The areas changed since the last update. Separate changes,
+	 *         like the cursor in one corner and an animation in the other,
+	 *         are kept apart instead of being joined into one bounding box.
+	 */
+	const Common::Array<Common::Rect> &getDirtyRects();
 private:
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Graphics::DirtyRegion _dirtyRegion;
 };
 
 /**
@@ -314,9 +345,18 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
-	void updateGLTexture(Common::Rect &dirtyArea);
+	/**
+	 * Upload the given areas of the texture data. The areas are extended
+	 * by the border duplicated for linear filtering.
+	 */
+	void updateGLTexture(Common::Array<Common::Rect> &dirtyRects);
+
+	/** Areas of the texture data to upload. */
+	Common::Array<Common::Rect> _uploadRects;
 
 private:
+	void extendForLinearFiltering(Common::Rect &dirtyArea);
+
 	GLTexture _glTexture;
 
 	Graphics::Surface _textureData;
@@ -445,7 +485,8 @@ private:
 	TextureTarget *_target;
 	CLUT8LookUpPipeline *_clut8Pipeline;
 
-	GLfloat _clut8Vertices[4*2];
+	/** Areas which need their colors looked up again. */
+	Common::Array<Common::Rect> _lookUpRects;
 
 	Graphics::Surface _clut8Data;
 	Graphics::Surface _userPixelData;
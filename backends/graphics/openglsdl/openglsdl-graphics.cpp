@@ -299,6 +299,10 @@ void OpenGLSdlGraphicsManager::notifyVideoExpose() {
 }
 
 void OpenGLSdlGraphicsManager::notifyResize(const int width, const int height) {
+	// The window might be recreated, which must not happen while a frame is
+	// presented.
+	waitForPresent();
+
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	// We sometime get inaccurate resize events from SDL2. So use the real drawable size
 	// we get from SDL2 and ignore the event data.
@@ -450,6 +454,16 @@ void OpenGLSdlGraphicsManager::refreshScreen() {
 #endif
 }
 
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+bool OpenGLSdlGraphicsManager::setContextCurrent(bool current) const {
+	if (!_glContext) {
+		return false;
+	}
+
+	return SDL_GL_MakeCurrent(_window->getSDLWindow(), current ? _glContext : nullptr) == 0;
+}
+#endif
+
 void OpenGLSdlGraphicsManager::handleResizeImpl(const int width, const int height) {
 	OpenGLGraphicsManager::handleResizeImpl(width, height);
 	SdlGraphicsManager::handleResizeImpl(width, height);
@@ -55,6 +55,10 @@ protected:
 
 	void refreshScreen() override;
 
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	bool setContextCurrent(bool current) const override;
+#endif
+
 	void handleResizeImpl(const int width, const int height) override;
 
 	bool saveScreenshot(const Common::Path &filename) const override;
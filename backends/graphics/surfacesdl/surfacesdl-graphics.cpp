@@ -31,6 +31,7 @@
 #include "common/util.h"
 #include "common/file.h"
 #include "common/frac.h"
+#include "common/threadpool.h"
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
 #endif
@@ -136,7 +137,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
-	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0) {
 
@@ -683,6 +684,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scaler = _scalerPlugin->createInstance(format);
+		_scaler->setBands(ThreadPoolMan.getThreadCount() + 1);
 
 		if (_mouseScaler != nullptr) {
 			delete _mouseScaler;
@@ -930,6 +932,10 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 
 	setupHardwareSize();
 
+	// The dirty region holds rects of both the game screen and the overlay
+	_dirtyRegion.setSize(MAX(_videoMode.screenWidth, _videoMode.overlayWidth),
+	                     MAX(_videoMode.screenHeight, _videoMode.overlayHeight));
+
 	//
 	// Create the surface that contains the game data
 	//
@@ -1311,20 +1317,43 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 	// In case of double buferring partially good version may be on another page,
 	// so we need to fully redraw
-	if (_isDoubleBuf && _numDirtyRects)
+	if (_isDoubleBuf && !_dirtyRegion.empty())
 		_forceRedraw = true;
 
 	bool doRedraw = _forceRedraw || (_prevForceRedraw && _isDoubleBuf);
-	int actualDirtyRects = _numDirtyRects;
-	if (_isDoubleBuf && _numPrevDirtyRects > 0) {
-		memcpy(_dirtyRectList + _numDirtyRects, _prevDirtyRectList, _numPrevDirtyRects * sizeof(_dirtyRectList[0]));
-		actualDirtyRects += _numPrevDirtyRects;
+
+	_dirtyRectList.clear();
+	if (!doRedraw) {
+		const Common::Array<Common::Rect> &dirtyRects = _dirtyRegion.getRects();
+		for (uint i = 0; i < dirtyRects.size(); ++i) {
+			int x = dirtyRects[i].left;
+			int y = dirtyRects[i].top;
+			int w = dirtyRects[i].width();
+			int h = dirtyRects[i].height();
+#ifdef USE_ASPECT
+			// Merged rects and tiles can start on any line, so they need to be
+			// aligned for the stretching again
+			if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
+				makeRectStretchable(x, y, w, h, _videoMode.filtering);
+#endif
+			SDL_Rect r;
+			r.x = x;
+			r.y = y;
+			r.w = w;
+			r.h = h;
+			_dirtyRectList.push_back(r);
+		}
 	}
+	const uint numDirtyRects = _dirtyRectList.size();
+	if (_isDoubleBuf)
+		_dirtyRectList.push_back(_prevDirtyRectList);
+	int actualDirtyRects = _dirtyRectList.size();
 
 	// Force a full redraw if requested.
 	// If _useOldSrc, the scaler will do its own partial updates.
 	if (doRedraw) {
 		actualDirtyRects = 1;
+		_dirtyRectList.resize(1);
 		_dirtyRectList[0].x = 0;
 		_dirtyRectList[0].y = 0;
 		_dirtyRectList[0].w = width;
@@ -1332,9 +1361,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	}
 
 	_prevForceRedraw = _forceRedraw;
-	if (!_prevForceRedraw && _numDirtyRects && _isDoubleBuf) {
-		memcpy(_prevDirtyRectList, _dirtyRectList, _numDirtyRects * sizeof(_dirtyRectList[0]));
-		_numPrevDirtyRects = _numDirtyRects;
+	if (!_prevForceRedraw && numDirtyRects && _isDoubleBuf) {
+		_prevDirtyRectList.resize(numDirtyRects);
+		memcpy(_prevDirtyRectList.data(), _dirtyRectList.data(), numDirtyRects * sizeof(_dirtyRectList[0]));
 	}
 
 	// Only draw anything if necessary
@@ -1342,9 +1371,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_Rect *r;
 		SDL_Rect dst;
 		uint32 bpp, srcPitch, dstPitch;
-		SDL_Rect *lastRect = _dirtyRectList + actualDirtyRects;
+		SDL_Rect *lastRect = _dirtyRectList.begin() + actualDirtyRects;
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = _dirtyRectList.begin(); r != lastRect; ++r) {
 			dst = *r;
 			dst.x += _maxExtraPixels;	// Shift rect since some scalers need to access the data around
 			dst.y += _maxExtraPixels;	// any pixel to scale it, and we want to avoid mem access crashes.
@@ -1360,7 +1389,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = _dirtyRectList.begin(); r != lastRect; ++r) {
 			int src_x = r->x;
 			int src_y = r->y;
 			int dst_x = r->x;
@@ -1515,14 +1544,14 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 		// Finally, blit all our changes to the screen
 		if (!_displayDisabled) {
-			updateScreen(_dirtyRectList, actualDirtyRects);
+			updateScreen(_dirtyRectList.data(), actualDirtyRects);
 		}
 	}
 
 	// Set up the old scale factor
 	_scaler->setFactor(oldScaleFactor);
 
-	_numDirtyRects = 0;
+	_dirtyRegion.clear();
 	_forceRedraw = false;
 	_cursorNeedsRedraw = false;
 #if !SDL_VERSION_ATLEAST(2, 0, 0)
@@ -1728,11 +1757,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceRedraw = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!inOverlay && !realCoordinates) {
@@ -1784,12 +1808,7 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	}
 
 	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
-
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+		_dirtyRegion.add(Common::Rect(x, y, x + w, y + h));
 	}
 }
 
@@ -24,9 +24,11 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtyregion.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
+#include "common/array.h"
 #include "common/events.h"
 #include "common/mutex.h"
 
@@ -342,19 +344,19 @@ protected:
 	int _screenChangeCount;
 
 	enum {
-		NUM_DIRTY_RECT = 100,
 		MAX_SCALING = 3
 	};
 
 	// Dirty rect management
+	// The dirty rects of a frame are collected and coalesced in the region,
+	// which is turned into the rect list when the screen is updated.
 	// When double-buffering we need to redraw both updates from
 	// current frame and previous frame. For convenience we copy
 	// them here before traversing the list.
-	SDL_Rect _dirtyRectList[2 * NUM_DIRTY_RECT];
-	int _numDirtyRects;
+	Graphics::DirtyRegion _dirtyRegion;
+	Common::Array<SDL_Rect> _dirtyRectList;
 
-	SDL_Rect _prevDirtyRectList[NUM_DIRTY_RECT];
-	int _numPrevDirtyRects;
+	Common::Array<SDL_Rect> _prevDirtyRectList;
 
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
@@ -69,6 +69,7 @@
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threadpool.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -807,6 +808,10 @@ Common::MutexInternal *OSystem_Android::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+Common::ThreadPoolInternal *OSystem_Android::createThreadPool(uint numThreads) {
+	return createPthreadThreadPoolInternal(numThreads);
+}
+
 void OSystem_Android::quit() {
 	ENTER();
 
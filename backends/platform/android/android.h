@@ -232,6 +232,7 @@ public:
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadPoolInternal *createThreadPool(uint numThreads) override;
 
 	void quit() override;
 
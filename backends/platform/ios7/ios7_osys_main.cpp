@@ -52,6 +52,7 @@
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threadpool.h"
 #include "backends/fs/chroot/chroot-fs-factory.h"
 #include "backends/fs/posix/posix-fs.h"
 #include "audio/mixer.h"
@@ -393,6 +394,10 @@ Common::MutexInternal *OSystem_iOS7::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+Common::ThreadPoolInternal *OSystem_iOS7::createThreadPool(uint numThreads) {
+	return createPthreadThreadPoolInternal(numThreads);
+}
+
 void OSystem_iOS7::quit() {
 }
 
@@ -126,6 +126,7 @@ public:
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadPoolInternal *createThreadPool(uint numThreads) override;
 
 	static void mixCallback(void *sys, byte *samples, int len);
 	virtual void setupMixer(void);
@@ -49,6 +49,9 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+#include "backends/mutex/pthread/pthread-mutex.h"
+#endif
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -187,7 +190,12 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#if defined(NULL_DRIVER_USE_FOR_TEST) && defined(POSIX)
+	// Tests run code on worker threads, which needs working locks
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
 }
 
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
@@ -0,0 +1,195 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(POSIX)
+
+#include "backends/threads/pthread/pthread-threadpool.h"
+#ifdef __ANDROID__
+#include "backends/platform/android/jni-android.h"
+#endif
+#include "common/array.h"
+#include "common/queue.h"
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+class PthreadThreadPoolInternal final : public Common::ThreadPoolInternal {
+public:
+	PthreadThreadPoolInternal();
+	~PthreadThreadPoolInternal() override;
+
+	bool start(uint numThreads);
+
+	uint getThreadCount() const override { return _threads.size(); }
+	void submit(Common::ThreadPoolProc proc, void *data, uint *counter) override;
+	void wait(uint *counter) override;
+	void cancel(uint *counter) override;
+
+private:
+	struct Job {
+		Common::ThreadPoolProc proc;
+		void *data;
+		uint *counter;
+	};
+
+	static void *threadProc(void *data);
+	void runJob(const Job &job);
+
+	pthread_mutex_t _mutex;
+	pthread_cond_t _workCond;
+	pthread_cond_t _doneCond;
+	Common::Array<pthread_t> _threads;
+	Common::Queue<Job> _jobs;
+	bool _quit;
+};
+
+PthreadThreadPoolInternal::PthreadThreadPoolInternal() : _quit(false) {
+	pthread_mutex_init(&_mutex, nullptr);
+	pthread_cond_init(&_workCond, nullptr);
+	pthread_cond_init(&_doneCond, nullptr);
+}
+
+PthreadThreadPoolInternal::~PthreadThreadPoolInternal() {
+	pthread_mutex_lock(&_mutex);
+	_quit = true;
+	pthread_cond_broadcast(&_workCond);
+	pthread_mutex_unlock(&_mutex);
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		pthread_join(_threads[i], nullptr);
+
+	pthread_cond_destroy(&_doneCond);
+	pthread_cond_destroy(&_workCond);
+	pthread_mutex_destroy(&_mutex);
+}
+
+bool PthreadThreadPoolInternal::start(uint numThreads) {
+	for (uint i = 0; i < numThreads; ++i) {
+		pthread_t thread;
+		if (pthread_create(&thread, nullptr, threadProc, this) != 0) {
+			warning("pthread_create() failed");
+			break;
+		}
+		_threads.push_back(thread);
+	}
+	return !_threads.empty();
+}
+
+void PthreadThreadPoolInternal::submit(Common::ThreadPoolProc proc, void *data, uint *counter) {
+	Job job;
+	job.proc = proc;
+	job.data = data;
+	job.counter = counter;
+
+	pthread_mutex_lock(&_mutex);
+	++*counter;
+	_jobs.push(job);
+	pthread_cond_signal(&_workCond);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void PthreadThreadPoolInternal::wait(uint *counter) {
+	pthread_mutex_lock(&_mutex);
+	while (*counter) {
+		if (!_jobs.empty()) {
+			runJob(_jobs.pop());
+		} else {
+			pthread_cond_wait(&_doneCond, &_mutex);
+		}
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+void PthreadThreadPoolInternal::cancel(uint *counter) {
+	pthread_mutex_lock(&_mutex);
+	Common::Queue<Job> remaining;
+	while (!_jobs.empty()) {
+		Job job = _jobs.pop();
+		if (job.counter == counter)
+			--*counter;
+		else
+			remaining.push(job);
+	}
+	_jobs = remaining;
+
+	if (*counter == 0)
+		pthread_cond_broadcast(&_doneCond);
+	pthread_mutex_unlock(&_mutex);
+}
+
+// Called and returns with _mutex held.
+void PthreadThreadPoolInternal::runJob(const Job &job) {
+	pthread_mutex_unlock(&_mutex);
+	job.proc(job.data);
+	pthread_mutex_lock(&_mutex);
+
+	if (--*job.counter == 0)
+		pthread_cond_broadcast(&_doneCond);
+}
+
+void *PthreadThreadPoolInternal::threadProc(void *data) {
+	PthreadThreadPoolInternal *pool = (PthreadThreadPoolInternal *)data;
+
+#ifdef __ANDROID__
+	// Jobs may access files through SAF, which needs a JNI environment
+	JNI::attachThread();
+#endif
+
+	pthread_mutex_lock(&pool->_mutex);
+	for (;;) {
+		while (pool->_jobs.empty() && !pool->_quit)
+			pthread_cond_wait(&pool->_workCond, &pool->_mutex);
+		if (pool->_jobs.empty())
+			break;
+		pool->runJob(pool->_jobs.pop());
+	}
+	pthread_mutex_unlock(&pool->_mutex);
+
+#ifdef __ANDROID__
+	JNI::detachThread();
+#endif
+
+	return nullptr;
+}
+
+Common::ThreadPoolInternal *createPthreadThreadPoolInternal(uint numThreads) {
+	if (!numThreads) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		numThreads = (cpus > 1) ? MIN<long>(cpus - 1, 16) : 0;
+	}
+	if (!numThreads)
+		return nullptr;
+
+	PthreadThreadPoolInternal *pool = new PthreadThreadPoolInternal();
+	if (!pool->start(numThreads)) {
+		delete pool;
+		return nullptr;
+	}
+	return pool;
+}
+
+#endif
@@ -0,0 +1,190 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threadpool.h"
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/array.h"
+#include "common/queue.h"
+#include "common/textconsole.h"
+
+/**
+ * Thread pool built on top of SDL threads and condition variables.
+ */
+class SdlThreadPoolInternal final : public Common::ThreadPoolInternal {
+public:
+	SdlThreadPoolInternal();
+	~SdlThreadPoolInternal() override;
+
+	bool start(uint numThreads);
+
+	uint getThreadCount() const override { return _threads.size(); }
+	void submit(Common::ThreadPoolProc proc, void *data, uint *counter) override;
+	void wait(uint *counter) override;
+	void cancel(uint *counter) override;
+
+private:
+	struct Job {
+		Common::ThreadPoolProc proc;
+		void *data;
+		uint *counter;
+	};
+
+	static int SDLCALL threadProc(void *data);
+	void runJob(const Job &job);
+
+	SDL_mutex *_mutex;
+	SDL_cond *_workCond;
+	SDL_cond *_doneCond;
+	Common::Array<SDL_Thread *> _threads;
+	Common::Queue<Job> _jobs;
+	bool _quit;
+};
+
+SdlThreadPoolInternal::SdlThreadPoolInternal() : _quit(false) {
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+}
+
+SdlThreadPoolInternal::~SdlThreadPoolInternal() {
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_workCond);
+	SDL_UnlockMutex(_mutex);
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		SDL_WaitThread(_threads[i], nullptr);
+
+	SDL_DestroyCond(_doneCond);
+	SDL_DestroyCond(_workCond);
+	SDL_DestroyMutex(_mutex);
+}
+
+bool SdlThreadPoolInternal::start(uint numThreads) {
+	if (!_mutex || !_workCond || !_doneCond)
+		return false;
+
+	for (uint i = 0; i < numThreads; ++i) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		SDL_Thread *thread = SDL_CreateThread(threadProc, "ScummVM worker", this);
+#else
+		SDL_Thread *thread = SDL_CreateThread(threadProc, this);
+#endif
+		if (!thread) {
+			warning("Could not create worker thread: %s", SDL_GetError());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+	return !_threads.empty();
+}
+
+void SdlThreadPoolInternal::submit(Common::ThreadPoolProc proc, void *data, uint *counter) {
+	Job job;
+	job.proc = proc;
+	job.data = data;
+	job.counter = counter;
+
+	SDL_LockMutex(_mutex);
+	++*counter;
+	_jobs.push(job);
+	SDL_CondSignal(_workCond);
+	SDL_UnlockMutex(_mutex);
+}
+
+void SdlThreadPoolInternal::wait(uint *counter) {
+	SDL_LockMutex(_mutex);
+	while (*counter) {
+		if (!_jobs.empty()) {
+			runJob(_jobs.pop());
+		} else {
+			SDL_CondWait(_doneCond, _mutex);
+		}
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+void SdlThreadPoolInternal::cancel(uint *counter) {
+	SDL_LockMutex(_mutex);
+	Common::Queue<Job> remaining;
+	while (!_jobs.empty()) {
+		Job job = _jobs.pop();
+		if (job.counter == counter)
+			--*counter;
+		else
+			remaining.push(job);
+	}
+	_jobs = remaining;
+
+	if (*counter == 0)
+		SDL_CondBroadcast(_doneCond);
+	SDL_UnlockMutex(_mutex);
+}
+
+// Called and returns with _mutex held.
+void SdlThreadPoolInternal::runJob(const Job &job) {
+	SDL_UnlockMutex(_mutex);
+	job.proc(job.data);
+	SDL_LockMutex(_mutex);
+
+	if (--*job.counter == 0)
+		SDL_CondBroadcast(_doneCond);
+}
+
+int SDLCALL SdlThreadPoolInternal::threadProc(void *data) {
+	SdlThreadPoolInternal *pool = (SdlThreadPoolInternal *)data;
+
+	SDL_LockMutex(pool->_mutex);
+	for (;;) {
+		while (pool->_jobs.empty() && !pool->_quit)
+			SDL_CondWait(pool->_workCond, pool->_mutex);
+		if (pool->_jobs.empty())
+			break;
+		pool->runJob(pool->_jobs.pop());
+	}
+	SDL_UnlockMutex(pool->_mutex);
+
+	return 0;
+}
+
+Common::ThreadPoolInternal *createSdlThreadPoolInternal(uint numThreads) {
+	if (!numThreads) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		int cpus = SDL_GetCPUCount();
+		numThreads = (cpus > 1) ? MIN(cpus - 1, 16) : 0;
+#endif
+	}
+	if (!numThreads)
+		return nullptr;
+
+	SdlThreadPoolInternal *pool = new SdlThreadPoolInternal();
+	if (!pool->start(numThreads)) {
+		delete pool;
+		return nullptr;
+	}
+	return pool;
+}
+
+#endif
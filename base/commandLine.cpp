@@ -302,6 +302,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("dirtyrects", true);
 	ConfMan.registerDefault("vsync", true);
+	ConfMan.registerDefault("async_present", false);
 
 	// Sound & Music
 	ConfMan.registerDefault("music_volume", 192);
@@ -323,6 +324,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("mt32_device", "null");
 	ConfMan.registerDefault("gm_device", "auto");
 	ConfMan.registerDefault("opl2lpt_parport", "null");
+	ConfMan.registerDefault("audio_resampler", "linear");
 
 	ConfMan.registerDefault("cdrom", 0);
 
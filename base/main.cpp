@@ -37,6 +37,7 @@
 #include "base/version.h"
 
 #include "common/archive.h"
+#include "common/compression/unzip.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h" /* for debug manager */
@@ -48,6 +49,7 @@
 #endif
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/text-to-speech.h"
@@ -907,6 +909,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	GUI::EventRecorder::destroy();
 #endif
 	Common::SearchManager::destroy();
+	Common::freeZipIndexCache();
 #ifdef USE_TRANSLATION
 	Common::MainTranslationManager::destroy();
 #endif
@@ -918,6 +921,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #endif
 	EngineManager::destroy();
 	Graphics::YUVToRGBManager::destroy();
+	Common::ThreadPool::destroy();
 
 	return 0;
 }
@@ -744,6 +744,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
 
+	// Remember the computed MD5s for the next detection run
+	ADCacheMan.savePersistentCache();
+
 	return DetectionResults(candidates);
 }
 
@@ -955,6 +958,7 @@ void EngineManager::upgradeTargetForEngineId(const Common::String &target) const
 		// Clear md5 cache before detection starts
 		ADCacheMan.clear();
 		DetectedGames candidates = metaEngine.detectGames(files);
+		ADCacheMan.savePersistentCache();
 		if (candidates.empty()) {
 			warning("No games supported by the engine '%s' were found in path '%s' when upgrading target '%s'",
 			        metaEngine.getName(), path.toString(Common::Path::kNativeSeparator).c_str(), target.c_str());
@@ -284,6 +284,44 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateLookupCaches();
+}
+
+Atomic<uint32> SearchSet::_generation(0);
+
+const SearchSet::LookupResult *SearchSet::findLookupResult(const Path &path) const {
+	if (_lookupCacheGeneration != _generation.load())
+		return nullptr;
+
+	LookupCache::const_iterator it = _lookupCache.find(path);
+	return (it != _lookupCache.end()) ? &it->_value : nullptr;
+}
+
+SearchSet::LookupResult &SearchSet::addLookupResult(const Path &path) const {
+	const uint32 generation = _generation.load();
+	if (_lookupCacheGeneration != generation || _lookupCache.size() >= kMaxLookupCacheSize) {
+		_lookupCache.clear();
+		_lookupCacheGeneration = generation;
+	}
+
+	return _lookupCache[path];
+}
+
+Archive *SearchSet::findMemberArchive(const Path &path) const {
+	// Only trust a cached archive if it still has the file
+	const LookupResult *cached = findLookupResult(path);
+	if (cached && cached->memberArchive && cached->memberArchive->hasFile(path))
+		return cached->memberArchive;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(path)) {
+			addLookupResult(path).memberArchive = it->_arc;
+			return it->_arc;
+		}
+	}
+
+	return nullptr;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -374,6 +412,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateLookupCaches();
 	}
 }
 
@@ -397,6 +436,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateLookupCaches();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -419,13 +459,7 @@ bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path))
-			return true;
-	}
-
-	return false;
+	return findMemberArchive(path) != nullptr;
 }
 
 bool SearchSet::isPathDirectory(const Path &path) const {
@@ -489,17 +523,14 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path)) {
-			if (container) {
-				*container = it->_arc;
-			}
-			return it->_arc->getMember(path);
-		}
-	}
+	Archive *archive = findMemberArchive(path);
+	if (!archive)
+		return ArchiveMemberPtr();
 
-	return ArchiveMemberPtr();
+	if (container) {
+		*container = archive;
+	}
+	return archive->getMember(path);
 }
 
 const ArchiveMemberPtr SearchSet::getMember(const Path &path) const {
@@ -510,11 +541,21 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	const LookupResult *cached = findLookupResult(path);
+	if (cached && cached->streamArchive) {
+		SeekableReadStream *stream = cached->streamArchive->createReadStreamForMember(path);
+		if (stream)
+			return stream;
+	}
+
+	// Failures are not cached, as they may be temporary
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
-		if (stream)
+		if (stream) {
+			addLookupResult(path).streamArchive = it->_arc;
 			return stream;
+		}
 	}
 
 	return nullptr;
@@ -23,6 +23,7 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/error.h"
+#include "common/atomic.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
 #include "common/list.h"
@@ -329,8 +330,45 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	/**
+	 * Archives which had a path when it was last looked up, for hasFile()
+	 * and getMember(), and for createReadStreamForMember(). Only found
+	 * paths are cached, and the archive is asked again on every lookup.
+	 * As with the list of archives, there is no locking, so a search set
+	 * must only be used by one thread at a time.
+	 */
+	struct LookupResult {
+		LookupResult() : memberArchive(nullptr), streamArchive(nullptr) {}
+
+		Archive *memberArchive;
+		Archive *streamArchive;
+	};
+
+	typedef HashMap<Path, LookupResult, Path::Hash, Path::EqualTo> LookupCache;
+
+	enum {
+		kMaxLookupCacheSize = 4096
+	};
+
+	mutable LookupCache _lookupCache;
+	mutable uint32 _lookupCacheGeneration;
+
+	/**
+	 * Incremented whenever the archives of any search set change. Search
+	 * sets can contain each other, so a change in one set invalidates the
+	 * lookup caches of all of them.
+	 */
+	static Atomic<uint32> _generation;
+
+	/** Return the cached result for @p path, or nullptr if there is none. */
+	const LookupResult *findLookupResult(const Path &path) const;
+	/** Return the cached result for @p path, creating it if needed. */
+	LookupResult &addLookupResult(const Path &path) const;
+
+	Archive *findMemberArchive(const Path &path) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _ignoreClashes(false), _lookupCacheGeneration(_generation.load()) { }
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -455,6 +493,21 @@ public:
 	 * in @ref FSDirectory documentation.
 	 */
 	void setIgnoreClashes(bool ignoreClashes) { _ignoreClashes = ignoreClashes; }
+
+	/**
+	 * Forget the cached results of earlier lookups.
+	 *
+	 * The archives in which hasFile(), getMember() and
+	 * createReadStreamForMember() found a file are cached until archives
+	 * are added to or removed from any search set, or a file is written
+	 * through an FSNode. Owners of archives which gain files in other ways
+	 * while they are part of a search set should call this, so that the
+	 * files are not hidden by lower priority archives.
+	 */
+	void clearLookupCache() { invalidateLookupCaches(); }
+
+	/** Forget the cached results of earlier lookups in all search sets. */
+	static void invalidateLookupCaches() { _generation.fetchAdd(1); }
 };
 
 
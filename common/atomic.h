@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+// Pulls in intrin.h while working around the forbidden symbol checks
+#include "common/math.h"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic integers
+ * @ingroup common
+ *
+ * @brief Minimal atomic 32-bit integer for sharing state between threads.
+ *
+ * Loads have acquire and stores have release semantics, which is enough to
+ * publish data written before a store to a thread observing the stored
+ * value. On compilers without atomic builtins, plain volatile accesses are
+ * used; such targets are not expected to run mixer or worker threads.
+ *
+ * @{
+ */
+
+/**
+ * Atomic wrapper around a 32-bit integer type.
+ */
+template<class T>
+class Atomic : NonCopyable {
+	static_assert(sizeof(T) == 4, "Common::Atomic only supports 32-bit types");
+
+public:
+	Atomic(T value = T()) : _value(value) {}
+
+	/** Return the current value. */
+	T load() const {
+#if defined(__GNUC__)
+		return __atomic_load_n(&_value, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+		return (T)_InterlockedOr((volatile long *)&_value, 0);
+#else
+		return _value;
+#endif
+	}
+
+	/** Replace the current value. */
+	void store(T value) {
+#if defined(__GNUC__)
+		__atomic_store_n(&_value, value, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+		_InterlockedExchange((volatile long *)&_value, (long)value);
+#else
+		_value = value;
+#endif
+	}
+
+	/** Add @p delta to the value and return the previous value. */
+	T fetchAdd(T delta) {
+#if defined(__GNUC__)
+		return __atomic_fetch_add(&_value, delta, __ATOMIC_ACQ_REL);
+#elif defined(_MSC_VER)
+		return (T)_InterlockedExchangeAdd((volatile long *)&_value, (long)delta);
+#else
+		T value = _value;
+		_value = value + delta;
+		return value;
+#endif
+	}
+
+private:
+	volatile T _value;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
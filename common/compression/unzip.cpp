@@ -98,6 +98,11 @@ typedef Byte Bytef;
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/threadpool.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -339,9 +344,82 @@ typedef struct {
 	unz_file_info cur_file_info;					/* public info about the current file in zip*/
 	unz_file_info_internal cur_file_info_internal;	/* private info about it*/
 
-	ZipHash _hash;
+	Common::SharedPtr<ZipHash> _hash;	/* may be shared with other handles on an identical zipfile */
 } unz_s;
 
+namespace Common {
+
+/**
+ * Keeps the member index of recently opened zip files, so that opening
+ * the same file again does not need to parse its central directory.
+ *
+ * Entries are matched by comparing the raw central directory, which makes
+ * the cache independent of where the zip file comes from.
+ */
+class ZipIndexCache : public Singleton<ZipIndexCache> {
+public:
+	SharedPtr<ZipHash> find(const byte *centralDir, uint32 size, bool flattenTree);
+	void insert(const byte *centralDir, uint32 size, bool flattenTree, const SharedPtr<ZipHash> &hash);
+
+private:
+	enum {
+		kMaxEntries = 16,
+		kMaxCentralDirSize = 1024 * 1024
+	};
+
+	struct Entry {
+		Array<byte> centralDir;
+		bool flattenTree;
+		SharedPtr<ZipHash> hash;
+	};
+
+	Mutex _mutex;
+	List<Entry> _entries;	///< Most recently used first
+};
+
+DECLARE_SINGLETON(ZipIndexCache);
+
+SharedPtr<ZipHash> ZipIndexCache::find(const byte *centralDir, uint32 size, bool flattenTree) {
+	StackLock lock(_mutex);
+
+	for (List<Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (i->flattenTree != flattenTree || i->centralDir.size() != size || memcmp(i->centralDir.data(), centralDir, size) != 0)
+			continue;
+
+		SharedPtr<ZipHash> hash = i->hash;
+		if (i != _entries.begin()) {
+			_entries.push_front(*i);
+			_entries.erase(i);
+		}
+		return hash;
+	}
+
+	return SharedPtr<ZipHash>();
+}
+
+void ZipIndexCache::insert(const byte *centralDir, uint32 size, bool flattenTree, const SharedPtr<ZipHash> &hash) {
+	if (size > kMaxCentralDirSize)
+		return;
+
+	StackLock lock(_mutex);
+
+	Entry entry;
+	entry.centralDir.resize(size);
+	memcpy(entry.centralDir.data(), centralDir, size);
+	entry.flattenTree = flattenTree;
+	entry.hash = hash;
+	_entries.push_front(entry);
+
+	if (_entries.size() > kMaxEntries)
+		_entries.pop_back();
+}
+
+void freeZipIndexCache() {
+	ZipIndexCache::destroy();
+}
+
+} // End of namespace Common
+
 /* ===========================================================================
 	 Read a byte from a gz_stream; update next_in and avail_in. Return EOF
    for end of file.
@@ -519,6 +597,29 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		                    (us->offset_central_dir + us->size_central_dir);
 	us->central_pos = central_pos;
 
+	// Look for an identical central directory which was already indexed.
+	// Memory mapped zip files are compared in place.
+	Common::Array<byte> centralDirCopy;
+	const byte *centralDir = us->_stream->getBufferPtr();
+	if (centralDir) {
+		centralDir += us->offset_central_dir + us->byte_before_the_zipfile;
+	} else {
+		centralDirCopy.resize(us->size_central_dir);
+		us->_stream->seek(us->offset_central_dir + us->byte_before_the_zipfile, SEEK_SET);
+		if (us->_stream->read(centralDirCopy.data(), us->size_central_dir) == us->size_central_dir)
+			centralDir = centralDirCopy.data();
+	}
+
+	if (centralDir) {
+		us->_hash = Common::ZipIndexCache::instance().find(centralDir, us->size_central_dir, flattenTree);
+		if (us->_hash) {
+			unzGoToFirstFile((unzFile)us);
+			return (unzFile)us;
+		}
+	}
+
+	us->_hash = Common::SharedPtr<ZipHash>(new ZipHash());
+
 	err = unzGoToFirstFile((unzFile)us);
 
 	while (err == UNZ_OK) {
@@ -580,11 +681,15 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 					*p = '/';
 		}
 
-		us->_hash[Common::Path(name)] = fe;
+		(*us->_hash)[Common::Path(name)] = fe;
 
 		// Move to the next file
 		err = unzGoToNextFile((unzFile)us);
 	}
+
+	if (centralDir)
+		Common::ZipIndexCache::instance().insert(centralDir, us->size_central_dir, flattenTree, us->_hash);
+
 	return (unzFile)us;
 }
 
@@ -846,12 +951,12 @@ int unzLocateFile(unzFile file, const Common::Path &szFileName, int iCaseSensiti
 		return UNZ_END_OF_LIST_OF_FILE;
 
 	// Check to see if the entry exists
-	ZipHash::iterator i = s->_hash.find(szFileName);
-	if (i == s->_hash.end())
+	ZipHash::const_iterator i = s->_hash->find(szFileName);
+	if (i == s->_hash->end())
 		return UNZ_END_OF_LIST_OF_FILE;
 
 	// Found it, so reset the details in the main structure
-	cached_file_in_zip &fe = i->_value;
+	const cached_file_in_zip &fe = i->_value;
 	s->num_file = fe.num_file;
 	s->pos_in_central_dir = fe.pos_in_central_dir;
 	s->current_file_ok = fe.current_file_ok;
@@ -869,7 +974,10 @@ int unzLocateFile(unzFile file, const Common::Path &szFileName, int iCaseSensiti
   store in *piSizeVar the size of extra info in local header
 		(filename and size of extra field data)
 */
-static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
+static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s,
+													const unz_file_info &file_info,
+													const unz_file_info_internal &file_info_internal,
+													uInt *piSizeVar,
 													uLong *poffset_local_extrafield,
 													uInt  *psize_local_extrafield) {
 	uLong uMagic,uData,uFlags;
@@ -881,7 +989,7 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 	*poffset_local_extrafield = 0;
 	*psize_local_extrafield = 0;
 
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile +
+	s->_stream->seek(file_info_internal.offset_curfile +
 								s->byte_before_the_zipfile, SEEK_SET);
 	if (s->_stream->err())
 		return UNZ_ERRNO;
@@ -897,7 +1005,7 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 	if (unzlocal_getShort(s->_stream, &uData) != UNZ_OK)
 		err = UNZ_ERRNO;
 /*
-	else if ((err == UNZ_OK) && (uData!=s->cur_file_info.wVersion))
+	else if ((err == UNZ_OK) && (uData!=file_info.wVersion))
 		err = UNZ_BADZIPFILE;
 */
 	if (unzlocal_getShort(s->_stream, &uFlags) != UNZ_OK)
@@ -905,11 +1013,11 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 
 	if (unzlocal_getShort(s->_stream, &uData) != UNZ_OK)
 		err = UNZ_ERRNO;
-	else if ((err == UNZ_OK) && (uData != s->cur_file_info.compression_method))
+	else if ((err == UNZ_OK) && (uData != file_info.compression_method))
 		err = UNZ_BADZIPFILE;
 
-	if ((err == UNZ_OK) && (s->cur_file_info.compression_method != 0) &&
-	                     (s->cur_file_info.compression_method != Z_DEFLATED))
+	if ((err == UNZ_OK) && (file_info.compression_method != 0) &&
+	                     (file_info.compression_method != Z_DEFLATED))
 		err = UNZ_BADZIPFILE;
 
 	if (unzlocal_getLong(s->_stream, &uData) != UNZ_OK) /* date/time */
@@ -917,33 +1025,33 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 
 	if (unzlocal_getLong(s->_stream, &uData) != UNZ_OK) /* crc */
 		err = UNZ_ERRNO;
-	else if ((err == UNZ_OK) && (uData!=s->cur_file_info.crc) &&
+	else if ((err == UNZ_OK) && (uData!=file_info.crc) &&
 		                      ((uFlags & 8) == 0))
 		err = UNZ_BADZIPFILE;
 
 	if (unzlocal_getLong(s->_stream, &uData) != UNZ_OK) /* size compr */
 		err = UNZ_ERRNO;
-	else if ((err == UNZ_OK) && (uData!=s->cur_file_info.compressed_size) &&
+	else if ((err == UNZ_OK) && (uData!=file_info.compressed_size) &&
 							  ((uFlags & 8) == 0))
 		err = UNZ_BADZIPFILE;
 
 	if (unzlocal_getLong(s->_stream, &uData) != UNZ_OK) /* size uncompr */
 		err = UNZ_ERRNO;
-	else if ((err == UNZ_OK) && (uData!=s->cur_file_info.uncompressed_size) &&
+	else if ((err == UNZ_OK) && (uData!=file_info.uncompressed_size) &&
 							  ((uFlags & 8) == 0))
 		err = UNZ_BADZIPFILE;
 
 
 	if (unzlocal_getShort(s->_stream, &size_filename) != UNZ_OK)
 		err = UNZ_ERRNO;
-	else if ((err == UNZ_OK) && (size_filename!=s->cur_file_info.size_filename))
+	else if ((err == UNZ_OK) && (size_filename!=file_info.size_filename))
 		err = UNZ_BADZIPFILE;
 
 	*piSizeVar += (uInt)size_filename;
 
 	if (unzlocal_getShort(s->_stream, &size_extra_field) != UNZ_OK)
 		err = UNZ_ERRNO;
-	*poffset_local_extrafield = s->cur_file_info_internal.offset_curfile +
+	*poffset_local_extrafield = file_info_internal.offset_curfile +
 									SIZEZIPLOCALHEADER + size_filename;
 	*psize_local_extrafield = (uInt)size_extra_field;
 
@@ -953,75 +1061,133 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 }
 
 /*
-  Open for reading data the current file in the zipfile.
-  If there is no error and the file is opened, the return value is UNZ_OK.
+  Read and decompress the file described by file_info, and check its CRC.
+  Return the contents, allocated with new[], or nullptr in case of an error.
+  If streamMutex is given, the zipfile stream is only used while holding it,
+	which allows reading several files from different threads at once.
 */
-Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
+static byte *unzlocal_ReadFile(unz_s *s, const unz_file_info &file_info,
+										const unz_file_info_internal &file_info_internal,
+										Common::Mutex *streamMutex
 #ifndef USE_ZLIB
-		, const Common::CRC32 &crc
+										, const Common::CRC32 &crc
 #endif
-		) {
+										) {
 	uInt iSizeVar;
-	unz_s *s;
 	uLong offset_local_extrafield;  /* offset of the local extra field */
 	uInt  size_local_extrafield;    /* size of the local extra field */
 
-	if (file == nullptr)
-		return Common::SharedArchiveContents();
-	s = (unz_s *)file;
-	if (!s->current_file_ok)
-		return Common::SharedArchiveContents();
+	if (file_info.compression_method != 0 && file_info.compression_method != Z_DEFLATED) {
+		warning("Unknown compression algoritthm %d", (int)file_info.compression_method);
+		return nullptr;
+	}
 
-	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
-				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
-		return Common::SharedArchiveContents();
+	byte *compressedBuffer = nullptr;
+	const byte *compressedData = nullptr;
 
-	if (s->cur_file_info.compression_method != 0 && s->cur_file_info.compression_method != Z_DEFLATED) {
-		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
-		return Common::SharedArchiveContents();
+	if (streamMutex)
+		streamMutex->lock();
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, file_info, file_info_internal, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) == UNZ_OK) {
+		const uint32 dataOffset = file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+
+		// Use the data in place if the archive is in memory, e.g. memory mapped
+		compressedData = s->_stream->getBufferPtr();
+		if (compressedData && (int64)dataOffset + (int64)file_info.compressed_size <= s->_stream->size()) {
+			compressedData += dataOffset;
+		} else {
+			compressedBuffer = new byte[file_info.compressed_size];
+			s->_stream->seek(dataOffset);
+			s->_stream->read(compressedBuffer, file_info.compressed_size);
+			compressedData = compressedBuffer;
+		}
 	}
 
-	uint32 crc32_wait = s->cur_file_info.crc;
+	if (streamMutex)
+		streamMutex->unlock();
+
+	if (!compressedData)
+		return nullptr;
 
-	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
-	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
 	byte *uncompressedBuffer = nullptr;
 
-	switch (s->cur_file_info.compression_method) {
+	switch (file_info.compression_method) {
 	case 0: // Store
+		if (!compressedBuffer) {
+			compressedBuffer = new byte[file_info.compressed_size];
+			memcpy(compressedBuffer, compressedData, file_info.compressed_size);
+		}
 		uncompressedBuffer = compressedBuffer;
 		break;
 	case Z_DEFLATED:
-		uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
-		assert(s->cur_file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
-		Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedBuffer, s->cur_file_info.compressed_size);
+		uncompressedBuffer = new byte[file_info.uncompressed_size];
+		assert(file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
+		Common::inflateZlibHeaderless(uncompressedBuffer, file_info.uncompressed_size, compressedData, file_info.compressed_size);
 		delete[] compressedBuffer;
 		compressedBuffer = nullptr;
 		break;
 	default:
-		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
-		delete[] compressedBuffer;
-		return Common::SharedArchiveContents();
+		break;
 	}
 #ifndef USE_ZLIB
-	uint32 crc32_data = crc.crcFast(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc.crcFast(uncompressedBuffer, file_info.uncompressed_size);
 #else
-	uint32 crc32_data = crc32(0, uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc32(0, uncompressedBuffer, file_info.uncompressed_size);
 #endif
-	if (crc32_data != crc32_wait) {
+	if (crc32_data != file_info.crc) {
 		delete[] uncompressedBuffer;
-		warning("CRC32 mismatch: %08x, %08x", crc32_data, crc32_wait);
-		return Common::SharedArchiveContents();
+		warning("CRC32 mismatch: %08x, %08x", crc32_data, (uint32)file_info.crc);
+		return nullptr;
 	}
 
-	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	return uncompressedBuffer;
+}
+
+/*
+  Open for reading data the current file in the zipfile.
+  If there is no error and the file is opened, the return value is UNZ_OK.
+*/
+Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
+#ifndef USE_ZLIB
+		, const Common::CRC32 &crc
+#endif
+		) {
+	unz_s *s;
+
+	if (file == nullptr)
+		return Common::SharedArchiveContents();
+	s = (unz_s *)file;
+	if (!s->current_file_ok)
+		return Common::SharedArchiveContents();
+
+	byte *contents = unzlocal_ReadFile(s, s->cur_file_info, s->cur_file_info_internal, nullptr
+#ifndef USE_ZLIB
+		, crc
+#endif
+		);
+	if (!contents)
+		return Common::SharedArchiveContents();
+
+	return Common::SharedArchiveContents(contents, s->cur_file_info.uncompressed_size);
 }
 
 
 namespace Common {
 
 
+/**
+ * Zip archive backed by an unzFile handle.
+ *
+ * readContentsForPath() only looks up members in the index and guards the
+ * accesses to the zipfile stream, so it may run on several threads at once.
+ * The contents cache of MemcachingCaseInsensitiveArchive is not guarded, so
+ * streams must still be created from one thread at a time.
+ *
+ * Members below a size limit can be inflated on the worker threads of the
+ * thread pool right after opening the archive. Reading a member which has
+ * not been preloaded yet inflates it right away instead of waiting.
+ */
 class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	unzFile _zipFile;
 #ifndef USE_ZLIB
@@ -1029,8 +1195,39 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 #endif
 	bool _flattenTree;
 
+	mutable Mutex _streamMutex;
+
+	enum PreloadState {
+		kPreloadPending,	///< No thread has started reading the member yet
+		kPreloadLoading,	///< A worker thread is reading the member
+		kPreloadDone,		///< The member is waiting in contents
+		kPreloadTaken		///< The member was requested or the archive closed, later results are dropped
+	};
+
+	struct PreloadedMember {
+		unz_file_info fileInfo;
+		unz_file_info_internal fileInfoInternal;
+		byte *contents;
+		PreloadState state;
+	};
+
+	typedef HashMap<Path, uint, Path::IgnoreCase_Hash, Path::IgnoreCase_EqualTo> PreloadIndex;
+
+	mutable Mutex _preloadMutex;
+	TaskGroup *_preloadTasks;
+	mutable Array<PreloadedMember> _preloaded;
+	mutable PreloadIndex _preloadIndex;
+
+	const cached_file_in_zip *findEntry(const Path &path) const;
+	byte *readFile(const unz_file_info &fileInfo, const unz_file_info_internal &fileInfoInternal) const;
+	byte *takePreloaded(const Path &path) const;
+	void startPreload(uint32 maxMemberSize);
+
+	static void preloadProc(void *data);
+	static void preloadRange(uint begin, uint end, void *data);
+
 public:
-	ZipArchive(unzFile zipFile, bool flattenTree);
+	ZipArchive(unzFile zipFile, bool flattenTree, uint32 preloadSize);
 
 
 	~ZipArchive();
@@ -1063,34 +1260,143 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : _zipFile(zipFile), _flattenTree(flattenTree) {
+ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree, uint32 preloadSize) : _zipFile(zipFile), _flattenTree(flattenTree), _preloadTasks(nullptr) {
 	assert(_zipFile);
+
+	if (preloadSize)
+		startPreload(preloadSize);
 }
 
 ZipArchive::~ZipArchive() {
+	if (_preloadTasks) {
+		// Skip the members which are not being inflated yet and drop the
+		// preloading job if it has not started, so that only the members
+		// being inflated right now are waited for
+		{
+			StackLock lock(_preloadMutex);
+			for (uint i = 0; i < _preloaded.size(); i++) {
+				if (_preloaded[i].state == kPreloadPending)
+					_preloaded[i].state = kPreloadTaken;
+			}
+		}
+		_preloadTasks->cancel();
+		delete _preloadTasks;
+	}
+
+	for (uint i = 0; i < _preloaded.size(); i++)
+		delete[] _preloaded[i].contents;
+
 	unzClose(_zipFile);
 }
 
+const cached_file_in_zip *ZipArchive::findEntry(const Path &path) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	ZipHash::const_iterator i = archive->_hash->find(path);
+	if (i == archive->_hash->end())
+		return nullptr;
+
+	return &i->_value;
+}
+
+byte *ZipArchive::readFile(const unz_file_info &fileInfo, const unz_file_info_internal &fileInfoInternal) const {
+#ifndef USE_ZLIB
+	return unzlocal_ReadFile((unz_s *)_zipFile, fileInfo, fileInfoInternal, &_streamMutex, _crc);
+#else
+	return unzlocal_ReadFile((unz_s *)_zipFile, fileInfo, fileInfoInternal, &_streamMutex);
+#endif
+}
+
+void ZipArchive::startPreload(uint32 maxMemberSize) {
+	if (!ThreadPoolMan.isMultiThreaded())
+		return;
+
+	// Stored members are only copied, so there is nothing to gain for them
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	for (ZipHash::const_iterator i = archive->_hash->begin(); i != archive->_hash->end(); ++i) {
+		const cached_file_in_zip &fe = i->_value;
+		if (fe.cur_file_info.compression_method != Z_DEFLATED || fe.cur_file_info.uncompressed_size > maxMemberSize)
+			continue;
+
+		PreloadedMember member;
+		member.fileInfo = fe.cur_file_info;
+		member.fileInfoInternal = fe.cur_file_info_internal;
+		member.contents = nullptr;
+		member.state = kPreloadPending;
+		_preloadIndex[i->_key] = _preloaded.size();
+		_preloaded.push_back(member);
+	}
+
+	if (_preloaded.empty())
+		return;
+
+	_preloadTasks = new TaskGroup(ThreadPoolMan);
+	_preloadTasks->run(preloadProc, this);
+}
+
+void ZipArchive::preloadProc(void *data) {
+	ZipArchive *archive = (ZipArchive *)data;
+	ThreadPoolMan.parallelFor(archive->_preloaded.size(), preloadRange, archive, 4);
+}
+
+void ZipArchive::preloadRange(uint begin, uint end, void *data) {
+	ZipArchive *archive = (ZipArchive *)data;
+	for (uint i = begin; i < end; i++) {
+		PreloadedMember &member = archive->_preloaded[i];
+
+		{
+			StackLock lock(archive->_preloadMutex);
+			if (member.state != kPreloadPending)
+				continue;
+			member.state = kPreloadLoading;
+		}
+
+		byte *contents = archive->readFile(member.fileInfo, member.fileInfoInternal);
+
+		StackLock lock(archive->_preloadMutex);
+		if (member.state == kPreloadLoading) {
+			member.contents = contents;
+			member.state = kPreloadDone;
+		} else {
+			// The member was read directly meanwhile
+			delete[] contents;
+		}
+	}
+}
+
+byte *ZipArchive::takePreloaded(const Path &path) const {
+	StackLock lock(_preloadMutex);
+
+	PreloadIndex::iterator i = _preloadIndex.find(path);
+	if (i == _preloadIndex.end())
+		return nullptr;
+
+	// Take the member if it is ready. Otherwise the caller reads it
+	// directly instead of waiting, and the workers skip or drop it.
+	PreloadedMember &member = _preloaded[i->_value];
+	byte *contents = member.contents;
+	member.contents = nullptr;
+	member.state = kPreloadTaken;
+	_preloadIndex.erase(i);
+	return contents;
+}
+
 bool ZipArchive::hasFile(const Path &path) const {
-	return (unzLocateFile(_zipFile, path, 2) == UNZ_OK);
+	return findEntry(path) != nullptr;
 }
 
 bool ZipArchive::isPathDirectory(const Path &path) const {
-	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
+	const cached_file_in_zip *fe = findEntry(path);
+	if (!fe)
 		return false;
 
-	unz_file_info fi;
-	if (unzGetCurrentFileInfo(_zipFile, &fi, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
-		return false;
-
-	return (fi.external_fa & 0x10) != 0;
+	return (fe->cur_file_info.external_fa & 0x10) != 0;
 }
 
 int ZipArchive::listMembers(ArchiveMemberList &list) const {
 	int members = 0;
 
 	const unz_s *const archive = (const unz_s *)_zipFile;
-	for (ZipHash::const_iterator i = archive->_hash.begin(), end = archive->_hash.end();
+	for (ZipHash::const_iterator i = archive->_hash->begin(), end = archive->_hash->end();
 	     i != end; ++i) {
 		list.push_back(ArchiveMemberList::value_type(new GenericArchiveMember(i->_key, *this)));
 		++members;
@@ -1107,24 +1413,30 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 }
 
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
-	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
+	const cached_file_in_zip *fe = findEntry(path);
+	if (!fe || !fe->current_file_ok)
 		return Common::SharedArchiveContents();
-#ifndef USE_ZLIB
-	return unzOpenCurrentFile(_zipFile, _crc);
-#else
-	return unzOpenCurrentFile(_zipFile);
-#endif
+
+	byte *contents = nullptr;
+	if (_preloadTasks)
+		contents = takePreloaded(path);
+	if (!contents)
+		contents = readFile(fe->cur_file_info, fe->cur_file_info_internal);
+	if (!contents)
+		return Common::SharedArchiveContents();
+
+	return Common::SharedArchiveContents(contents, fe->cur_file_info.uncompressed_size);
 }
 
-Archive *makeZipArchive(const Path &name, bool flattenTree) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree);
+Archive *makeZipArchive(const Path &name, bool flattenTree, uint32 preloadSize) {
+	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree, preloadSize);
 }
 
-Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
+Archive *makeZipArchive(const FSNode &node, bool flattenTree, uint32 preloadSize) {
+	return makeZipArchive(node.createReadStream(), flattenTree, preloadSize);
 }
 
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree, uint32 preloadSize) {
 	if (!stream)
 		return nullptr;
 	unzFile zipFile = unzOpen(stream, flattenTree);
@@ -1133,7 +1445,7 @@ Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile, flattenTree);
+	return new ZipArchive(zipFile, flattenTree, preloadSize);
 }
 
 } // End of namespace Common
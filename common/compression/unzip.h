@@ -43,17 +43,23 @@ class SeekableReadStream;
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * If @p preloadSize is not 0, compressed members up to that size are
+ * inflated on the worker threads of the thread pool in the background,
+ * for archives whose members will all be read anyway.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const Path &name, bool flattenTree = false);
+Archive *makeZipArchive(const Path &name, bool flattenTree = false, uint32 preloadSize = 0);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * @see makeZipArchive(const Path &, bool, uint32) for @p preloadSize.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const FSNode &node, bool flattenTree = false);
+Archive *makeZipArchive(const FSNode &node, bool flattenTree = false, uint32 preloadSize = 0);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
@@ -61,9 +67,18 @@ Archive *makeZipArchive(const FSNode &node, bool flattenTree = false);
  * This takes ownership of the stream,  in particular, it is deleted when the
  * ZipArchive is deleted.
  *
+ * @see makeZipArchive(const Path &, bool, uint32) for @p preloadSize.
+ *
  * May return 0 in case of a failure. In this case stream will still be deleted.
  */
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false);
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false, uint32 preloadSize = 0);
+
+/**
+ * Free the indices of recently opened ZIP files, which are kept so that
+ * reopening the same file does not parse its directory again. Archives
+ * which are still open keep their own index.
+ */
+void freeZipIndexCache();
 
 /** @} */
 
@@ -142,6 +142,11 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+const byte *File::getBufferPtr() const {
+	assert(_handle);
+	return _handle->getBufferPtr();
+}
+
 
 DumpFile::DumpFile() : _handle(nullptr) {
 }
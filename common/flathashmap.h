@@ -0,0 +1,544 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/math.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val>, with
+ * the same interface and the same requirements on the hash and equality
+ * functors.
+ *
+ * The key/value pairs are stored inline in a single array instead of being
+ * allocated one by one, and a separate array holds one control byte per
+ * slot. A control byte either marks the slot as empty or erased, or holds
+ * seven bits of the hash of the key stored there, so that most mismatching
+ * slots are skipped without comparing keys. This makes lookups touch far
+ * less memory, and inserting does not allocate unless the table grows.
+ *
+ * The slot index is taken from the high bits of the mixed hash and the tag
+ * from other bits, so keys which only differ in their high bits (e.g.
+ * aligned pointers) still spread out.
+ *
+ * As with HashMap, erasing an element leaves a marker behind, so erasing
+ * while iterating is allowed. Growing the table invalidates all iterators
+ * and references to values, so unlike HashMap, references obtained with
+ * operator[] or getVal() must not be kept across insertions.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Key &key, const Val &value) : _value(value), _key(key) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// table, including erased slots, may fill up before it is rehashed.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	enum {
+		kCtrlEmpty = 0x80,   ///< Slot has never been used
+		kCtrlDeleted = 0xFE, ///< Slot held an element which was erased
+		kCtrlFullMask = 0x80 ///< Control bytes of used slots have this bit cleared
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;        ///< Control byte of each slot
+	Node *_slots;       ///< Uninitialized storage for the nodes, of size _mask + 1
+	size_type _mask;    ///< Capacity of the table minus one; the capacity is a power of two
+	uint _shift;        ///< Shift turning a mixed hash into a slot index
+	size_type _size;
+	size_type _deleted; ///< Number of slots marked as kCtrlDeleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/**
+	 * Spread the bits of the hash, since many hash functions (e.g. the
+	 * one for integers) leave some bits unused. The high bits of the
+	 * product depend on every bit of the hash, the low bits do not.
+	 */
+	static uint64 mixHash(uint32 hash) {
+		return hash * 0x9E3779B97F4A7C15ULL;
+	}
+
+	static byte hashTag(uint64 mixed) {
+		return (mixed >> 32) & 0x7F;
+	}
+
+	size_type hashIndex(uint64 mixed) const {
+		return (size_type)(mixed >> _shift);
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key, const Val *val = nullptr);
+	void rehash(size_type newCapacity);
+
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(!(_hashmap->_ctrl[_idx] & kCtrlFullMask));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsed(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	/** Return the index of the first used slot at or after @p idx, or (size_type)-1. */
+	size_type nextUsed(size_type idx) const {
+		for (; idx <= _mask; ++idx) {
+			if (!(_ctrl[idx] & kCtrlFullMask))
+				return idx;
+		}
+		return (size_type)-1;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		clear();
+		freeStorage();
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator begin() { return iterator(nextUsed(0), this); }
+	iterator end() { return iterator((size_type)-1, this); }
+
+	const_iterator begin() const { return const_iterator(nextUsed(0), this); }
+	const_iterator end() const { return const_iterator((size_type)-1, this); }
+
+	iterator find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+/**
+ * Allocate empty storage for @p capacity slots. The previous storage must
+ * have been released by the caller.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_shift = 64 - intLog2(capacity);
+	_size = 0;
+	_deleted = 0;
+
+	_ctrl = (byte *)malloc(capacity);
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	if (!_ctrl || !_slots)
+		::error("Common::FlatHashMap: failure to allocate %u slots", capacity);
+
+	memset(_ctrl, kCtrlEmpty, capacity);
+}
+
+/**
+ * Release the storage. The nodes must have been destroyed before.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	free(_ctrl);
+	free(_slots);
+	_ctrl = nullptr;
+	_slots = nullptr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The slot layout is the same, so every element keeps its index
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & kCtrlFullMask))
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & kCtrlFullMask))
+			_slots[ctr].~Node();
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, kCtrlEmpty, _mask + 1);
+		_size = 0;
+		_deleted = 0;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+#ifndef NDEBUG
+	const size_type old_size = _size;
+#endif
+	const size_type old_mask = _mask;
+	byte *old_ctrl = _ctrl;
+	Node *old_slots = _slots;
+
+	allocStorage(newCapacity);
+
+	// Move the elements over. Since no key exists twice in the old table,
+	// the first free slot can be taken without comparing any keys.
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_ctrl[ctr] & kCtrlFullMask)
+			continue;
+
+		Node &node = old_slots[ctr];
+		const uint64 mixed = mixHash(_hash(node._key));
+		size_type idx = hashIndex(mixed);
+		while (_ctrl[idx] != kCtrlEmpty)
+			idx = (idx + 1) & _mask;
+
+		_ctrl[idx] = hashTag(mixed);
+		new ((void *)&_slots[idx]) Node(node);
+		node.~Node();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == old_size);
+
+	free(old_ctrl);
+	free(old_slots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint64 mixed = mixHash(_hash(key));
+	const byte tag = hashTag(mixed);
+
+	// The load factor guarantees that there is at least one empty slot
+	for (size_type ctr = hashIndex(mixed); ; ctr = (ctr + 1) & _mask) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == kCtrlEmpty)
+			return (size_type)-1;
+		if (ctrl == tag && _equal(_slots[ctr]._key, key))
+			return ctr;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key, const Val *val) {
+	const uint64 mixed = mixHash(_hash(key));
+	const byte tag = hashTag(mixed);
+	const size_type NONE_FOUND = (size_type)-1;
+	size_type first_free = NONE_FOUND;
+
+	size_type ctr = hashIndex(mixed);
+	for (; ; ctr = (ctr + 1) & _mask) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == kCtrlEmpty)
+			break;
+		if (ctrl == kCtrlDeleted) {
+			if (first_free == NONE_FOUND)
+				first_free = ctr;
+		} else if (ctrl == tag && _equal(_slots[ctr]._key, key)) {
+			return ctr;
+		}
+	}
+
+	if (first_free != NONE_FOUND) {
+		// Reuse an erased slot, which does not change the load
+		ctr = first_free;
+		_deleted--;
+	} else {
+		// Keep the load factor below a certain threshold.
+		// Erased slots are also counted
+		size_type capacity = _mask + 1;
+		if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+			// Only grow if the live elements take up a sizeable part of the
+			// table, otherwise getting rid of the erased slots is enough.
+			if ((_size + 1) * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+				capacity *= 2;
+
+			// Rehashing frees the old slots, which key and val may refer to
+			const Node node = val ? Node(key, *val) : Node(key);
+			rehash(capacity);
+
+			ctr = hashIndex(mixed);
+			while (_ctrl[ctr] != kCtrlEmpty)
+				ctr = (ctr + 1) & _mask;
+
+			_ctrl[ctr] = tag;
+			new ((void *)&_slots[ctr]) Node(node);
+			_size++;
+			return ctr;
+		}
+	}
+
+	_ctrl[ctr] = tag;
+	if (val)
+		new ((void *)&_slots[ctr]) Node(key, *val);
+	else
+		new ((void *)&_slots[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// Look up first, since inserting may reallocate _slots
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type oldSize = _size;
+	size_type ctr = lookupAndCreateIfMissing(key, &val);
+	// New nodes are created with the value already
+	if (_size == oldSize)
+		_slots[ctr]._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(!(_ctrl[ctr] & kCtrlFullMask));
+
+	_slots[ctr].~Node();
+	_ctrl[ctr] = kCtrlDeleted;
+	_size--;
+	_deleted++;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	const size_type ctr = lookup(key);
+	if (ctr == (size_type)-1)
+		return;
+
+	_slots[ctr].~Node();
+	_ctrl[ctr] = kCtrlDeleted;
+	_size--;
+	_deleted++;
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
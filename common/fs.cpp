@@ -52,7 +52,8 @@ FSDirectoryFile::FSDirectoryFile(const Common::Path &pathInDirectory, const FSNo
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStream() const {
-	return _fsNode.createReadStream();
+	// Directories searched this way only hold game data
+	return _fsNode.createMappedReadStream();
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStreamForAltStream(AltStreamType altStreamType) const {
@@ -233,6 +234,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileInfo(int64 &size, int64 &modificationTime) const {
+	return _realNode && _realNode->getFileInfo(size, modificationTime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -248,6 +253,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createMappedReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createMappedReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createMappedReadStream();
+}
+
 SeekableReadStream *FSNode::createReadStreamForAltStream(AltStreamType altStreamType) const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -272,6 +292,8 @@ SeekableWriteStream *FSNode::createWriteStream() const {
 		return nullptr;
 	}
 
+	// Search sets may have cached that a lower priority archive has the file
+	SearchSet::invalidateLookupCaches();
 	return _realNode->createWriteStream();
 }
 
@@ -288,6 +310,7 @@ bool FSNode::createDirectory() const {
 		return false;
 	}
 
+	SearchSet::invalidateLookupCaches();
 	return _realNode->createDirectory();
 }
 
@@ -333,8 +356,9 @@ FSNode *FSDirectory::lookupCache(NodeCache &cache, const Path &name) const {
 	if (!name.empty()) {
 		ensureCached();
 
-		if (cache.contains(name))
-			return &cache[name];
+		NodeCache::iterator it = cache.find(name);
+		if (it != cache.end())
+			return &it->_value;
 	}
 
 	return nullptr;
@@ -383,7 +407,7 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) con
 
 	debug(5, "FSDirectory::createReadStreamForMember('%s') -> '%s'", path.toString(Common::Path::kNativeSeparator).c_str(), node->getPath().toString(Common::Path::kNativeSeparator).c_str());
 
-	SeekableReadStream *stream = node->createReadStream();
+	SeekableReadStream *stream = node->createMappedReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", Common::toPrintable(path.toString(Common::Path::kNativeSeparator)).c_str());
 
@@ -252,6 +252,17 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Query the size and the last modification time of the file referred
+	 * by this node, without opening it.
+	 *
+	 * The modification time is in a backend-specific unit and only meant
+	 * to be compared against values previously obtained on the same system.
+	 *
+	 * @return True if the information is available, false otherwise.
+	 */
+	bool getFileInfo(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -261,6 +272,18 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Like createReadStream(), but allows the backend to map the file into
+	 * memory, so that getBufferPtr() gives direct access to its contents.
+	 *
+	 * Only use this for read-only game data. The file must not be truncated
+	 * or rewritten while the stream exists, which is never the case for
+	 * files written by ScummVM itself, such as saved games.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SPSC_QUEUE_H
+#define COMMON_SPSC_QUEUE_H
+
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spsc_queue Single-producer single-consumer queue
+ * @ingroup common
+ *
+ * @brief Fixed-size lock-free queue for passing items between two threads.
+ * @{
+ */
+
+/**
+ * Bounded lock-free queue with one producer and one consumer thread.
+ *
+ * push() may only be called by one thread at a time, and likewise pop();
+ * callers with several producers or consumers must serialize each side
+ * themselves. Neither function blocks or allocates, which makes the queue
+ * suitable for talking to real-time threads such as the audio callback.
+ *
+ * @tparam T     Item type, copied in and out of the queue.
+ * @tparam SIZE  Capacity of the queue, must be a power of two.
+ */
+template<class T, uint SIZE>
+class SPSCQueue : NonCopyable {
+	static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SPSCQueue size must be a power of two");
+
+public:
+	SPSCQueue() : _head(0), _tail(0) {}
+
+	/** Append @p item, or return false if the queue is full. */
+	bool push(const T &item) {
+		const uint32 tail = _tail.load();
+		if (tail - _head.load() == SIZE)
+			return false;
+
+		_items[tail & (SIZE - 1)] = item;
+		_tail.store(tail + 1);
+		return true;
+	}
+
+	/** Remove the oldest item into @p item, or return false if the queue is empty. */
+	bool pop(T &item) {
+		const uint32 head = _head.load();
+		if (head == _tail.load())
+			return false;
+
+		item = _items[head & (SIZE - 1)];
+		_head.store(head + 1);
+		return true;
+	}
+
+	/** Return true if the queue holds no items. */
+	bool empty() const { return _head.load() == _tail.load(); }
+
+private:
+	T _items[SIZE];
+	Atomic<uint32> _head; ///< Index of the next item to pop, owned by the consumer
+	Atomic<uint32> _tail; ///< Index of the next item to push, owned by the producer
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -287,6 +287,11 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getBufferPtr() const {
+	const byte *ptr = _parentStream->getBufferPtr();
+	return ptr ? ptr + _begin : nullptr;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -792,6 +792,22 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Obtain direct access to the contents of the stream.
+	 *
+	 * Streams that hold all of their data in memory, such as memory streams
+	 * or memory mapped files, return a pointer to it. This allows parsing the
+	 * data in place instead of copying it with read() first.
+	 *
+	 * The pointer addresses the byte at position 0 and covers size() bytes,
+	 * independently of the current position. It stays valid as long as the
+	 * stream exists.
+	 *
+	 * @return Pointer to the stream contents, or nullptr if they are not
+	 *         available in memory.
+	 */
+	virtual const byte *getBufferPtr() const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -982,6 +998,7 @@ public:
 	int64 pos() const override { return _parentStream->pos(); }
 	int64 size() const override { return _parentStream->size(); }
 	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+	const byte *getBufferPtr() const override { return _parentStream->getBufferPtr(); }
 };
 
 /** @} */
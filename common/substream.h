@@ -86,6 +86,8 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+
+	virtual const byte *getBufferPtr() const;
 };
 
 /**
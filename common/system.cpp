@@ -33,6 +33,7 @@
 #include "common/str-enc.h"
 #include "common/textconsole.h"
 #include "common/text-to-speech.h"
+#include "common/threadpool.h"
 
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/fs/fs-factory.h"
@@ -116,6 +117,10 @@ void OSystem::initBackend() {
 // 	if (!_fsFactory)
 // 		error("Backend failed to instantiate fs factory");
 
+	// Create the shared thread pool up front on the main thread, since the
+	// singleton cannot be created safely from several threads
+	Common::ThreadPool::instance();
+
 	_backendInitialized = true;
 }
 
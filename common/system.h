@@ -55,6 +55,7 @@ namespace Common {
 class EventManager;
 class MutexInternal;
 struct Rect;
+class ThreadPoolInternal;
 class SaveFileManager;
 class SearchSet;
 class String;
@@ -1590,6 +1591,20 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Create a pool of worker threads.
+	 *
+	 * This is the only place where ScummVM code may obtain threads of its
+	 * own. Backends without thread support keep the default implementation,
+	 * which makes Common::ThreadPool run all work on the calling thread.
+	 *
+	 * @param numThreads Number of worker threads to create, or 0 to let the
+	 *                   backend pick a value suitable for the host.
+	 *
+	 * @return The newly created pool, or nullptr if threads are unavailable.
+	 */
+	virtual Common::ThreadPoolInternal *createThreadPool(uint numThreads) { return nullptr; }
+
 	/** @} */
 
 
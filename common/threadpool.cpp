@@ -0,0 +1,136 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/threadpool.h"
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/system.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(ThreadPool);
+
+ThreadPool *ThreadPool::makeInstance() {
+	uint numThreads = 0;
+	if (ConfMan.hasKey("worker_threads"))
+		numThreads = MAX(ConfMan.getInt("worker_threads"), 1);
+	return new ThreadPool(numThreads);
+}
+
+ThreadPool::ThreadPool(uint numThreads) : _internal(nullptr) {
+	assert(g_system);
+	// The calling thread always takes part in the work, so one thread
+	// less than requested needs to be created.
+	if (numThreads != 1)
+		_internal = g_system->createThreadPool(numThreads ? numThreads - 1 : 0);
+}
+
+ThreadPool::ThreadPool(ThreadPoolInternal *internal) : _internal(internal) {
+}
+
+ThreadPool::~ThreadPool() {
+	delete _internal;
+}
+
+uint ThreadPool::getThreadCount() const {
+	return _internal ? _internal->getThreadCount() : 0;
+}
+
+namespace {
+
+struct RangeJob {
+	ThreadPool::RangeProc proc;
+	void *data;
+	uint begin;
+	uint end;
+};
+
+void runRangeJob(void *data) {
+	RangeJob *job = (RangeJob *)data;
+	job->proc(job->begin, job->end, job->data);
+}
+
+} // End of anonymous namespace
+
+void ThreadPool::parallelFor(uint count, RangeProc proc, void *data, uint minRange) {
+	if (count == 0)
+		return;
+
+	uint numRanges = getThreadCount() + 1;
+	if (minRange > 1)
+		numRanges = MIN(numRanges, (count + minRange - 1) / minRange);
+	numRanges = MIN(numRanges, count);
+
+	if (numRanges <= 1) {
+		proc(0, count, data);
+		return;
+	}
+
+	Array<RangeJob> jobs;
+	jobs.resize(numRanges);
+	uint begin = 0;
+	for (uint i = 0; i < numRanges; ++i) {
+		uint end = (uint)(((uint64)count * (i + 1)) / numRanges);
+		jobs[i].proc = proc;
+		jobs[i].data = data;
+		jobs[i].begin = begin;
+		jobs[i].end = end;
+		begin = end;
+	}
+
+	TaskGroup group(*this);
+	for (uint i = 1; i < numRanges; ++i)
+		group.run(runRangeJob, &jobs[i]);
+	runRangeJob(&jobs[0]);
+	group.wait();
+}
+
+
+#pragma mark -
+
+
+TaskGroup::TaskGroup(ThreadPool &pool) : _pool(pool), _pending(0) {
+}
+
+TaskGroup::~TaskGroup() {
+	wait();
+}
+
+void TaskGroup::run(ThreadPoolProc proc, void *data) {
+	if (_pool._internal)
+		_pool._internal->submit(proc, data, &_pending);
+	else
+		proc(data);
+}
+
+void TaskGroup::wait() {
+	if (_pool._internal)
+		_pool._internal->wait(&_pending);
+}
+
+void TaskGroup::cancel() {
+	if (_pool._internal) {
+		_pool._internal->cancel(&_pending);
+		_pool._internal->wait(&_pending);
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,176 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief API for offloading CPU-bound work to worker threads.
+ *
+ * The worker threads are provided by the backend through
+ * OSystem::createThreadPool(). Backends that do not support threads
+ * return nullptr there, in which case all work submitted to a ThreadPool
+ * is executed synchronously on the calling thread. Code using this API
+ * must therefore never rely on tasks running concurrently.
+ *
+ * @{
+ */
+
+typedef void (*ThreadPoolProc)(void *data); /*!< Type definition of a thread pool job. */
+
+/**
+ * Backend implementation of a thread pool.
+ *
+ * The job counters passed to submit() and wait() are owned by the caller
+ * but must only be accessed by the implementation, which protects them
+ * with its own lock.
+ */
+class ThreadPoolInternal {
+public:
+	virtual ~ThreadPoolInternal() {}
+
+	/** Return the number of worker threads owned by the pool. */
+	virtual uint getThreadCount() const = 0;
+
+	/**
+	 * Queue @p proc for execution on a worker thread.
+	 *
+	 * @p counter is incremented before this function returns, and
+	 * decremented once the job has finished running.
+	 */
+	virtual void submit(ThreadPoolProc proc, void *data, uint *counter) = 0;
+
+	/**
+	 * Block until @p counter drops to zero.
+	 *
+	 * Implementations should run queued jobs on the calling thread while
+	 * waiting, so that waiting from inside a job cannot deadlock the pool.
+	 */
+	virtual void wait(uint *counter) = 0;
+
+	/**
+	 * Drop the jobs queued with @p counter which have not started yet,
+	 * decrementing @p counter for each of them. Running jobs are not
+	 * affected.
+	 */
+	virtual void cancel(uint *counter) = 0;
+};
+
+class ThreadPool;
+
+/**
+ * A set of jobs that can be waited on together.
+ *
+ * The destructor waits for all outstanding jobs, so any data passed to
+ * run() only needs to outlive the group.
+ */
+class TaskGroup : NonCopyable {
+public:
+	explicit TaskGroup(ThreadPool &pool);
+	~TaskGroup();
+
+	/** Run @p proc with @p data, asynchronously if the pool has worker threads. */
+	void run(ThreadPoolProc proc, void *data);
+
+	/** Block until every job started through run() has finished. */
+	void wait();
+
+	/**
+	 * Drop the jobs which have not started yet and wait for the running
+	 * ones to finish.
+	 */
+	void cancel();
+
+private:
+	ThreadPool &_pool;
+	uint _pending;
+};
+
+/**
+ * Pool of worker threads used to parallelize CPU-bound work.
+ *
+ * A shared instance is available through ThreadPoolMan; its size is taken
+ * from the "worker_threads" config key, or chosen by the backend when that
+ * key is not set. A value of 1 disables worker threads altogether.
+ */
+class ThreadPool : public Singleton<ThreadPool> {
+	friend class TaskGroup;
+
+public:
+	/**
+	 * Range callback used by parallelFor(). It is invoked with disjoint
+	 * [begin, end) ranges which together cover the whole iteration space.
+	 */
+	typedef void (*RangeProc)(uint begin, uint end, void *data);
+
+	/**
+	 * Create a pool.
+	 *
+	 * @param numThreads  Total number of threads doing work, including the
+	 *                    calling thread. 0 lets the backend decide.
+	 */
+	explicit ThreadPool(uint numThreads = 0);
+
+	/**
+	 * Create a pool running its work on the given workers, which it takes
+	 * ownership of. With nullptr all work runs synchronously.
+	 */
+	explicit ThreadPool(ThreadPoolInternal *internal);
+	~ThreadPool();
+
+	/** Return the number of worker threads, 0 if work runs synchronously. */
+	uint getThreadCount() const;
+
+	/** Return true if submitted work may run on other threads. */
+	bool isMultiThreaded() const { return _internal != nullptr; }
+
+	/**
+	 * Split [0, count) into ranges of at least @p minRange items, call
+	 * @p proc for each of them and wait for all of them to finish.
+	 *
+	 * One range is always processed on the calling thread.
+	 */
+	void parallelFor(uint count, RangeProc proc, void *data, uint minRange = 1);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	static ThreadPool *makeInstance();
+
+	ThreadPoolInternal *_internal;
+};
+
+/** Shortcut for accessing the shared thread pool. */
+#define ThreadPoolMan		Common::ThreadPool::instance()
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -30,6 +30,7 @@
 #include "common/punycode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/compression/installshield_cab.h"
@@ -413,6 +414,7 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.savePersistentCache();
 
 	// If the GUI options were updated, we catch this here and update them in the users config
 	// file transparently.
@@ -517,6 +519,67 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+#define DETECTION_CACHE_FILENAME "scummvm-detection.cache"
+
+Common::Path AdvancedDetectorCacheManager::getPersistentCachePath() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return configFile.getParent().appendComponent(DETECTION_CACHE_FILENAME);
+}
+
+Common::String AdvancedDetectorCacheManager::makePersistentKey(const Common::FSNode &node, const Common::String &key) {
+	return key + ':' + node.getPath().toString(Common::Path::kNativeSeparator);
+}
+
+void AdvancedDetectorCacheManager::loadPersistentCache() {
+	_persistentLoaded = true;
+
+	Common::FSNode file(getPersistentCachePath());
+	if (!file.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(file.createReadStream());
+	if (stream)
+		_persistentCache.load(*stream);
+}
+
+void AdvancedDetectorCacheManager::savePersistentCache() {
+	if (!_persistentCache.isDirty())
+		return;
+
+	Common::FSNode file(getPersistentCachePath());
+	Common::ScopedPtr<Common::WriteStream> stream(file.createWriteStream());
+	if (!stream || !_persistentCache.save(*stream)) {
+		debugC(2, kDebugGlobalDetection, "Cannot write the detection cache to '%s'", file.getPath().toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+	stream->finalize();
+}
+
+bool AdvancedDetectorCacheManager::getPersistentProperties(const Common::FSNode &node, const Common::String &key, FileProperties &props) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	int64 fileSize, modificationTime;
+	if (!node.getFileInfo(fileSize, modificationTime))
+		return false;
+
+	return _persistentCache.lookup(makePersistentKey(node, key), fileSize, modificationTime, props.size, props.md5);
+}
+
+void AdvancedDetectorCacheManager::setPersistentProperties(const Common::FSNode &node, const Common::String &key, const FileProperties &props) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	int64 fileSize, modificationTime;
+	if (!node.getFileInfo(fileSize, modificationTime))
+		return;
+
+	_persistentCache.store(makePersistentKey(node, key), fileSize, modificationTime, props.size, props.md5);
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -581,12 +644,51 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
-bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+static Common::String getMD5CacheName(MD5Properties md5prop, const Common::Path &fname, uint md5Bytes) {
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
 		hashname += fname.toString('/');
 		hashname += ':';
-		hashname += Common::String::format("%d", _md5Bytes);
+		hashname += Common::String::format("%d", md5Bytes);
+	return hashname;
+}
+
+// Files read through MacResManager may come from several nodes on disk,
+// so only plain files and archive members are cached across runs.
+static bool getPersistentCacheKey(const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, uint md5Bytes, Common::FSNode &node, Common::String &key) {
+	if (md5prop & (kMD5MacResFork | kMD5MacDataFork))
+		return false;
+
+	Common::Path nodeName = fname;
+	if (md5prop & kMD5Archive) {
+		Common::StringTokenizer tok(fname.toString(), ":");
+		Common::String archiveType = tok.nextToken();
+		nodeName = Common::Path(tok.nextToken());
+		key = Common::String::format("%s:%d:%s:%s", md5PropToCachePrefix(md5prop).c_str(), md5Bytes, archiveType.c_str(), tok.nextToken().c_str());
+	} else {
+		key = Common::String::format("%s:%d", md5PropToCachePrefix(md5prop).c_str(), md5Bytes);
+	}
+
+	if (!allFiles.contains(nodeName))
+		return false;
+
+	node = allFiles[nodeName];
+	return true;
+}
+
+static void computeStreamProperties(Common::SeekableReadStream &stream, uint md5Bytes, MD5Properties md5prop, FileProperties &fileProps) {
+	if (md5prop & kMD5Tail) {
+		if (stream.size() > md5Bytes)
+			stream.seek(-(int64)md5Bytes, SEEK_END);
+	}
+
+	fileProps.size = stream.size();
+	fileProps.md5 = Common::computeStreamMD5AsString(stream, md5Bytes);
+	fileProps.md5prop = (MD5Properties) (md5prop & kMD5Tail);
+}
+
+bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+	Common::String hashname = getMD5CacheName(md5prop, fname, _md5Bytes);
 
 	if (ADCacheMan.containsMD5(hashname)) {
 		fileProps.md5 = ADCacheMan.getMD5(hashname);
@@ -594,16 +696,128 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5
 		return true;
 	}
 
+	Common::FSNode persistentNode;
+	Common::String persistentKey;
+	bool persistent = getPersistentCacheKey(allFiles, md5prop, fname, _md5Bytes, persistentNode, persistentKey);
+
+	if (persistent && ADCacheMan.getPersistentProperties(persistentNode, persistentKey, fileProps)) {
+		fileProps.md5prop = (MD5Properties)(md5prop & kMD5Tail);
+		ADCacheMan.setMD5(hashname, fileProps.md5);
+		ADCacheMan.setSize(hashname, fileProps.size);
+		return true;
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+
+		if (persistent)
+			ADCacheMan.setPersistentProperties(persistentNode, persistentKey, fileProps);
 	}
 
 	return res;
 }
 
+namespace {
+
+struct PrefetchJob {
+	Common::Path fname;
+	MD5Properties md5prop;
+	Common::SeekableReadStream *stream;
+	FileProperties props;
+};
+
+struct PrefetchData {
+	Common::Array<PrefetchJob> *jobs;
+	uint md5Bytes;
+};
+
+void prefetchRange(uint begin, uint end, void *data) {
+	PrefetchData *prefetch = (PrefetchData *)data;
+	for (uint i = begin; i < end; i++) {
+		PrefetchJob &job = (*prefetch->jobs)[i];
+		computeStreamProperties(*job.stream, prefetch->md5Bytes, job.md5prop, job.props);
+	}
+}
+
+} // End of anonymous namespace
+
+void AdvancedMetaEngineDetection::prefetchFileProperties(const FileMap &allFiles) const {
+	if (!ThreadPoolMan.isMultiThreaded())
+		return;
+
+	// Collect the plain files which are present but not cached yet
+	Common::Array<PrefetchJob> jobs;
+	Common::HashMap<Common::String, bool> queued;
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
+			if (md5prop & (kMD5MacResFork | kMD5MacDataFork | kMD5Archive))
+				continue;
+
+			Common::Path fname(fileDesc->fileName);
+			Common::String hashname = getMD5CacheName(md5prop, fname, _md5Bytes);
+			if (queued.contains(hashname) || ADCacheMan.containsMD5(hashname) || !allFiles.contains(fname))
+				continue;
+			queued[hashname] = true;
+
+			PrefetchJob job;
+			job.fname = fname;
+			job.md5prop = md5prop;
+			job.stream = nullptr;
+			jobs.push_back(job);
+		}
+	}
+
+	// Hash the files in batches to bound the number of open files. The
+	// streams are opened and the results stored on this thread, only the
+	// reading and hashing is done in parallel.
+	const uint kBatchSize = 64;
+	for (uint batchStart = 0; batchStart < jobs.size(); batchStart += kBatchSize) {
+		Common::Array<PrefetchJob> batch;
+		for (uint i = batchStart; i < MIN<uint>(batchStart + kBatchSize, jobs.size()); i++) {
+			PrefetchJob &job = jobs[i];
+
+			Common::FSNode node;
+			Common::String persistentKey;
+			if (getPersistentCacheKey(allFiles, job.md5prop, job.fname, _md5Bytes, node, persistentKey) &&
+			    ADCacheMan.getPersistentProperties(node, persistentKey, job.props)) {
+				Common::String hashname = getMD5CacheName(job.md5prop, job.fname, _md5Bytes);
+				ADCacheMan.setMD5(hashname, job.props.md5);
+				ADCacheMan.setSize(hashname, job.props.size);
+				continue;
+			}
+
+			job.stream = node.createReadStream();
+			if (job.stream)
+				batch.push_back(job);
+		}
+
+		PrefetchData data;
+		data.jobs = &batch;
+		data.md5Bytes = _md5Bytes;
+		ThreadPoolMan.parallelFor(batch.size(), prefetchRange, &data);
+
+		for (uint i = 0; i < batch.size(); i++) {
+			PrefetchJob &job = batch[i];
+			delete job.stream;
+
+			Common::String hashname = getMD5CacheName(job.md5prop, job.fname, _md5Bytes);
+			ADCacheMan.setMD5(hashname, job.props.md5);
+			ADCacheMan.setSize(hashname, job.props.size);
+
+			Common::FSNode node;
+			Common::String persistentKey;
+			if (getPersistentCacheKey(allFiles, job.md5prop, job.fname, _md5Bytes, node, persistentKey))
+				ADCacheMan.setPersistentProperties(node, persistentKey, job.props);
+		}
+	}
+}
+
 bool AdvancedMetaEngine::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
 }
@@ -700,14 +914,7 @@ static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::Fil
 			return false;
 	}
 
-	if (md5prop & kMD5Tail) {
-		if (testFile->size() > md5Bytes)
-			testFile->seek(-(int64)md5Bytes, SEEK_END);
-	}
-
-	fileProps.size = testFile->size();
-	fileProps.md5 = Common::computeStreamMD5AsString(*testFile.get(), md5Bytes);
-	fileProps.md5prop = (MD5Properties) (md5prop & kMD5Tail);
+	computeStreamProperties(*testFile, md5Bytes, md5prop, fileProps);
 	return true;
 }
 
@@ -775,6 +982,10 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 
 	preprocessDescriptions();
 
+	// Hash the candidate files in parallel, the loop below then finds their
+	// properties in the cache.
+	prefetchFileProperties(allFiles);
+
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
@@ -24,6 +24,7 @@
 
 #include "engines/metaengine.h"
 #include "engines/engine.h"
+#include "engines/detectioncache.h"
 
 #include "common/hash-str.h"
 
@@ -472,6 +473,13 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
+	/**
+	 * Compute the properties of all present files referenced by the game
+	 * descriptions on the worker threads of the thread pool, and add them
+	 * to the MD5 cache. Does nothing without worker threads.
+	 */
+	void prefetchFileProperties(const FileMap &allFiles) const;
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -572,6 +580,11 @@ protected:
 
 /**
  * Singleton Cache Storage for Computed MD5s and Open Archives
+ *
+ * Besides the per-detection cache, MD5s of files on disk are kept in a
+ * persistent cache stored next to the configuration file. Its entries are
+ * keyed by the absolute path of the hashed file and are only used while
+ * the size and modification time of that file are unchanged.
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -612,7 +625,23 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look up the properties of @p node in the persistent cache.
+	 *
+	 * @param node  The file that was hashed.
+	 * @param key   What was computed from it, e.g. the MD5 flags and length.
+	 * @param props Filled in with the cached size and MD5 on success.
+	 * @return True if an up-to-date entry was found.
+	 */
+	bool getPersistentProperties(const Common::FSNode &node, const Common::String &key, FileProperties &props);
+
+	/** Store the properties of @p node in the persistent cache. */
+	void setPersistentProperties(const Common::FSNode &node, const Common::String &key, const FileProperties &props);
+
+	/** Write the persistent cache to disk, if it has been modified. */
+	void savePersistentCache();
+
+	AdvancedDetectorCacheManager() : _persistentLoaded(false) {
 		clear();
 	}
 
@@ -638,6 +667,13 @@ private:
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	PersistentDetectionCache _persistentCache;
+	bool _persistentLoaded;
+
+	void loadPersistentCache();
+	static Common::Path getPersistentCachePath();
+	static Common::String makePersistentKey(const Common::FSNode &node, const Common::String &key);
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
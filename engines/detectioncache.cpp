@@ -0,0 +1,227 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/detectioncache.h"
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/stream.h"
+
+// Bumped whenever the format or the meaning of a field changes. Version 1
+// stored modification times with a resolution of one second, version 2 did
+// not escape the keys.
+#define DETECTION_CACHE_HEADER "# ScummVM detection cache v3"
+
+// Keys are paths, which may contain line breaks. Those and backslashes are
+// escaped, so that each entry stays on a line of its own.
+static Common::String escapeKey(const Common::String &key) {
+	Common::String escaped;
+	for (uint i = 0; i < key.size(); i++) {
+		switch (key[i]) {
+		case '\\':
+			escaped += "\\\\";
+			break;
+		case '\n':
+			escaped += "\\n";
+			break;
+		case '\r':
+			escaped += "\\r";
+			break;
+		default:
+			escaped += key[i];
+			break;
+		}
+	}
+	return escaped;
+}
+
+static bool unescapeKey(const Common::String &escaped, Common::String &key) {
+	key.clear();
+	for (uint i = 0; i < escaped.size(); i++) {
+		if (escaped[i] != '\\') {
+			key += escaped[i];
+			continue;
+		}
+
+		if (++i == escaped.size())
+			return false;
+		switch (escaped[i]) {
+		case '\\':
+			key += '\\';
+			break;
+		case 'n':
+			key += '\n';
+			break;
+		case 'r':
+			key += '\r';
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+PersistentDetectionCache::PersistentDetectionCache() : _run(1), _dirty(false) {
+}
+
+void PersistentDetectionCache::clear() {
+	_entries.clear();
+	_run = 1;
+	_dirty = false;
+}
+
+void PersistentDetectionCache::load(Common::SeekableReadStream &stream) {
+	clear();
+
+	// Discard caches written by other versions of the format
+	if (stream.readLine() != DETECTION_CACHE_HEADER)
+		return;
+
+	// The run counter of the session that wrote the cache comes next
+	Common::String runLine = stream.readLine();
+	if (runLine.empty())
+		return;
+	_run = (uint32)runLine.asUint64() + 1;
+
+	// Each line holds: file size, modification time, hashed size, last run
+	// the entry was used in, MD5 and key, separated by tabs. The key comes
+	// last as it may contain anything.
+	while (!stream.eos() && !stream.err()) {
+		Common::String line = stream.readLine();
+		if (line.empty())
+			continue;
+
+		Common::String fields[5];
+		uint pos = 0;
+		bool valid = true;
+		for (int i = 0; i < ARRAYSIZE(fields) && valid; i++) {
+			size_t tab = line.findFirstOf('\t', pos);
+			if (tab == Common::String::npos) {
+				valid = false;
+			} else {
+				fields[i] = line.substr(pos, tab - pos);
+				pos = tab + 1;
+			}
+		}
+		Common::String key;
+		if (!valid || pos >= line.size() || !unescapeKey(line.substr(pos), key))
+			continue;
+
+		Entry entry;
+		entry.fileSize = (int64)fields[0].asUint64();
+		entry.modificationTime = (int64)fields[1].asUint64();
+		entry.size = (int64)fields[2].asUint64();
+		entry.lastUsed = (uint32)fields[3].asUint64();
+		entry.md5 = fields[4];
+		_entries.setVal(key, entry);
+	}
+
+	debugC(2, kDebugGlobalDetection, "Loaded %u entries from the detection cache", _entries.size());
+}
+
+bool PersistentDetectionCache::save(Common::WriteStream &stream) {
+	prune();
+
+	stream.writeString(DETECTION_CACHE_HEADER "\n");
+	stream.writeString(Common::String::format("%u\n", _run));
+	for (const auto &entry : _entries) {
+		stream.writeString(Common::String::format("%llu\t%llu\t%llu\t%u\t%s\t%s\n",
+			(unsigned long long)entry._value.fileSize, (unsigned long long)entry._value.modificationTime,
+			(unsigned long long)entry._value.size, entry._value.lastUsed,
+			entry._value.md5.c_str(), escapeKey(entry._key).c_str()));
+	}
+
+	if (!stream.flush() || stream.err())
+		return false;
+
+	_dirty = false;
+	return true;
+}
+
+bool PersistentDetectionCache::lookup(const Common::String &key, int64 fileSize, int64 modificationTime, int64 &size, Common::String &md5) {
+	EntryMap::iterator entry = _entries.find(key);
+	if (entry == _entries.end())
+		return false;
+
+	if (entry->_value.fileSize != fileSize || entry->_value.modificationTime != modificationTime) {
+		// The file has changed since it was hashed
+		_entries.erase(entry);
+		_dirty = true;
+		return false;
+	}
+
+	if (entry->_value.lastUsed != _run) {
+		entry->_value.lastUsed = _run;
+		_dirty = true;
+	}
+
+	size = entry->_value.size;
+	md5 = entry->_value.md5;
+	return true;
+}
+
+void PersistentDetectionCache::store(const Common::String &key, int64 fileSize, int64 modificationTime, int64 size, const Common::String &md5) {
+	Entry entry;
+	entry.fileSize = fileSize;
+	entry.modificationTime = modificationTime;
+	entry.size = size;
+	entry.lastUsed = _run;
+	entry.md5 = md5;
+	_entries.setVal(key, entry);
+	_dirty = true;
+}
+
+namespace {
+
+struct UsageEntry {
+	uint32 lastUsed;
+	Common::String key;
+
+	bool operator<(const UsageEntry &other) const { return lastUsed < other.lastUsed; }
+};
+
+} // End of anonymous namespace
+
+void PersistentDetectionCache::prune() {
+	Common::Array<UsageEntry> usage;
+	usage.reserve(_entries.size());
+
+	for (EntryMap::iterator entry = _entries.begin(); entry != _entries.end(); ++entry) {
+		if (_run - entry->_value.lastUsed >= kMaxUnusedRuns) {
+			_entries.erase(entry);
+			_dirty = true;
+		} else {
+			UsageEntry item = { entry->_value.lastUsed, entry->_key };
+			usage.push_back(item);
+		}
+	}
+
+	if (usage.size() <= kMaxEntries)
+		return;
+
+	// Evict the least recently used entries
+	Common::sort(usage.begin(), usage.end());
+	for (uint i = 0; i < usage.size() - kMaxEntries; i++)
+		_entries.erase(usage[i].key);
+	_dirty = true;
+}
@@ -0,0 +1,109 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace Common {
+class SeekableReadStream;
+class WriteStream;
+}
+
+/**
+ * @defgroup engines_detectioncache Detection cache
+ * @ingroup engines
+ *
+ * @brief The on-disk cache of file MD5s computed during game detection.
+ * @{
+ */
+
+/**
+ * Remembers the MD5 computed for a file across runs, together with the
+ * size and modification time the file had at that point. An entry is only
+ * returned while both still match.
+ *
+ * Every load starts a new run. Entries which have not been looked up or
+ * stored for kMaxUnusedRuns runs are dropped when the cache is written, and
+ * at most kMaxEntries entries are kept, the least recently used going first.
+ */
+class PersistentDetectionCache {
+public:
+	enum {
+		kMaxEntries = 16384,
+		kMaxUnusedRuns = 32
+	};
+
+	PersistentDetectionCache();
+
+	/**
+	 * Replace the contents of the cache with the entries read from
+	 * @p stream. Caches written in an older format are ignored.
+	 */
+	void load(Common::SeekableReadStream &stream);
+
+	/** Prune the cache and write it to @p stream. */
+	bool save(Common::WriteStream &stream);
+
+	/**
+	 * Look up the MD5 computed for @p key.
+	 *
+	 * @param key              Identifies the file and what was computed from it.
+	 * @param fileSize         The current size of the file.
+	 * @param modificationTime The current modification time of the file.
+	 * @param size             Set to the cached hashed size on success.
+	 * @param md5              Set to the cached MD5 on success.
+	 * @return True if an up-to-date entry was found.
+	 */
+	bool lookup(const Common::String &key, int64 fileSize, int64 modificationTime, int64 &size, Common::String &md5);
+
+	/** Store the MD5 computed for @p key. */
+	void store(const Common::String &key, int64 fileSize, int64 modificationTime, int64 size, const Common::String &md5);
+
+	/** Drop the entries which have gone unused for too long and enforce the size limit. */
+	void prune();
+
+	void clear();
+
+	uint size() const { return _entries.size(); }
+	bool isDirty() const { return _dirty; }
+
+private:
+	struct Entry {
+		int64 fileSize;
+		int64 modificationTime;
+		int64 size;
+		uint32 lastUsed;
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+	EntryMap _entries;
+	uint32 _run;
+	bool _dirty;
+};
+
+/** @} */
+
+#endif
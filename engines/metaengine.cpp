@@ -446,7 +446,7 @@ SaveStateDescriptor MetaEngine::querySaveMetaInfos(const char *target, int slot)
 
 	if (f) {
 		ExtendedSavegameHeader header;
-		if (!readSavegameHeader(f.get(), &header, false)) {
+		if (!readSavegameHeader(f.get(), &header, _deferThumbnail)) {
 			return SaveStateDescriptor();
 		}
 
@@ -455,8 +455,32 @@ SaveStateDescriptor MetaEngine::querySaveMetaInfos(const char *target, int slot)
 		parseSavegameHeader(&header, &desc);
 		desc.setThumbnail(header.thumbnail);
 		desc.setAutosave(header.isAutosave);
+
+		if (_deferThumbnail) {
+			delete _deferredThumbnailFile;
+			_deferredThumbnailFile = f.release();
+		}
 		return desc;
 	}
 
 	return SaveStateDescriptor();
 }
+
+SaveStateDescriptor MetaEngine::querySaveMetaInfosDeferringThumbnail(const char *target, int slot, Common::InSaveFile *&thumbnailFile) const {
+	// Engines which override querySaveMetaInfos() load the thumbnail as usual
+	_deferThumbnail = true;
+	SaveStateDescriptor desc = querySaveMetaInfos(target, slot);
+	_deferThumbnail = false;
+
+	thumbnailFile = _deferredThumbnailFile;
+	_deferredThumbnailFile = nullptr;
+	return desc;
+}
+
+Graphics::Surface *MetaEngine::loadDeferredThumbnail(Common::InSaveFile *thumbnailFile) {
+	ExtendedSavegameHeader header;
+	if (!readSavegameHeader(thumbnailFile, &header, false))
+		return nullptr;
+
+	return header.thumbnail;
+}
@@ -233,6 +233,7 @@ protected:
 	}
 
 public:
+	MetaEngine() : _deferThumbnail(false), _deferredThumbnailFile(nullptr) {}
 	virtual ~MetaEngine() {}
 
 	/**
@@ -345,6 +346,32 @@ public:
 	 */
 	virtual SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const;
 
+	/**
+	 * Return meta information from the specified save state like
+	 * querySaveMetaInfos(), but leave loading the thumbnail to the caller
+	 * where possible.
+	 *
+	 * This is possible for engines using the default implementation of
+	 * querySaveMetaInfos(). Then @p thumbnailFile is set to the save file,
+	 * which loadDeferredThumbnail() loads the thumbnail from. Otherwise it
+	 * is set to nullptr and the descriptor includes the thumbnail.
+	 *
+	 * @param target         Name of a config manager target.
+	 * @param slot           Slot number of the save state.
+	 * @param thumbnailFile  Set to the save file, which the caller deletes.
+	 */
+	SaveStateDescriptor querySaveMetaInfosDeferringThumbnail(const char *target, int slot, Common::InSaveFile *&thumbnailFile) const;
+
+	/**
+	 * Load the thumbnail from a save file returned by
+	 * querySaveMetaInfosDeferringThumbnail(). This does not touch any engine
+	 * state, so it may be called from any thread.
+	 *
+	 * @return The thumbnail, which the caller frees and deletes, or nullptr
+	 *         if there is none.
+	 */
+	static Graphics::Surface *loadDeferredThumbnail(Common::InSaveFile *thumbnailFile);
+
 	/**
 	 * Return the name of the save file for the given slot and optional target,
 	 * or a pattern for matching filenames against.
@@ -564,6 +591,15 @@ public:
 	 * Read the extended savegame header from the given savegame file.
 	 */
 	WARN_UNUSED_RESULT static bool readSavegameHeader(Common::InSaveFile *in, ExtendedSavegameHeader *header, bool skipThumbnail = true);
+
+private:
+	/**
+	 * Whether querySaveMetaInfosDeferringThumbnail() is running, in which
+	 * case the default querySaveMetaInfos() hands over its save file instead
+	 * of loading the thumbnail.
+	 */
+	mutable bool _deferThumbnail;
+	mutable Common::InSaveFile *_deferredThumbnailFile;
 };
 
 /**
@@ -30,6 +30,7 @@ struct Point;
 }
 
 class BlendBlitUnfilteredTestSuite;
+class CrossBlitTestSuite;
 
 namespace Graphics {
 
@@ -250,6 +251,84 @@ bool setAlpha(byte *dst, const byte *src,
               const Graphics::PixelFormat &format,
               const bool skipTransparent, const uint8 alpha);
 
+// This is a class so that we can declare certain things as private
+class ConvertBlit {
+public:
+	/** Shifts and masks for converting pixels between two formats, per channel in the order A, R, G, B. */
+	struct Args {
+		uint srcBpp, dstBpp;
+		uint32 srcMask[4];
+		uint srcShift[4];
+		uint expandLeft[4], expandRight[4];  ///< Expand a channel to 8 bits by (c << expandLeft) | (c >> expandRight)
+		uint dstLoss[4], dstShift[4];
+		uint32 alphaFill;                    ///< 0xFF if the source has no alpha channel
+
+		Args(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+	};
+
+	/** Convert one pixel, in the same way as PixelFormat::colorToARGB and PixelFormat::ARGBToColor do. */
+	static inline uint32 convertPixel(uint32 color, const Args &args) {
+		uint32 out = 0;
+		for (int c = 0; c < 4; c++) {
+			const uint32 value = (color >> args.srcShift[c]) & args.srcMask[c];
+			uint32 expanded = (value << args.expandLeft[c]) | (value >> args.expandRight[c]);
+			if (c == 0)
+				expanded |= args.alphaFill;
+			out |= (expanded >> args.dstLoss[c]) << args.dstShift[c];
+		}
+		return out;
+	}
+
+	/**
+	 * Return true if convert() handles conversions between these formats:
+	 * 16 and 32 bpp formats with channels of 4 to 8 bits.
+	 */
+	static bool canConvert(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+
+	/** Same as crossBlit(), for formats accepted by canConvert(). */
+	static void convert(byte *dst, const byte *src,
+				const uint dstPitch, const uint srcPitch,
+				const uint w, const uint h,
+				const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+
+	/** Same as crossBlitMap(), for a bytesPerPixel of 2 or 4. */
+	static void map(byte *dst, const byte *src,
+				const uint dstPitch, const uint srcPitch,
+				const uint w, const uint h,
+				const uint bytesPerPixel, const uint32 *map);
+
+private:
+	// Rows are converted from right to left if the destination is wider than the source,
+	// and from left to right otherwise, so a surface can be converted in place.
+	typedef void(*ConvertFunc)(byte *dst, const byte *src, const uint w, const Args &args);
+	typedef void(*MapFunc)(byte *dst, const byte *src, const uint w, const uint32 *map);
+
+#ifdef SCUMMVM_NEON
+	static void convertNEON(byte *dst, const byte *src, const uint w, const Args &args);
+	static void map16NEON(byte *dst, const byte *src, const uint w, const uint32 *map);
+	static void map32NEON(byte *dst, const byte *src, const uint w, const uint32 *map);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void convertSSE2(byte *dst, const byte *src, const uint w, const Args &args);
+	static void map16SSE2(byte *dst, const byte *src, const uint w, const uint32 *map);
+	static void map32SSE2(byte *dst, const byte *src, const uint w, const uint32 *map);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void convertAVX2(byte *dst, const byte *src, const uint w, const Args &args);
+	static void map16AVX2(byte *dst, const byte *src, const uint w, const uint32 *map);
+	static void map32AVX2(byte *dst, const byte *src, const uint w, const uint32 *map);
+#endif
+	static void convertGeneric(byte *dst, const byte *src, const uint w, const Args &args);
+	static void map16Generic(byte *dst, const byte *src, const uint w, const uint32 *map);
+	static void map32Generic(byte *dst, const byte *src, const uint w, const uint32 *map);
+	static void init();
+
+	static ConvertFunc convertFunc;
+	static MapFunc map16Func;
+	static MapFunc map32Func;
+	friend class ::CrossBlitTestSuite;
+}; // End of class ConvertBlit
+
 // This is a class so that we can declare certain things as private
 class BlendBlit {
 private:
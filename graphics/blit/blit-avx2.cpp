@@ -305,6 +305,100 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+namespace {
+
+// The shift counts of ConvertBlit::Args, ready for the AVX2 shift instructions
+struct ConvertShifts_AVX2 {
+	__m256i srcMask[4], alphaFill;
+	__m128i srcShift[4], expandLeft[4], expandRight[4], dstLoss[4], dstShift[4];
+
+	ConvertShifts_AVX2(const ConvertBlit::Args &args) {
+		for (int c = 0; c < 4; c++) {
+			srcMask[c] = _mm256_set1_epi32(args.srcMask[c]);
+			srcShift[c] = _mm_cvtsi32_si128(args.srcShift[c]);
+			expandLeft[c] = _mm_cvtsi32_si128(args.expandLeft[c]);
+			expandRight[c] = _mm_cvtsi32_si128(args.expandRight[c]);
+			dstLoss[c] = _mm_cvtsi32_si128(args.dstLoss[c]);
+			dstShift[c] = _mm_cvtsi32_si128(args.dstShift[c]);
+		}
+		alphaFill = _mm256_set1_epi32(args.alphaFill);
+	}
+};
+
+// Same as ConvertBlit::convertPixel, for eight pixels
+static FORCEINLINE __m256i convertPixels_AVX2(__m256i src, const ConvertShifts_AVX2 &shifts) {
+	__m256i out = _mm256_setzero_si256();
+	for (int c = 0; c < 4; c++) {
+		const __m256i value = _mm256_and_si256(_mm256_srl_epi32(src, shifts.srcShift[c]), shifts.srcMask[c]);
+		__m256i expanded = _mm256_or_si256(_mm256_sll_epi32(value, shifts.expandLeft[c]), _mm256_srl_epi32(value, shifts.expandRight[c]));
+		if (c == 0)
+			expanded = _mm256_or_si256(expanded, shifts.alphaFill);
+		out = _mm256_or_si256(out, _mm256_sll_epi32(_mm256_srl_epi32(expanded, shifts.dstLoss[c]), shifts.dstShift[c]));
+	}
+	return out;
+}
+
+static FORCEINLINE __m256i loadPixels_AVX2(const byte *src, uint bpp) {
+	if (bpp == 2)
+		return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+	return _mm256_loadu_si256((const __m256i *)src);
+}
+
+static FORCEINLINE void storePixels_AVX2(byte *dst, uint bpp, __m256i pixels) {
+	if (bpp == 2) {
+		// Pack the low halves, and then move them out of the two 128 bit lanes
+		pixels = _mm256_packus_epi32(_mm256_and_si256(pixels, _mm256_set1_epi32(0xFFFF)), _mm256_setzero_si256());
+		_mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(_mm256_permute4x64_epi64(pixels, _MM_SHUFFLE(3, 1, 2, 0))));
+	} else {
+		_mm256_storeu_si256((__m256i *)dst, pixels);
+	}
+}
+
+static FORCEINLINE __m256i lookupPixels_AVX2(const byte *src, const uint32 *map) {
+	const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+	return _mm256_i32gather_epi32((const int *)map, indices, 4);
+}
+
+} // End of anonymous namespace
+
+void ConvertBlit::convertAVX2(byte *dst, const byte *src, const uint w, const Args &args) {
+	const ConvertShifts_AVX2 shifts(args);
+
+	if (args.dstBpp > args.srcBpp) {
+		// Going from right to left, the odd pixels are at the start of the row
+		const uint head = w & 7;
+		for (uint x = w; x > head;) {
+			x -= 8;
+			storePixels_AVX2(dst + x * 4, 4, convertPixels_AVX2(loadPixels_AVX2(src + x * 2, 2), shifts));
+		}
+		convertGeneric(dst, src, head, args);
+		return;
+	}
+
+	uint x = 0;
+	for (; x + 8 <= w; x += 8)
+		storePixels_AVX2(dst + x * args.dstBpp, args.dstBpp, convertPixels_AVX2(loadPixels_AVX2(src + x * args.srcBpp, args.srcBpp), shifts));
+	convertGeneric(dst + x * args.dstBpp, src + x * args.srcBpp, w - x, args);
+}
+
+void ConvertBlit::map16AVX2(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	const uint head = w & 7;
+	for (uint x = w; x > head;) {
+		x -= 8;
+		storePixels_AVX2(dst + x * 2, 2, lookupPixels_AVX2(src + x, map));
+	}
+	map16Generic(dst, src, head, map);
+}
+
+void ConvertBlit::map32AVX2(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	const uint head = w & 7;
+	for (uint x = w; x > head;) {
+		x -= 8;
+		storePixels_AVX2(dst + x * 4, 4, lookupPixels_AVX2(src + x, map));
+	}
+	map32Generic(dst, src, head, map);
+}
+
 } // End of namespace Graphics
 
 #ifdef __GNUC__
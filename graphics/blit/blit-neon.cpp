@@ -308,6 +308,103 @@ void BlendBlit::blitNEON(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_NEON>(args, blendMode, alphaType);
 }
 
+namespace {
+
+// The shift counts of ConvertBlit::Args, negated for right shifts by vshlq_u32
+struct ConvertShifts_NEON {
+	uint32x4_t srcMask[4], alphaFill;
+	int32x4_t srcShift[4], expandLeft[4], expandRight[4], dstLoss[4], dstShift[4];
+
+	ConvertShifts_NEON(const ConvertBlit::Args &args) {
+		for (int c = 0; c < 4; c++) {
+			srcMask[c] = vdupq_n_u32(args.srcMask[c]);
+			srcShift[c] = vdupq_n_s32(-(int)args.srcShift[c]);
+			expandLeft[c] = vdupq_n_s32(args.expandLeft[c]);
+			expandRight[c] = vdupq_n_s32(-(int)args.expandRight[c]);
+			dstLoss[c] = vdupq_n_s32(-(int)args.dstLoss[c]);
+			dstShift[c] = vdupq_n_s32(args.dstShift[c]);
+		}
+		alphaFill = vdupq_n_u32(args.alphaFill);
+	}
+};
+
+// Same as ConvertBlit::convertPixel, for four pixels
+static inline uint32x4_t convertPixels_NEON(uint32x4_t src, const ConvertShifts_NEON &shifts) {
+	uint32x4_t out = vdupq_n_u32(0);
+	for (int c = 0; c < 4; c++) {
+		const uint32x4_t value = vandq_u32(vshlq_u32(src, shifts.srcShift[c]), shifts.srcMask[c]);
+		uint32x4_t expanded = vorrq_u32(vshlq_u32(value, shifts.expandLeft[c]), vshlq_u32(value, shifts.expandRight[c]));
+		if (c == 0)
+			expanded = vorrq_u32(expanded, shifts.alphaFill);
+		out = vorrq_u32(out, vshlq_u32(vshlq_u32(expanded, shifts.dstLoss[c]), shifts.dstShift[c]));
+	}
+	return out;
+}
+
+static inline uint32x4_t loadPixels_NEON(const byte *src, uint bpp) {
+	if (bpp == 2)
+		return vmovl_u16(vld1_u16((const uint16 *)src));
+	return vld1q_u32((const uint32 *)src);
+}
+
+static inline void storePixels_NEON(byte *dst, uint bpp, uint32x4_t pixels) {
+	if (bpp == 2)
+		vst1_u16((uint16 *)dst, vmovn_u32(pixels));
+	else
+		vst1q_u32((uint32 *)dst, pixels);
+}
+
+} // End of anonymous namespace
+
+void ConvertBlit::convertNEON(byte *dst, const byte *src, const uint w, const Args &args) {
+	const ConvertShifts_NEON shifts(args);
+
+	if (args.dstBpp > args.srcBpp) {
+		// Going from right to left, the odd pixels are at the start of the row
+		const uint head = w & 3;
+		for (uint x = w; x > head;) {
+			x -= 4;
+			storePixels_NEON(dst + x * 4, 4, convertPixels_NEON(loadPixels_NEON(src + x * 2, 2), shifts));
+		}
+		convertGeneric(dst, src, head, args);
+		return;
+	}
+
+	uint x = 0;
+	for (; x + 4 <= w; x += 4)
+		storePixels_NEON(dst + x * args.dstBpp, args.dstBpp, convertPixels_NEON(loadPixels_NEON(src + x * args.srcBpp, args.srcBpp), shifts));
+	convertGeneric(dst + x * args.dstBpp, src + x * args.srcBpp, w - x, args);
+}
+
+// NEON has no gather instruction, so the lookups are scalar and only the stores are combined
+void ConvertBlit::map16NEON(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	const uint head = w & 3;
+	for (uint x = w; x > head;) {
+		x -= 4;
+		const byte *s = src + x;
+		uint32x4_t pixels = vdupq_n_u32(map[s[0]]);
+		pixels = vsetq_lane_u32(map[s[1]], pixels, 1);
+		pixels = vsetq_lane_u32(map[s[2]], pixels, 2);
+		pixels = vsetq_lane_u32(map[s[3]], pixels, 3);
+		storePixels_NEON(dst + x * 2, 2, pixels);
+	}
+	map16Generic(dst, src, head, map);
+}
+
+void ConvertBlit::map32NEON(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	const uint head = w & 3;
+	for (uint x = w; x > head;) {
+		x -= 4;
+		const byte *s = src + x;
+		uint32x4_t pixels = vdupq_n_u32(map[s[0]]);
+		pixels = vsetq_lane_u32(map[s[1]], pixels, 1);
+		pixels = vsetq_lane_u32(map[s[2]], pixels, 2);
+		pixels = vsetq_lane_u32(map[s[3]], pixels, 3);
+		storePixels_NEON(dst + x * 4, 4, pixels);
+	}
+	map32Generic(dst, src, head, map);
+}
+
 } // end of namespace Graphics
 
 #ifdef __GNUC__
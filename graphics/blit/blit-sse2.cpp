@@ -311,6 +311,100 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+namespace {
+
+// The shift counts of ConvertBlit::Args, ready for the SSE2 shift instructions
+struct ConvertShifts_SSE2 {
+	__m128i srcMask[4], srcShift[4], expandLeft[4], expandRight[4], dstLoss[4], dstShift[4];
+	__m128i alphaFill;
+
+	ConvertShifts_SSE2(const ConvertBlit::Args &args) {
+		for (int c = 0; c < 4; c++) {
+			srcMask[c] = _mm_set1_epi32(args.srcMask[c]);
+			srcShift[c] = _mm_cvtsi32_si128(args.srcShift[c]);
+			expandLeft[c] = _mm_cvtsi32_si128(args.expandLeft[c]);
+			expandRight[c] = _mm_cvtsi32_si128(args.expandRight[c]);
+			dstLoss[c] = _mm_cvtsi32_si128(args.dstLoss[c]);
+			dstShift[c] = _mm_cvtsi32_si128(args.dstShift[c]);
+		}
+		alphaFill = _mm_set1_epi32(args.alphaFill);
+	}
+};
+
+// Same as ConvertBlit::convertPixel, for four pixels
+static FORCEINLINE __m128i convertPixels_SSE2(__m128i src, const ConvertShifts_SSE2 &shifts) {
+	__m128i out = _mm_setzero_si128();
+	for (int c = 0; c < 4; c++) {
+		const __m128i value = _mm_and_si128(_mm_srl_epi32(src, shifts.srcShift[c]), shifts.srcMask[c]);
+		__m128i expanded = _mm_or_si128(_mm_sll_epi32(value, shifts.expandLeft[c]), _mm_srl_epi32(value, shifts.expandRight[c]));
+		if (c == 0)
+			expanded = _mm_or_si128(expanded, shifts.alphaFill);
+		out = _mm_or_si128(out, _mm_sll_epi32(_mm_srl_epi32(expanded, shifts.dstLoss[c]), shifts.dstShift[c]));
+	}
+	return out;
+}
+
+static FORCEINLINE __m128i loadPixels_SSE2(const byte *src, uint bpp) {
+	if (bpp == 2)
+		return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+static FORCEINLINE void storePixels_SSE2(byte *dst, uint bpp, __m128i pixels) {
+	if (bpp == 2) {
+		// Sign extend the low halves, so packing them does not saturate
+		pixels = _mm_srai_epi32(_mm_slli_epi32(pixels, 16), 16);
+		_mm_storel_epi64((__m128i *)dst, _mm_packs_epi32(pixels, pixels));
+	} else {
+		_mm_storeu_si128((__m128i *)dst, pixels);
+	}
+}
+
+} // End of anonymous namespace
+
+void ConvertBlit::convertSSE2(byte *dst, const byte *src, const uint w, const Args &args) {
+	const ConvertShifts_SSE2 shifts(args);
+
+	if (args.dstBpp > args.srcBpp) {
+		// Going from right to left, the odd pixels are at the start of the row
+		const uint head = w & 3;
+		for (uint x = w; x > head;) {
+			x -= 4;
+			storePixels_SSE2(dst + x * 4, 4, convertPixels_SSE2(loadPixels_SSE2(src + x * 2, 2), shifts));
+		}
+		convertGeneric(dst, src, head, args);
+		return;
+	}
+
+	uint x = 0;
+	for (; x + 4 <= w; x += 4)
+		storePixels_SSE2(dst + x * args.dstBpp, args.dstBpp, convertPixels_SSE2(loadPixels_SSE2(src + x * args.srcBpp, args.srcBpp), shifts));
+	convertGeneric(dst + x * args.dstBpp, src + x * args.srcBpp, w - x, args);
+}
+
+// SSE2 has no gather instruction, so the lookups are scalar and only the stores are combined
+void ConvertBlit::map16SSE2(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	const uint head = w & 7;
+	for (uint x = w; x > head;) {
+		x -= 8;
+		const byte *s = src + x;
+		const __m128i pixels = _mm_setr_epi16(map[s[0]], map[s[1]], map[s[2]], map[s[3]],
+		                                      map[s[4]], map[s[5]], map[s[6]], map[s[7]]);
+		_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+	}
+	map16Generic(dst, src, head, map);
+}
+
+void ConvertBlit::map32SSE2(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	const uint head = w & 3;
+	for (uint x = w; x > head;) {
+		x -= 4;
+		const byte *s = src + x;
+		_mm_storeu_si128((__m128i *)(dst + x * 4), _mm_setr_epi32(map[s[0]], map[s[1]], map[s[2]], map[s[3]]));
+	}
+	map32Generic(dst, src, head, map);
+}
+
 } // End of namespace Graphics
 
 #ifdef __GNUC__
@@ -22,6 +22,7 @@
 #include "graphics/blit.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -265,6 +266,131 @@ inline void crossBlitLogic1BppSource(byte *dst, const byte *src, const byte *mas
 
 } // End of anonymous namespace
 
+ConvertBlit::Args::Args(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	const uint srcBits[4]    = { srcFmt.aBits(), srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits() };
+	const uint srcShifts[4]  = { srcFmt.aShift,  srcFmt.rShift,  srcFmt.gShift,  srcFmt.bShift  };
+	const uint dstLosses[4]  = { dstFmt.aLoss,   dstFmt.rLoss,   dstFmt.gLoss,   dstFmt.bLoss   };
+	const uint dstShifts[4]  = { dstFmt.aShift,  dstFmt.rShift,  dstFmt.gShift,  dstFmt.bShift  };
+
+	srcBpp = srcFmt.bytesPerPixel;
+	dstBpp = dstFmt.bytesPerPixel;
+	for (int c = 0; c < 4; c++) {
+		srcMask[c] = (1 << srcBits[c]) - 1;
+		srcShift[c] = srcShifts[c];
+		expandLeft[c] = 8 - srcBits[c];
+		expandRight[c] = srcBits[c] ? 2 * srcBits[c] - 8 : 0;
+		dstLoss[c] = dstLosses[c];
+		dstShift[c] = dstShifts[c];
+	}
+	alphaFill = (srcBits[0] == 0) ? 0xFF : 0;
+}
+
+bool ConvertBlit::canConvert(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	if ((srcFmt.bytesPerPixel != 2 && srcFmt.bytesPerPixel != 4) ||
+	    (dstFmt.bytesPerPixel != 2 && dstFmt.bytesPerPixel != 4))
+		return false;
+
+	// Narrower channels are not expanded by replicating their bits once
+	const uint srcBits[4] = { srcFmt.aBits(), srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits() };
+	for (int c = 0; c < 4; c++) {
+		if (srcBits[c] != 0 && (srcBits[c] < 4 || srcBits[c] > 8))
+			return false;
+	}
+	return true;
+}
+
+// Initialize these to nullptr at the start
+ConvertBlit::ConvertFunc ConvertBlit::convertFunc = nullptr;
+ConvertBlit::MapFunc ConvertBlit::map16Func = nullptr;
+ConvertBlit::MapFunc ConvertBlit::map32Func = nullptr;
+
+void ConvertBlit::init() {
+	// If no functions have been selected yet, detect and select
+	if (convertFunc)
+		return;
+
+	convertFunc = convertGeneric;
+	map16Func = map16Generic;
+	map32Func = map32Generic;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		convertFunc = convertNEON;
+		map16Func = map16NEON;
+		map32Func = map32NEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		convertFunc = convertSSE2;
+		map16Func = map16SSE2;
+		map32Func = map32SSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		convertFunc = convertAVX2;
+		map16Func = map16AVX2;
+		map32Func = map32AVX2;
+	}
+#endif
+}
+
+void ConvertBlit::convert(byte *dst, const byte *src,
+						  const uint dstPitch, const uint srcPitch,
+						  const uint w, const uint h,
+						  const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	init();
+
+	const Args args(dstFmt, srcFmt);
+	if (args.dstBpp > args.srcBpp) {
+		// Rows grow when converted, so start from the bottom for in place conversions
+		for (uint y = h; y-- > 0;)
+			convertFunc(dst + y * dstPitch, src + y * srcPitch, w, args);
+	} else {
+		for (uint y = 0; y < h; y++)
+			convertFunc(dst + y * dstPitch, src + y * srcPitch, w, args);
+	}
+}
+
+void ConvertBlit::map(byte *dst, const byte *src,
+					  const uint dstPitch, const uint srcPitch,
+					  const uint w, const uint h,
+					  const uint bytesPerPixel, const uint32 *map) {
+	init();
+
+	const MapFunc mapFunc = (bytesPerPixel == 2) ? map16Func : map32Func;
+	for (uint y = h; y-- > 0;)
+		mapFunc(dst + y * dstPitch, src + y * srcPitch, w, map);
+}
+
+void ConvertBlit::convertGeneric(byte *dst, const byte *src, const uint w, const Args &args) {
+	if (args.dstBpp > args.srcBpp) {
+		for (uint x = w; x-- > 0;)
+			*(uint32 *)(dst + x * 4) = convertPixel(*(const uint16 *)(src + x * 2), args);
+		return;
+	}
+
+	for (uint x = 0; x < w; x++) {
+		const uint32 color = (args.srcBpp == 2) ? *(const uint16 *)src : *(const uint32 *)src;
+		if (args.dstBpp == 2)
+			*(uint16 *)dst = convertPixel(color, args);
+		else
+			*(uint32 *)dst = convertPixel(color, args);
+		src += args.srcBpp;
+		dst += args.dstBpp;
+	}
+}
+
+void ConvertBlit::map16Generic(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	for (uint x = w; x-- > 0;)
+		((uint16 *)dst)[x] = map[src[x]];
+}
+
+void ConvertBlit::map32Generic(byte *dst, const byte *src, const uint w, const uint32 *map) {
+	for (uint x = w; x-- > 0;)
+		((uint32 *)dst)[x] = map[src[x]];
+}
+
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src,
 			   const uint dstPitch, const uint srcPitch,
@@ -281,6 +407,12 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	// Use the vectorized conversion for the common formats
+	if (ConvertBlit::canConvert(dstFmt, srcFmt)) {
+		ConvertBlit::convert(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt);
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -491,21 +623,18 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if (!bytesPerPixel)
 		return false;
 
+	// Use the vectorized conversion for the common formats
+	if (bytesPerPixel == 2 || bytesPerPixel == 4) {
+		ConvertBlit::map(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, map);
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
 
 	if (bytesPerPixel == 1) {
 		crossBlitLogic1BppSource<uint8, 1, false, false, false>(dst, src, nullptr, w, h, srcDelta, dstDelta, 0, map, 0);
-	} else if (bytesPerPixel == 2) {
-		// We need to blit the surface from bottom right to top left here.
-		// This is neeeded, because when we convert to the same memory
-		// buffer copying the surface from top left to bottom right would
-		// overwrite the source, since we have more bits per destination
-		// color than per source color.
-		dst += h * dstPitch - dstDelta - bytesPerPixel;
-		src += h * srcPitch - srcDelta - 1;
-		crossBlitLogic1BppSource<uint16, 2, true, false, false>(dst, src, nullptr, w, h, srcDelta, dstDelta, 0, map, 0);
 	} else if (bytesPerPixel == 3) {
 		// We need to blit the surface from bottom right to top left here.
 		// This is needed, because when we convert to the same memory
@@ -515,15 +644,6 @@ bool crossBlitMap(byte *dst, const byte *src,
 		dst += h * dstPitch - dstDelta - bytesPerPixel;
 		src += h * srcPitch - srcDelta - 1;
 		crossBlitLogic1BppSource<uint8, 3, true, false, false>(dst, src, nullptr, w, h, srcDelta, dstDelta, 0, map, 0);
-	} else if (bytesPerPixel == 4) {
-		// We need to blit the surface from bottom right to top left here.
-		// This is needed, because when we convert to the same memory
-		// buffer copying the surface from top left to bottom right would
-		// overwrite the source, since we have more bits per destination
-		// color than per source color.
-		dst += h * dstPitch - dstDelta - bytesPerPixel;
-		src += h * srcPitch - srcDelta - 1;
-		crossBlitLogic1BppSource<uint32, 4, true, false, false>(dst, src, nullptr, w, h, srcDelta, dstDelta, 0, map, 0);
 	} else {
 		return false;
 	}
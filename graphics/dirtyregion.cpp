@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/dirtyregion.h"
+
+namespace Graphics {
+
+namespace {
+int area(const Common::Rect &r) {
+	return r.width() * r.height();
+}
+} // End of anonymous namespace
+
+DirtyRegion::DirtyRegion() : _width(0), _height(0), _tileColumns(0), _tileRows(0), _tiled(false) {
+}
+
+void DirtyRegion::setSize(int16 width, int16 height) {
+	if (width == _width && height == _height)
+		return;
+
+	_width = width;
+	_height = height;
+	_tileColumns = (width + kTileSize - 1) / kTileSize;
+	_tileRows = (height + kTileSize - 1) / kTileSize;
+
+	if (_tiled) {
+		// The old tiles cannot be mapped to the new ones
+		_tiles.clear();
+		_tiles.resize(_tileColumns * _tileRows, 1);
+	}
+}
+
+void DirtyRegion::add(const Common::Rect &r) {
+	Common::Rect rect = r.findIntersectingRect(Common::Rect(_width, _height));
+	if (rect.isEmpty())
+		return;
+
+	if (_tiled) {
+		markTiles(rect);
+		return;
+	}
+
+	// Drop rects which are covered by the new one, and merge it with rects
+	// where the bounding box costs no more than the two of them. Since
+	// merging grows the new rect, start over after each merge.
+	for (uint i = 0; i < _rects.size(); ) {
+		const Common::Rect &other = _rects[i];
+		if (other.contains(rect))
+			return;
+
+		Common::Rect bounds = other;
+		bounds.extend(rect);
+		if (area(bounds) <= area(other) + area(rect)) {
+			rect = bounds;
+			_rects[i] = _rects.back();
+			_rects.pop_back();
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	_rects.push_back(rect);
+	if (_rects.size() > kMaxRects)
+		switchToTiles();
+}
+
+void DirtyRegion::clear() {
+	_rects.clear();
+	_tiles.clear();
+	_tiled = false;
+}
+
+const Common::Array<Common::Rect> &DirtyRegion::getRects() {
+	if (!_tiled)
+		return _rects;
+
+	// Emit the runs of dirty tiles in each row, extending the rect of the
+	// row above when it spans the same columns
+	_rects.clear();
+	uint firstOpen = 0;
+	for (int row = 0; row < _tileRows; row++) {
+		const byte *tiles = &_tiles[row * _tileColumns];
+		const int16 top = row * kTileSize;
+		const int16 bottom = MIN<int>(top + kTileSize, _height);
+		const uint rowStart = _rects.size();
+
+		for (int column = 0; column < _tileColumns; ) {
+			if (!tiles[column]) {
+				column++;
+				continue;
+			}
+
+			const int first = column;
+			while (column < _tileColumns && tiles[column])
+				column++;
+
+			const int16 left = first * kTileSize;
+			const int16 right = MIN<int>(column * kTileSize, _width);
+
+			bool extended = false;
+			for (uint i = firstOpen; i < rowStart; i++) {
+				Common::Rect &open = _rects[i];
+				if (open.left == left && open.right == right && open.bottom == top) {
+					open.bottom = bottom;
+					extended = true;
+					break;
+				}
+			}
+
+			if (!extended)
+				_rects.push_back(Common::Rect(left, top, right, bottom));
+		}
+
+		// Rects which ended before this row cannot be extended any more.
+		// The ones extended into this row are kept open by moving them
+		// to the front of the open range.
+		for (uint i = firstOpen; i < rowStart; i++) {
+			if (_rects[i].bottom != bottom) {
+				SWAP(_rects[i], _rects[firstOpen]);
+				firstOpen++;
+			}
+		}
+	}
+
+	return _rects;
+}
+
+void DirtyRegion::switchToTiles() {
+	_tiled = true;
+	_tiles.clear();
+	_tiles.resize(_tileColumns * _tileRows, 0);
+
+	for (uint i = 0; i < _rects.size(); i++)
+		markTiles(_rects[i]);
+	_rects.clear();
+}
+
+void DirtyRegion::markTiles(const Common::Rect &r) {
+	const int left = r.left / kTileSize;
+	const int right = (r.right + kTileSize - 1) / kTileSize;
+	const int top = r.top / kTileSize;
+	const int bottom = (r.bottom + kTileSize - 1) / kTileSize;
+
+	for (int row = top; row < bottom; row++)
+		memset(&_tiles[row * _tileColumns + left], 1, right - left);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_DIRTYREGION_H
+#define GRAPHICS_DIRTYREGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirtyregion Dirty region
+ * @ingroup graphics
+ *
+ * @brief Collection of the areas of a screen which need to be redrawn.
+ *
+ * @{
+ */
+
+/**
+ * Collects dirty rects and coalesces them into a list of rects to redraw.
+ *
+ * Up to kMaxRects rects are kept as they are. A new rect is merged with a
+ * kept one when their bounding box is no larger than the two of them, so
+ * redrawing it costs no more than redrawing both. Beyond kMaxRects the
+ * region switches to a bitmap of kTileSize sized tiles, which bounds the
+ * overdraw of busy frames by the tiles they touch instead of falling back
+ * to the whole screen.
+ */
+class DirtyRegion {
+public:
+	/** Number of rects kept before switching to tiles. */
+	static const uint kMaxRects = 100;
+	/** Width and height of a tile. */
+	static const int kTileSize = 16;
+
+	DirtyRegion();
+
+	/**
+	 * Set the size of the screen, which all rects are clipped to. If this
+	 * changes the size while tiles are in use, the whole screen is dirty.
+	 */
+	void setSize(int16 width, int16 height);
+
+	/** Mark @p r as dirty. */
+	void add(const Common::Rect &r);
+
+	/** Mark the whole screen as clean. */
+	void clear();
+
+	/** Return true if nothing is dirty. */
+	bool empty() const { return !_tiled && _rects.empty(); }
+
+	/** Return true if the region has switched to tiles. */
+	bool isTiled() const { return _tiled; }
+
+	/**
+	 * Return a list of rects which together cover everything marked as
+	 * dirty since the last clear. The list stays valid until the region
+	 * is changed.
+	 */
+	const Common::Array<Common::Rect> &getRects();
+
+private:
+	void switchToTiles();
+	void markTiles(const Common::Rect &r);
+
+	int16 _width, _height;
+	int _tileColumns, _tileRows;
+	bool _tiled;
+
+	/** The kept rects, or the tile rects built by getRects. */
+	Common::Array<Common::Rect> _rects;
+	/** One entry per tile, non-zero if it is dirty. */
+	Common::Array<byte> _tiles;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
@@ -7,6 +7,7 @@ MODULE_OBJS := \
 	blit/blit-generic.o \
 	blit/blit-scale.o \
 	cursorman.o \
+	dirtyregion.o \
 	font.o \
 	fontman.o \
 	fonts/amigafont.o \
@@ -46,6 +47,7 @@ MODULE_OBJS := \
 	pixelformat.o \
 	pm5544.o \
 	primitives.o \
+	rendercache.o \
 	renderer.o \
 	scalerplugin.o \
 	scaler/downscaler.o \
@@ -91,9 +93,23 @@ MODULE_OBJS += \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/zspan-avx2.o
+endif
 endif
 
 ifdef USE_ASPECT
@@ -111,6 +127,19 @@ MODULE_OBJS += \
 	scaler/scalebit.o \
 	scaler/tv.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	scaler/scalebit-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/scalebit-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	scaler/scalebit-avx2.o
+endif
+
 ifdef USE_ARM_SCALER_ASM
 MODULE_OBJS += \
 	scaler/scale2xARM.o \
@@ -121,6 +150,19 @@ ifdef USE_HQ_SCALERS
 MODULE_OBJS += \
 	scaler/hq.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	scaler/hq-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/hq-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	scaler/hq-avx2.o
+endif
+
 ifdef USE_NASM
 MODULE_OBJS += \
 	scaler/hq2x_i386.o \
@@ -143,15 +185,18 @@ endif
 
 ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	blit/blit-neon.o
+	blit/blit-neon.o \
+	yuv_to_rgb-neon.o
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	blit/blit-sse2.o \
+	yuv_to_rgb-sse2.o
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
-	blit/blit-avx2.o
+	blit/blit-avx2.o \
+	yuv_to_rgb-avx2.o
 endif
 
 # Include common rules
@@ -67,6 +67,7 @@ void Context::reset() {
 	packedPixelsSupported = false;
 	packedDepthStencilSupported = false;
 	unpackSubImageSupported = false;
+	pixelBufferObjectSupported = false;
 	OESDepth24 = false;
 	textureEdgeClampSupported = false;
 	textureBorderClampSupported = false;
@@ -233,6 +234,8 @@ void Context::initialize(ContextType contextType) {
 		textureEdgeClampSupported = true;
 		// No border clamping in GLES2
 		textureMirrorRepeatSupported = true;
+		// GLES3 adds pixel buffer objects and buffer range mapping
+		pixelBufferObjectSupported = (majorVersion >= 3);
 		// TODO: textureMaxLevelSupported with GLES3
 		debug(5, "OpenGL: GLES2 context initialized");
 	} else if (type == kContextGLES) {
@@ -276,6 +279,10 @@ void Context::initialize(ContextType contextType) {
 		if (isGLVersionOrHigher(1, 4)) {
 			textureMirrorRepeatSupported = true;
 		}
+		// OpenGL 3.0 adds buffer range mapping, pixel buffer objects are there since 2.1
+		if (isGLVersionOrHigher(3, 0)) {
+			pixelBufferObjectSupported = true;
+		}
 		debug(5, "OpenGL: GL context initialized");
 	} else {
 		warning("OpenGL: Unknown context initialized");
@@ -301,6 +308,7 @@ void Context::initialize(ContextType contextType) {
 	debug(5, "OpenGL: Packed pixels support: %d", packedPixelsSupported);
 	debug(5, "OpenGL: Packed depth stencil support: %d", packedDepthStencilSupported);
 	debug(5, "OpenGL: Unpack subimage support: %d", unpackSubImageSupported);
+	debug(5, "OpenGL: Pixel buffer object support: %d", pixelBufferObjectSupported);
 	debug(5, "OpenGL: OpenGL ES depth 24 support: %d", OESDepth24);
 	debug(5, "OpenGL: Texture edge clamping support: %d", textureEdgeClampSupported);
 	debug(5, "OpenGL: Texture border clamping support: %d", textureBorderClampSupported);
@@ -0,0 +1,144 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/rendercache.h"
+
+namespace Graphics {
+
+namespace {
+
+bool equalContents(const Surface &surface, const Surface &dst, const Common::Rect &bounds) {
+	const uint lineSize = bounds.width() * dst.format.bytesPerPixel;
+	for (int y = 0; y < bounds.height(); ++y) {
+		if (memcmp(surface.getBasePtr(0, y), dst.getBasePtr(bounds.left, bounds.top + y), lineSize))
+			return false;
+	}
+	return true;
+}
+
+void copyContents(Surface &surface, const Surface &src, const Common::Rect &bounds) {
+	if (surface.w != bounds.width() || surface.h != bounds.height() || surface.format != src.format) {
+		surface.free();
+		surface.create(bounds.width(), bounds.height(), src.format);
+	}
+	surface.copyRectToSurface(src, 0, 0, bounds);
+}
+
+} // End of anonymous namespace
+
+RenderCacheKey::RenderCacheKey(uint32 id_, uint32 param_, const Common::Rect &bounds, const Common::Rect &area_)
+	: id(id_), param(param_), width(bounds.width()), height(bounds.height()),
+	  area(area_), parity((bounds.left & 1) | ((bounds.top & 1) << 1)) {
+	area.translate(-bounds.left, -bounds.top);
+}
+
+bool RenderCacheKey::operator==(const RenderCacheKey &key) const {
+	return id == key.id && param == key.param && width == key.width && height == key.height
+	    && area == key.area && parity == key.parity;
+}
+
+uint RenderCache::KeyHash::operator()(const RenderCacheKey &key) const {
+	uint hash = key.id;
+	hash = hash * 31 + key.param;
+	hash = hash * 31 + (key.width | (key.height << 16));
+	hash = hash * 31 + (key.area.left | (key.area.top << 16));
+	hash = hash * 31 + (key.area.right | (key.area.bottom << 16));
+	return hash * 31 + key.parity;
+}
+
+RenderCache::RenderCache(uint maxBytes) : _maxBytes(maxBytes), _bytes(0), _useCounter(0) {
+}
+
+RenderCache::~RenderCache() {
+	clear();
+}
+
+bool RenderCache::lookUp(const RenderCacheKey &key, Surface &dst, const Common::Rect &bounds) {
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end())
+		return false;
+
+	Entry *entry = i->_value;
+	if (entry->before.format != dst.format || !equalContents(entry->before, dst, bounds)) {
+		++entry->misses;
+		return false;
+	}
+
+	dst.copyRectToSurface(entry->after, bounds.left, bounds.top, Common::Rect(bounds.width(), bounds.height()));
+	entry->lastUse = ++_useCounter;
+	entry->misses = 0;
+	return true;
+}
+
+bool RenderCache::wantsStore(const RenderCacheKey &key) const {
+	EntryMap::const_iterator i = _entries.find(key);
+	return i == _entries.end() || i->_value->misses < kMaxMisses;
+}
+
+void RenderCache::store(const RenderCacheKey &key, const Surface &before, const Surface &dst, const Common::Rect &bounds) {
+	const uint entryBytes = 2 * bounds.width() * bounds.height() * dst.format.bytesPerPixel;
+	if (entryBytes > _maxBytes)
+		return;
+
+	Entry *&entry = _entries.getOrCreateVal(key);
+	if (entry) {
+		_bytes -= entry->before.pitch * entry->before.h + entry->after.pitch * entry->after.h;
+	} else {
+		entry = new Entry();
+		entry->misses = 0;
+	}
+
+	copyContents(entry->before, before, Common::Rect(bounds.width(), bounds.height()));
+	copyContents(entry->after, dst, bounds);
+	entry->lastUse = ++_useCounter;
+	_bytes += entry->before.pitch * entry->before.h + entry->after.pitch * entry->after.h;
+
+	while (_bytes > _maxBytes)
+		removeLeastRecentlyUsed();
+}
+
+void RenderCache::clear() {
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		i->_value->before.free();
+		i->_value->after.free();
+		delete i->_value;
+	}
+	_entries.clear();
+	_bytes = 0;
+}
+
+void RenderCache::removeLeastRecentlyUsed() {
+	EntryMap::iterator oldest = _entries.begin();
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (i->_value->lastUse < oldest->_value->lastUse)
+			oldest = i;
+	}
+
+	Entry *entry = oldest->_value;
+	_bytes -= entry->before.pitch * entry->before.h + entry->after.pitch * entry->after.h;
+	entry->before.free();
+	entry->after.free();
+	delete entry;
+	_entries.erase(oldest);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,144 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_RENDERCACHE_H
+#define GRAPHICS_RENDERCACHE_H
+
+#include "common/hashmap.h"
+#include "common/noncopyable.h"
+#include "common/rect.h"
+
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_rendercache Render cache
+ * @ingroup graphics
+ *
+ * @brief Cache for the results of expensive drawing operations.
+ *
+ * @{
+ */
+
+/**
+ * Identifies what was drawn into a rect, independently of where the rect is.
+ */
+struct RenderCacheKey {
+	/**
+	 * @param id      What is drawn, e.g. the type of a widget.
+	 * @param param   Extra parameter of the drawing.
+	 * @param bounds  Rect which the drawing modifies.
+	 * @param area    Rect which is drawn in, usually inside of @p bounds.
+	 */
+	RenderCacheKey(uint32 id, uint32 param, const Common::Rect &bounds, const Common::Rect &area);
+
+	uint32 id;
+	uint32 param;
+	int16 width;        ///< Width of the bounds
+	int16 height;       ///< Height of the bounds
+	Common::Rect area;  ///< Area relative to the top left corner of the bounds
+	byte parity;        ///< Parity of the bounds position, for dithered drawing
+
+	bool operator==(const RenderCacheKey &key) const;
+};
+
+/**
+ * Cache of rendered rects.
+ *
+ * Each entry holds the contents of a rect before and after something was
+ * drawn into it. Drawing the same thing onto the same contents again,
+ * anywhere on the surface, gives the same result, which can then be copied
+ * instead of being drawn. Since the contents before drawing are compared,
+ * blending and anti-aliasing are reproduced exactly.
+ *
+ * Keys which keep missing because they are drawn onto changing contents are
+ * not stored again until they hit, so they only cost the comparison.
+ */
+class RenderCache : Common::NonCopyable {
+public:
+	/** Default limit of the memory used by the entries. */
+	static const uint kDefaultMaxBytes = 4 * 1024 * 1024;
+	/** Number of misses in a row after which a key is not stored again. */
+	static const uint kMaxMisses = 4;
+
+	explicit RenderCache(uint maxBytes = kDefaultMaxBytes);
+	~RenderCache();
+
+	/**
+	 * Copy the cached result for @p key into @p bounds of @p dst, if there
+	 * is one for the current contents of @p bounds.
+	 *
+	 * @return true if the result was copied.
+	 */
+	bool lookUp(const RenderCacheKey &key, Surface &dst, const Common::Rect &bounds);
+
+	/**
+	 * Return true if the result of drawing @p key should be stored.
+	 */
+	bool wantsStore(const RenderCacheKey &key) const;
+
+	/**
+	 * Store the result of drawing @p key.
+	 *
+	 * @param before  Contents of @p bounds before drawing.
+	 * @param dst     Surface which was drawn to.
+	 * @param bounds  Rect of @p dst which was drawn to.
+	 */
+	void store(const RenderCacheKey &key, const Surface &before, const Surface &dst, const Common::Rect &bounds);
+
+	/** Drop all entries, e.g. because the drawing operations changed. */
+	void clear();
+
+	/** Return the number of entries. */
+	uint size() const { return _entries.size(); }
+
+	/** Return the memory used by the entries. */
+	uint getBytes() const { return _bytes; }
+
+private:
+	struct Entry {
+		Surface before;
+		Surface after;
+		uint32 lastUse;
+		uint misses;
+	};
+
+	struct KeyHash {
+		uint operator()(const RenderCacheKey &key) const;
+	};
+
+	typedef Common::HashMap<RenderCacheKey, Entry *, KeyHash> EntryMap;
+
+	void removeLeastRecentlyUsed();
+
+	EntryMap _entries;
+	uint _maxBytes;
+	uint _bytes;
+	uint32 _useCounter;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
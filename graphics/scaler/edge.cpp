@@ -3530,12 +3530,41 @@ void EdgeScaler::initTables(const uint8 *srcPtr, uint32 srcPitch,
 	}
 }
 
-EdgeScaler::EdgeScaler(const Graphics::PixelFormat &format) : SourceScaler(format) {
+EdgeScaler::EdgeScaler(const Graphics::PixelFormat &format) : SourceScaler(format), _tables(new Tables()) {
 	_factor = 2;
+	_rgbTable = _tables->rgb;
+	_greyscaleTable = _tables->greyscale;
 
 	initTables(0, 0, 0, 0);
 }
 
+EdgeScaler::EdgeScaler(const Graphics::PixelFormat &format, const Common::SharedPtr<Tables> &tables) : SourceScaler(format), _tables(tables) {
+	_factor = 2;
+	_rgbTable = _tables->rgb;
+	_greyscaleTable = _tables->greyscale;
+}
+
+EdgeScaler::~EdgeScaler() {
+	for (uint i = 0; i < _bandScalers.size(); i++)
+		delete _bandScalers[i];
+}
+
+void EdgeScaler::prepareBands(uint count) {
+	// The edge detection keeps its state in members, so each band needs
+	// a scaler of its own
+	while (_bandScalers.size() + 1 < count)
+		_bandScalers.push_back(new EdgeScaler(_format, _tables));
+
+	for (uint i = 0; i < _bandScalers.size(); i++)
+		_bandScalers[i]->_factor = _factor;
+}
+
+void EdgeScaler::internScaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch,
+					   uint8 *dstPtr, uint32 dstPitch, const uint8 *oldSrcPtr, uint32 oldSrcPitch, int width, int height, const uint8 *buffer, uint32 bufferPitch) {
+	EdgeScaler *scaler = band ? _bandScalers[band - 1] : this;
+	scaler->internScale(srcPtr, srcPitch, dstPtr, dstPitch, oldSrcPtr, oldSrcPitch, width, height, buffer, bufferPitch);
+}
+
 #if 0
 void EdgeScaler::scale(const uint8 *srcPtr, uint32 srcPitch,
 					   uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
@@ -21,17 +21,27 @@
 #ifndef GRAPHICS_SCALER_EDGE_H
 #define GRAPHICS_SCALER_EDGE_H
 
+#include "common/array.h"
+#include "common/ptr.h"
 #include "graphics/scalerplugin.h"
 
 class EdgeScaler : public SourceScaler {
 public:
 
 	EdgeScaler(const Graphics::PixelFormat &format);
+	~EdgeScaler();
 	uint increaseFactor() override;
 	uint decreaseFactor() override;
 
 protected:
 
+	void prepareBands(uint count) override;
+
+	void internScaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch,
+						 uint8 *dstPtr, uint32 dstPitch,
+						 const uint8 *oldSrcPtr, uint32 oldSrcPitch,
+						 int width, int height, const uint8 *buffer, uint32 bufferPitch) override;
+
 	virtual void internScale(const uint8 *srcPtr, uint32 srcPitch,
 						   uint8 *dstPtr, uint32 dstPitch,
 						   const uint8 *oldSrcPtr, uint32 oldSrcPitch,
@@ -39,6 +49,18 @@ protected:
 
 private:
 
+	/** Lookup tables, shared with the scalers of the other bands. */
+	struct Tables {
+		int16 rgb[65536][3];       ///< table lookup for RGB
+		int16 greyscale[3][65536]; ///< greyscale tables
+	};
+
+	/**
+	 * Create a scaler for an additional band, using the tables of the
+	 * scaler which splits the rect.
+	 */
+	EdgeScaler(const Graphics::PixelFormat &format, const Common::SharedPtr<Tables> &tables);
+
 	/**
 	 * Choose greyscale bitplane to use, return diff array.  Exit early and
 	 * return NULL for a block of solid color (all diffs zero).
@@ -160,8 +182,10 @@ private:
 		const uint8* oldSrc, int oldPitch,
 		const uint8 *buffer, int bufferPitch);
 
-	int16 _rgbTable[65536][3];       ///< table lookup for RGB
-	int16 _greyscaleTable[3][65536]; ///< greyscale tables
+	Common::SharedPtr<Tables> _tables;
+	int16 (*_rgbTable)[3];                 ///< table lookup for RGB
+	int16 (*_greyscaleTable)[65536];       ///< greyscale tables
+	Common::Array<EdgeScaler *> _bandScalers; ///< scalers for the bands below the first one
 	int16 *_chosenGreyscale;               ///< pointer to chosen greyscale table
 	int16 *_bptr;                          ///< too awkward to pass variables
 	int8 _simSum;                          ///< sum of similarity matrix
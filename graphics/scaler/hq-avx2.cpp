@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+/**
+ * Return @p bit in the lanes where the YUV values differ by more than the
+ * thresholds of diffYUV(). Y, U and V are single bytes, so their absolute
+ * differences exceed the thresholds when they survive subtracting them.
+ */
+static FORCEINLINE __m256i diffYUV_AVX2(__m256i yuv, const uint32 *other, int bit) {
+	const __m256i thresholds = _mm256_set1_epi32(0xFF300706);
+	const __m256i b = _mm256_loadu_si256((const __m256i *)other);
+	const __m256i diff = _mm256_or_si256(_mm256_subs_epu8(yuv, b), _mm256_subs_epu8(b, yuv));
+	const __m256i same = _mm256_cmpeq_epi32(_mm256_subs_epu8(diff, thresholds), _mm256_setzero_si256());
+	return _mm256_andnot_si256(same, _mm256_set1_epi32(bit));
+}
+
+static FORCEINLINE __m256i pattern_AVX2(const uint32 *above, const uint32 *row, const uint32 *below) {
+	const __m256i yuv = _mm256_loadu_si256((const __m256i *)row);
+	__m256i pattern = diffYUV_AVX2(yuv, above - 1, 0x01);
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, above, 0x02));
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, above + 1, 0x04));
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, row - 1, 0x08));
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, row + 1, 0x10));
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, below - 1, 0x20));
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, below, 0x40));
+	pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv, below + 1, 0x80));
+	return pattern;
+}
+
+void HQPatterns::computeAVX2(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count) {
+	uint x = 0;
+	for (; x + 16 <= count; x += 16) {
+		const __m256i lo = pattern_AVX2(above + x, row + x, below + x);
+		const __m256i hi = pattern_AVX2(above + x + 8, row + x + 8, below + x + 8);
+		// Packing works within 128 bit lanes, so restore the order in between
+		const __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+		_mm_storeu_si128((__m128i *)(dst + x), bytes);
+	}
+
+	computeGeneric(dst + x, above + x, row + x, below + x, count - x);
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,80 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/scaler/hq.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+/**
+ * Return @p bit in the lanes where the YUV values differ by more than the
+ * thresholds of diffYUV(). Y, U and V are single bytes, so their absolute
+ * differences exceed the thresholds when they survive subtracting them.
+ */
+static FORCEINLINE uint32x4_t diffYUV_NEON(uint32x4_t yuv, const uint32 *other, uint32 bit) {
+	const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(0xFF300706));
+	const uint8x16_t diff = vabdq_u8(vreinterpretq_u8_u32(yuv), vreinterpretq_u8_u32(vld1q_u32(other)));
+	const uint32x4_t same = vceqq_u32(vreinterpretq_u32_u8(vqsubq_u8(diff, thresholds)), vdupq_n_u32(0));
+	return vbicq_u32(vdupq_n_u32(bit), same);
+}
+
+static FORCEINLINE uint16x4_t pattern_NEON(const uint32 *above, const uint32 *row, const uint32 *below) {
+	const uint32x4_t yuv = vld1q_u32(row);
+	uint32x4_t pattern = diffYUV_NEON(yuv, above - 1, 0x01);
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, above, 0x02));
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, above + 1, 0x04));
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, row - 1, 0x08));
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, row + 1, 0x10));
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, below - 1, 0x20));
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, below, 0x40));
+	pattern = vorrq_u32(pattern, diffYUV_NEON(yuv, below + 1, 0x80));
+	return vmovn_u32(pattern);
+}
+
+void HQPatterns::computeNEON(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count) {
+	uint x = 0;
+	for (; x + 8 <= count; x += 8) {
+		const uint16x4_t lo = pattern_NEON(above + x, row + x, below + x);
+		const uint16x4_t hi = pattern_NEON(above + x + 4, row + x + 4, below + x + 4);
+		vst1_u8(dst + x, vmovn_u16(vcombine_u16(lo, hi)));
+	}
+
+	computeGeneric(dst + x, above + x, row + x, below + x, count - x);
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
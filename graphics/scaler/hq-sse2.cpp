@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/hq.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+/**
+ * Return @p bit in the lanes where the YUV values differ by more than the
+ * thresholds of diffYUV(). Y, U and V are single bytes, so their absolute
+ * differences exceed the thresholds when they survive subtracting them.
+ */
+static FORCEINLINE __m128i diffYUV_SSE2(__m128i yuv, const uint32 *other, int bit) {
+	const __m128i thresholds = _mm_set1_epi32(0xFF300706);
+	const __m128i b = _mm_loadu_si128((const __m128i *)other);
+	const __m128i diff = _mm_or_si128(_mm_subs_epu8(yuv, b), _mm_subs_epu8(b, yuv));
+	const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(diff, thresholds), _mm_setzero_si128());
+	return _mm_andnot_si128(same, _mm_set1_epi32(bit));
+}
+
+static FORCEINLINE __m128i pattern_SSE2(const uint32 *above, const uint32 *row, const uint32 *below) {
+	const __m128i yuv = _mm_loadu_si128((const __m128i *)row);
+	__m128i pattern = diffYUV_SSE2(yuv, above - 1, 0x01);
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, above, 0x02));
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, above + 1, 0x04));
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, row - 1, 0x08));
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, row + 1, 0x10));
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, below - 1, 0x20));
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, below, 0x40));
+	pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv, below + 1, 0x80));
+	return pattern;
+}
+
+void HQPatterns::computeSSE2(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count) {
+	uint x = 0;
+	for (; x + 8 <= count; x += 8) {
+		const __m128i lo = pattern_SSE2(above + x, row + x, below + x);
+		const __m128i hi = pattern_SSE2(above + x + 4, row + x + 4, below + x + 4);
+		_mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128()));
+	}
+
+	computeGeneric(dst + x, above + x, row + x, below + x, count - x);
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -17,6 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include "common/system.h"
 
 #include "graphics/scaler/hq.h"
 #include "graphics/scaler.h"
@@ -173,7 +174,7 @@ void HQScaler::initLUT(Graphics::PixelFormat format) {
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate_2_3_3(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate_14_1_1(w5, w6, w8);
 
-#define YUV(x)	(sizeof(Pixel) == 2 ? RGBtoYUV[w ## x] : ConvertYUV<ColorMask>(w ## x, RGBtoYUV))
+#define YUV(x)	yuv ## x
 
 /**
  * Convert 32 bit RGB values to Yuv
@@ -193,13 +194,61 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Convert a row of pixels to YUV, so that every pixel is converted only once.
+ */
+template<typename ColorMask>
+static inline void convertRowToYUV(uint32 *dst, const typename ColorMask::PixelType *src, int count, const uint32 *RGBtoYUV) {
+	for (int i = 0; i < count; i++)
+		dst[i] = (sizeof(src[i]) == 2) ? RGBtoYUV[src[i]] : ConvertYUV<ColorMask>(src[i], RGBtoYUV);
+}
+
+// Initialize this to nullptr at the start
+HQPatterns::PatternFunc HQPatterns::patternFunc = nullptr;
+
+void HQPatterns::init() {
+	// If no function has been selected yet, detect and select
+	if (patternFunc)
+		return;
+
+	patternFunc = computeGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		patternFunc = computeNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		patternFunc = computeSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		patternFunc = computeAVX2;
+#endif
+}
+
+void HQPatterns::computeGeneric(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count) {
+	for (int x = 0; x < (int)count; x++) {
+		const int yuv5 = row[x];
+		int pattern = 0;
+		if (diffYUV(yuv5, above[x - 1])) pattern |= 0x0001;
+		if (diffYUV(yuv5, above[x]))     pattern |= 0x0002;
+		if (diffYUV(yuv5, above[x + 1])) pattern |= 0x0004;
+		if (diffYUV(yuv5, row[x - 1]))   pattern |= 0x0008;
+		if (diffYUV(yuv5, row[x + 1]))   pattern |= 0x0010;
+		if (diffYUV(yuv5, below[x - 1])) pattern |= 0x0020;
+		if (diffYUV(yuv5, below[x]))     pattern |= 0x0040;
+		if (diffYUV(yuv5, below[x + 1])) pattern |= 0x0080;
+		dst[x] = pattern;
+	}
+}
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (https://web.archive.org/web/20090204033742/http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, uint32 *yuvRows, uint8 *patterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,7 +270,21 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// The YUV values of the rows above, at and below the current one,
+	// each including the pixels to the left and right of the rect
+	uint32 *yuvLines[3] = { yuvRows + 1, yuvRows + 1 + (width + 2), yuvRows + 1 + 2 * (width + 2) };
+	convertRowToYUV<ColorMask>(yuvLines[0] - 1, p - 1 - nextlineSrc, width + 2, RGBtoYUV);
+	convertRowToYUV<ColorMask>(yuvLines[1] - 1, p - 1, width + 2, RGBtoYUV);
+
 	while (height--) {
+		convertRowToYUV<ColorMask>(yuvLines[2] - 1, p - 1 + nextlineSrc, width + 2, RGBtoYUV);
+		HQPatterns::compute(patterns, yuvLines[0], yuvLines[1], yuvLines[2], width);
+
+		const uint32 *yuvAbove = yuvLines[0];
+		const uint32 *yuvRow = yuvLines[1];
+		const uint32 *yuvBelow = yuvLines[2];
+		const uint8 *patternRow = patterns;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -238,16 +301,14 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *patternRow++;
+			const int yuv2 = yuvAbove[0];
+			const int yuv4 = yuvRow[-1];
+			const int yuv6 = yuvRow[1];
+			const int yuv8 = yuvBelow[0];
+			yuvAbove++;
+			yuvRow++;
+			yuvBelow++;
 
 			switch (pattern) {
 			case 0:
@@ -2053,6 +2114,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 2;
+
+		uint32 *yuvFirst = yuvLines[0];
+		yuvLines[0] = yuvLines[1];
+		yuvLines[1] = yuvLines[2];
+		yuvLines[2] = yuvFirst;
 	}
 }
 
@@ -2116,7 +2182,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV, uint32 *yuvRows, uint8 *patterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,7 +2205,21 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	// The YUV values of the rows above, at and below the current one,
+	// each including the pixels to the left and right of the rect
+	uint32 *yuvLines[3] = { yuvRows + 1, yuvRows + 1 + (width + 2), yuvRows + 1 + 2 * (width + 2) };
+	convertRowToYUV<ColorMask>(yuvLines[0] - 1, p - 1 - nextlineSrc, width + 2, RGBtoYUV);
+	convertRowToYUV<ColorMask>(yuvLines[1] - 1, p - 1, width + 2, RGBtoYUV);
+
 	while (height--) {
+		convertRowToYUV<ColorMask>(yuvLines[2] - 1, p - 1 + nextlineSrc, width + 2, RGBtoYUV);
+		HQPatterns::compute(patterns, yuvLines[0], yuvLines[1], yuvLines[2], width);
+
+		const uint32 *yuvAbove = yuvLines[0];
+		const uint32 *yuvRow = yuvLines[1];
+		const uint32 *yuvBelow = yuvLines[2];
+		const uint8 *patternRow = patterns;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2156,16 +2236,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *patternRow++;
+			const int yuv2 = yuvAbove[0];
+			const int yuv4 = yuvRow[-1];
+			const int yuv6 = yuvRow[1];
+			const int yuv8 = yuvBelow[0];
+			yuvAbove++;
+			yuvRow++;
+			yuvBelow++;
 
 			switch (pattern) {
 			case 0:
@@ -4944,6 +5022,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		}
 		p += nextlineSrc - width;
 		q += (nextlineDst - width) * 3;
+
+		uint32 *yuvFirst = yuvLines[0];
+		yuvLines[0] = yuvLines[1];
+		yuvLines[1] = yuvLines[2];
+		yuvLines[2] = yuvFirst;
 	}
 }
 
@@ -4953,6 +5036,9 @@ HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 #endif
 	_RGBtoYUV(nullptr) {
 	_factor = 2;
+	_scratch.resize(1);
+
+	HQPatterns::init();
 
 	if (format.bytesPerPixel == 2) {
 		initLUT(format);
@@ -4976,83 +5062,104 @@ HQScaler::~HQScaler() {
 }
 
 #ifdef USE_NASM
-void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch) {
 	hq2x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch, _hqx_params);
 }
 
-void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch) {
 	hq3x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch, _hqx_params);
 }
 #else
-void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 }
 
-void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 }
 #endif
 
-void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch) {
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ2x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 		} else {
 			HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 	}
 }
 
-void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch) {
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ3x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 		} else {
 			HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, scratch.yuvRows.data(), scratch.patterns.data());
 	}
 }
 
 void HQScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	scaleRect(_scratch[0], srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+}
+
+void HQScaler::prepareBands(uint count) {
+	if (_scratch.size() < count)
+		_scratch.resize(count);
+}
+
+void HQScaler::scaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+						 uint32 dstPitch, int width, int height, int x, int y) {
+	scaleRect(_scratch[band], srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+}
+
+void HQScaler::scaleRect(Scratch &scratch, const uint8 *srcPtr, uint32 srcPitch,
+						 uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	// The scratch only grows, so scaling does not allocate once the widest rect was seen
+	if (scratch.patterns.size() < (uint)width) {
+		scratch.yuvRows.resize(3 * (width + 2));
+		scratch.patterns.resize(width);
+	}
+
 	if (_format.bytesPerPixel == 2) {
 		switch (_factor) {
 		case 2:
-			HQ2x16(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+			HQ2x16(srcPtr, srcPitch, dstPtr, dstPitch, width, height, scratch);
 			break;
 		case 3:
-			HQ3x16(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+			HQ3x16(srcPtr, srcPitch, dstPtr, dstPitch, width, height, scratch);
 			break;
 		}
 	} else {
 		switch (_factor) {
 		case 2:
-			HQ2x32(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+			HQ2x32(srcPtr, srcPitch, dstPtr, dstPitch, width, height, scratch);
 			break;
 		case 3:
-			HQ3x32(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+			HQ3x32(srcPtr, srcPitch, dstPtr, dstPitch, width, height, scratch);
 			break;
 		}
 	}
@@ -21,12 +21,54 @@
 #ifndef GRAPHICS_SCALER_HQ_H
 #define GRAPHICS_SCALER_HQ_H
 
+#include "common/array.h"
 #include "graphics/scalerplugin.h"
 
 #ifdef USE_NASM
 struct hqx_parameters;
 #endif
 
+class ScalerTestSuite;
+
+/**
+ * Computes the neighbour patterns the HQ scalers select their
+ * interpolation from, a whole row of pixels at a time.
+ */
+class HQPatterns {
+public:
+	/**
+	 * Compute the patterns of @p count pixels from three rows of packed YUV
+	 * values. Bit n of a pattern is set when neighbour n + 1 (numbered
+	 * w1 to w9 left to right and top to bottom, skipping the centre w5)
+	 * differs noticeably from the pixel. All three rows must be readable
+	 * one entry before and after the @p count pixels.
+	 */
+	static void compute(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count) {
+		patternFunc(dst, above, row, below, count);
+	}
+
+	/** Select the fastest implementation supported by the CPU. */
+	static void init();
+
+private:
+	typedef void (*PatternFunc)(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count);
+
+	static void computeGeneric(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count);
+#ifdef SCUMMVM_NEON
+	static void computeNEON(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void computeSSE2(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void computeAVX2(uint8 *dst, const uint32 *above, const uint32 *row, const uint32 *below, uint count);
+#endif
+
+	static PatternFunc patternFunc;
+
+	friend class ::ScalerTestSuite;
+};
+
 class HQScaler : public Scaler {
 public:
 	HQScaler(const Graphics::PixelFormat &format);
@@ -37,13 +79,28 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) override;
 
+	void prepareBands(uint count) override;
+	void scaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+				   uint32 dstPitch, int width, int height, int x, int y) override;
+
+	/** Rows of YUV values and the patterns detected in them, used while scaling a rect. */
+	struct Scratch {
+		Common::Array<uint32> yuvRows;
+		Common::Array<uint8> patterns;
+	};
+
+	void scaleRect(Scratch &scratch, const uint8 *srcPtr, uint32 srcPitch,
+				   uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
 	void initLUT(Graphics::PixelFormat format);
-	inline void HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
-	inline void HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
-	inline void HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
-	inline void HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
+	inline void HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch);
+	inline void HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch);
+	inline void HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch);
+	inline void HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, Scratch &scratch);
 
 	uint32 *_RGBtoYUV;
+	/** Scratch for each band of a rect, the first one is also used when the rect is not split. */
+	Common::Array<Scratch> _scratch;
 #ifdef USE_NASM
 	hqx_parameters *_hqx_params;
 #endif
@@ -0,0 +1,209 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+static FORCEINLINE __m256i scale_load_avx2(const void *src) {
+	return _mm256_loadu_si256((const __m256i *)src);
+}
+
+static FORCEINLINE __m256i scale_select_avx2(__m256i mask, __m256i a, __m256i b) {
+	return _mm256_blendv_epi8(b, a, mask);
+}
+
+/**
+ * Interleave three vectors of 32 bit pixels, a0 b0 c0 a1 b1 c1 ...
+ */
+static FORCEINLINE void scale_interleave3_avx2(__m256i a, __m256i b, __m256i c, __m256i &o0, __m256i &o1, __m256i &o2) {
+	// Every output picks its pixels from the same positions in a, b and c
+	const __m256i idx0 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+	const __m256i idx1 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+	const __m256i idx2 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+
+	o0 = _mm256_permutevar8x32_epi32(a, idx0);
+	o0 = _mm256_blend_epi32(o0, _mm256_permutevar8x32_epi32(b, idx0), 0x92);
+	o0 = _mm256_blend_epi32(o0, _mm256_permutevar8x32_epi32(c, idx0), 0x24);
+	o1 = _mm256_permutevar8x32_epi32(a, idx1);
+	o1 = _mm256_blend_epi32(o1, _mm256_permutevar8x32_epi32(b, idx1), 0x24);
+	o1 = _mm256_blend_epi32(o1, _mm256_permutevar8x32_epi32(c, idx1), 0x49);
+	o2 = _mm256_permutevar8x32_epi32(a, idx2);
+	o2 = _mm256_blend_epi32(o2, _mm256_permutevar8x32_epi32(b, idx2), 0x49);
+	o2 = _mm256_blend_epi32(o2, _mm256_permutevar8x32_epi32(c, idx2), 0x92);
+}
+
+template<typename T>
+struct ScaleLanes_AVX2;
+
+template<>
+struct ScaleLanes_AVX2<scale2x_uint16> {
+	enum { kCount = 16 };
+
+	static FORCEINLINE __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); }
+
+	static FORCEINLINE void store2(scale2x_uint16 *dst, __m256i a, __m256i b) {
+		const __m256i lo = _mm256_unpacklo_epi16(a, b);
+		const __m256i hi = _mm256_unpackhi_epi16(a, b);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	static FORCEINLINE __m256i pack(__m256i a, __m256i b) {
+		return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+	}
+
+	static FORCEINLINE void store3(scale2x_uint16 *dst, __m256i a, __m256i b, __m256i c) {
+		// Interleave as sign extended 32 bit values, which pack back without saturating
+		__m256i lo0, lo1, lo2, hi0, hi1, hi2;
+		scale_interleave3_avx2(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(a)),
+		                       _mm256_cvtepi16_epi32(_mm256_castsi256_si128(b)),
+		                       _mm256_cvtepi16_epi32(_mm256_castsi256_si128(c)), lo0, lo1, lo2);
+		scale_interleave3_avx2(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(a, 1)),
+		                       _mm256_cvtepi16_epi32(_mm256_extracti128_si256(b, 1)),
+		                       _mm256_cvtepi16_epi32(_mm256_extracti128_si256(c, 1)), hi0, hi1, hi2);
+		_mm256_storeu_si256((__m256i *)dst, pack(lo0, lo1));
+		_mm256_storeu_si256((__m256i *)(dst + 16), pack(lo2, hi0));
+		_mm256_storeu_si256((__m256i *)(dst + 32), pack(hi1, hi2));
+	}
+};
+
+template<>
+struct ScaleLanes_AVX2<scale2x_uint32> {
+	enum { kCount = 8 };
+
+	static FORCEINLINE __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+
+	static FORCEINLINE void store2(scale2x_uint32 *dst, __m256i a, __m256i b) {
+		const __m256i lo = _mm256_unpacklo_epi32(a, b);
+		const __m256i hi = _mm256_unpackhi_epi32(a, b);
+		_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	static FORCEINLINE void store3(scale2x_uint32 *dst, __m256i a, __m256i b, __m256i c) {
+		__m256i o0, o1, o2;
+		scale_interleave3_avx2(a, b, c, o0, o1, o2);
+		_mm256_storeu_si256((__m256i *)dst, o0);
+		_mm256_storeu_si256((__m256i *)(dst + 8), o1);
+		_mm256_storeu_si256((__m256i *)(dst + 16), o2);
+	}
+};
+
+/**
+ * Scale2x on both output rows at once, leaving the remaining pixels to the C implementation.
+ */
+template<typename T>
+static inline void scale2x_avx2(T *dst0, T *dst1, const T *src0, const T *src1, const T *src2, unsigned count,
+                                void (*tail)(T *, T *, const T *, const T *, const T *, unsigned)) {
+	typedef ScaleLanes_AVX2<T> Lanes;
+
+	unsigned i = 0;
+	for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+		const __m256i a = scale_load_avx2(src0 + i);
+		const __m256i c = scale_load_avx2(src2 + i);
+		const __m256i l = scale_load_avx2(src1 + i - 1);
+		const __m256i e = scale_load_avx2(src1 + i);
+		const __m256i r = scale_load_avx2(src1 + i + 1);
+
+		// Pixels whose opposite neighbours match keep their own colour
+		const __m256i flat = _mm256_or_si256(Lanes::cmpeq(a, c), Lanes::cmpeq(l, r));
+
+		Lanes::store2(dst0 + 2 * i,
+		              scale_select_avx2(_mm256_andnot_si256(flat, Lanes::cmpeq(l, a)), a, e),
+		              scale_select_avx2(_mm256_andnot_si256(flat, Lanes::cmpeq(r, a)), a, e));
+		Lanes::store2(dst1 + 2 * i,
+		              scale_select_avx2(_mm256_andnot_si256(flat, Lanes::cmpeq(l, c)), c, e),
+		              scale_select_avx2(_mm256_andnot_si256(flat, Lanes::cmpeq(r, c)), c, e));
+	}
+
+	tail(dst0 + 2 * i, dst1 + 2 * i, src0 + i, src1 + i, src2 + i, count - i);
+}
+
+/**
+ * Scale3x on all three output rows at once, leaving the remaining pixels to the C implementation.
+ */
+template<typename T>
+static inline void scale3x_avx2(T *dst0, T *dst1, T *dst2, const T *src0, const T *src1, const T *src2, unsigned count,
+                                void (*tail)(T *, T *, T *, const T *, const T *, const T *, unsigned)) {
+	typedef ScaleLanes_AVX2<T> Lanes;
+
+	unsigned i = 0;
+	for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+		const __m256i am = scale_load_avx2(src0 + i - 1);
+		const __m256i a = scale_load_avx2(src0 + i);
+		const __m256i ap = scale_load_avx2(src0 + i + 1);
+		const __m256i cm = scale_load_avx2(src2 + i - 1);
+		const __m256i c = scale_load_avx2(src2 + i);
+		const __m256i cp = scale_load_avx2(src2 + i + 1);
+		const __m256i l = scale_load_avx2(src1 + i - 1);
+		const __m256i e = scale_load_avx2(src1 + i);
+		const __m256i r = scale_load_avx2(src1 + i + 1);
+
+		// Pixels whose opposite neighbours match keep their own colour
+		const __m256i flat = _mm256_or_si256(Lanes::cmpeq(a, c), Lanes::cmpeq(l, r));
+		const __m256i la = _mm256_andnot_si256(flat, Lanes::cmpeq(l, a));
+		const __m256i ra = _mm256_andnot_si256(flat, Lanes::cmpeq(r, a));
+		const __m256i lc = _mm256_andnot_si256(flat, Lanes::cmpeq(l, c));
+		const __m256i rc = _mm256_andnot_si256(flat, Lanes::cmpeq(r, c));
+
+		const __m256i top = _mm256_or_si256(_mm256_andnot_si256(Lanes::cmpeq(e, ap), la), _mm256_andnot_si256(Lanes::cmpeq(e, am), ra));
+		Lanes::store3(dst0 + 3 * i, scale_select_avx2(la, l, e), scale_select_avx2(top, a, e), scale_select_avx2(ra, r, e));
+
+		const __m256i left = _mm256_or_si256(_mm256_andnot_si256(Lanes::cmpeq(e, cm), la), _mm256_andnot_si256(Lanes::cmpeq(e, am), lc));
+		const __m256i right = _mm256_or_si256(_mm256_andnot_si256(Lanes::cmpeq(e, cp), ra), _mm256_andnot_si256(Lanes::cmpeq(e, ap), rc));
+		Lanes::store3(dst1 + 3 * i, scale_select_avx2(left, l, e), e, scale_select_avx2(right, r, e));
+
+		const __m256i bottom = _mm256_or_si256(_mm256_andnot_si256(Lanes::cmpeq(e, cp), lc), _mm256_andnot_si256(Lanes::cmpeq(e, cm), rc));
+		Lanes::store3(dst2 + 3 * i, scale_select_avx2(lc, l, e), scale_select_avx2(bottom, c, e), scale_select_avx2(rc, r, e));
+	}
+
+	tail(dst0 + 3 * i, dst1 + 3 * i, dst2 + 3 * i, src0 + i, src1 + i, src2 + i, count - i);
+}
+
+void scale2x_16_avx2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_avx2(dst0, dst1, src0, src1, src2, count, scale2x_16_def);
+}
+
+void scale2x_32_avx2(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count) {
+	scale2x_avx2(dst0, dst1, src0, src1, src2, count, scale2x_32_def);
+}
+
+void scale3x_16_avx2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_avx2(dst0, dst1, dst2, src0, src1, src2, count, scale3x_16_def);
+}
+
+void scale3x_32_avx2(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count) {
+	scale3x_avx2(dst0, dst1, dst2, src0, src1, src2, count, scale3x_32_def);
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+template<typename T>
+struct ScaleLanes_NEON;
+
+template<>
+struct ScaleLanes_NEON<scale2x_uint16> {
+	typedef uint16x8_t Vec;
+	enum { kCount = 8 };
+
+	static FORCEINLINE Vec load(const scale2x_uint16 *src) { return vld1q_u16(src); }
+	static FORCEINLINE Vec cmpeq(Vec a, Vec b) { return vceqq_u16(a, b); }
+	static FORCEINLINE Vec orr(Vec a, Vec b) { return vorrq_u16(a, b); }
+	static FORCEINLINE Vec andnot(Vec mask, Vec a) { return vbicq_u16(a, mask); }
+	static FORCEINLINE Vec select(Vec mask, Vec a, Vec b) { return vbslq_u16(mask, a, b); }
+
+	static FORCEINLINE void store2(scale2x_uint16 *dst, Vec a, Vec b) {
+		uint16x8x2_t v = { { a, b } };
+		vst2q_u16(dst, v);
+	}
+
+	static FORCEINLINE void store3(scale2x_uint16 *dst, Vec a, Vec b, Vec c) {
+		uint16x8x3_t v = { { a, b, c } };
+		vst3q_u16(dst, v);
+	}
+};
+
+template<>
+struct ScaleLanes_NEON<scale2x_uint32> {
+	typedef uint32x4_t Vec;
+	enum { kCount = 4 };
+
+	static FORCEINLINE Vec load(const scale2x_uint32 *src) { return vld1q_u32(src); }
+	static FORCEINLINE Vec cmpeq(Vec a, Vec b) { return vceqq_u32(a, b); }
+	static FORCEINLINE Vec orr(Vec a, Vec b) { return vorrq_u32(a, b); }
+	static FORCEINLINE Vec andnot(Vec mask, Vec a) { return vbicq_u32(a, mask); }
+	static FORCEINLINE Vec select(Vec mask, Vec a, Vec b) { return vbslq_u32(mask, a, b); }
+
+	static FORCEINLINE void store2(scale2x_uint32 *dst, Vec a, Vec b) {
+		uint32x4x2_t v = { { a, b } };
+		vst2q_u32(dst, v);
+	}
+
+	static FORCEINLINE void store3(scale2x_uint32 *dst, Vec a, Vec b, Vec c) {
+		uint32x4x3_t v = { { a, b, c } };
+		vst3q_u32(dst, v);
+	}
+};
+
+/**
+ * Scale2x on both output rows at once, leaving the remaining pixels to the C implementation.
+ */
+template<typename T>
+static inline void scale2x_neon(T *dst0, T *dst1, const T *src0, const T *src1, const T *src2, unsigned count,
+                                void (*tail)(T *, T *, const T *, const T *, const T *, unsigned)) {
+	typedef ScaleLanes_NEON<T> Lanes;
+	typedef typename Lanes::Vec Vec;
+
+	unsigned i = 0;
+	for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+		const Vec a = Lanes::load(src0 + i);
+		const Vec c = Lanes::load(src2 + i);
+		const Vec l = Lanes::load(src1 + i - 1);
+		const Vec e = Lanes::load(src1 + i);
+		const Vec r = Lanes::load(src1 + i + 1);
+
+		// Pixels whose opposite neighbours match keep their own colour
+		const Vec flat = Lanes::orr(Lanes::cmpeq(a, c), Lanes::cmpeq(l, r));
+
+		Lanes::store2(dst0 + 2 * i,
+		              Lanes::select(Lanes::andnot(flat, Lanes::cmpeq(l, a)), a, e),
+		              Lanes::select(Lanes::andnot(flat, Lanes::cmpeq(r, a)), a, e));
+		Lanes::store2(dst1 + 2 * i,
+		              Lanes::select(Lanes::andnot(flat, Lanes::cmpeq(l, c)), c, e),
+		              Lanes::select(Lanes::andnot(flat, Lanes::cmpeq(r, c)), c, e));
+	}
+
+	tail(dst0 + 2 * i, dst1 + 2 * i, src0 + i, src1 + i, src2 + i, count - i);
+}
+
+/**
+ * Scale3x on all three output rows at once, leaving the remaining pixels to the C implementation.
+ */
+template<typename T>
+static inline void scale3x_neon(T *dst0, T *dst1, T *dst2, const T *src0, const T *src1, const T *src2, unsigned count,
+                                void (*tail)(T *, T *, T *, const T *, const T *, const T *, unsigned)) {
+	typedef ScaleLanes_NEON<T> Lanes;
+	typedef typename Lanes::Vec Vec;
+
+	unsigned i = 0;
+	for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+		const Vec am = Lanes::load(src0 + i - 1);
+		const Vec a = Lanes::load(src0 + i);
+		const Vec ap = Lanes::load(src0 + i + 1);
+		const Vec cm = Lanes::load(src2 + i - 1);
+		const Vec c = Lanes::load(src2 + i);
+		const Vec cp = Lanes::load(src2 + i + 1);
+		const Vec l = Lanes::load(src1 + i - 1);
+		const Vec e = Lanes::load(src1 + i);
+		const Vec r = Lanes::load(src1 + i + 1);
+
+		// Pixels whose opposite neighbours match keep their own colour
+		const Vec flat = Lanes::orr(Lanes::cmpeq(a, c), Lanes::cmpeq(l, r));
+		const Vec la = Lanes::andnot(flat, Lanes::cmpeq(l, a));
+		const Vec ra = Lanes::andnot(flat, Lanes::cmpeq(r, a));
+		const Vec lc = Lanes::andnot(flat, Lanes::cmpeq(l, c));
+		const Vec rc = Lanes::andnot(flat, Lanes::cmpeq(r, c));
+
+		const Vec top = Lanes::orr(Lanes::andnot(Lanes::cmpeq(e, ap), la), Lanes::andnot(Lanes::cmpeq(e, am), ra));
+		Lanes::store3(dst0 + 3 * i, Lanes::select(la, l, e), Lanes::select(top, a, e), Lanes::select(ra, r, e));
+
+		const Vec left = Lanes::orr(Lanes::andnot(Lanes::cmpeq(e, cm), la), Lanes::andnot(Lanes::cmpeq(e, am), lc));
+		const Vec right = Lanes::orr(Lanes::andnot(Lanes::cmpeq(e, cp), ra), Lanes::andnot(Lanes::cmpeq(e, ap), rc));
+		Lanes::store3(dst1 + 3 * i, Lanes::select(left, l, e), e, Lanes::select(right, r, e));
+
+		const Vec bottom = Lanes::orr(Lanes::andnot(Lanes::cmpeq(e, cp), lc), Lanes::andnot(Lanes::cmpeq(e, cm), rc));
+		Lanes::store3(dst2 + 3 * i, Lanes::select(lc, l, e), Lanes::select(bottom, c, e), Lanes::select(rc, r, e));
+	}
+
+	tail(dst0 + 3 * i, dst1 + 3 * i, dst2 + 3 * i, src0 + i, src1 + i, src2 + i, count - i);
+}
+
+void scale2x_16_neon(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_neon(dst0, dst1, src0, src1, src2, count, scale2x_16_def);
+}
+
+void scale2x_32_neon(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count) {
+	scale2x_neon(dst0, dst1, src0, src1, src2, count, scale2x_32_def);
+}
+
+void scale3x_16_neon(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_neon(dst0, dst1, dst2, src0, src1, src2, count, scale3x_16_def);
+}
+
+void scale3x_32_neon(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count) {
+	scale3x_neon(dst0, dst1, dst2, src0, src1, src2, count, scale3x_32_def);
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
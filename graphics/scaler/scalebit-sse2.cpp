@@ -0,0 +1,201 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+static FORCEINLINE __m128i scale_load_sse2(const void *src) {
+	return _mm_loadu_si128((const __m128i *)src);
+}
+
+static FORCEINLINE __m128i scale_select_sse2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/**
+ * Interleave three vectors of 32 bit pixels, a0 b0 c0 a1 b1 c1 ...
+ */
+static FORCEINLINE void scale_interleave3_sse2(__m128i a, __m128i b, __m128i c, __m128i &o0, __m128i &o1, __m128i &o2) {
+	const __m128 abLo = _mm_castsi128_ps(_mm_unpacklo_epi32(a, b)); // a0 b0 a1 b1
+	const __m128 abHi = _mm_castsi128_ps(_mm_unpackhi_epi32(a, b)); // a2 b2 a3 b3
+	const __m128 bcLo = _mm_castsi128_ps(_mm_unpacklo_epi32(b, c)); // b0 c0 b1 c1
+	const __m128 bcHi = _mm_castsi128_ps(_mm_unpackhi_epi32(b, c)); // b2 c2 b3 c3
+	const __m128 caLo = _mm_castsi128_ps(_mm_unpacklo_epi32(c, a)); // c0 a0 c1 a1
+	const __m128 caHi = _mm_castsi128_ps(_mm_unpackhi_epi32(c, a)); // c2 a2 c3 a3
+
+	o0 = _mm_castps_si128(_mm_shuffle_ps(abLo, caLo, _MM_SHUFFLE(3, 0, 1, 0)));
+	o1 = _mm_castps_si128(_mm_shuffle_ps(bcLo, abHi, _MM_SHUFFLE(1, 0, 3, 2)));
+	o2 = _mm_castps_si128(_mm_shuffle_ps(caHi, bcHi, _MM_SHUFFLE(3, 2, 3, 0)));
+}
+
+template<typename T>
+struct ScaleLanes_SSE2;
+
+template<>
+struct ScaleLanes_SSE2<scale2x_uint16> {
+	enum { kCount = 8 };
+
+	static FORCEINLINE __m128i cmpeq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+
+	static FORCEINLINE void store2(scale2x_uint16 *dst, __m128i a, __m128i b) {
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(a, b));
+		_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi16(a, b));
+	}
+
+	static FORCEINLINE void store3(scale2x_uint16 *dst, __m128i a, __m128i b, __m128i c) {
+		// Interleave as sign extended 32 bit values, which pack back without saturating
+		__m128i lo0, lo1, lo2, hi0, hi1, hi2;
+		scale_interleave3_sse2(_mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16),
+		                       _mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16),
+		                       _mm_srai_epi32(_mm_unpacklo_epi16(c, c), 16), lo0, lo1, lo2);
+		scale_interleave3_sse2(_mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16),
+		                       _mm_srai_epi32(_mm_unpackhi_epi16(b, b), 16),
+		                       _mm_srai_epi32(_mm_unpackhi_epi16(c, c), 16), hi0, hi1, hi2);
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(lo0, lo1));
+		_mm_storeu_si128((__m128i *)(dst + 8), _mm_packs_epi32(lo2, hi0));
+		_mm_storeu_si128((__m128i *)(dst + 16), _mm_packs_epi32(hi1, hi2));
+	}
+};
+
+template<>
+struct ScaleLanes_SSE2<scale2x_uint32> {
+	enum { kCount = 4 };
+
+	static FORCEINLINE __m128i cmpeq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+
+	static FORCEINLINE void store2(scale2x_uint32 *dst, __m128i a, __m128i b) {
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi32(a, b));
+		_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi32(a, b));
+	}
+
+	static FORCEINLINE void store3(scale2x_uint32 *dst, __m128i a, __m128i b, __m128i c) {
+		__m128i o0, o1, o2;
+		scale_interleave3_sse2(a, b, c, o0, o1, o2);
+		_mm_storeu_si128((__m128i *)dst, o0);
+		_mm_storeu_si128((__m128i *)(dst + 4), o1);
+		_mm_storeu_si128((__m128i *)(dst + 8), o2);
+	}
+};
+
+/**
+ * Scale2x on both output rows at once, leaving the remaining pixels to the C implementation.
+ */
+template<typename T>
+static inline void scale2x_sse2(T *dst0, T *dst1, const T *src0, const T *src1, const T *src2, unsigned count,
+                                void (*tail)(T *, T *, const T *, const T *, const T *, unsigned)) {
+	typedef ScaleLanes_SSE2<T> Lanes;
+
+	unsigned i = 0;
+	for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+		const __m128i a = scale_load_sse2(src0 + i);
+		const __m128i c = scale_load_sse2(src2 + i);
+		const __m128i l = scale_load_sse2(src1 + i - 1);
+		const __m128i e = scale_load_sse2(src1 + i);
+		const __m128i r = scale_load_sse2(src1 + i + 1);
+
+		// Pixels whose opposite neighbours match keep their own colour
+		const __m128i flat = _mm_or_si128(Lanes::cmpeq(a, c), Lanes::cmpeq(l, r));
+
+		Lanes::store2(dst0 + 2 * i,
+		              scale_select_sse2(_mm_andnot_si128(flat, Lanes::cmpeq(l, a)), a, e),
+		              scale_select_sse2(_mm_andnot_si128(flat, Lanes::cmpeq(r, a)), a, e));
+		Lanes::store2(dst1 + 2 * i,
+		              scale_select_sse2(_mm_andnot_si128(flat, Lanes::cmpeq(l, c)), c, e),
+		              scale_select_sse2(_mm_andnot_si128(flat, Lanes::cmpeq(r, c)), c, e));
+	}
+
+	tail(dst0 + 2 * i, dst1 + 2 * i, src0 + i, src1 + i, src2 + i, count - i);
+}
+
+/**
+ * Scale3x on all three output rows at once, leaving the remaining pixels to the C implementation.
+ */
+template<typename T>
+static inline void scale3x_sse2(T *dst0, T *dst1, T *dst2, const T *src0, const T *src1, const T *src2, unsigned count,
+                                void (*tail)(T *, T *, T *, const T *, const T *, const T *, unsigned)) {
+	typedef ScaleLanes_SSE2<T> Lanes;
+
+	unsigned i = 0;
+	for (; i + Lanes::kCount <= count; i += Lanes::kCount) {
+		const __m128i am = scale_load_sse2(src0 + i - 1);
+		const __m128i a = scale_load_sse2(src0 + i);
+		const __m128i ap = scale_load_sse2(src0 + i + 1);
+		const __m128i cm = scale_load_sse2(src2 + i - 1);
+		const __m128i c = scale_load_sse2(src2 + i);
+		const __m128i cp = scale_load_sse2(src2 + i + 1);
+		const __m128i l = scale_load_sse2(src1 + i - 1);
+		const __m128i e = scale_load_sse2(src1 + i);
+		const __m128i r = scale_load_sse2(src1 + i + 1);
+
+		// Pixels whose opposite neighbours match keep their own colour
+		const __m128i flat = _mm_or_si128(Lanes::cmpeq(a, c), Lanes::cmpeq(l, r));
+		const __m128i la = _mm_andnot_si128(flat, Lanes::cmpeq(l, a));
+		const __m128i ra = _mm_andnot_si128(flat, Lanes::cmpeq(r, a));
+		const __m128i lc = _mm_andnot_si128(flat, Lanes::cmpeq(l, c));
+		const __m128i rc = _mm_andnot_si128(flat, Lanes::cmpeq(r, c));
+
+		const __m128i top = _mm_or_si128(_mm_andnot_si128(Lanes::cmpeq(e, ap), la), _mm_andnot_si128(Lanes::cmpeq(e, am), ra));
+		Lanes::store3(dst0 + 3 * i, scale_select_sse2(la, l, e), scale_select_sse2(top, a, e), scale_select_sse2(ra, r, e));
+
+		const __m128i left = _mm_or_si128(_mm_andnot_si128(Lanes::cmpeq(e, cm), la), _mm_andnot_si128(Lanes::cmpeq(e, am), lc));
+		const __m128i right = _mm_or_si128(_mm_andnot_si128(Lanes::cmpeq(e, cp), ra), _mm_andnot_si128(Lanes::cmpeq(e, ap), rc));
+		Lanes::store3(dst1 + 3 * i, scale_select_sse2(left, l, e), e, scale_select_sse2(right, r, e));
+
+		const __m128i bottom = _mm_or_si128(_mm_andnot_si128(Lanes::cmpeq(e, cp), lc), _mm_andnot_si128(Lanes::cmpeq(e, cm), rc));
+		Lanes::store3(dst2 + 3 * i, scale_select_sse2(lc, l, e), scale_select_sse2(bottom, c, e), scale_select_sse2(rc, r, e));
+	}
+
+	tail(dst0 + 3 * i, dst1 + 3 * i, dst2 + 3 * i, src0 + i, src1 + i, src2 + i, count - i);
+}
+
+void scale2x_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_sse2(dst0, dst1, src0, src1, src2, count, scale2x_16_def);
+}
+
+void scale2x_32_sse2(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count) {
+	scale2x_sse2(dst0, dst1, src0, src1, src2, count, scale2x_32_def);
+}
+
+void scale3x_16_sse2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_sse2(dst0, dst1, dst2, src0, src1, src2, count, scale3x_16_def);
+}
+
+void scale3x_32_sse2(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count) {
+	scale3x_sse2(dst0, dst1, dst2, src0, src1, src2, count, scale3x_32_def);
+}
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
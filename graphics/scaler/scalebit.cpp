@@ -35,6 +35,7 @@
  */
 
 #include "common/scummsys.h"
+#include "common/system.h"
 
 #include "graphics/scaler/scale2x.h"
 #include "graphics/scaler/scale3x.h"
@@ -43,24 +44,66 @@
 #define DST(bits, num)	(scale2x_uint ## bits *)dst ## num
 #define SRC(bits, num)	(const scale2x_uint ## bits *)src ## num
 
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SCALE2X_ROW(bits) scale2x_ ## bits ## _mmx
+#elif defined(USE_ARM_SCALER_ASM)
+#define SCALE2X_ROW(bits) scale2x_ ## bits ## _arm
+#else
+#define SCALE2X_ROW(bits) scale2x_ ## bits ## _def
+#endif
+
+/*
+ * Row functions for 16 and 32 bits pixels.
+ * They are replaced by the SIMD versions supported by the CPU in scale_select().
+ */
+static void (*scale2x_16_row)(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) = SCALE2X_ROW(16);
+static void (*scale2x_32_row)(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count) = SCALE2X_ROW(32);
+static void (*scale3x_16_row)(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) = scale3x_16_def;
+static void (*scale3x_32_row)(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32* dst2, const scale3x_uint32* src0, const scale3x_uint32* src1, const scale3x_uint32* src2, unsigned count) = scale3x_32_def;
+
+/**
+ * Select the fastest row functions supported by the CPU.
+ */
+static void scale_select() {
+	static bool selected = false;
+	if (selected)
+		return;
+	selected = true;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		scale2x_16_row = scale2x_16_neon;
+		scale2x_32_row = scale2x_32_neon;
+		scale3x_16_row = scale3x_16_neon;
+		scale3x_32_row = scale3x_32_neon;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		scale2x_16_row = scale2x_16_sse2;
+		scale2x_32_row = scale2x_32_sse2;
+		scale3x_16_row = scale3x_16_sse2;
+		scale3x_32_row = scale3x_32_sse2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		scale2x_16_row = scale2x_16_avx2;
+		scale2x_32_row = scale2x_32_avx2;
+		scale3x_16_row = scale3x_16_avx2;
+		scale3x_32_row = scale3x_32_avx2;
+	}
+#endif
+}
+
 /**
  * Apply the Scale2x effect on a group of rows. Used internally.
  */
 static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const void* src1, const void* src2, unsigned pixel, unsigned pixel_per_row) {
 	switch (pixel) {
-#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
-	case 1: scale2x_8_mmx( DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
-	case 2: scale2x_16_mmx(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
-	case 4: scale2x_32_mmx(DST(32,0), DST(32,1), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
-#elif defined(USE_ARM_SCALER_ASM)
-	case 1: scale2x_8_arm( DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
-	case 2: scale2x_16_arm(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
-	case 4: scale2x_32_arm(DST(32,0), DST(32,1), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
-#else
-	case 1: scale2x_8_def( DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
-	case 2: scale2x_16_def(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
-	case 4: scale2x_32_def(DST(32,0), DST(32,1), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
-#endif
+	case 1: SCALE2X_ROW(8)(DST( 8,0), DST( 8,1), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
+	case 2: scale2x_16_row(DST(16,0), DST(16,1), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
+	case 4: scale2x_32_row(DST(32,0), DST(32,1), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
 	default: break;
 	}
 }
@@ -71,8 +114,8 @@ static inline void stage_scale2x(void* dst0, void* dst1, const void* src0, const
 static inline void stage_scale3x(void* dst0, void* dst1, void* dst2, const void* src0, const void* src1, const void* src2, unsigned pixel, unsigned pixel_per_row) {
 	switch (pixel) {
 	case 1: scale3x_8_def( DST( 8,0), DST( 8,1), DST( 8,2), SRC( 8,0), SRC( 8,1), SRC( 8,2), pixel_per_row); break;
-	case 2: scale3x_16_def(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
-	case 4: scale3x_32_def(DST(32,0), DST(32,1), DST(32,2), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
+	case 2: scale3x_16_row(DST(16,0), DST(16,1), DST(16,2), SRC(16,0), SRC(16,1), SRC(16,2), pixel_per_row); break;
+	case 4: scale3x_32_row(DST(32,0), DST(32,1), DST(32,2), SRC(32,0), SRC(32,1), SRC(32,2), pixel_per_row); break;
 	default: break;
 	}
 }
@@ -353,6 +396,11 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+AdvMameScaler::AdvMameScaler(const Graphics::PixelFormat &format) : Scaler(format) {
+	_factor = 2;
+	scale_select();
+}
+
 void AdvMameScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
 	if (_factor != 4)
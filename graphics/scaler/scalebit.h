@@ -44,7 +44,7 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 
 class AdvMameScaler : public Scaler {
 public:
-	AdvMameScaler(const Graphics::PixelFormat &format) : Scaler(format) { _factor = 2; }
+	AdvMameScaler(const Graphics::PixelFormat &format);
 	uint increaseFactor() override;
 	uint decreaseFactor() override;
 protected:
@@ -20,6 +20,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/threadpool.h"
+
 namespace {
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -40,6 +42,16 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 		dstPtr += dstPitch;
 	}
 }
+
+struct BandJob {
+	Scaler *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height, x, y;
+	uint count;
+};
 } // End of anonymous namespace
 
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
@@ -52,11 +64,40 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
+	} else if (_bands > 1 && height >= 2 * kMinBandRows) {
+		BandJob job;
+		job.scaler = this;
+		job.srcPtr = srcPtr;
+		job.srcPitch = srcPitch;
+		job.dstPtr = dstPtr;
+		job.dstPitch = dstPitch;
+		job.width = width;
+		job.height = height;
+		job.x = x;
+		job.y = y;
+		job.count = MIN<uint>(_bands, height / kMinBandRows);
+
+		prepareBands(job.count);
+		ThreadPoolMan.parallelFor(job.count, scaleBands, &job);
+		finishBands(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	} else {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
 }
 
+void Scaler::scaleBands(uint begin, uint end, void *data) {
+	const BandJob &job = *(const BandJob *)data;
+	Scaler *scaler = job.scaler;
+
+	for (uint band = begin; band < end; band++) {
+		const int top = job.height * band / job.count;
+		const int bottom = job.height * (band + 1) / job.count;
+		scaler->scaleBand(band, job.srcPtr + top * job.srcPitch, job.srcPitch,
+		                  job.dstPtr + top * scaler->_factor * job.dstPitch, job.dstPitch,
+		                  job.width, bottom - top, job.x, job.y + top);
+	}
+}
+
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
@@ -95,22 +136,37 @@ uint SourceScaler::setFactor(uint factor) {
 
 void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 						 uint32 dstPitch, int width, int height, int x, int y) {
+	scaleBand(0, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	finishBands(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+}
+
+void SourceScaler::scaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+						 uint32 dstPitch, int width, int height, int x, int y) {
 	if (!_enable) {
-		// Do not pass _oldSrc, do not update _oldSrc
-		internScale(srcPtr, srcPitch,
-		            dstPtr, dstPitch,
-		            NULL, 0,
-		            width, height,
-		            NULL, 0);
+		// Do not pass _oldSrc
+		internScaleBand(band, srcPtr, srcPitch,
+		                dstPtr, dstPitch,
+		                NULL, 0,
+		                width, height,
+		                NULL, 0);
 		return;
 	}
 	int offset = (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
 	// Call user defined scale function
-	internScale(srcPtr, srcPitch,
-	            dstPtr, dstPitch,
-	            _oldSrc + offset, srcPitch,
-	            width, height,
-	            (uint8 *)_bufferedOutput.getBasePtr(x * _factor, y * _factor), _bufferedOutput.pitch);
+	internScaleBand(band, srcPtr, srcPitch,
+	                dstPtr, dstPitch,
+	                _oldSrc + offset, srcPitch,
+	                width, height,
+	                (uint8 *)_bufferedOutput.getBasePtr(x * _factor, y * _factor), _bufferedOutput.pitch);
+}
+
+void SourceScaler::finishBands(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+						 uint32 dstPitch, int width, int height, int x, int y) {
+	// Do not update _oldSrc
+	if (!_enable)
+		return;
+
+	int offset = (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
 
 	// Update the destination buffer
 	byte *buffer = (byte *)_bufferedOutput.getBasePtr(x * _factor, y * _factor);
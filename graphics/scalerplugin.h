@@ -27,7 +27,7 @@
 
 class Scaler {
 public:
-	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
+	Scaler(const Graphics::PixelFormat &format) : _format(format), _bands(1) {}
 	virtual ~Scaler() {}
 
 	/**
@@ -41,6 +41,9 @@ public:
 	 * @param height   The height of the source rect to scale.
 	 * @param x        The x position of the source rect.
 	 * @param y        The y position of the source rect.
+	 *
+	 * Tall rects are split into horizontal bands which are scaled in
+	 * parallel, see setBands.
 	 */
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
@@ -94,15 +97,60 @@ public:
 		assert(0);
 	}
 
+	/**
+	 * Set the maximum number of horizontal bands a rect is split into by
+	 * scale. The bands are processed on the shared thread pool. Each band
+	 * reads the source rows around it directly from the source surface, so
+	 * the result is the same as when scaling the whole rect at once.
+	 *
+	 * @param bands The maximum number of bands, 1 disables the splitting.
+	 */
+	void setBands(uint bands) { _bands = MAX<uint>(bands, 1); }
+
 protected:
+	/** Minimum number of source rows in a band. */
+	static const int kMinBandRows = 16;
+
 	/**
 	 * @see scale
+	 *
+	 * This may be called concurrently for disjoint bands of a rect.
 	 */
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Called before the bands of a rect are scaled. Scalers which keep
+	 * per-call state can set up one copy of it for each band here.
+	 *
+	 * @param count The number of bands.
+	 */
+	virtual void prepareBands(uint count) {}
+
+	/**
+	 * Scale one band of a rect. The parameters are those of scaleIntern,
+	 * restricted to the band.
+	 *
+	 * @param band The index of the band, starting with 0 at the top.
+	 */
+	virtual void scaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                       uint32 dstPitch, int width, int height, int x, int y) {
+		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	}
+
+	/**
+	 * Called with the whole rect once all its bands have been scaled.
+	 */
+	virtual void finishBands(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) {}
+
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	static void scaleBands(uint begin, uint end, void *data);
+
+	uint _bands;
 };
 
 /**
@@ -127,6 +175,27 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) final;
 
+	virtual void scaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                       uint32 dstPitch, int width, int height, int x, int y) final;
+
+	/**
+	 * Updates the old source and the buffered output, which the bands of
+	 * a rect must not do on their own since they read each other's rows.
+	 */
+	virtual void finishBands(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) final;
+
+	/**
+	 * Like internScale, but for one band of a rect. Scalers which are not
+	 * reentrant can use @p band to select the state set up by prepareBands.
+	 */
+	virtual void internScaleBand(uint band, const uint8 *srcPtr, uint32 srcPitch,
+	                             uint8 *dstPtr, uint32 dstPitch,
+	                             const uint8 *oldSrcPtr, uint32 oldSrcPitch,
+	                             int width, int height, const uint8 *buffer, uint32 bufferPitch) {
+		internScale(srcPtr, srcPitch, dstPtr, dstPitch, oldSrcPtr, oldSrcPitch, width, height, buffer, bufferPitch);
+	}
+
 	/**
 	 * Scalers must implement this function. It will be called by oldSrcScale.
 	 * If by comparing the src and oldsrc images it is discovered that no change
@@ -27,6 +27,7 @@
 
 #include "common/singleton.h"
 #include "common/array.h"
+#include "common/threadpool.h"
 
 #include "graphics/tinygl/tinygl.h"
 #include "graphics/tinygl/zgl.h"
@@ -354,11 +355,16 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
 
+	// Draw calls are recorded with their screen area so they can be binned into tiles
+	_tiledRenderingEnabled = ThreadPoolMan.isMultiThreaded();
+	_binDrawCalls = _tiledRenderingEnabled;
+
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
 void GLContext::deinit() {
 	disposeDrawCallLists();
+	disposeTileContexts();
 	disposeResources();
 
 	specbuf_cleanup();
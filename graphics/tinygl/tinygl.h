@@ -39,6 +39,9 @@ void destroyContext(ContextHandle *handle);
 void setContext(ContextHandle *handle);
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
+// Rasterize the draw calls of a frame in screen tiles, on all worker threads.
+// Enabled by default when the thread pool has worker threads; takes effect from the next frame.
+void enableTiledRendering(bool enable);
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyFromFrameBuffer(const Graphics::PixelFormat &dstFormat);
 
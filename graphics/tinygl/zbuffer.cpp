@@ -33,6 +33,7 @@
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
@@ -52,13 +53,29 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
+	_ownsBuffers = true;
 
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
+
+	SpanKernels::init();
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer *parent) {
+	*this = *parent;
+	_ownsBuffers = false;
+}
+
+void FrameBuffer::copyState(const FrameBuffer *parent) {
+	const bool ownsBuffers = _ownsBuffers;
+	*this = *parent;
+	_ownsBuffers = ownsBuffers;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
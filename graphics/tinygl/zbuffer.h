@@ -104,8 +104,13 @@ struct ZBufferPoint {
 
 struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
+	// Creates a frame buffer drawing into the buffers of parent, with its own copy of the render state
+	explicit FrameBuffer(const FrameBuffer *parent);
 	~FrameBuffer();
 
+	// Takes over the buffers and render state of parent, keeping the ownership of this frame buffer
+	void copyState(const FrameBuffer *parent);
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -372,6 +377,11 @@ private:
 	template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 	void putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx);
 
+	template <bool kDepthWrite, bool kSmoothMode, bool kEnableScissor, bool kDepthTestEnabled>
+	void putSpan(int fbOffset, const TexelBuffer *texture, uint *pz, int count, int x,
+	             uint &z, int &t, int &s, uint &r, uint &g, uint &b, uint &a,
+	             int dzdx, int dsdx, int dtdx, int drdx, int dgdx, int dbdx, uint dadx);
+
 
 	template <bool kEnableAlphaTest>
 	FORCEINLINE void writePixel(int pixel, int value) {
@@ -750,6 +760,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -25,6 +25,7 @@
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/threadpool.h"
 
 namespace TinyGL {
 
@@ -107,6 +108,135 @@ void GLContext::disposeDrawCallLists() {
 	_drawCallsQueue.clear();
 }
 
+// Tiles are bands of full rows, so rasterizing a triangle into a tile touches
+// exactly the pixels it would touch when drawing the whole screen at once.
+static const int kTileHeight = 32;
+
+struct TileBins {
+	const GLContext *context;
+	const Common::Array<Common::Rect> *clipRects;
+	// Draw calls touching each tile, in draw order
+	Common::Array<Common::Array<const DrawCall *> > bins;
+	uint workerCount;
+};
+
+static void rasterizeTiles(uint begin, uint end, void *data) {
+	const TileBins *tiles = (const TileBins *)data;
+	const GLContext *parent = tiles->context;
+
+	for (uint worker = begin; worker < end; worker++) {
+		// The draw calls change the rendering state, so each worker has its own context
+		GLContext *c = parent->_tileContexts[worker];
+		// Interleave the tiles between workers, to spread busy parts of the screen
+		for (uint tile = worker; tile < tiles->bins.size(); tile += tiles->workerCount) {
+			const int top = parent->renderRect.top + tile * kTileHeight;
+			const Common::Rect tileRect(parent->renderRect.left, top, parent->renderRect.right,
+			                            MIN<int>(top + kTileHeight, parent->renderRect.bottom));
+			const Common::Array<const DrawCall *> &bin = tiles->bins[tile];
+
+			for (uint i = 0; i < bin.size(); i++) {
+				if (!tiles->clipRects) {
+					bin[i]->executeTile(c, tileRect);
+					continue;
+				}
+
+				const Common::Rect drawCallRegion = bin[i]->getDirtyRegion();
+				for (uint j = 0; j < tiles->clipRects->size(); j++) {
+					const Common::Rect &dirtyRegion = (*tiles->clipRects)[j];
+					if (dirtyRegion.intersects(drawCallRegion) && dirtyRegion.intersects(tileRect)) {
+						bin[i]->executeTile(c, dirtyRegion.findIntersectingRect(tileRect));
+					}
+				}
+			}
+		}
+	}
+}
+
+void GLContext::prepareTileContexts(uint count) {
+	while (_tileContexts.size() < count) {
+		GLContext *c = new GLContext();
+		c->fb = new FrameBuffer(fb);
+		c->vertex = nullptr;
+		c->vertex_max = 0;
+		c->_profilingEnabled = false;
+		_tileContexts.push_back(c);
+	}
+
+	for (uint i = 0; i < count; i++) {
+		GLContext *c = _tileContexts[i];
+		c->fb->copyState(fb);
+		c->renderRect = renderRect;
+		c->render_mode = render_mode;
+		c->current_cull_face = current_cull_face;
+		c->vertex_n = vertex_n;
+	}
+}
+
+void GLContext::disposeTileContexts() {
+	for (uint i = 0; i < _tileContexts.size(); i++) {
+		gl_free(_tileContexts[i]->vertex);
+		delete _tileContexts[i]->fb;
+		delete _tileContexts[i];
+	}
+	_tileContexts.clear();
+}
+
+bool GLContext::useTiledRendering() const {
+	return _tiledRenderingEnabled && _binDrawCalls && render_mode == TGL_RENDER;
+}
+
+void GLContext::executeDrawCallsTiled(const Common::Array<Common::Rect> *clipRects) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	TileBins tiles;
+	tiles.context = this;
+	tiles.clipRects = clipRects;
+	tiles.bins.resize((renderRect.height() + kTileHeight - 1) / kTileHeight);
+	tiles.workerCount = MIN<uint>(ThreadPoolMan.getThreadCount() + 1, tiles.bins.size());
+	prepareTileContexts(tiles.workerCount);
+
+	DrawCallIterator it = _drawCallsQueue.begin();
+	while (it != _drawCallsQueue.end()) {
+		// Bin the draw calls up to the next blit, which can only run on this thread.
+		bool binned = false;
+		for ( ; it != _drawCallsQueue.end() && (*it)->getType() != DrawCall::DrawCall_Blitting; ++it) {
+			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+			drawCallRegion.clip(renderRect);
+			if (drawCallRegion.isEmpty())
+				continue;
+
+			const int firstTile = (drawCallRegion.top - renderRect.top) / kTileHeight;
+			const int lastTile = (drawCallRegion.bottom - 1 - renderRect.top) / kTileHeight;
+			for (int tile = firstTile; tile <= lastTile; tile++) {
+				tiles.bins[tile].push_back(*it);
+			}
+			binned = true;
+		}
+
+		if (binned) {
+			ThreadPoolMan.parallelFor(tiles.workerCount, rasterizeTiles, &tiles);
+			for (uint tile = 0; tile < tiles.bins.size(); tile++) {
+				tiles.bins[tile].clear();
+			}
+		}
+
+		if (it == _drawCallsQueue.end())
+			break;
+
+		if (!clipRects) {
+			(*it)->execute(true);
+		} else {
+			const Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+			for (uint i = 0; i < clipRects->size(); i++) {
+				if ((*clipRects)[i].intersects(drawCallRegion)) {
+					(*it)->execute((*clipRects)[i], true);
+				}
+			}
+		}
+		++it;
+	}
+}
+
 static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
@@ -193,12 +323,20 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		if (useTiledRendering()) {
+			Common::Array<Common::Rect> clipRects;
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				clipRects.push_back((*itRect).rectangle);
+			}
+			executeDrawCallsTiled(&clipRects);
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -228,6 +366,7 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 
 	_previousFrameDrawCallsQueue = _drawCallsQueue;
 	_drawCallsQueue.clear();
+	_binDrawCalls = _tiledRenderingEnabled;
 
 	disposeResources();
 
@@ -240,12 +379,20 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
-	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
-		delete *it;
+	if (useTiledRendering()) {
+		executeDrawCallsTiled(nullptr);
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			delete *it;
+		}
+	} else {
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			(*it)->execute(true);
+			delete *it;
+		}
 	}
 
 	_drawCallsQueue.clear();
+	_binDrawCalls = _tiledRenderingEnabled;
 
 	disposeResources();
 
@@ -266,6 +413,10 @@ void presentBuffer() {
 	presentBuffer(dirtyAreas);
 }
 
+void enableTiledRendering(bool enable) {
+	gl_get_context()->_tiledRenderingEnabled = enable;
+}
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -294,8 +445,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (c->_enableDirtyRectangles || c->_binDrawCalls) {
 		computeDirtyRegion();
 	}
 }
@@ -338,9 +489,9 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
@@ -350,6 +501,39 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
+	rasterize(c);
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+
+	if (restoreState) {
+		applyState(c, backupState);
+	}
+}
+
+void RasterizationDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
+	// Rasterization modifies the vertices, so every tile works on its own copy.
+	if (c->vertex_max < _vertexCount) {
+		gl_free(c->vertex);
+		c->vertex_max = _vertexCount;
+		c->vertex = (GLVertex *)gl_malloc(c->vertex_max * sizeof(GLVertex));
+	}
+	GLVertex *tileVertex = c->vertex;
+	memcpy(tileVertex, _vertex, sizeof(GLVertex) * _vertexCount);
+
+	applyState(c, _state);
+	c->vertex_cnt = _vertexCount;
+	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
+	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
+
+	c->fb->setScissorRectangle(clippingRectangle);
+	rasterize(c);
+	c->fb->resetScissorRectangle();
+
+	c->vertex = tileVertex;
+}
+
+void RasterizationDrawCall::rasterize(GLContext *c) const {
 	int n = c->vertex_n;
 	int cnt = c->vertex_cnt;
 
@@ -424,18 +608,10 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	default:
 		error("glBegin: type %x not handled", c->begin_type);
 	}
-
-	c->vertex = prevVertex;
-	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(GLContext *c) const {
 	RasterizationState state;
-	GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
 	state.dfactor = c->destination_blending_factor;
@@ -484,8 +660,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -690,7 +865,7 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	  _rValue(rValue), _gValue(gValue), _bValue(bValue), _clearStencilBuffer(clearStencilBuffer),
 	  _stencilValue(stencilValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_binDrawCalls) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -701,7 +876,10 @@ void ClearBufferDrawCall::execute(bool restoreState) const {
 }
 
 void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = gl_get_context();
+	executeTile(gl_get_context(), clippingRectangle);
+}
+
+void ClearBufferDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(),
 	                   _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
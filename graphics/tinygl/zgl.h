@@ -463,6 +463,12 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Tiled rendering
+	bool _tiledRenderingEnabled;
+	bool _binDrawCalls;
+	// One rendering context per worker, kept between frames
+	Common::Array<GLContext *> _tileContexts;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -519,6 +525,10 @@ public:
 
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
+	bool useTiledRendering() const;
+	void executeDrawCallsTiled(const Common::Array<Common::Rect> *clipRects);
+	void prepareTileContexts(uint count);
+	void disposeTileContexts();
 
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
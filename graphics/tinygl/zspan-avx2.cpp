@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+static FORCEINLINE __m256i avx2_ramp(uint base, int step) {
+	return _mm256_add_epi32(_mm256_set1_epi32(base), _mm256_mullo_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+}
+
+// Expand bits 0 - 7 of mask to full lanes
+static FORCEINLINE __m256i avx2_laneMask(uint32 mask) {
+	const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(mask), bits), bits);
+}
+
+// Same as (uint)(float)z for unsigned z, which the per pixel code does
+static FORCEINLINE __m256i avx2_roundDepth(__m256i z) {
+	// Both halves convert exactly, so the sum is rounded only once
+	const __m256 hi = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(z, 16)), _mm256_set1_ps(65536.0f));
+	const __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(z, _mm256_set1_epi32(0xFFFF)));
+	const __m256 f = _mm256_add_ps(hi, lo);
+
+	const __m256 big = _mm256_cmp_ps(f, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+	const __m256i i = _mm256_cvttps_epi32(_mm256_sub_ps(f, _mm256_and_ps(big, _mm256_set1_ps(2147483648.0f))));
+	return _mm256_add_epi32(i, _mm256_and_si256(_mm256_castps_si256(big), _mm256_set1_epi32((int)0x80000000)));
+}
+
+static FORCEINLINE __m256i avx2_depthTest(__m256i dst, __m256i src, int depthFunc) {
+	// AVX2 only has signed comparisons
+	const __m256i bias = _mm256_set1_epi32((int)0x80000000);
+	const __m256i d = _mm256_xor_si256(dst, bias);
+	const __m256i s = _mm256_xor_si256(src, bias);
+	const __m256i ones = _mm256_set1_epi32(-1);
+
+	switch (depthFunc) {
+	case TGL_LESS:
+		return _mm256_cmpgt_epi32(s, d);
+	case TGL_EQUAL:
+		return _mm256_cmpeq_epi32(d, s);
+	case TGL_LEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(d, s), ones);
+	case TGL_GREATER:
+		return _mm256_cmpgt_epi32(d, s);
+	case TGL_NOTEQUAL:
+		return _mm256_xor_si256(_mm256_cmpeq_epi32(d, s), ones);
+	case TGL_GEQUAL:
+		return _mm256_xor_si256(_mm256_cmpgt_epi32(s, d), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm256_setzero_si256();
+	}
+}
+
+static uint32 depthTestAVX2Impl(const uint *pz, uint z, int dzdx, int depthFunc) {
+	const __m256i pass = avx2_depthTest(_mm256_loadu_si256((const __m256i *)pz), avx2_ramp(z, dzdx), depthFunc);
+	return _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+}
+
+static void writeAVX2Impl(const SpanArgs &args, uint32 *pbuf, uint *pz, uint32 mask) {
+	const Graphics::PixelFormat &format = *args.format;
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i write = avx2_laneMask(mask);
+
+	__m256i a = _mm256_srli_epi32(avx2_ramp(args.a, args.dadx), 8);
+	__m256i r = _mm256_srli_epi32(avx2_ramp(args.r, args.drdx), 8);
+	__m256i g = _mm256_srli_epi32(avx2_ramp(args.g, args.dgdx), 8);
+	__m256i b = _mm256_srli_epi32(avx2_ramp(args.b, args.dbdx), 8);
+	if (args.texels) {
+		const __m256i texel = _mm256_loadu_si256((const __m256i *)args.texels);
+		a = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(texel, 24), a), 8);
+		r = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(texel, 16), byteMask), r), 8);
+		g = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(texel, 8), byteMask), g), 8);
+		b = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(texel, byteMask), b), 8);
+	}
+	a = _mm256_and_si256(a, byteMask);
+	r = _mm256_and_si256(r, byteMask);
+	g = _mm256_and_si256(g, byteMask);
+	b = _mm256_and_si256(b, byteMask);
+
+	__m256i color = _mm256_sll_epi32(_mm256_srl_epi32(a, _mm_cvtsi32_si128(format.aLoss)), _mm_cvtsi32_si128(format.aShift));
+	color = _mm256_or_si256(color, _mm256_sll_epi32(_mm256_srl_epi32(r, _mm_cvtsi32_si128(format.rLoss)), _mm_cvtsi32_si128(format.rShift)));
+	color = _mm256_or_si256(color, _mm256_sll_epi32(_mm256_srl_epi32(g, _mm_cvtsi32_si128(format.gLoss)), _mm_cvtsi32_si128(format.gShift)));
+	color = _mm256_or_si256(color, _mm256_sll_epi32(_mm256_srl_epi32(b, _mm_cvtsi32_si128(format.bLoss)), _mm_cvtsi32_si128(format.bShift)));
+	_mm256_maskstore_epi32((int *)pbuf, write, color);
+
+	if (args.depthWrite)
+		_mm256_maskstore_epi32((int *)pz, write, avx2_roundDepth(avx2_ramp(args.z, args.dzdx)));
+}
+
+uint32 SpanKernels::depthTestAVX2(const uint *pz, uint z, int dzdx, int count, int depthFunc) {
+	if (count == kMaxSpan)
+		return depthTestAVX2Impl(pz, z, dzdx, depthFunc);
+
+	// Short spans work on a copy, to stay inside the depth buffer
+	uint depth[kMaxSpan] = {};
+	memcpy(depth, pz, count * sizeof(uint));
+	return depthTestAVX2Impl(depth, z, dzdx, depthFunc) & ((1 << count) - 1);
+}
+
+void SpanKernels::writeAVX2(const SpanArgs &args, uint32 mask) {
+	// Masked stores never touch the pixels past the end of the span
+	writeAVX2Impl(args, args.pbuf, args.pz, mask & ((1 << args.count) - 1));
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
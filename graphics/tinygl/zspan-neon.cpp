@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace TinyGL {
+
+static const uint32 neonLaneBits[4] = { 1, 2, 4, 8 };
+static const uint32 neonLaneSteps[4] = { 0, 1, 2, 3 };
+
+static inline uint32x4_t neon_ramp(uint base, int step) {
+	return vmlaq_u32(vdupq_n_u32(base), vdupq_n_u32(step), vld1q_u32(neonLaneSteps));
+}
+
+// Expand bits 0 - 3 of mask to full lanes
+static inline uint32x4_t neon_laneMask(uint32 mask) {
+	const uint32x4_t bits = vld1q_u32(neonLaneBits);
+	return vceqq_u32(vandq_u32(vdupq_n_u32(mask), bits), bits);
+}
+
+// Collect the top bit of every lane, like _mm_movemask_ps does
+static inline uint32 neon_moveMask(uint32x4_t v) {
+	const uint32x4_t bits = vandq_u32(v, vld1q_u32(neonLaneBits));
+	const uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+	return vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+
+static inline uint32x4_t neon_depthTest(uint32x4_t dst, uint32x4_t src, int depthFunc) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return vcltq_u32(dst, src);
+	case TGL_EQUAL:
+		return vceqq_u32(dst, src);
+	case TGL_LEQUAL:
+		return vcleq_u32(dst, src);
+	case TGL_GREATER:
+		return vcgtq_u32(dst, src);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_u32(dst, src));
+	case TGL_GEQUAL:
+		return vcgeq_u32(dst, src);
+	case TGL_ALWAYS:
+		return vdupq_n_u32(0xFFFFFFFF);
+	default:
+		return vdupq_n_u32(0);
+	}
+}
+
+// Shift every lane of v right by loss bits and then left by shift bits
+static inline uint32x4_t neon_pack(uint32x4_t v, int loss, int shift) {
+	return vshlq_u32(vshlq_u32(v, vdupq_n_s32(-loss)), vdupq_n_s32(shift));
+}
+
+static uint32 depthTestNEONImpl(const uint *pz, uint z, int dzdx, int depthFunc) {
+	uint32 mask = 0;
+	for (int i = 0; i < SpanKernels::kMaxSpan; i += 4) {
+		const uint32x4_t pass = neon_depthTest(vld1q_u32(pz + i), neon_ramp(z + i * dzdx, dzdx), depthFunc);
+		mask |= neon_moveMask(pass) << i;
+	}
+	return mask;
+}
+
+static void writeNEONImpl(const SpanArgs &args, uint32 *pbuf, uint *pz, uint32 mask) {
+	const Graphics::PixelFormat &format = *args.format;
+	const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+
+	for (int i = 0; i < SpanKernels::kMaxSpan; i += 4) {
+		const uint32x4_t write = neon_laneMask(mask >> i);
+
+		uint32x4_t a = vshrq_n_u32(neon_ramp(args.a + i * args.dadx, args.dadx), 8);
+		uint32x4_t r = vshrq_n_u32(neon_ramp(args.r + i * args.drdx, args.drdx), 8);
+		uint32x4_t g = vshrq_n_u32(neon_ramp(args.g + i * args.dgdx, args.dgdx), 8);
+		uint32x4_t b = vshrq_n_u32(neon_ramp(args.b + i * args.dbdx, args.dbdx), 8);
+		if (args.texels) {
+			const uint32x4_t texel = vld1q_u32(args.texels + i);
+			a = vshrq_n_u32(vmulq_u32(vshrq_n_u32(texel, 24), a), 8);
+			r = vshrq_n_u32(vmulq_u32(vandq_u32(vshrq_n_u32(texel, 16), byteMask), r), 8);
+			g = vshrq_n_u32(vmulq_u32(vandq_u32(vshrq_n_u32(texel, 8), byteMask), g), 8);
+			b = vshrq_n_u32(vmulq_u32(vandq_u32(texel, byteMask), b), 8);
+		}
+
+		uint32x4_t color = neon_pack(vandq_u32(a, byteMask), format.aLoss, format.aShift);
+		color = vorrq_u32(color, neon_pack(vandq_u32(r, byteMask), format.rLoss, format.rShift));
+		color = vorrq_u32(color, neon_pack(vandq_u32(g, byteMask), format.gLoss, format.gShift));
+		color = vorrq_u32(color, neon_pack(vandq_u32(b, byteMask), format.bLoss, format.bShift));
+		vst1q_u32(pbuf + i, vbslq_u32(write, color, vld1q_u32(pbuf + i)));
+
+		if (args.depthWrite) {
+			// Same as (uint)(float)z, which the per pixel code does
+			const uint32x4_t z = vcvtq_u32_f32(vcvtq_f32_u32(neon_ramp(args.z + i * args.dzdx, args.dzdx)));
+			vst1q_u32(pz + i, vbslq_u32(write, z, vld1q_u32(pz + i)));
+		}
+	}
+}
+
+uint32 SpanKernels::depthTestNEON(const uint *pz, uint z, int dzdx, int count, int depthFunc) {
+	if (count == kMaxSpan)
+		return depthTestNEONImpl(pz, z, dzdx, depthFunc);
+
+	// Short spans work on a copy, to stay inside the depth buffer
+	uint depth[kMaxSpan] = {};
+	memcpy(depth, pz, count * sizeof(uint));
+	return depthTestNEONImpl(depth, z, dzdx, depthFunc) & ((1 << count) - 1);
+}
+
+void SpanKernels::writeNEON(const SpanArgs &args, uint32 mask) {
+	if (args.count == kMaxSpan) {
+		writeNEONImpl(args, args.pbuf, args.pz, mask);
+		return;
+	}
+
+	uint32 pixels[kMaxSpan];
+	uint depth[kMaxSpan];
+	memcpy(pixels, args.pbuf, args.count * sizeof(uint32));
+	memcpy(depth, args.pz, args.count * sizeof(uint));
+	writeNEONImpl(args, pixels, depth, mask & ((1 << args.count) - 1));
+	memcpy(args.pbuf, pixels, args.count * sizeof(uint32));
+	memcpy(args.pz, depth, args.count * sizeof(uint));
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,179 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace TinyGL {
+
+static FORCEINLINE __m128i sse2_mul32(__m128i a, __m128i b) {
+	__m128i even = _mm_shuffle_epi32(_mm_mul_epu32(a, b), _MM_SHUFFLE(0, 0, 2, 0));
+	__m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_bsrli_si128(a, 4), _mm_bsrli_si128(b, 4)), _MM_SHUFFLE(0, 0, 2, 0));
+	return _mm_unpacklo_epi32(even, odd);
+}
+
+static FORCEINLINE __m128i sse2_ramp(uint base, int step) {
+	return _mm_setr_epi32(base, base + step, base + 2 * step, base + 3 * step);
+}
+
+// Expand bits 0 - 3 of mask to full lanes
+static FORCEINLINE __m128i sse2_laneMask(uint32 mask) {
+	const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+	return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(mask), bits), bits);
+}
+
+static FORCEINLINE __m128i sse2_select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Same as (uint)(float)z for unsigned z, which the per pixel code does
+static FORCEINLINE __m128i sse2_roundDepth(__m128i z) {
+	// Both halves convert exactly, so the sum is rounded only once
+	const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(z, 16)), _mm_set1_ps(65536.0f));
+	const __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(z, _mm_set1_epi32(0xFFFF)));
+	const __m128 f = _mm_add_ps(hi, lo);
+
+	const __m128 big = _mm_cmpge_ps(f, _mm_set1_ps(2147483648.0f));
+	const __m128i i = _mm_cvttps_epi32(_mm_sub_ps(f, _mm_and_ps(big, _mm_set1_ps(2147483648.0f))));
+	return _mm_add_epi32(i, _mm_and_si128(_mm_castps_si128(big), _mm_set1_epi32((int)0x80000000)));
+}
+
+static FORCEINLINE __m128i sse2_depthTest(__m128i dst, __m128i src, int depthFunc) {
+	// SSE2 only has signed comparisons
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i d = _mm_xor_si128(dst, bias);
+	const __m128i s = _mm_xor_si128(src, bias);
+	const __m128i ones = _mm_set1_epi32(-1);
+
+	switch (depthFunc) {
+	case TGL_LESS:
+		return _mm_cmplt_epi32(d, s);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(d, s);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(_mm_cmpgt_epi32(d, s), ones);
+	case TGL_GREATER:
+		return _mm_cmpgt_epi32(d, s);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(d, s), ones);
+	case TGL_GEQUAL:
+		return _mm_xor_si128(_mm_cmplt_epi32(d, s), ones);
+	case TGL_ALWAYS:
+		return ones;
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+static uint32 depthTestSSE2Impl(const uint *pz, uint z, int dzdx, int depthFunc) {
+	uint32 mask = 0;
+	for (int i = 0; i < SpanKernels::kMaxSpan; i += 4) {
+		const __m128i pass = sse2_depthTest(_mm_loadu_si128((const __m128i *)(pz + i)), sse2_ramp(z + i * dzdx, dzdx), depthFunc);
+		mask |= _mm_movemask_ps(_mm_castsi128_ps(pass)) << i;
+	}
+	return mask;
+}
+
+static void writeSSE2Impl(const SpanArgs &args, uint32 *pbuf, uint *pz, uint32 mask) {
+	const Graphics::PixelFormat &format = *args.format;
+	const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss), aShift = _mm_cvtsi32_si128(format.aShift);
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+
+	for (int i = 0; i < SpanKernels::kMaxSpan; i += 4) {
+		const __m128i write = sse2_laneMask(mask >> i);
+
+		__m128i a = _mm_srli_epi32(sse2_ramp(args.a + i * args.dadx, args.dadx), 8);
+		__m128i r = _mm_srli_epi32(sse2_ramp(args.r + i * args.drdx, args.drdx), 8);
+		__m128i g = _mm_srli_epi32(sse2_ramp(args.g + i * args.dgdx, args.dgdx), 8);
+		__m128i b = _mm_srli_epi32(sse2_ramp(args.b + i * args.dbdx, args.dbdx), 8);
+		if (args.texels) {
+			const __m128i texel = _mm_loadu_si128((const __m128i *)(args.texels + i));
+			a = _mm_srli_epi32(sse2_mul32(_mm_srli_epi32(texel, 24), a), 8);
+			r = _mm_srli_epi32(sse2_mul32(_mm_and_si128(_mm_srli_epi32(texel, 16), byteMask), r), 8);
+			g = _mm_srli_epi32(sse2_mul32(_mm_and_si128(_mm_srli_epi32(texel, 8), byteMask), g), 8);
+			b = _mm_srli_epi32(sse2_mul32(_mm_and_si128(texel, byteMask), b), 8);
+		}
+		a = _mm_and_si128(a, byteMask);
+		r = _mm_and_si128(r, byteMask);
+		g = _mm_and_si128(g, byteMask);
+		b = _mm_and_si128(b, byteMask);
+
+		__m128i color = _mm_sll_epi32(_mm_srl_epi32(a, aLoss), aShift);
+		color = _mm_or_si128(color, _mm_sll_epi32(_mm_srl_epi32(r, rLoss), rShift));
+		color = _mm_or_si128(color, _mm_sll_epi32(_mm_srl_epi32(g, gLoss), gShift));
+		color = _mm_or_si128(color, _mm_sll_epi32(_mm_srl_epi32(b, bLoss), bShift));
+		_mm_storeu_si128((__m128i *)(pbuf + i), sse2_select(write, color, _mm_loadu_si128((const __m128i *)(pbuf + i))));
+
+		if (args.depthWrite) {
+			const __m128i z = sse2_roundDepth(sse2_ramp(args.z + i * args.dzdx, args.dzdx));
+			_mm_storeu_si128((__m128i *)(pz + i), sse2_select(write, z, _mm_loadu_si128((const __m128i *)(pz + i))));
+		}
+	}
+}
+
+uint32 SpanKernels::depthTestSSE2(const uint *pz, uint z, int dzdx, int count, int depthFunc) {
+	if (count == kMaxSpan)
+		return depthTestSSE2Impl(pz, z, dzdx, depthFunc);
+
+	// Short spans work on a copy, to stay inside the depth buffer
+	uint depth[kMaxSpan] = {};
+	memcpy(depth, pz, count * sizeof(uint));
+	return depthTestSSE2Impl(depth, z, dzdx, depthFunc) & ((1 << count) - 1);
+}
+
+void SpanKernels::writeSSE2(const SpanArgs &args, uint32 mask) {
+	if (args.count == kMaxSpan) {
+		writeSSE2Impl(args, args.pbuf, args.pz, mask);
+		return;
+	}
+
+	uint32 pixels[kMaxSpan];
+	uint depth[kMaxSpan];
+	memcpy(pixels, args.pbuf, args.count * sizeof(uint32));
+	memcpy(depth, args.pz, args.count * sizeof(uint));
+	writeSSE2Impl(args, pixels, depth, mask & ((1 << args.count) - 1));
+	memcpy(args.pbuf, pixels, args.count * sizeof(uint32));
+	memcpy(args.pz, depth, args.count * sizeof(uint));
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
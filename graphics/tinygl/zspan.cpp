@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/system.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+SpanKernels::DepthTestFunc SpanKernels::depthTestFunc = nullptr;
+SpanKernels::WriteFunc SpanKernels::writeFunc = nullptr;
+
+void SpanKernels::init() {
+	if (writeFunc)
+		return;
+
+	depthTestFunc = depthTestGeneric;
+	writeFunc = writeGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		depthTestFunc = depthTestNEON;
+		writeFunc = writeNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		depthTestFunc = depthTestSSE2;
+		writeFunc = writeSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		depthTestFunc = depthTestAVX2;
+		writeFunc = writeAVX2;
+	}
+#endif
+}
+
+uint32 SpanKernels::depthTestGeneric(const uint *pz, uint z, int dzdx, int count, int depthFunc) {
+	uint32 mask = 0;
+	for (int i = 0; i < count; i++) {
+		bool pass;
+		switch (depthFunc) {
+		case TGL_LESS:
+			pass = pz[i] < z;
+			break;
+		case TGL_EQUAL:
+			pass = pz[i] == z;
+			break;
+		case TGL_LEQUAL:
+			pass = pz[i] <= z;
+			break;
+		case TGL_GREATER:
+			pass = pz[i] > z;
+			break;
+		case TGL_NOTEQUAL:
+			pass = pz[i] != z;
+			break;
+		case TGL_GEQUAL:
+			pass = pz[i] >= z;
+			break;
+		case TGL_ALWAYS:
+			pass = true;
+			break;
+		default:
+			pass = false;
+			break;
+		}
+		if (pass)
+			mask |= 1 << i;
+		z += dzdx;
+	}
+	return mask;
+}
+
+void SpanKernels::writeGeneric(const SpanArgs &args, uint32 mask) {
+	uint z = args.z;
+	uint r = args.r, g = args.g, b = args.b, a = args.a;
+	for (int i = 0; i < args.count; i++) {
+		if (mask & (1 << i)) {
+			uint8 c_a, c_r, c_g, c_b;
+			if (args.texels) {
+				const uint32 texel = args.texels[i];
+				c_a = ((texel >> 24) * (a >> 8)) >> 8;
+				c_r = (((texel >> 16) & 0xFF) * (r >> 8)) >> 8;
+				c_g = (((texel >> 8) & 0xFF) * (g >> 8)) >> 8;
+				c_b = ((texel & 0xFF) * (b >> 8)) >> 8;
+			} else {
+				c_a = a >> 8;
+				c_r = r >> 8;
+				c_g = g >> 8;
+				c_b = b >> 8;
+			}
+			args.pbuf[i] = args.format->ARGBToColor(c_a, c_r, c_g, c_b);
+			// The per pixel code passes the depth through a float
+			if (args.depthWrite)
+				args.pz[i] = (uint)(float)z;
+		}
+		z += args.dzdx;
+		r += args.drdx;
+		g += args.dgdx;
+		b += args.dbdx;
+		a += args.dadx;
+	}
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+
+class TinyGLTestSuite;
+
+namespace Graphics {
+struct PixelFormat;
+}
+
+namespace TinyGL {
+
+/**
+ * A run of pixels on a scan line of a triangle, written by FrameBuffer::fillTriangle
+ * when stencil test, alpha test, blending and fog are all disabled. Pixels outside
+ * the scissor rectangle are left out of the masks passed to SpanKernels::write().
+ */
+struct SpanArgs {
+	uint32 *pbuf;                       ///< First pixel of the span, in a 32 bpp frame buffer
+	uint *pz;                           ///< Depth of the first pixel
+	const uint32 *texels;               ///< kMaxSpan texel colors as ARGB8888, or nullptr for untextured spans
+	int count;                          ///< Number of pixels, at most SpanKernels::kMaxSpan
+	bool depthWrite;
+	uint z;
+	int dzdx;
+	uint r, g, b, a;                    ///< Color of the first pixel in 8.8 fixed point, which modulates the texels (1.0 leaves them unchanged)
+	int drdx, dgdx, dbdx;
+	uint dadx;
+	const Graphics::PixelFormat *format;
+};
+
+/**
+ * Depth test and pixel write kernels for spans of up to kMaxSpan pixels.
+ *
+ * Spans are processed in two steps, so textures only need to be sampled for
+ * the pixels passing the depth test: depthTest() returns a mask of those
+ * pixels, and write() stores their color and depth. The results match the
+ * per pixel code in FrameBuffer exactly. SIMD implementations are selected
+ * at runtime, in the same way as Graphics::BlendBlit does it.
+ */
+class SpanKernels {
+public:
+	static const int kMaxSpan = 8;
+
+	/** Select the kernels for the CPU, if that has not been done yet. */
+	static void init();
+
+	/**
+	 * Return a mask with bit i set if pixel i of @p count pixels, starting at
+	 * depth @p z, passes the depth test @p depthFunc against @p pz.
+	 */
+	static uint32 depthTest(const uint *pz, uint z, int dzdx, int count, int depthFunc) {
+		return depthTestFunc(pz, z, dzdx, count, depthFunc);
+	}
+
+	/** Write the pixels of @p args whose bit is set in @p mask. */
+	static void write(const SpanArgs &args, uint32 mask) {
+		writeFunc(args, mask);
+	}
+
+private:
+	typedef uint32 (*DepthTestFunc)(const uint *pz, uint z, int dzdx, int count, int depthFunc);
+	typedef void (*WriteFunc)(const SpanArgs &args, uint32 mask);
+
+#ifdef SCUMMVM_NEON
+	static uint32 depthTestNEON(const uint *pz, uint z, int dzdx, int count, int depthFunc);
+	static void writeNEON(const SpanArgs &args, uint32 mask);
+#endif
+#ifdef SCUMMVM_SSE2
+	static uint32 depthTestSSE2(const uint *pz, uint z, int dzdx, int count, int depthFunc);
+	static void writeSSE2(const SpanArgs &args, uint32 mask);
+#endif
+#ifdef SCUMMVM_AVX2
+	static uint32 depthTestAVX2(const uint *pz, uint z, int dzdx, int count, int depthFunc);
+	static void writeAVX2(const SpanArgs &args, uint32 mask);
+#endif
+	static uint32 depthTestGeneric(const uint *pz, uint z, int dzdx, int count, int depthFunc);
+	static void writeGeneric(const SpanArgs &args, uint32 mask);
+
+	static DepthTestFunc depthTestFunc;
+	static WriteFunc writeFunc;
+	friend class ::TinyGLTestSuite;
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -29,10 +29,11 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
 
 namespace TinyGL {
 
-static const int NB_INTERP = 8;
+static const int NB_INTERP = SpanKernels::kMaxSpan;
 
 template <bool kDepthWrite, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
@@ -130,6 +131,69 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
 	}
 }
 
+template <bool kDepthWrite, bool kSmoothMode, bool kEnableScissor, bool kDepthTestEnabled>
+void FrameBuffer::putSpan(int fbOffset, const TexelBuffer *texture, uint *pz, int count, int x,
+                          uint &z, int &t, int &s, uint &r, uint &g, uint &b, uint &a,
+                          int dzdx, int dsdx, int dtdx, int drdx, int dgdx, int dbdx, uint dadx) {
+	uint32 mask = (1 << count) - 1;
+	if (kEnableScissor) {
+		// drop the pixels left and right of the scissor rectangle, the scan line is inside it
+		const int first = _clipRectangle.left - x;
+		const int last = _clipRectangle.right - x;
+		if (first > 0)
+			mask &= first < count ? ~((1 << first) - 1) : 0;
+		if (last < count)
+			mask &= last > 0 ? (1 << last) - 1 : 0;
+	}
+	if (kDepthTestEnabled && mask) {
+		mask &= SpanKernels::depthTest(pz, z, dzdx, count, _depthFunc);
+	}
+	if (mask) {
+		uint32 texels[SpanKernels::kMaxSpan] = {};
+		SpanArgs args;
+		args.pbuf = (uint32 *)_pbuf + fbOffset;
+		args.pz = pz;
+		args.texels = nullptr;
+		args.count = count;
+		args.depthWrite = kDepthWrite;
+		args.z = z;
+		args.dzdx = dzdx;
+		args.r = r;
+		args.g = g;
+		args.b = b;
+		args.a = a;
+		args.drdx = kSmoothMode ? drdx : 0;
+		args.dgdx = kSmoothMode ? dgdx : 0;
+		args.dbdx = kSmoothMode ? dbdx : 0;
+		args.dadx = kSmoothMode ? dadx : 0;
+		args.format = &_pbufFormat;
+		if (texture) {
+			// only the pixels passing the depth test need to be sampled
+			int ts = s, tt = t;
+			for (int i = 0; i < count; i++) {
+				if (mask & (1 << i)) {
+					uint8 c_a, c_r, c_g, c_b;
+					texture->getARGBAt(_wrapS, _wrapT, ts, tt, c_a, c_r, c_g, c_b);
+					texels[i] = (c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+				}
+				ts += dsdx;
+				tt += dtdx;
+			}
+			args.texels = texels;
+		}
+		SpanKernels::write(args, mask);
+	}
+	z += count * dzdx;
+	s += count * dsdx;
+	t += count * dtdx;
+	if (kSmoothMode) {
+		a += count * dadx;
+		r += count * drdx;
+		g += count * dgdx;
+		b += count * dbdx;
+	}
+}
+
 template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
@@ -172,6 +236,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 	int nb_lines, dx1, dy1, tmp, dx2, dy2, y;
 
+	// spans without any per pixel state besides the depth and scissor tests go through the span kernels
+	const bool useSpanKernels = kInterpZ && !kFogMode && !kAlphaTestEnabled &&
+	                            !kBlendingEnabled && !kStencilEnabled && _pbufBpp == 4;
+
 	int error = 0, derror = 0;
 	int x1 = 0, dxdy_min = 0, dxdy_max = 0;
 	// warning: x2 is multiplied by 2^16
@@ -207,6 +275,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	// nothing to draw if the triangle lies above or below the scissor rectangle
+	if (kEnableScissor && (p2->y < _clipRectangle.top || p0->y >= _clipRectangle.bottom))
+		return;
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -424,7 +496,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// the whole scan line is scissored out, only the edges need to be stepped
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -483,6 +557,36 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				if (useSpanKernels) {
+					int s = 0, t = 0;
+					if (kEnableScissor) {
+						// clip the scan line to the scissor rectangle, instead of testing every pixel
+						const int skip = MIN<int>(_clipRectangle.left - x, n + 1);
+						if (skip > 0) {
+							pp += skip;
+							pz += skip;
+							z += skip * dzdx;
+							if (kSmoothMode) {
+								r += skip * drdx;
+								g += skip * dgdx;
+								b += skip * dbdx;
+								a += skip * dadx;
+							}
+							n -= skip;
+							x += skip;
+						}
+						n = MIN<int>(n, _clipRectangle.right - 1 - x);
+					}
+					while (n >= 0) {
+						int count = MIN<int>(n + 1, SpanKernels::kMaxSpan);
+						putSpan<kDepthWrite, kSmoothMode, kEnableScissor, kDepthTestEnabled>
+						       (pp, nullptr, pz, count, x, z, t, s, r, g, b, a, dzdx, 0, 0, drdx, dgdx, dbdx, dadx);
+						pp += count;
+						pz += count;
+						n -= count;
+						x += count;
+					}
+				}
 				while (n >= 3) {
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 					                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
@@ -557,9 +661,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					if (useSpanKernels) {
+						putSpan<kDepthWrite, kSmoothMode, kEnableScissor, kDepthTestEnabled>
+						       (pp, texture, pz, NB_INTERP, x, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -584,6 +693,11 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
 				}
 
+				if (useSpanKernels && n >= 0) {
+					putSpan<kDepthWrite, kSmoothMode, kEnableScissor, kDepthTestEnabled>
+					       (pp, texture, pz, n + 1, x, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					n = -1;
+				}
 				while (n >= 0) {
 					putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 					               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
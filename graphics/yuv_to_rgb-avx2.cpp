@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+static FORCEINLINE __m256i loadOffsets_AVX2(const int16 *offsets, uint chromaShift) {
+	if (chromaShift) {
+		const __m128i shared = _mm_loadu_si128((const __m128i *)offsets);
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(shared, shared)), _mm_unpackhi_epi16(shared, shared), 1);
+	}
+	return _mm256_loadu_si256((const __m256i *)offsets);
+}
+
+/**
+ * Return the red, green or blue values of 16 pixels, computed like
+ * yuvToRGBChannel(). The division by 219 is done by multiplying with
+ * 2^23 / 219 rounded up, which is exact for all values that occur.
+ */
+static FORCEINLINE __m256i channel_AVX2(__m256i y, __m256i offsets, bool itu) {
+	const __m256i value = _mm256_add_epi16(y, offsets);
+	if (itu) {
+		const __m256i clipped = _mm256_min_epi16(_mm256_max_epi16(value, _mm256_set1_epi16(16)), _mm256_set1_epi16(235));
+		const __m256i scaled = _mm256_mullo_epi16(_mm256_sub_epi16(clipped, _mm256_set1_epi16(16)), _mm256_set1_epi16(255));
+		return _mm256_srli_epi16(_mm256_mulhi_epu16(scaled, _mm256_set1_epi16((int16)38305)), 7);
+	}
+	return _mm256_min_epi16(_mm256_max_epi16(value, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+}
+
+static FORCEINLINE __m256i widen_AVX2(__m256i value, int half, __m128i shift) {
+	return _mm256_sll_epi32(_mm256_cvtepu16_epi32(half ? _mm256_extracti128_si256(value, 1) : _mm256_castsi256_si128(value)), shift);
+}
+
+template<typename PixelInt>
+static void convertRow_AVX2(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(format.aShift);
+
+	for (uint x = 0; x < count; x += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		const int16 *chroma = offsets + (x >> chromaShift);
+
+		const __m256i r = _mm256_srl_epi16(channel_AVX2(y, loadOffsets_AVX2(chroma + 0 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), rLoss);
+		const __m256i g = _mm256_srl_epi16(channel_AVX2(y, loadOffsets_AVX2(chroma + 1 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), gLoss);
+		const __m256i b = _mm256_srl_epi16(channel_AVX2(y, loadOffsets_AVX2(chroma + 2 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), bLoss);
+		const __m256i a = aSrc ? _mm256_srl_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(aSrc + x))), aLoss) : _mm256_setzero_si256();
+
+		if (sizeof(PixelInt) == 2) {
+			__m256i color = _mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift));
+			color = _mm256_or_si256(color, _mm256_or_si256(_mm256_sll_epi16(b, bShift), _mm256_sll_epi16(a, aShift)));
+			color = _mm256_or_si256(color, _mm256_set1_epi16((int16)format.alpha));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), color);
+		} else {
+			const __m256i alpha = _mm256_set1_epi32((int32)format.alpha);
+			for (int half = 0; half < 2; half++) {
+				__m256i color = _mm256_or_si256(widen_AVX2(r, half, rShift), widen_AVX2(g, half, gShift));
+				color = _mm256_or_si256(color, _mm256_or_si256(widen_AVX2(b, half, bShift), widen_AVX2(a, half, aShift)));
+				_mm256_storeu_si256((__m256i *)(dst + x * 4 + half * 32), _mm256_or_si256(color, alpha));
+			}
+		}
+	}
+}
+
+void YUVToRGBRows::convertAVX2(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	const uint vectorCount = count & ~15;
+	if (format.bytesPerPixel == 2)
+		convertRow_AVX2<uint16>(dst, format, ySrc, aSrc, offsets, vectorCount, chromaShift);
+	else
+		convertRow_AVX2<uint32>(dst, format, ySrc, aSrc, offsets, vectorCount, chromaShift);
+
+	convertGeneric(dst + vectorCount * format.bytesPerPixel, format, ySrc + vectorCount, aSrc ? aSrc + vectorCount : nullptr,
+	               offsets + (vectorCount >> chromaShift), count - vectorCount, chromaShift);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Graphics {
+
+static FORCEINLINE int16x8_t loadOffsets_NEON(const int16 *offsets, uint chromaShift) {
+	if (chromaShift) {
+		const int16x4x2_t shared = vzip_s16(vld1_s16(offsets), vld1_s16(offsets));
+		return vcombine_s16(shared.val[0], shared.val[1]);
+	}
+	return vld1q_s16(offsets);
+}
+
+/**
+ * Return the red, green or blue values of 8 pixels, computed like
+ * yuvToRGBChannel(). The division by 219 is done by multiplying with
+ * 2^23 / 219 rounded up, which is exact for all values that occur.
+ */
+static FORCEINLINE uint16x8_t channel_NEON(int16x8_t y, int16x8_t offsets, bool itu) {
+	const int16x8_t value = vaddq_s16(y, offsets);
+	if (itu) {
+		const int16x8_t clipped = vminq_s16(vmaxq_s16(value, vdupq_n_s16(16)), vdupq_n_s16(235));
+		const uint16x8_t scaled = vmulq_n_u16(vreinterpretq_u16_s16(vsubq_s16(clipped, vdupq_n_s16(16))), 255);
+		const uint32x4_t lo = vmull_n_u16(vget_low_u16(scaled), 38305);
+		const uint32x4_t hi = vmull_n_u16(vget_high_u16(scaled), 38305);
+		return vshrq_n_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)), 7);
+	}
+	return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(value, vdupq_n_s16(0)), vdupq_n_s16(255)));
+}
+
+template<typename PixelInt>
+static void convertRow_NEON(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	// NEON shifts right by shifting left with negative counts
+	const int16x8_t rLoss = vdupq_n_s16(-format.rLoss);
+	const int16x8_t gLoss = vdupq_n_s16(-format.gLoss);
+	const int16x8_t bLoss = vdupq_n_s16(-format.bLoss);
+	const int16x8_t aLoss = vdupq_n_s16(-format.aLoss);
+
+	for (uint x = 0; x < count; x += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		const int16 *chroma = offsets + (x >> chromaShift);
+
+		const uint16x8_t r = vshlq_u16(channel_NEON(y, loadOffsets_NEON(chroma + 0 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), rLoss);
+		const uint16x8_t g = vshlq_u16(channel_NEON(y, loadOffsets_NEON(chroma + 1 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), gLoss);
+		const uint16x8_t b = vshlq_u16(channel_NEON(y, loadOffsets_NEON(chroma + 2 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), bLoss);
+		const uint16x8_t a = aSrc ? vshlq_u16(vmovl_u8(vld1_u8(aSrc + x)), aLoss) : vdupq_n_u16(0);
+
+		if (sizeof(PixelInt) == 2) {
+			uint16x8_t color = vorrq_u16(vshlq_u16(r, vdupq_n_s16(format.rShift)), vshlq_u16(g, vdupq_n_s16(format.gShift)));
+			color = vorrq_u16(color, vorrq_u16(vshlq_u16(b, vdupq_n_s16(format.bShift)), vshlq_u16(a, vdupq_n_s16(format.aShift))));
+			vst1q_u16((uint16 *)(dst + x * 2), vorrq_u16(color, vdupq_n_u16(format.alpha)));
+		} else {
+			const int32x4_t rShift = vdupq_n_s32(format.rShift);
+			const int32x4_t gShift = vdupq_n_s32(format.gShift);
+			const int32x4_t bShift = vdupq_n_s32(format.bShift);
+			const int32x4_t aShift = vdupq_n_s32(format.aShift);
+
+			uint32x4_t lo = vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(g)), gShift));
+			uint32x4_t hi = vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(g)), gShift));
+			lo = vorrq_u32(lo, vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(b)), bShift), vshlq_u32(vmovl_u16(vget_low_u16(a)), aShift)));
+			hi = vorrq_u32(hi, vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(b)), bShift), vshlq_u32(vmovl_u16(vget_high_u16(a)), aShift)));
+			vst1q_u32((uint32 *)(dst + x * 4), vorrq_u32(lo, vdupq_n_u32(format.alpha)));
+			vst1q_u32((uint32 *)(dst + x * 4 + 16), vorrq_u32(hi, vdupq_n_u32(format.alpha)));
+		}
+	}
+}
+
+void YUVToRGBRows::convertNEON(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	const uint vectorCount = count & ~7;
+	if (format.bytesPerPixel == 2)
+		convertRow_NEON<uint16>(dst, format, ySrc, aSrc, offsets, vectorCount, chromaShift);
+	else
+		convertRow_NEON<uint32>(dst, format, ySrc, aSrc, offsets, vectorCount, chromaShift);
+
+	convertGeneric(dst + vectorCount * format.bytesPerPixel, format, ySrc + vectorCount, aSrc ? aSrc + vectorCount : nullptr,
+	               offsets + (vectorCount >> chromaShift), count - vectorCount, chromaShift);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
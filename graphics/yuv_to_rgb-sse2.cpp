@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+static FORCEINLINE __m128i loadOffsets_SSE2(const int16 *offsets, uint chromaShift) {
+	if (chromaShift) {
+		const __m128i shared = _mm_loadl_epi64((const __m128i *)offsets);
+		return _mm_unpacklo_epi16(shared, shared);
+	}
+	return _mm_loadu_si128((const __m128i *)offsets);
+}
+
+/**
+ * Return the red, green or blue values of 8 pixels, computed like
+ * yuvToRGBChannel(). The division by 219 is done by multiplying with
+ * 2^23 / 219 rounded up, which is exact for all values that occur.
+ */
+static FORCEINLINE __m128i channel_SSE2(__m128i y, __m128i offsets, bool itu) {
+	const __m128i value = _mm_add_epi16(y, offsets);
+	if (itu) {
+		const __m128i clipped = _mm_min_epi16(_mm_max_epi16(value, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+		const __m128i scaled = _mm_mullo_epi16(_mm_sub_epi16(clipped, _mm_set1_epi16(16)), _mm_set1_epi16(255));
+		return _mm_srli_epi16(_mm_mulhi_epu16(scaled, _mm_set1_epi16((int16)38305)), 7);
+	}
+	return _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), _mm_set1_epi16(255));
+}
+
+template<typename PixelInt>
+static void convertRow_SSE2(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(format.aShift);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (uint x = 0; x < count; x += 8) {
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		const int16 *chroma = offsets + (x >> chromaShift);
+
+		const __m128i r = _mm_srl_epi16(channel_SSE2(y, loadOffsets_SSE2(chroma + 0 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), rLoss);
+		const __m128i g = _mm_srl_epi16(channel_SSE2(y, loadOffsets_SSE2(chroma + 1 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), gLoss);
+		const __m128i b = _mm_srl_epi16(channel_SSE2(y, loadOffsets_SSE2(chroma + 2 * YUVToRGBRows::kMaxChunk, chromaShift), format.itu), bLoss);
+		const __m128i a = aSrc ? _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(aSrc + x)), zero), aLoss) : zero;
+
+		if (sizeof(PixelInt) == 2) {
+			__m128i color = _mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift));
+			color = _mm_or_si128(color, _mm_or_si128(_mm_sll_epi16(b, bShift), _mm_sll_epi16(a, aShift)));
+			color = _mm_or_si128(color, _mm_set1_epi16((int16)format.alpha));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), color);
+		} else {
+			__m128i lo = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift));
+			__m128i hi = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift));
+			lo = _mm_or_si128(lo, _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift), _mm_sll_epi32(_mm_unpacklo_epi16(a, zero), aShift)));
+			hi = _mm_or_si128(hi, _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift), _mm_sll_epi32(_mm_unpackhi_epi16(a, zero), aShift)));
+			const __m128i alpha = _mm_set1_epi32((int32)format.alpha);
+			_mm_storeu_si128((__m128i *)(dst + x * 4), _mm_or_si128(lo, alpha));
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), _mm_or_si128(hi, alpha));
+		}
+	}
+}
+
+void YUVToRGBRows::convertSSE2(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	const uint vectorCount = count & ~7;
+	if (format.bytesPerPixel == 2)
+		convertRow_SSE2<uint16>(dst, format, ySrc, aSrc, offsets, vectorCount, chromaShift);
+	else
+		convertRow_SSE2<uint32>(dst, format, ySrc, aSrc, offsets, vectorCount, chromaShift);
+
+	convertGeneric(dst + vectorCount * format.bytesPerPixel, format, ySrc + vectorCount, aSrc ? aSrc + vectorCount : nullptr,
+	               offsets + (vectorCount >> chromaShift), count - vectorCount, chromaShift);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
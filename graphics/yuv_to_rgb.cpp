@@ -82,8 +82,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -97,12 +100,14 @@ public:
 
 	Graphics::PixelFormat getFormat() const { return _format; }
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
+	bool getAlphaMode() const { return _alphaMode; }
 	const uint32 *getRGBToPix() const { return _rgbToPix; }
 	const uint32 *getAlphaToPix() const { return _alphaToPix; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
+	bool _alphaMode;
 	uint32 _rgbToPix[3 * 768]; // 9216 bytes
 	uint32 _alphaToPix[256];   // 958 bytes
 };
@@ -110,6 +115,7 @@ private:
 YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
 	_format = format;
 	_scale = scale;
+	_alphaMode = alphaMode;
 
 	int alphaValue = alphaMode ? 0 : 255;
 
@@ -165,9 +171,56 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
+YUVToRGBRowFormat::YUVToRGBRowFormat(const PixelFormat &format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) :
+	bytesPerPixel(format.bytesPerPixel),
+	rLoss(format.rLoss), gLoss(format.gLoss), bLoss(format.bLoss), aLoss(format.aLoss),
+	rShift(format.rShift), gShift(format.gShift), bShift(format.bShift), aShift(format.aShift),
+	itu(scale == YUVToRGBManager::kScaleITU),
+	alpha(alphaMode ? 0 : format.ARGBToColor(255, 0, 0, 0)) {
+}
+
+// Initialize this to nullptr at the start
+YUVToRGBRows::RowFunc YUVToRGBRows::rowFunc = nullptr;
+
+void YUVToRGBRows::init() {
+	// If no function has been selected yet, detect and select
+	if (rowFunc)
+		return;
+
+	rowFunc = convertGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		rowFunc = convertNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		rowFunc = convertSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		rowFunc = convertAVX2;
+#endif
+}
+
+void YUVToRGBRows::convertGeneric(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+	for (uint x = 0; x < count; x++) {
+		const int16 *chroma = offsets + (x >> chromaShift);
+		uint32 color = format.alpha;
+		color |= (yuvToRGBChannel(ySrc[x] + chroma[0 * kMaxChunk], format.itu) >> format.rLoss) << format.rShift;
+		color |= (yuvToRGBChannel(ySrc[x] + chroma[1 * kMaxChunk], format.itu) >> format.gLoss) << format.gShift;
+		color |= (yuvToRGBChannel(ySrc[x] + chroma[2 * kMaxChunk], format.itu) >> format.bLoss) << format.bShift;
+		if (aSrc)
+			color |= (aSrc[x] >> format.aLoss) << format.aShift;
+
+		if (format.bytesPerPixel == 2)
+			((uint16 *)dst)[x] = color;
+		else
+			((uint32 *)dst)[x] = color;
+	}
+}
+
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
-	_alphaMode = false;
+	YUVToRGBRows::init();
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -189,17 +242,62 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i];
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool alphaMode) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale && _alphaMode == alphaMode)
-		return _lookup;
+	// Tables are never replaced, as another thread may still be using them
+	Common::StackLock lock(_lookupMutex);
+	for (uint i = 0; i < _lookups.size(); i++) {
+		const YUVToRGBLookup *lookup = _lookups[i];
+		if (lookup->getFormat() == format && lookup->getScale() == scale && lookup->getAlphaMode() == alphaMode)
+			return lookup;
+	}
 
-	_alphaMode = alphaMode;
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale, alphaMode);
-	return _lookup;
+	_lookups.push_back(new YUVToRGBLookup(format, scale, alphaMode));
+	return _lookups.back();
+}
+
+/**
+ * Compute the offsets YUVToRGBRows adds to the luminance for @p count
+ * chroma samples.
+ */
+static void computeChromaOffsets(int16 *offsets, const int16 *colorTab, const byte *uSrc, const byte *vSrc, uint count) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	// The color tables include the position of the channel in the lookup
+	// table, which is removed here
+	for (uint i = 0; i < count; i++) {
+		offsets[i + 0 * YUVToRGBRows::kMaxChunk] = Cr_r_tab[vSrc[i]] - (0 * 768 + 256);
+		offsets[i + 1 * YUVToRGBRows::kMaxChunk] = Cr_g_tab[vSrc[i]] + Cb_g_tab[uSrc[i]] - (1 * 768 + 256);
+		offsets[i + 2 * YUVToRGBRows::kMaxChunk] = Cb_b_tab[uSrc[i]] - (2 * 768 + 256);
+	}
+}
+
+/**
+ * Convert an image with YUVToRGBRows, in chunks of pixels which share
+ * their chroma offsets. Every chroma sample covers (1 << chromaShiftX)
+ * pixels horizontally and (1 << chromaShiftY) pixels vertically.
+ */
+static void convertYUVRows(Graphics::Surface *dst, const YUVToRGBRowFormat &format, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, uint chromaShiftX, uint chromaShiftY) {
+	int16 offsets[3 * YUVToRGBRows::kMaxChunk];
+
+	for (int chromaY = 0; chromaY < (yHeight >> chromaShiftY); chromaY++) {
+		for (int x = 0; x < yWidth; x += YUVToRGBRows::kMaxChunk) {
+			const uint count = MIN<uint>(yWidth - x, YUVToRGBRows::kMaxChunk);
+			const int chromaOffset = chromaY * uvPitch + (x >> chromaShiftX);
+			computeChromaOffsets(offsets, colorTab, uSrc + chromaOffset, vSrc + chromaOffset, count >> chromaShiftX);
+
+			for (int y = chromaY << chromaShiftY; y < (chromaY + 1) << chromaShiftY; y++) {
+				YUVToRGBRows::convert((byte *)dst->getBasePtr(x, y), format, ySrc + y * yPitch + x,
+				                      aSrc ? aSrc + y * yPitch + x : nullptr, offsets, count, chromaShiftX);
+			}
+		}
+	}
 }
 
 #define PUT_PIXEL(s, d) \
@@ -243,6 +341,11 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	if (YUVToRGBRows::isAccelerated()) {
+		convertYUVRows(dst, YUVToRGBRowFormat(dst->format, scale, false), _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 0, 0);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -295,6 +398,11 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
 
+	if (YUVToRGBRows::isAccelerated()) {
+		convertYUVRows(dst, YUVToRGBRowFormat(dst->format, scale, false), _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1, 0);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -351,6 +459,11 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	if (YUVToRGBRows::isAccelerated()) {
+		convertYUVRows(dst, YUVToRGBRowFormat(dst->format, scale, false), _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1, 1);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -415,6 +528,11 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	if (YUVToRGBRows::isAccelerated()) {
+		convertYUVRows(dst, YUVToRGBRowFormat(dst->format, scale, true), _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 1, 1);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -488,6 +606,40 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+/**
+ * Convert a YUV410 image with YUVToRGBRows. The chroma is interpolated for
+ * every pixel, as in convertYUV410ToRGB().
+ */
+static void convertYUV410Rows(Graphics::Surface *dst, const YUVToRGBRowFormat &format, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	int16 offsets[3 * YUVToRGBRows::kMaxChunk];
+	byte uRow[YUVToRGBRows::kMaxChunk], vRow[YUVToRGBRows::kMaxChunk];
+
+	for (int y = 0; y < yHeight; y++) {
+		const int yDiff = y & 3;
+
+		for (int x = 0; x < yWidth; x += YUVToRGBRows::kMaxChunk) {
+			const uint count = MIN<uint>(yWidth - x, YUVToRGBRows::kMaxChunk);
+
+			for (uint i = 0; i < count; i++) {
+				const int xDiff = (x + i) & 3;
+				const int index = (y >> 2) * uvPitch + ((x + i) >> 2);
+
+				READ_QUAD(uSrc, u);
+				READ_QUAD(vSrc, v);
+
+				byte u, v;
+				DO_INTERPOLATION(u);
+				DO_INTERPOLATION(v);
+				uRow[i] = u;
+				vRow[i] = v;
+			}
+
+			computeChromaOffsets(offsets, colorTab, uRow, vRow, count);
+			YUVToRGBRows::convert((byte *)dst->getBasePtr(x, y), format, ySrc + y * yPitch + x, nullptr, offsets, count, 0);
+		}
+	}
+}
+
 #undef READ_QUAD
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
@@ -500,6 +652,11 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	if (YUVToRGBRows::isAccelerated()) {
+		convertYUV410Rows(dst, YUVToRGBRowFormat(dst->format, scale, false), _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
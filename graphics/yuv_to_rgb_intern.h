@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/util.h"
+
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite;
+
+namespace Graphics {
+
+/**
+ * Destination format of the YUVToRGBRows functions.
+ */
+struct YUVToRGBRowFormat {
+	YUVToRGBRowFormat(const PixelFormat &format, YUVToRGBManager::LuminanceScale scale, bool alphaMode);
+
+	byte bytesPerPixel;
+	byte rLoss, gLoss, bLoss, aLoss;
+	byte rShift, gShift, bShift, aShift;
+	bool itu;     ///< Whether luminance ranges from 16 to 235
+	uint32 alpha; ///< Alpha bits of pixels without an alpha source
+};
+
+/**
+ * Converts rows of YUV pixels to RGB arithmetically, which gives the same
+ * results as the lookup tables of YUVToRGBManager but can be vectorized.
+ *
+ * The chroma of the pixels is passed as offsets which are added to the
+ * luminance to get the red, green and blue values. They are computed once
+ * for every chroma sample, which may be shared by two neighbouring pixels.
+ */
+class YUVToRGBRows {
+public:
+	/**
+	 * Convert @p count pixels.
+	 *
+	 * @param dst          Destination pixels, in the format described by @p format.
+	 * @param ySrc         Luminance of the pixels.
+	 * @param aSrc         Alpha of the pixels, nullptr for opaque pixels.
+	 * @param offsets      Red, green and blue offsets of the chroma samples,
+	 *                     as three arrays of kMaxChunk entries.
+	 * @param chromaShift  1 if every chroma sample is shared by two pixels, 0 otherwise.
+	 */
+	static void convert(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+		rowFunc(dst, format, ySrc, aSrc, offsets, count, chromaShift);
+	}
+
+	/** Return true if a vectorized implementation has been selected. */
+	static bool isAccelerated() { return rowFunc != convertGeneric; }
+
+	/** Select the fastest implementation supported by the CPU. */
+	static void init();
+
+	/** Maximum number of pixels passed to convert() at once. */
+	static const uint kMaxChunk = 256;
+
+private:
+	typedef void (*RowFunc)(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift);
+
+	static void convertGeneric(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift);
+#ifdef SCUMMVM_NEON
+	static void convertNEON(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void convertSSE2(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void convertAVX2(byte *dst, const YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift);
+#endif
+
+	static RowFunc rowFunc;
+
+	friend class ::YUVToRGBTestSuite;
+};
+
+/**
+ * Return the red, green or blue value for the sum of a luminance and a
+ * chroma offset, as the lookup tables do.
+ */
+static inline uint8 yuvToRGBChannel(int value, bool itu) {
+	if (itu)
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	return CLIP(value, 0, 255);
+}
+
+} // End of namespace Graphics
+
+#endif
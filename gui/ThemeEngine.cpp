@@ -242,6 +242,7 @@ ThemeEngine::~ThemeEngine() {
 	_vectorRenderer = nullptr;
 	_screen.free();
 	_backBuffer.free();
+	_renderCacheBefore.free();
 
 	unloadTheme();
 	unloadExtraFont();
@@ -338,16 +339,20 @@ bool ThemeEngine::init() {
 		if (node.isDirectory()) {
 			_themeArchive = new Common::FSDirectory(node);
 		} else if (_themeFile.baseName().matchString("*.zip", true)) {
+			// Almost all files of the theme are loaded, so let them be
+			// inflated in the background right away
+			const uint32 preloadSize = 256 * 1024;
+
 			// TODO: Also use "node" directly?
 			// Look for the zip file via SearchMan
 			Common::ArchiveMemberPtr member = SearchMan.getMember(_themeFile);
 			if (member) {
-				_themeArchive = Common::makeZipArchive(member->createReadStream());
+				_themeArchive = Common::makeZipArchive(member->createReadStream(), false, preloadSize);
 				if (!_themeArchive) {
 					warning("Failed to open Zip archive '%s'.", member->getName().c_str());
 				}
 			} else {
-				_themeArchive = Common::makeZipArchive(node);
+				_themeArchive = Common::makeZipArchive(node, false, preloadSize);
 				if (!_themeArchive) {
 					warning("Failed to open Zip archive '%s'.", node.getPath().toString(Common::Path::kNativeSeparator).c_str());
 				}
@@ -458,6 +463,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
 
+	// The cached items were drawn in the old mode and format.
+	_renderCache.clear();
+
 	// Since we reinitialized our screen surfaces we know nothing has been
 	// drawn so far. Sometimes we still end up with dirty screen bits in the
 	// list. Clearing it avoids invalid overlay writes when the backend
@@ -778,6 +786,8 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 }
 
 void ThemeEngine::unloadTheme() {
+	_renderCache.clear();
+
 	if (!_themeOk)
 		return;
 
@@ -927,6 +937,10 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		extendedRect.bottom += drawData->_shadowOffset - drawData->_backgroundOffset;
 	}
 
+	// Only items which are not clipped go through the render cache, since
+	// the clipped parts would be missing from the result.
+	const Common::Rect unclippedRect = extendedRect;
+
 	if (!_clip.isEmpty()) {
 		extendedRect.clip(_clip);
 	}
@@ -940,15 +954,46 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
-			_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+		if (area == r && extendedRect == unclippedRect && Common::Rect(_screen.w, _screen.h).contains(extendedRect)) {
+			drawDDCached(type, area, extendedRect, dynamic);
+		} else {
+			Common::List<Graphics::DrawStep>::const_iterator step;
+			for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+				_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+			}
 		}
 
 		addDirtyRect(extendedRect);
 	}
 }
 
+void ThemeEngine::drawDDCached(DrawData type, const Common::Rect &area, const Common::Rect &extendedRect, uint32 dynamic) {
+	Graphics::Surface &dst = *_vectorRenderer->getActiveSurface()->surfacePtr();
+
+	const Graphics::RenderCacheKey key(type, dynamic, extendedRect, area);
+	if (_renderCache.lookUp(key, dst, extendedRect))
+		return;
+
+	const bool store = _renderCache.wantsStore(key);
+	if (store) {
+		if (_renderCacheBefore.w != extendedRect.width() || _renderCacheBefore.h != extendedRect.height() || _renderCacheBefore.format != dst.format) {
+			_renderCacheBefore.free();
+			_renderCacheBefore.create(extendedRect.width(), extendedRect.height(), dst.format);
+		}
+		_renderCacheBefore.copyRectToSurface(dst, 0, 0, extendedRect);
+	}
+
+	// The steps are drawn exactly as without the cache. The stored area is
+	// the one marked as dirty, which already has to cover all their changes.
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	for (step = _widgets[type]->_steps.begin(); step != _widgets[type]->_steps.end(); ++step) {
+		_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+	}
+
+	if (store)
+		_renderCache.store(key, _renderCacheBefore, dst, extendedRect);
+}
+
 void ThemeEngine::drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::U32String &text,
 	bool restoreBg, bool ellipsis, Graphics::TextAlign alignH, TextAlignVertical alignV,
 	int deltax, const Common::Rect &drawableTextArea) {
@@ -34,6 +34,7 @@
 #include "graphics/managed_surface.h"
 #include "graphics/font.h"
 #include "graphics/pixelformat.h"
+#include "graphics/rendercache.h"
 
 
 #define SCUMMVM_THEME_VERSION_STR "SCUMMVM_STX0.9.15"
@@ -713,6 +714,7 @@ protected:
 	 * These functions are called from all the Widget drawing methods.
 	 */
 	void drawDD(DrawData type, const Common::Rect &r, uint32 dynamic = 0, bool forceRestore = false);
+	void drawDDCached(DrawData type, const Common::Rect &area, const Common::Rect &extendedRect, uint32 dynamic);
 	void drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::U32String &text, bool restoreBg,
 	                bool elipsis, Graphics::TextAlign alignH = Graphics::kTextAlignLeft,
 	                TextAlignVertical alignV = kTextAlignVTop, int deltax = 0,
@@ -762,6 +764,15 @@ protected:
 	/** Backbuffer surface. Stores previous states of the screen to blit back */
 	Graphics::ManagedSurface _backBuffer;
 
+	/**
+	 * Results of drawing DrawData items, which are copied instead of
+	 * drawing the items again onto the same background.
+	 */
+	Graphics::RenderCache _renderCache;
+
+	/** Contents of the area of the DrawData item being stored in the cache. */
+	Graphics::Surface _renderCacheBefore;
+
 	/**
 	 * Filter the submitted DrawData descriptors according to their layer attribute
 	 *
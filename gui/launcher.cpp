@@ -999,6 +999,7 @@ public:
 
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
 	void handleKeyDown(Common::KeyState state) override;
+	void handleTickle() override;
 
 	LauncherDisplayType getType() const override { return kLauncherDisplayGrid; }
 
@@ -1494,6 +1495,11 @@ void LauncherGrid::handleKeyDown(Common::KeyState state) {
 	updateButtons();
 }
 
+void LauncherGrid::handleTickle() {
+	_grid->handleTickle();
+	LauncherDialog::handleTickle();
+}
+
 void LauncherGrid::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
 
 	switch (cmd) {
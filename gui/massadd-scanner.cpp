@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/massadd-scanner.h"
+
+#include "common/algorithm.h"
+#include "common/threadpool.h"
+
+#ifdef __ANDROID__
+#include "backends/fs/android/android-saf-fs.h"
+#endif
+
+namespace GUI {
+
+MassAddScanner::MassAddScanner(const Common::FSNode &startDir, uint batchSize) : _batchSize(batchSize) {
+	if (!_batchSize)
+		_batchSize = ThreadPoolMan.getThreadCount() + 1;
+
+	_pending.push_back(PendingDir(startDir));
+}
+
+bool MassAddScanner::canListOnWorker(const Common::FSNode &dir) {
+#ifdef __ANDROID__
+	// Storage Access Framework nodes are listed through JNI calls which
+	// must stay on the main thread
+	if (dir.getPath().toString('/').hasPrefix(AndroidSAFFilesystemNode::SAF_MOUNT_POINT))
+		return false;
+#endif
+	return true;
+}
+
+void MassAddScanner::list(PendingDir &pending) {
+	pending.valid = pending.dir.getChildren(pending.files, Common::FSNode::kListAll);
+	pending.listed = true;
+
+	// Sort the entries, so that the results do not depend on the order
+	// the file system returns them in
+	if (pending.valid)
+		Common::sort(pending.files.begin(), pending.files.end());
+}
+
+void MassAddScanner::listRange(uint begin, uint end, void *data) {
+	MassAddScanner *scanner = (MassAddScanner *)data;
+	for (uint i = begin; i < end; i++)
+		list(*scanner->_batch[i]);
+}
+
+void MassAddScanner::prefetch() {
+	// Gather the next directories to visit which have not been listed yet.
+	// Only the listing happens on the workers, the results are consumed in
+	// visiting order.
+	_batch.clear();
+	for (uint i = _pending.size(); i > 0 && _batch.size() < _batchSize; i--) {
+		PendingDir &pending = _pending[i - 1];
+		if (!pending.listed && canListOnWorker(pending.dir))
+			_batch.push_back(&pending);
+	}
+
+	if (_batch.size() > 1)
+		ThreadPoolMan.parallelFor(_batch.size(), listRange, this);
+	else if (_batch.size() == 1)
+		list(*_batch[0]);
+	_batch.clear();
+}
+
+bool MassAddScanner::scanNext(Common::FSNode &dir, Common::FSList &files) {
+	assert(!_pending.empty());
+
+	if (!_pending.back().listed)
+		prefetch();
+
+	PendingDir next = _pending.back();
+	_pending.pop_back();
+	if (!next.listed)
+		list(next);
+
+	dir = next.dir;
+	files = next.files;
+
+	// Queue the subdirectories in reverse, so that they are visited in order
+	for (uint i = files.size(); i > 0; i--) {
+		if (files[i - 1].isDirectory())
+			_pending.push_back(PendingDir(files[i - 1]));
+	}
+
+	return next.valid;
+}
+
+} // End of namespace GUI
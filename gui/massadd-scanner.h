@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_MASSADD_SCANNER_H
+#define GUI_MASSADD_SCANNER_H
+
+#include "common/array.h"
+#include "common/fs.h"
+
+namespace GUI {
+
+/**
+ * Walks a directory tree for the mass add dialog.
+ *
+ * Directories are visited depth first, and the entries of every directory
+ * are sorted by name, so the order does not depend on the file system. When
+ * worker threads are available, the next few pending directories are listed
+ * ahead of time on the shared thread pool, which hides the latency of slow
+ * (e.g. network) storage. The visiting order is the same either way.
+ */
+class MassAddScanner {
+public:
+	/**
+	 * @param startDir   The directory to start the scan at.
+	 * @param batchSize  Number of directories listed at once, or 0 to use
+	 *                   one more than the number of worker threads.
+	 */
+	MassAddScanner(const Common::FSNode &startDir, uint batchSize = 0);
+
+	/** Return true when every directory has been visited. */
+	bool empty() const { return _pending.empty(); }
+
+	/**
+	 * Visit the next directory. Its subdirectories are queued, to be
+	 * visited before the remaining pending directories.
+	 *
+	 * @param dir    Set to the directory.
+	 * @param files  Set to its sorted entries.
+	 * @return False if the directory could not be listed.
+	 */
+	bool scanNext(Common::FSNode &dir, Common::FSList &files);
+
+private:
+	struct PendingDir {
+		PendingDir() : listed(false), valid(false) {}
+		explicit PendingDir(const Common::FSNode &node) : dir(node), listed(false), valid(false) {}
+
+		Common::FSNode dir;
+		Common::FSList files;
+		bool listed;
+		bool valid;
+	};
+
+	static void listRange(uint begin, uint end, void *data);
+	static bool canListOnWorker(const Common::FSNode &dir);
+	static void list(PendingDir &pending);
+
+	void prefetch();
+
+	/** Pending directories, the next one to visit at the end */
+	Common::Array<PendingDir> _pending;
+	/** Pending directories being listed by listRange() */
+	Common::Array<PendingDir *> _batch;
+	uint _batchSize;
+};
+
+} // End of namespace GUI
+
+#endif
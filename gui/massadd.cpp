@@ -58,6 +58,7 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
+	_scanner(startDir),
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
@@ -67,9 +68,6 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 
 	Common::U32StringArray l;
 
-	// The dir we start our scan at
-	_scanStack.push(startDir);
-
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
 
@@ -161,95 +159,94 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 	}
 }
 
-void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
-		return;	// We have finished scanning
-
-	uint32 t = g_system->getMillis();
-
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
+void MassAddDialog::scanDirectory(const Common::FSNode &dir, const Common::FSList &files) {
+	// Run the detector on the dir
+	DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
-		}
-
-		// Run the detector on the dir
-		DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
+	if (detectionResults.foundUnknownGames()) {
+		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
+		g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
+	}
 
-		if (detectionResults.foundUnknownGames()) {
-			Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
-			g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
-		}
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	DetectedGames candidates = detectionResults.listRecognizedGames();
+	for (DetectedGames::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		const DetectedGame &result = *cand;
+
+		Common::Path path = dir.getPath();
+		path.removeTrailingSeparators();
 
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		DetectedGames candidates = detectionResults.listRecognizedGames();
-		for (DetectedGames::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			const DetectedGame &result = *cand;
-
-			Common::Path path = dir.getPath();
-			path.removeTrailingSeparators();
-
-			// Check for existing config entries for this path/engineid/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
-				Common::String resultLanguageCode = Common::getLanguageCode(result.language);
-
-				bool duplicate = false;
-				const Common::StringArray &targets = _pathToTargets[path];
-				for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the engineid, gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
-						(*dom)["gameid"] == result.gameId &&
-					    dom->getValOrDefault("platform") == resultPlatformCode &&
-						parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					continue;	// Skip duplicates
+		// Check for existing config entries for this path/engineid/gameid/lang/platform combination
+		if (_pathToTargets.contains(path)) {
+			Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
+			Common::String resultLanguageCode = Common::getLanguageCode(result.language);
+
+			bool duplicate = false;
+			const Common::StringArray &targets = _pathToTargets[path];
+			for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+				// If the engineid, gameid, platform and language match -> skip it
+				Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+				assert(dom);
+
+				if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
+					(*dom)["gameid"] == result.gameId &&
+				    dom->getValOrDefault("platform") == resultPlatformCode &&
+					parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
+					duplicate = true;
+					break;
 				}
 			}
-			_games.push_back(result);
-
-			_list->append(result.description);
+			if (duplicate) {
+				_oldGamesCount++;
+				continue;	// Skip duplicates
+			}
 		}
+		_games.push_back(result);
 
+		_list->append(result.description);
+	}
 
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
 
-				_dirTotal++;
-			}
-		}
+	// Count the subdirs, which the scanner recurses into
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+		if (file->isDirectory())
+			_dirTotal++;
+	}
 
-		_dirsScanned++;
+	_dirsScanned++;
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
+	g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+	g_system->getTaskbarManager()->setCount(_games.size());
 #endif
+}
+
+void MassAddDialog::handleTickle() {
+	if (_scanner.empty())
+		return;	// We have finished scanning
+
+	uint32 t = g_system->getMillis();
+
+	// Perform a depth-first scan of the filesystem.
+	while (!_scanner.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
+		Common::FSNode dir;
+		Common::FSList files;
+		if (!_scanner.scanNext(dir, files))
+			continue;
+
+		scanDirectory(dir, files);
 	}
 
 
 	// Update the dialog
 	Common::U32String buf;
 
-	if (_scanStack.empty()) {
+	if (_scanner.empty()) {
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -23,10 +23,10 @@
 #define MASSADD_DIALOG_H
 
 #include "gui/dialog.h"
+#include "gui/massadd-scanner.h"
 #include "gui/widgets/list.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
-#include "common/stack.h"
 #include "common/str.h"
 
 namespace GUI {
@@ -48,7 +48,9 @@ public:
 	}
 
 private:
-	Common::Stack<Common::FSNode>  _scanStack;
+	void scanDirectory(const Common::FSNode &dir, const Common::FSList &files);
+
+	MassAddScanner _scanner;
 	DetectedGames _games;
 
 	/**
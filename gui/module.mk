@@ -17,6 +17,7 @@ MODULE_OBJS := \
 	imagealbum-dialog.o \
 	launcher.o \
 	massadd.o \
+	massadd-scanner.o \
 	message.o \
 	MetadataParser.o \
 	object.o \
@@ -31,6 +32,7 @@ MODULE_OBJS := \
 	ThemeEval.o \
 	ThemeLayout.o \
 	ThemeParser.o \
+	thumbnail-loader.o \
 	Tooltip.o \
 	unknown-game-dialog.o \
 	widget.o \
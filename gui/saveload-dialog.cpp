@@ -813,8 +813,14 @@ enum {
 	kNewSaveCmd = 'SAVE'
 };
 
+enum {
+	// Number of saves whose meta infos are kept in memory
+	kMaxLoadedSaves = 100
+};
+
 SaveLoadChooserGrid::SaveLoadChooserGrid(const Common::U32String &title, bool saveMode)
-	: SaveLoadChooserDialog("SaveLoadChooser", saveMode), _lines(0), _columns(0), _entriesPerPage(0),
+	: SaveLoadChooserDialog("SaveLoadChooser", saveMode), _thumbnailLoader(loadThumbnail, this, kMaxLoadedSaves, prepareThumbnail),
+	_thumbnailScaleFactor(g_gui.getScaleFactor()), _lines(0), _columns(0), _entriesPerPage(0),
 	_curPage(0), _newSaveContainer(nullptr), _nextFreeSaveSlot(0), _buttons() {
 	_backgroundType = ThemeEngine::kDialogBackgroundSpecial;
 
@@ -838,6 +844,8 @@ SaveLoadChooserGrid::SaveLoadChooserGrid(const Common::U32String &title, bool sa
 }
 
 SaveLoadChooserGrid::~SaveLoadChooserGrid() {
+	_thumbnailLoader.clear();
+
 	removeWidget(_pageTitle);
 	delete _pageTitle;
 
@@ -897,13 +905,27 @@ void SaveLoadChooserGrid::handleMouseWheel(int x, int y, int direction) {
 	}
 }
 
+void SaveLoadChooserGrid::handleTickle() {
+	// Show the saves whose meta infos finished loading in the meantime
+	if (_thumbnailLoader.update()) {
+		updateSaves();
+		g_gui.scheduleTopDialogRedraw();
+	}
+
+	SaveLoadChooserDialog::handleTickle();
+}
+
 void SaveLoadChooserGrid::updateSaveList() {
+	_thumbnailLoader.clear();
 	SaveLoadChooserDialog::updateSaveList();
 	updateSaves();
 	g_gui.scheduleTopDialogRedraw();
 }
 
 void SaveLoadChooserGrid::open() {
+	// The saves might have changed since the dialog was shown last
+	_thumbnailLoader.clear();
+
 	SaveLoadChooserDialog::open();
 
 	listSaves();
@@ -974,6 +996,9 @@ void SaveLoadChooserGrid::reflowLayout() {
 	SaveLoadChooserDialog::reflowLayout();
 	destroyButtons();
 
+	_thumbnailLoader.clear();
+	_thumbnailScaleFactor = g_gui.getScaleFactor();
+
 	// HACK: The whole code below really works around the fact, that we have
 	// no easy way to dynamically layout widgets.
 	const uint16 availableWidth = getWidth() - 20;
@@ -1083,6 +1108,7 @@ void SaveLoadChooserGrid::close() {
 
 	SaveLoadChooserDialog::close();
 	hideButtons();
+	_thumbnailLoader.clear();
 }
 
 int SaveLoadChooserGrid::runIntern() {
@@ -1142,21 +1168,77 @@ void SaveLoadChooserGrid::hideButtons() {
 	}
 }
 
+ThumbnailLoader::Result *SaveLoadChooserGrid::prepareThumbnail(const Common::String &slot, void *data) {
+	const SaveLoadChooserGrid *dialog = (const SaveLoadChooserGrid *)data;
+
+	// Engines are not prepared to have their meta infos queried from other
+	// threads, so this has to happen on the GUI thread. Where possible the
+	// thumbnail is loaded on the worker.
+	SaveThumbnail *result = new SaveThumbnail();
+	Common::InSaveFile *thumbnailFile;
+	result->desc = dialog->_metaEngine->querySaveMetaInfosDeferringThumbnail(dialog->_target.c_str(), atoi(slot.c_str()), thumbnailFile);
+	result->thumbnailFile.reset(thumbnailFile);
+	return result;
+}
+
+ThumbnailLoader::Result *SaveLoadChooserGrid::loadThumbnail(const Common::String &slot, ThumbnailLoader::Result *prepared, void *data) {
+	const SaveLoadChooserGrid *dialog = (const SaveLoadChooserGrid *)data;
+	SaveThumbnail *result = (SaveThumbnail *)prepared;
+
+	if (result->thumbnailFile) {
+		Graphics::Surface *thumbnail = MetaEngine::loadDeferredThumbnail(result->thumbnailFile.get());
+		if (thumbnail)
+			result->desc.setThumbnail(thumbnail);
+		result->thumbnailFile.reset();
+	}
+
+	// Only keep the thumbnail in the size it is shown in
+	const Graphics::Surface *thumbnail = result->desc.getThumbnail();
+	if (thumbnail && thumbnail->format.bytesPerPixel != 1) {
+		const float sf = dialog->_thumbnailScaleFactor;
+		if (sf != 1.0f)
+			result->surface = new Graphics::ManagedSurface(thumbnail->scale(thumbnail->w * sf, thumbnail->h * sf, false));
+		else
+			result->surface = new Graphics::ManagedSurface(thumbnail);
+	}
+	result->desc.setThumbnail(Common::SharedPtr<Graphics::Surface>());
+
+	return result;
+}
+
 void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
 
+	// Saves of other pages are not needed anymore. The last requests are
+	// loaded first, so the saves at the top of the page are requested last.
+	const uint firstSave = _curPage * _entriesPerPage;
+	const uint endSave = MIN<uint>(firstSave + _entriesPerPage, _saveList.size());
+	_thumbnailLoader.cancel();
+	for (uint i = endSave; i > firstSave; --i) {
+		if (!_saveList[i - 1].getLocked())
+			_thumbnailLoader.get(Common::String::format("%d", _saveList[i - 1].getSaveSlot()));
+	}
+
 	bool isWriteProtected = false;
 
-	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
+	for (uint i = firstSave, curNum = 0; i < endSave; ++i, ++curNum) {
 		const uint saveSlot = _saveList[i].getSaveSlot();
 
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
-		if (!_saveList[i].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[i] = desc;
+		// Until the meta infos are loaded the save is shown with the
+		// information from the save list and an empty thumbnail.
+		const SaveThumbnail *loaded = nullptr;
+		if (!_saveList[i].getLocked()) {
+			loaded = (const SaveThumbnail *)_thumbnailLoader.get(Common::String::format("%d", saveSlot));
+			if (loaded && loaded->desc.getSaveSlot() >= 0 && !loaded->desc.getDescription().empty())
+				_saveList[i] = loaded->desc;
+		}
+		const SaveStateDescriptor &desc = loaded ? loaded->desc : _saveList[i];
+
 		SlotButton &curButton = _buttons[curNum];
 		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
+		if (loaded && loaded->surface) {
+			curButton.button->setGfx(loaded->surface, kPicButtonStateEnabled, false);
+		} else if (desc.getThumbnail()) {
 			curButton.button->setGfx(desc.getThumbnail());
 		} else {
 			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
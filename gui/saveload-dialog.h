@@ -22,7 +22,11 @@
 #ifndef GUI_SAVELOAD_DIALOG_H
 #define GUI_SAVELOAD_DIALOG_H
 
+#include "common/ptr.h"
+#include "common/savefile.h"
+
 #include "gui/dialog.h"
+#include "gui/thumbnail-loader.h"
 #include "gui/widgets/list.h"
 
 #include "engines/metaengine.h"
@@ -219,10 +223,24 @@ public:
 protected:
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
 	void handleMouseWheel(int x, int y, int direction) override;
+	void handleTickle() override;
 	void updateSaveList() override;
 private:
 	int runIntern() override;
 
+	/** Meta infos of a save, loaded together with its thumbnail. */
+	struct SaveThumbnail : public ThumbnailLoader::Result {
+		SaveStateDescriptor desc;
+		/** The save file to load the thumbnail from, if the engine left it out. */
+		Common::ScopedPtr<Common::InSaveFile> thumbnailFile;
+	};
+
+	static ThumbnailLoader::Result *prepareThumbnail(const Common::String &slot, void *data);
+	static ThumbnailLoader::Result *loadThumbnail(const Common::String &slot, ThumbnailLoader::Result *prepared, void *data);
+
+	ThumbnailLoader _thumbnailLoader;
+	float _thumbnailScaleFactor;
+
 	uint _columns, _lines;
 	uint _entriesPerPage;
 	uint _curPage;
@@ -0,0 +1,216 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "gui/thumbnail-loader.h"
+
+#include "graphics/managed_surface.h"
+
+namespace GUI {
+
+ThumbnailLoader::Result::~Result() {
+	delete surface;
+}
+
+ThumbnailLoader::ThumbnailLoader(LoadProc proc, void *data, uint maxEntries, PrepareProc prepare)
+	: _proc(proc), _prepare(prepare), _data(data), _maxEntries(MAX<uint>(maxEntries, 1)), _useCounter(0),
+	  _loaderRunning(false), _tasks(ThreadPoolMan) {
+}
+
+ThumbnailLoader::~ThumbnailLoader() {
+	clear();
+}
+
+const ThumbnailLoader::Result *ThumbnailLoader::get(const Common::String &key) {
+	_visible[key] = true;
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		i->_value.lastUse = ++_useCounter;
+		return i->_value.result;
+	}
+
+	if (_loading.contains(key))
+		return nullptr;
+	_loading[key] = true;
+	_pending.push_back(key);
+
+	// Requests which have to be prepared wait for update(), so that only
+	// one of them is prepared at a time
+	if (!_prepare)
+		startPending();
+
+	// Without worker threads the thumbnail is loaded right away
+	if (!ThreadPoolMan.isMultiThreaded()) {
+		update();
+		i = _entries.find(key);
+		if (i != _entries.end())
+			return i->_value.result;
+	}
+
+	return nullptr;
+}
+
+void ThumbnailLoader::startPending() {
+	bool startLoader = false;
+
+	while (!_pending.empty()) {
+		Job job;
+		job.key = _pending.back();
+		job.result = nullptr;
+		_pending.pop_back();
+
+		if (_prepare)
+			job.result = _prepare(job.key, _data);
+
+		{
+			Common::StackLock lock(_mutex);
+			if (_prepare && !job.result) {
+				// There is nothing to load
+				_finished.push_back(job);
+			} else {
+				_queued.push_back(job);
+				startLoader = startLoader || !_loaderRunning;
+				_loaderRunning = true;
+			}
+		}
+
+		if (_prepare)
+			break;
+	}
+
+	if (startLoader)
+		_tasks.run(loadJobs, this);
+}
+
+void ThumbnailLoader::loadJobs(void *data) {
+	ThumbnailLoader *loader = (ThumbnailLoader *)data;
+
+	while (true) {
+		Job job;
+		{
+			Common::StackLock lock(loader->_mutex);
+			if (loader->_queued.empty()) {
+				loader->_loaderRunning = false;
+				return;
+			}
+
+			job = loader->_queued.back();
+			loader->_queued.pop_back();
+		}
+
+		job.result = loader->_proc(job.key, job.result, loader->_data);
+
+		Common::StackLock lock(loader->_mutex);
+		loader->_finished.push_back(job);
+	}
+}
+
+bool ThumbnailLoader::update() {
+	startPending();
+
+	Common::Array<Job> finished;
+	{
+		Common::StackLock lock(_mutex);
+		if (_finished.empty())
+			return false;
+		finished.swap(_finished);
+	}
+
+	for (uint i = 0; i < finished.size(); ++i) {
+		const Job &job = finished[i];
+		_loading.erase(job.key);
+
+		// Remember missing thumbnails too, so they are not loaded again
+		Entry &entry = _entries.getOrCreateVal(job.key);
+		delete entry.result;
+		entry.result = job.result ? job.result : new Result();
+		entry.lastUse = ++_useCounter;
+	}
+
+	while (_entries.size() > _maxEntries) {
+		if (!removeLeastRecentlyUsed())
+			break;
+	}
+
+	return true;
+}
+
+void ThumbnailLoader::cancel() {
+	_visible.clear();
+
+	for (uint i = 0; i < _pending.size(); ++i)
+		_loading.erase(_pending[i]);
+	_pending.clear();
+
+	// Prepared requests are still loaded, so that their preparation is not
+	// wasted
+	Common::StackLock lock(_mutex);
+	for (uint i = 0; i < _queued.size();) {
+		if (_queued[i].result) {
+			++i;
+			continue;
+		}
+
+		_loading.erase(_queued[i].key);
+		_queued.remove_at(i);
+	}
+}
+
+void ThumbnailLoader::clear() {
+	cancel();
+	{
+		Common::StackLock lock(_mutex);
+		for (uint i = 0; i < _queued.size(); ++i)
+			delete _queued[i].result;
+		_queued.clear();
+	}
+	_tasks.wait();
+
+	for (uint i = 0; i < _finished.size(); ++i)
+		delete _finished[i].result;
+	_finished.clear();
+
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i)
+		delete i->_value.result;
+	_entries.clear();
+	_loading.clear();
+}
+
+bool ThumbnailLoader::removeLeastRecentlyUsed() {
+	// Visible thumbnails are kept, as they would be requested again right away
+	EntryMap::iterator oldest = _entries.end();
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (_visible.contains(i->_key))
+			continue;
+		if (oldest == _entries.end() || i->_value.lastUse < oldest->_value.lastUse)
+			oldest = i;
+	}
+
+	if (oldest == _entries.end())
+		return false;
+
+	delete oldest->_value.result;
+	_entries.erase(oldest);
+	return true;
+}
+
+} // End of namespace GUI
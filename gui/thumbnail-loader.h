@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GUI_THUMBNAIL_LOADER_H
+#define GUI_THUMBNAIL_LOADER_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+#include "common/threadpool.h"
+
+namespace Graphics {
+class ManagedSurface;
+}
+
+namespace GUI {
+
+/**
+ * Loads thumbnails in the background and keeps the most recently used ones.
+ *
+ * Thumbnails are requested through get(), which returns nullptr until the
+ * thumbnail has been loaded, so that a placeholder can be drawn meanwhile.
+ * Requests are handled one at a time on the shared thread pool, newest
+ * first, since those are usually the ones on screen. The owner has to call
+ * update() regularly, e.g. from handleTickle(), to pick up the loaded
+ * thumbnails. Without worker threads get() loads synchronously.
+ *
+ * The thumbnails requested since the last call to cancel() are the visible
+ * ones. They are kept even if there are more of them than the loader keeps
+ * otherwise, so the owner should call cancel() whenever the view changes.
+ *
+ * Loading may be split in two steps: an optional prepare step, which runs
+ * on the GUI thread for work that is not thread safe, and the load step,
+ * which runs on a worker thread. Only one request is prepared per call to
+ * update(), so that the GUI stays responsive.
+ */
+class ThumbnailLoader : Common::NonCopyable {
+public:
+	/**
+	 * A loaded thumbnail. Loaders may derive from it to pass along data
+	 * which is loaded together with the thumbnail.
+	 */
+	struct Result {
+		Result() : surface(nullptr) {}
+		virtual ~Result();
+
+		/** The thumbnail, nullptr if there is none. */
+		const Graphics::ManagedSurface *surface;
+	};
+
+	/**
+	 * Start loading the thumbnail for @p key. Called on the GUI thread.
+	 *
+	 * @return The partially loaded result, which is passed on to the
+	 *         LoadProc, or nullptr if there is no thumbnail.
+	 */
+	typedef Result *(*PrepareProc)(const Common::String &key, void *data);
+
+	/**
+	 * Load the thumbnail for @p key. Called on a worker thread, so it must
+	 * not touch any state which the GUI thread modifies meanwhile.
+	 *
+	 * @param prepared  The result of the PrepareProc, or nullptr if there
+	 *                  is none.
+	 * @return The result, which is @p prepared if that is given, or nullptr
+	 *         if there is no thumbnail.
+	 */
+	typedef Result *(*LoadProc)(const Common::String &key, Result *prepared, void *data);
+
+	/**
+	 * @param proc        Function loading a thumbnail.
+	 * @param data        Data passed to @p proc and @p prepare.
+	 * @param maxEntries  Number of loaded thumbnails to keep.
+	 * @param prepare     Function preparing the loading, or nullptr.
+	 */
+	ThumbnailLoader(LoadProc proc, void *data, uint maxEntries, PrepareProc prepare = nullptr);
+	~ThumbnailLoader();
+
+	/**
+	 * Return the thumbnail for @p key, and start loading it if it is not
+	 * loaded yet.
+	 *
+	 * The result stays valid until the next call to get(), update() or
+	 * clear().
+	 *
+	 * @return The result, or nullptr if it is still being loaded.
+	 */
+	const Result *get(const Common::String &key);
+
+	/**
+	 * Prepare the next request and add the thumbnails which finished
+	 * loading to the cache.
+	 *
+	 * @return true if any thumbnail was added.
+	 */
+	bool update();
+
+	/**
+	 * Drop the requests which were not prepared yet, and start a new set of
+	 * visible thumbnails.
+	 */
+	void cancel();
+
+	/**
+	 * Drop all thumbnails and requests, e.g. because the way they are
+	 * loaded has changed. Waits for the thumbnail being loaded.
+	 */
+	void clear();
+
+private:
+	struct Job {
+		Common::String key;
+		Result *result;
+	};
+
+	struct Entry {
+		Result *result;
+		uint32 lastUse;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static void loadJobs(void *data);
+	void startPending();
+	bool removeLeastRecentlyUsed();
+
+	const LoadProc _proc;
+	const PrepareProc _prepare;
+	void *const _data;
+	const uint _maxEntries;
+
+	EntryMap _entries;
+	Common::HashMap<Common::String, bool> _loading;
+	Common::HashMap<Common::String, bool> _visible;  ///< Keys requested since the last cancel()
+	Common::Array<Common::String> _pending;  ///< Requests waiting to be prepared
+	uint32 _useCounter;
+
+	Common::Mutex _mutex;
+	Common::Array<Job> _queued;    ///< Requests waiting to be loaded, guarded by _mutex
+	Common::Array<Job> _finished;  ///< Loaded requests, guarded by _mutex
+	bool _loaderRunning;           ///< Whether a job is processing requests, guarded by _mutex
+
+	Common::TaskGroup _tasks;
+};
+
+} // End of namespace GUI
+
+#endif
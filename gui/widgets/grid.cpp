@@ -47,7 +47,7 @@ void GridItemWidget::setActiveEntry(GridItemInfo &entry) {
 }
 
 void GridItemWidget::updateThumb() {
-	const Graphics::ManagedSurface *gfx = _grid->filenameToSurface(_activeEntry->thumbPath);
+	const Graphics::ManagedSurface *gfx = _grid->entryToSurface(*_activeEntry);
 	_thumbGfx.free();
 	if (gfx)
 		_thumbGfx.copyFrom(*gfx);
@@ -389,11 +389,18 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 
 #pragma mark -
 
+enum {
+	// Number of game icons kept in memory, well above the number of visible ones
+	kMaxLoadedThumbnails = 256
+};
+
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
-	: ContainerWidget(boss, name), CommandSender(boss) {
+	: ContainerWidget(boss, name), CommandSender(boss), _thumbnailLoader(loadThumbnail, this, kMaxLoadedThumbnails) {
 
 	_thumbnailHeight = 0;
 	_thumbnailWidth = 0;
+	_thumbnailLoadWidth = 0;
+	_thumbnailLoadHeight = 0;
 	_flagIconHeight = 0;
 	_flagIconWidth = 0;
 	_platformIconHeight = 0;
@@ -437,10 +444,10 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 }
 
 GridWidget::~GridWidget() {
+	_thumbnailLoader.clear();
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
-	unloadSurfaces(_loadedSurfaces);
 	delete _disabledIconOverlay;
 	_gridItems.clear();
 	_dataEntryList.clear();
@@ -457,10 +464,15 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 	surfaces.clear();
 }
 
-const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
-	if (name.empty())
+const Graphics::ManagedSurface *GridWidget::entryToSurface(const GridItemInfo &entry) {
+	if (entry.thumbPath.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+
+	const ThumbnailLoader::Result *result = _thumbnailLoader.get(entry.thumbPath);
+	// Games without an icon of their own use the one of their engine
+	if (result && !result->surface)
+		result = _thumbnailLoader.get(Common::String::format("icons/%s.png", entry.engineid.c_str()));
+	return result ? result->surface : nullptr;
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode) {
@@ -680,43 +692,26 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 	_groupHeaderSuffix = suffix;
 }
 
-void GridWidget::reloadThumbnails() {
-	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
-	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
-	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
-		GridItemInfo *entry = *iter;
-		if (entry->thumbPath.empty())
-			continue;
-
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
-				}
-			}
+ThumbnailLoader::Result *GridWidget::loadThumbnail(const Common::String &path, ThumbnailLoader::Result *prepared, void *data) {
+	const GridWidget *grid = (const GridWidget *)data;
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+	Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
+	if (!surf)
+		return nullptr;
 
-				if (path != entry->thumbPath) {
-					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
-				}
+	ThumbnailLoader::Result *result = new ThumbnailLoader::Result();
+	result->surface = scaleGfx(surf, grid->_thumbnailLoadWidth, grid->_thumbnailLoadHeight, true);
+	if (result->surface != surf)
+		delete surf;
+	return result;
+}
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
-		}
-	}
+void GridWidget::reloadThumbnails() {
+	// Icons of entries which were scrolled out of view are not needed anymore.
+	// The last requests are loaded first, so request the top entries last.
+	_thumbnailLoader.cancel();
+	for (uint i = _visibleEntryList.size(); i > 0; --i)
+		entryToSurface(*_visibleEntryList[i - 1]);
 }
 
 void GridWidget::loadFlagIcons() {
@@ -860,6 +855,16 @@ void GridWidget::assignEntriesToItems() {
 	}
 }
 
+void GridWidget::handleTickle() {
+	// Show the icons which finished loading in the meantime
+	if (_thumbnailLoader.update()) {
+		for (Common::Array<GridItemWidget *>::iterator it = _gridItems.begin(); it != _gridItems.end(); ++it) {
+			if ((*it)->isVisible())
+				(*it)->update();
+		}
+	}
+}
+
 void GridWidget::handleMouseWheel(int x, int y, int direction) {
 	_scrollBar->handleMouseWheel(x, y, direction);
 	_scrollPos = _scrollBar->_currentPos;
@@ -1009,7 +1014,9 @@ void GridWidget::reflowLayout() {
 		unloadSurfaces(_extraIcons);
 		unloadSurfaces(_platformIcons);
 		unloadSurfaces(_languageIcons);
-		unloadSurfaces(_loadedSurfaces);
+		_thumbnailLoader.clear();
+		_thumbnailLoadWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+		_thumbnailLoadHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
 		if (_disabledIconOverlay)
 			_disabledIconOverlay->free();
 		reloadThumbnails();
@@ -23,6 +23,7 @@
 #define GUI_WIDGETS_GRID_H
 
 #include "gui/dialog.h"
+#include "gui/thumbnail-loader.h"
 #include "gui/widgets/scrollbar.h"
 #include "common/str.h"
 
@@ -102,8 +103,11 @@ protected:
 	Common::HashMap<int, const Graphics::ManagedSurface *> _languageIcons;
 	Common::HashMap<int, const Graphics::ManagedSurface *> _extraIcons;
 	Graphics::ManagedSurface *_disabledIconOverlay;
-	// Images are mapped by filename -> surface.
-	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	// Game icons are loaded in the background and mapped by filename.
+	ThumbnailLoader _thumbnailLoader;
+	// Size the game icons are scaled to, only changed while none are loading.
+	int _thumbnailLoadWidth;
+	int _thumbnailLoadHeight;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -152,6 +156,8 @@ protected:
 	int				_gridHeaderWidth;
 	int				_trayHeight;
 
+	static ThumbnailLoader::Result *loadThumbnail(const Common::String &path, ThumbnailLoader::Result *prepared, void *data);
+
 public:
 	int				_gridItemHeight;
 	int				_gridItemWidth;
@@ -171,7 +177,7 @@ public:
 	template<typename T>
 	void unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurface *> &surfaces);
 
-	const Graphics::ManagedSurface *filenameToSurface(const Common::String &name);
+	const Graphics::ManagedSurface *entryToSurface(const GridItemInfo &entry);
 	const Graphics::ManagedSurface *languageToSurface(Common::Language languageCode);
 	const Graphics::ManagedSurface *platformToSurface(Common::Platform platformCode);
 	const Graphics::ManagedSurface *demoToSurface(const Common::String extraString);
@@ -213,6 +219,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -0,0 +1,157 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "image/codecs/idct.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Image {
+
+/**
+ * Apply the one-dimensional transform to four columns and return the
+ * results with @p bias added.
+ */
+static FORCEINLINE void transformHalf_NEON(int32x4_t *d, const int16x4_t *s, int32x4_t bias) {
+	// Even part
+	const int32x4_t dc = vaddq_s32(vshll_n_s16(s[0], kIDCTConstBits), bias);
+	const int32x4_t e0 = vaddq_s32(dc, vshll_n_s16(s[4], kIDCTConstBits));
+	const int32x4_t e1 = vsubq_s32(dc, vshll_n_s16(s[4], kIDCTConstBits));
+	const int32x4_t e2 = vmlal_n_s16(vmull_n_s16(s[2], kIDCTFix0_541196100), s[6], kIDCTFix0_541196100 - kIDCTFix1_847759065);
+	const int32x4_t e3 = vmlal_n_s16(vmull_n_s16(s[2], kIDCTFix0_541196100 + kIDCTFix0_765366865), s[6], kIDCTFix0_541196100);
+
+	const int32x4_t t10 = vaddq_s32(e0, e3);
+	const int32x4_t t13 = vsubq_s32(e0, e3);
+	const int32x4_t t11 = vaddq_s32(e1, e2);
+	const int32x4_t t12 = vsubq_s32(e1, e2);
+
+	// Odd part, with the shared products of the scalar code distributed
+	int32x4_t o0 = vmull_n_s16(s[1], kIDCTFix1_175875602 - kIDCTFix0_899976223);
+	o0 = vmlal_n_s16(o0, s[3], kIDCTFix1_175875602 - kIDCTFix1_961570560);
+	o0 = vmlal_n_s16(o0, s[5], kIDCTFix1_175875602);
+	o0 = vmlal_n_s16(o0, s[7], kIDCTFix0_298631336 - kIDCTFix0_899976223 - kIDCTFix1_961570560 + kIDCTFix1_175875602);
+
+	int32x4_t o1 = vmull_n_s16(s[1], kIDCTFix1_175875602 - kIDCTFix0_390180644);
+	o1 = vmlal_n_s16(o1, s[3], kIDCTFix1_175875602 - kIDCTFix2_562915447);
+	o1 = vmlal_n_s16(o1, s[5], kIDCTFix2_053119869 - kIDCTFix2_562915447 - kIDCTFix0_390180644 + kIDCTFix1_175875602);
+	o1 = vmlal_n_s16(o1, s[7], kIDCTFix1_175875602);
+
+	int32x4_t o2 = vmull_n_s16(s[1], kIDCTFix1_175875602);
+	o2 = vmlal_n_s16(o2, s[3], kIDCTFix3_072711026 - kIDCTFix2_562915447 - kIDCTFix1_961570560 + kIDCTFix1_175875602);
+	o2 = vmlal_n_s16(o2, s[5], kIDCTFix1_175875602 - kIDCTFix2_562915447);
+	o2 = vmlal_n_s16(o2, s[7], kIDCTFix1_175875602 - kIDCTFix1_961570560);
+
+	int32x4_t o3 = vmull_n_s16(s[1], kIDCTFix1_501321110 - kIDCTFix0_899976223 - kIDCTFix0_390180644 + kIDCTFix1_175875602);
+	o3 = vmlal_n_s16(o3, s[3], kIDCTFix1_175875602);
+	o3 = vmlal_n_s16(o3, s[5], kIDCTFix1_175875602 - kIDCTFix0_390180644);
+	o3 = vmlal_n_s16(o3, s[7], kIDCTFix1_175875602 - kIDCTFix0_899976223);
+
+	d[0] = vaddq_s32(t10, o3);
+	d[7] = vsubq_s32(t10, o3);
+	d[1] = vaddq_s32(t11, o2);
+	d[6] = vsubq_s32(t11, o2);
+	d[2] = vaddq_s32(t12, o1);
+	d[5] = vsubq_s32(t12, o1);
+	d[3] = vaddq_s32(t13, o0);
+	d[4] = vsubq_s32(t13, o0);
+}
+
+/**
+ * Apply the one-dimensional transform to the eight columns of the rows in
+ * @p r, and replace them with the results, plus @p bias and shifted right
+ * by @p shift, saturated to 16 bits.
+ */
+template<int shift>
+static FORCEINLINE void transform_NEON(int16x8_t *r, int32 bias) {
+	const int32x4_t b = vdupq_n_s32(bias);
+	int16x4_t s[8];
+	int32x4_t lo[8], hi[8];
+
+	for (int i = 0; i < 8; i++)
+		s[i] = vget_low_s16(r[i]);
+	transformHalf_NEON(lo, s, b);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = vget_high_s16(r[i]);
+	transformHalf_NEON(hi, s, b);
+
+	for (int i = 0; i < 8; i++)
+		r[i] = vcombine_s16(vqmovn_s32(vshrq_n_s32(lo[i], shift)), vqmovn_s32(vshrq_n_s32(hi[i], shift)));
+}
+
+static FORCEINLINE void transpose_NEON(int16x8_t *r) {
+	const int16x8x2_t t01 = vtrnq_s16(r[0], r[1]);
+	const int16x8x2_t t23 = vtrnq_s16(r[2], r[3]);
+	const int16x8x2_t t45 = vtrnq_s16(r[4], r[5]);
+	const int16x8x2_t t67 = vtrnq_s16(r[6], r[7]);
+
+	const int32x4x2_t u02 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[0]), vreinterpretq_s32_s16(t23.val[0]));
+	const int32x4x2_t u13 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[1]), vreinterpretq_s32_s16(t23.val[1]));
+	const int32x4x2_t u46 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[0]), vreinterpretq_s32_s16(t67.val[0]));
+	const int32x4x2_t u57 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[1]), vreinterpretq_s32_s16(t67.val[1]));
+
+	r[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u02.val[0]), vget_low_s32(u46.val[0])));
+	r[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u13.val[0]), vget_low_s32(u57.val[0])));
+	r[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u02.val[1]), vget_low_s32(u46.val[1])));
+	r[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u13.val[1]), vget_low_s32(u57.val[1])));
+	r[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u02.val[0]), vget_high_s32(u46.val[0])));
+	r[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u13.val[0]), vget_high_s32(u57.val[0])));
+	r[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u02.val[1]), vget_high_s32(u46.val[1])));
+	r[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u13.val[1]), vget_high_s32(u57.val[1])));
+}
+
+void IDCT::putNEON(byte *dest, uint pitch, const int16 *block) {
+	const int pass2Shift = kIDCTConstBits + kIDCTPass1Bits + 3;
+	int16x8_t r[8];
+
+	for (int i = 0; i < 8; i++)
+		r[i] = vld1q_s16(block + i * 8);
+
+	transform_NEON<kIDCTConstBits - kIDCTPass1Bits>(r, 1 << (kIDCTConstBits - kIDCTPass1Bits - 1));
+	transpose_NEON(r);
+	transform_NEON<pass2Shift>(r, (1 << (pass2Shift - 1)) + (128 << pass2Shift));
+	transpose_NEON(r);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vqmovun_s16(r[i]));
+}
+
+} // End of namespace Image
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,159 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "common/scummsys.h"
+
+#include "image/codecs/idct.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Image {
+
+/** Return the factors for _mm_madd_epi16() of interleaved pairs of values. */
+static FORCEINLINE __m128i factors_SSE2(int16 a, int16 b) {
+	return _mm_set1_epi32((int32)(((uint32)(uint16)b << 16) | (uint16)a));
+}
+
+/**
+ * Apply the one-dimensional transform to four columns, given as pairs of
+ * rows interleaved by _mm_unpack*_epi16(), and return the results with
+ * @p bias added.
+ */
+static FORCEINLINE void transformHalf_SSE2(__m128i *d, __m128i p04, __m128i p26, __m128i p13, __m128i p57, __m128i bias) {
+	// Even part
+	const __m128i e0 = _mm_add_epi32(_mm_madd_epi16(p04, factors_SSE2(1 << kIDCTConstBits, 1 << kIDCTConstBits)), bias);
+	const __m128i e1 = _mm_add_epi32(_mm_madd_epi16(p04, factors_SSE2(1 << kIDCTConstBits, -(1 << kIDCTConstBits))), bias);
+	const __m128i e2 = _mm_madd_epi16(p26, factors_SSE2(kIDCTFix0_541196100, kIDCTFix0_541196100 - kIDCTFix1_847759065));
+	const __m128i e3 = _mm_madd_epi16(p26, factors_SSE2(kIDCTFix0_541196100 + kIDCTFix0_765366865, kIDCTFix0_541196100));
+
+	const __m128i t10 = _mm_add_epi32(e0, e3);
+	const __m128i t13 = _mm_sub_epi32(e0, e3);
+	const __m128i t11 = _mm_add_epi32(e1, e2);
+	const __m128i t12 = _mm_sub_epi32(e1, e2);
+
+	// Odd part, with the shared products of the scalar code distributed
+	const __m128i o0 = _mm_add_epi32(
+		_mm_madd_epi16(p13, factors_SSE2(kIDCTFix1_175875602 - kIDCTFix0_899976223, kIDCTFix1_175875602 - kIDCTFix1_961570560)),
+		_mm_madd_epi16(p57, factors_SSE2(kIDCTFix1_175875602, kIDCTFix0_298631336 - kIDCTFix0_899976223 - kIDCTFix1_961570560 + kIDCTFix1_175875602)));
+	const __m128i o1 = _mm_add_epi32(
+		_mm_madd_epi16(p13, factors_SSE2(kIDCTFix1_175875602 - kIDCTFix0_390180644, kIDCTFix1_175875602 - kIDCTFix2_562915447)),
+		_mm_madd_epi16(p57, factors_SSE2(kIDCTFix2_053119869 - kIDCTFix2_562915447 - kIDCTFix0_390180644 + kIDCTFix1_175875602, kIDCTFix1_175875602)));
+	const __m128i o2 = _mm_add_epi32(
+		_mm_madd_epi16(p13, factors_SSE2(kIDCTFix1_175875602, kIDCTFix3_072711026 - kIDCTFix2_562915447 - kIDCTFix1_961570560 + kIDCTFix1_175875602)),
+		_mm_madd_epi16(p57, factors_SSE2(kIDCTFix1_175875602 - kIDCTFix2_562915447, kIDCTFix1_175875602 - kIDCTFix1_961570560)));
+	const __m128i o3 = _mm_add_epi32(
+		_mm_madd_epi16(p13, factors_SSE2(kIDCTFix1_501321110 - kIDCTFix0_899976223 - kIDCTFix0_390180644 + kIDCTFix1_175875602, kIDCTFix1_175875602)),
+		_mm_madd_epi16(p57, factors_SSE2(kIDCTFix1_175875602 - kIDCTFix0_390180644, kIDCTFix1_175875602 - kIDCTFix0_899976223)));
+
+	d[0] = _mm_add_epi32(t10, o3);
+	d[7] = _mm_sub_epi32(t10, o3);
+	d[1] = _mm_add_epi32(t11, o2);
+	d[6] = _mm_sub_epi32(t11, o2);
+	d[2] = _mm_add_epi32(t12, o1);
+	d[5] = _mm_sub_epi32(t12, o1);
+	d[3] = _mm_add_epi32(t13, o0);
+	d[4] = _mm_sub_epi32(t13, o0);
+}
+
+/**
+ * Apply the one-dimensional transform to the eight columns of the rows in
+ * @p r, and replace them with the results, plus @p bias and shifted right
+ * by @p shift, saturated to 16 bits.
+ */
+template<int shift>
+static FORCEINLINE void transform_SSE2(__m128i *r, int32 bias) {
+	const __m128i b = _mm_set1_epi32(bias);
+	__m128i lo[8], hi[8];
+
+	transformHalf_SSE2(lo, _mm_unpacklo_epi16(r[0], r[4]), _mm_unpacklo_epi16(r[2], r[6]),
+	                   _mm_unpacklo_epi16(r[1], r[3]), _mm_unpacklo_epi16(r[5], r[7]), b);
+	transformHalf_SSE2(hi, _mm_unpackhi_epi16(r[0], r[4]), _mm_unpackhi_epi16(r[2], r[6]),
+	                   _mm_unpackhi_epi16(r[1], r[3]), _mm_unpackhi_epi16(r[5], r[7]), b);
+
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm_packs_epi32(_mm_srai_epi32(lo[i], shift), _mm_srai_epi32(hi[i], shift));
+}
+
+static FORCEINLINE void transpose_SSE2(__m128i *r) {
+	const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4);
+	r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5);
+	r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6);
+	r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7);
+	r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+void IDCT::putSSE2(byte *dest, uint pitch, const int16 *block) {
+	const int pass2Shift = kIDCTConstBits + kIDCTPass1Bits + 3;
+	__m128i r[8];
+
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm_loadu_si128((const __m128i *)(block + i * 8));
+
+	transform_SSE2<kIDCTConstBits - kIDCTPass1Bits>(r, 1 << (kIDCTConstBits - kIDCTPass1Bits - 1));
+	transpose_SSE2(r);
+	transform_SSE2<pass2Shift>(r, (1 << (pass2Shift - 1)) + (128 << pass2Shift));
+	transpose_SSE2(r);
+
+	for (int i = 0; i < 8; i += 2) {
+		const __m128i pixels = _mm_packus_epi16(r[i], r[i + 1]);
+		_mm_storel_epi64((__m128i *)dest, pixels);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_srli_si128(pixels, 8));
+		dest += pitch * 2;
+	}
+}
+
+} // End of namespace Image
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,125 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// The transform is the one of jidctint.c from the Independent JPEG Group's
+// JPEG library, based on the algorithm by Loeffler, Ligtenberg and Moschytz.
+
+#include "common/system.h"
+#include "common/util.h"
+
+#include "image/codecs/idct.h"
+
+namespace Image {
+
+/**
+ * Apply the one-dimensional transform to the eight values at @p in, which
+ * are @p stride values apart, and store the unscaled results in @p out.
+ */
+static inline void transform1D(int32 *out, const int16 *in, uint stride) {
+	const int32 s0 = in[0 * stride];
+	const int32 s1 = in[1 * stride];
+	const int32 s2 = in[2 * stride];
+	const int32 s3 = in[3 * stride];
+	const int32 s4 = in[4 * stride];
+	const int32 s5 = in[5 * stride];
+	const int32 s6 = in[6 * stride];
+	const int32 s7 = in[7 * stride];
+
+	// Even part
+	const int32 e = (s2 + s6) * kIDCTFix0_541196100;
+	const int32 e2 = e - s6 * kIDCTFix1_847759065;
+	const int32 e3 = e + s2 * kIDCTFix0_765366865;
+	const int32 e0 = (s0 + s4) * (1 << kIDCTConstBits);
+	const int32 e1 = (s0 - s4) * (1 << kIDCTConstBits);
+
+	const int32 t10 = e0 + e3;
+	const int32 t13 = e0 - e3;
+	const int32 t11 = e1 + e2;
+	const int32 t12 = e1 - e2;
+
+	// Odd part
+	const int32 z5 = (s7 + s3 + s5 + s1) * kIDCTFix1_175875602;
+	const int32 z1 = (s7 + s1) * -kIDCTFix0_899976223;
+	const int32 z2 = (s5 + s3) * -kIDCTFix2_562915447;
+	const int32 z3 = (s7 + s3) * -kIDCTFix1_961570560 + z5;
+	const int32 z4 = (s5 + s1) * -kIDCTFix0_390180644 + z5;
+
+	const int32 o0 = s7 * kIDCTFix0_298631336 + z1 + z3;
+	const int32 o1 = s5 * kIDCTFix2_053119869 + z2 + z4;
+	const int32 o2 = s3 * kIDCTFix3_072711026 + z2 + z3;
+	const int32 o3 = s1 * kIDCTFix1_501321110 + z1 + z4;
+
+	out[0] = t10 + o3;
+	out[7] = t10 - o3;
+	out[1] = t11 + o2;
+	out[6] = t11 - o2;
+	out[2] = t12 + o1;
+	out[5] = t12 - o1;
+	out[3] = t13 + o0;
+	out[4] = t13 - o0;
+}
+
+IDCT::PutFunc IDCT::putFunc = nullptr;
+
+void IDCT::init() {
+	if (putFunc)
+		return;
+
+	putFunc = putGeneric;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		putFunc = putNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		putFunc = putSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		putFunc = putAVX2;
+#endif
+}
+
+void IDCT::putGeneric(byte *dest, uint pitch, const int16 *block) {
+	int16 workspace[8 * 8];
+	int32 out[8];
+
+	// Columns, keeping kIDCTPass1Bits of extra precision
+	const int32 pass1Shift = kIDCTConstBits - kIDCTPass1Bits;
+	for (int x = 0; x < 8; x++) {
+		transform1D(out, block + x, 8);
+		for (int i = 0; i < 8; i++)
+			workspace[i * 8 + x] = CLIP<int32>((out[i] + (1 << (pass1Shift - 1))) >> pass1Shift, -32768, 32767);
+	}
+
+	// Rows, removing the extra precision and the scale of the DCT
+	const int32 pass2Shift = kIDCTConstBits + kIDCTPass1Bits + 3;
+	for (int y = 0; y < 8; y++) {
+		transform1D(out, workspace + y * 8, 1);
+		for (int i = 0; i < 8; i++)
+			dest[i] = CLIP<int32>((out[i] + (1 << (pass2Shift - 1)) + (128 << pass2Shift)) >> pass2Shift, 0, 255);
+		dest += pitch;
+	}
+}
+
+} // End of namespace Image
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef IMAGE_CODECS_IDCT_H
+#define IMAGE_CODECS_IDCT_H
+
+#include "common/scummsys.h"
+
+class IDCTTestSuite;
+
+namespace Image {
+
+/**
+ * Integer 8x8 inverse DCT for the intra blocks of JPEG style codecs.
+ *
+ * This is the accurate integer transform of the IJG JPEG library, with
+ * its output level shifted to unsigned samples. A block of coefficients
+ * in the range [-1024, 1023], as produced by 8-bit JPEG and the
+ * PlayStation MDEC, is transformed without overflow; intermediate values
+ * of larger blocks are saturated to 16 bits.
+ *
+ * A vectorized implementation is selected at runtime when the CPU
+ * supports one; all of them give the same results as the generic one.
+ *
+ * Used by PSX streams.
+ */
+class IDCT {
+public:
+	/**
+	 * Transform the dequantized coefficients in @p block, which are in
+	 * row order, and store the result shifted by 128 and clamped to
+	 * [0, 255] in the 8x8 pixels at @p dest.
+	 */
+	static void put(byte *dest, uint pitch, const int16 *block) { putFunc(dest, pitch, block); }
+
+	/** Select the fastest implementation supported by the CPU. */
+	static void init();
+
+private:
+	typedef void (*PutFunc)(byte *dest, uint pitch, const int16 *block);
+
+	static void putGeneric(byte *dest, uint pitch, const int16 *block);
+#ifdef SCUMMVM_NEON
+	static void putNEON(byte *dest, uint pitch, const int16 *block);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void putSSE2(byte *dest, uint pitch, const int16 *block);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void putAVX2(byte *dest, uint pitch, const int16 *block);
+#endif
+
+	static PutFunc putFunc;
+
+	friend class ::IDCTTestSuite;
+};
+
+/**
+ * Fixed point constants of the transform, with 13 fractional bits.
+ */
+enum {
+	kIDCTConstBits = 13,
+	kIDCTPass1Bits = 2,
+
+	kIDCTFix0_298631336 = 2446,
+	kIDCTFix0_390180644 = 3196,
+	kIDCTFix0_541196100 = 4433,
+	kIDCTFix0_765366865 = 6270,
+	kIDCTFix0_899976223 = 7373,
+	kIDCTFix1_175875602 = 9633,
+	kIDCTFix1_501321110 = 12299,
+	kIDCTFix1_847759065 = 15137,
+	kIDCTFix1_961570560 = 16069,
+	kIDCTFix2_053119869 = 16819,
+	kIDCTFix2_562915447 = 20995,
+	kIDCTFix3_072711026 = 25172
+};
+
+} // End of namespace Image
+
+#endif
@@ -19,6 +19,7 @@ MODULE_OBJS := \
 	codecs/codec.o \
 	codecs/hlz.o \
 	codecs/hnm.o \
+	codecs/idct.o \
 	codecs/indeo3.o \
 	codecs/indeo4.o \
 	codecs/indeo5.o \
@@ -38,6 +39,19 @@ MODULE_OBJS := \
 	codecs/indeo/mem.o \
 	codecs/indeo/vlc.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	codecs/idct-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	codecs/idct-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	codecs/idct-avx2.o
+endif
+
 ifdef USE_MPEG2
 MODULE_OBJS += \
 	codecs/mpeg.o
@@ -0,0 +1,95 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/rate_intern.h"
+
+#include "helper.h"
+
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		// The null OSystem used by the tests cannot answer feature queries
+		if (!Audio::SampleMix::mixFunc)
+			Audio::SampleMix::mixFunc = Audio::SampleMix::mixGeneric;
+	}
+
+	void test_handle_status() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle, other;
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(22050, 1, nullptr, false, false), 42);
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &other, createSineStream<int16>(22050, 1, nullptr, false, false));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kMusicSoundType));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kSpeechSoundType));
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 0);
+		TS_ASSERT(mixer.isSoundHandleActive(other));
+
+		// Settings for stopped sounds are ignored
+		mixer.setChannelVolume(handle, 10);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), (byte)0);
+
+		mixer.stopAll();
+		TS_ASSERT(!mixer.isSoundHandleActive(other));
+#endif
+	}
+
+	void test_channel_settings() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(22050);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, createSineStream<int16>(22050, 1, nullptr, false, false));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), (byte)Audio::Mixer::kMaxChannelVolume);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050U);
+
+		// New settings are visible before the audio callback applies them
+		mixer.setChannelVolume(handle, 0);
+		mixer.setChannelBalance(handle, -20);
+		mixer.setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), (byte)0);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), (int8)-20);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025U);
+
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050U);
+
+		// A muted channel mixes silence once the callback has run
+		int16 buffer[512];
+		mixerImpl.mixCallback((byte *)buffer, sizeof(buffer));
+		for (uint i = 0; i < ARRAYSIZE(buffer); i++)
+			TS_ASSERT_EQUALS(buffer[i], (int16)0);
+
+		// Overflowing the command queue applies the commands directly
+		for (int i = 0; i < 1000; i++)
+			mixer.setChannelVolume(handle, i & 0xFF);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), (byte)(999 & 0xFF));
+
+		mixer.setChannelVolume(handle, Audio::Mixer::kMaxChannelVolume);
+		mixerImpl.mixCallback((byte *)buffer, sizeof(buffer));
+		bool silent = true;
+		for (uint i = 0; i < ARRAYSIZE(buffer); i++)
+			silent = silent && buffer[i] == 0;
+		TS_ASSERT(!silent);
+#endif
+	}
+};
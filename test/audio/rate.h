@@ -0,0 +1,198 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/mixer.h"
+
+#include "helper.h"
+
+#include "test/instrset_detect.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+	typedef Audio::SampleMix::MixFunc MixFunc;
+
+	static int16 randomSample(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (int16)(seed >> 16);
+	}
+
+	static int16 referenceMix(int16 dst, int16 src, int vol) {
+		int val = dst + (src * vol) / Audio::Mixer::kMaxMixerVolume;
+		return (int16)CLIP<int>(val, Audio::ST_SAMPLE_MIN, Audio::ST_SAMPLE_MAX);
+	}
+
+	void checkKernel(MixFunc func) {
+		const int volumes[][2] = { { 0, 0 }, { 256, 256 }, { 255, 17 }, { 1, 128 } };
+		uint32 seed = 1;
+
+		for (uint v = 0; v < ARRAYSIZE(volumes); v++) {
+		for (uint frames = 0; frames < 40; frames += 3) {
+		for (int inStereo = 0; inStereo <= 1; inStereo++) {
+		for (int reverse = 0; reverse <= inStereo; reverse++) {
+			int16 src[80], dst[80], expected[80];
+			for (uint i = 0; i < ARRAYSIZE(src); i++) {
+				src[i] = randomSample(seed);
+				dst[i] = expected[i] = randomSample(seed);
+			}
+
+			const int volL = volumes[v][0], volR = volumes[v][1];
+			for (uint i = 0; i < frames; i++) {
+				const int16 inL = src[inStereo ? i * 2 : i];
+				const int16 inR = inStereo ? src[i * 2 + 1] : inL;
+				const uint left = i * 2 + (reverse ? 1 : 0), right = i * 2 + (reverse ? 0 : 1);
+				expected[left] = referenceMix(expected[left], inL, volL);
+				expected[right] = referenceMix(expected[right], inR, volR);
+			}
+
+			func(dst, src, frames, volL, volR, inStereo, reverse);
+
+			TS_ASSERT_EQUALS(memcmp(dst, expected, sizeof(dst)), 0);
+		} // reverse
+		} // inStereo
+		} // frames
+		} // volumes
+	}
+
+public:
+	void setUp() {
+		// The null OSystem used by the tests cannot answer feature queries
+		if (!Audio::SampleMix::mixFunc)
+			Audio::SampleMix::mixFunc = Audio::SampleMix::mixGeneric;
+	}
+
+	void test_mix_generic() {
+		checkKernel(Audio::SampleMix::mixGeneric);
+	}
+
+	void test_mix_simd() {
+#ifdef SCUMMVM_NEON
+		checkKernel(Audio::SampleMix::mixNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernel(Audio::SampleMix::mixSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernel(Audio::SampleMix::mixAVX2);
+#endif
+	}
+
+	void test_interpolate_matches_generic() {
+		const int sampleRate = 11025;
+		const int outRate = 44100;
+		const uint outFrames = outRate;
+
+		MixFunc funcs[] = {
+			Audio::SampleMix::mixGeneric,
+#ifdef SCUMMVM_SSE2
+			instrset_detect() >= 2 ? Audio::SampleMix::mixSSE2 : nullptr,
+#endif
+#ifdef SCUMMVM_AVX2
+			instrset_detect() >= 8 ? Audio::SampleMix::mixAVX2 : nullptr,
+#endif
+		};
+
+		int16 *reference = nullptr;
+		for (uint f = 0; f < ARRAYSIZE(funcs); f++) {
+			if (!funcs[f])
+				continue;
+
+			MixFunc oldFunc = Audio::SampleMix::mixFunc;
+			Audio::SampleMix::mixFunc = funcs[f];
+
+			Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 2, nullptr, false, true);
+			Audio::RateConverter *converter = Audio::makeRateConverter(sampleRate, outRate, true, true, false);
+			int16 *buffer = new int16[outFrames * 2]();
+			// Convert in odd-sized chunks to exercise the kernel tails
+			uint done = 0;
+			while (done < outFrames) {
+				const uint chunk = MIN<uint>(333, outFrames - done);
+				TS_ASSERT_EQUALS((uint)converter->convert(*s, buffer + done * 2, chunk, 200, 100), chunk);
+				done += chunk;
+			}
+			delete converter;
+			delete s;
+
+			Audio::SampleMix::mixFunc = oldFunc;
+
+			if (!reference) {
+				reference = buffer;
+			} else {
+				TS_ASSERT_EQUALS(memcmp(reference, buffer, outFrames * 2 * sizeof(int16)), 0);
+				delete[] buffer;
+			}
+		}
+		delete[] reference;
+	}
+
+	void test_sinc_passes_dc() {
+		const int inRate = 11025, outRate = 44100;
+		const int numSamples = 2048;
+		int16 *input = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; i++)
+			WRITE_LE_INT16(&input[i], 10000);
+
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((byte *)input, numSamples * sizeof(int16), inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, true, false, Audio::kRateConverterSinc);
+		int16 output[2 * 4096] = { 0 };
+		TS_ASSERT_EQUALS(converter->convert(*s, output, 4096, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 4096);
+
+		// Skip the samples affected by the filter delay
+		for (int i = 2 * 64; i < ARRAYSIZE(output); i++)
+			TS_ASSERT_EQUALS(output[i], 10000);
+
+		delete converter;
+		delete s;
+	}
+
+	void test_sinc_sine() {
+		const int inRate = 22050, outRate = 44100;
+		const int numSamples = 4096;
+		const double freq = 440.0, amplitude = 16000.0;
+		int16 *input = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; i++)
+			WRITE_LE_INT16(&input[i], (int16)(sin(2 * M_PI * freq * i / inRate) * amplitude));
+
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((byte *)input, numSamples * sizeof(int16), inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, false, Audio::kRateConverterSinc);
+		int16 output[4096] = { 0 };
+		TS_ASSERT_EQUALS(converter->convert(*s, output, 4096, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 4096);
+
+		// The first output sample lies one input sample before the start of
+		// the stream, and the filter adds a delay of 7 input samples
+		for (int i = 64; i < ARRAYSIZE(output); i++) {
+			const double t = (double)i * inRate / outRate - 8;
+			const double expected = sin(2 * M_PI * freq * t / inRate) * amplitude;
+			TS_ASSERT_DELTA(output[i], expected, amplitude * 0.01);
+		}
+
+		delete converter;
+		delete s;
+	}
+
+	void test_sinc_rate_change() {
+		const int inRate = 44100, outRate = 22050;
+		const int numSamples = 8192;
+		int16 *input = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; i++)
+			WRITE_LE_INT16(&input[i], -8000);
+
+		// Downsampling selects another filter bank, which passes DC as well
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((byte *)input, numSamples * sizeof(int16), inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, false, Audio::kRateConverterSinc);
+		int16 output[1024] = { 0 };
+		TS_ASSERT_EQUALS(converter->convert(*s, output, 1024, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1024);
+		for (int i = 16; i < ARRAYSIZE(output); i++)
+			TS_ASSERT_EQUALS(output[i], -8000);
+
+		memset(output, 0, sizeof(output));
+		converter->setInputRate(11025);
+		TS_ASSERT_EQUALS(converter->convert(*s, output, 1024, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1024);
+		for (int i = 0; i < ARRAYSIZE(output); i++)
+			TS_ASSERT_EQUALS(output[i], -8000);
+
+		delete converter;
+		delete s;
+	}
+};
@@ -0,0 +1,387 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/*
+ * Video decoder throughput benchmark.
+ *
+ * Decodes a video file as fast as possible, without pacing or output,
+ * and reports the decoding speed, the distribution of per-frame decoding
+ * times and the peak memory use of the process. A CRC32 of all decoded
+ * surfaces is printed as well, so runs with different builds can be
+ * checked for identical output.
+ *
+ * Usage: videobench [-t type] [-n frames] [-c] [-j threads] [-a frames] <file>
+ *
+ * With -a, frames are decoded ahead on worker threads, and the frame times
+ * show how long decodeNextFrame() stalled the caller instead.
+ *
+ * Build it with 'make videobench'.
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+// The null OSystem of the unit tests, extended below with an audio mixer
+#include "../null_osystem.cpp"
+
+#include "backends/mixer/null/null-mixer.h"
+
+#include "audio/mixer_intern.h"
+
+#include "common/algorithm.h"
+#include "common/config-manager.h"
+#include "common/crc.h"
+#include "common/fs.h"
+
+#include "video/avi_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/mpegps_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+
+#ifdef USE_BINK
+#include "video/bink_decoder.h"
+#endif
+
+#ifdef USE_THEORADEC
+#include "video/theora_decoder.h"
+#endif
+
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+#define VIDEOBENCH_HAVE_VMD
+#include "video/coktel_decoder.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef POSIX
+#include <sys/resource.h>
+
+#include "backends/threads/pthread/pthread-threadpool.h"
+#endif
+
+namespace {
+
+/**
+ * Null OSystem with a mixer, which the video decoders need for their
+ * audio tracks. Nothing drives the mixer, the benchmark pulls the mixed
+ * audio itself so queued audio does not pile up in memory.
+ */
+class BenchmarkOSystem : public OSystem_NULL {
+public:
+	BenchmarkOSystem() : OSystem_NULL(true) {}
+
+	/** Create the mixer, which needs g_system to be set already. */
+	void initMixer() {
+		_mixerManager = new NullMixerManager();
+		_mixerManager->init();
+	}
+
+#ifdef POSIX
+	Common::ThreadPoolInternal *createThreadPool(uint numThreads) override {
+		return createPthreadThreadPoolInternal(numThreads);
+	}
+#endif
+};
+
+struct DecoderType {
+	const char *name;
+	const char *extensions[4]; ///< Lower case with the leading dot, terminated by nullptr
+	Video::VideoDecoder *(*create)();
+};
+
+template<class T>
+Video::VideoDecoder *createDecoder() {
+	return new T();
+}
+
+const DecoderType decoderTypes[] = {
+	{ "avi", { ".avi" }, createDecoder<Video::AVIDecoder> },
+#ifdef USE_BINK
+	{ "bink", { ".bik" }, createDecoder<Video::BinkDecoder> },
+#endif
+	{ "dxa", { ".dxa" }, createDecoder<Video::DXADecoder> },
+	{ "flic", { ".fli", ".flc" }, createDecoder<Video::FlicDecoder> },
+	{ "mpegps", { ".mpg", ".mpeg", ".vob" }, createDecoder<Video::MPEGPSDecoder> },
+	{ "quicktime", { ".mov", ".qt", ".mp4" }, createDecoder<Video::QuickTimeDecoder> },
+	{ "smacker", { ".smk" }, createDecoder<Video::SmackerDecoder> },
+#ifdef USE_THEORADEC
+	{ "theora", { ".ogv", ".ogg" }, createDecoder<Video::TheoraDecoder> },
+#endif
+#ifdef VIDEOBENCH_HAVE_VMD
+	{ "vmd", { ".vmd" }, createDecoder<Video::AdvancedVMDDecoder> },
+#endif
+};
+
+const DecoderType *findTypeByName(const Common::String &name) {
+	for (uint i = 0; i < ARRAYSIZE(decoderTypes); i++) {
+		if (name.equalsIgnoreCase(decoderTypes[i].name))
+			return &decoderTypes[i];
+	}
+
+	return nullptr;
+}
+
+const DecoderType *findTypeByFileName(const Common::String &fileName) {
+	const char *dot = strrchr(fileName.c_str(), '.');
+	if (!dot)
+		return nullptr;
+
+	Common::String extension(dot);
+	extension.toLowercase();
+	for (uint i = 0; i < ARRAYSIZE(decoderTypes); i++) {
+		for (const char *const *e = decoderTypes[i].extensions; *e; e++) {
+			if (extension == *e)
+				return &decoderTypes[i];
+		}
+	}
+
+	return nullptr;
+}
+
+/** Return a monotonic time stamp in microseconds. */
+uint64 getMicros() {
+#ifdef POSIX
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	return (uint64)g_system->getMillis() * 1000;
+#endif
+}
+
+/** Return the peak resident set size of the process in KiB, or 0 if unknown. */
+uint64 getPeakMemory() {
+#ifdef POSIX
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef MACOSX
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+/** Feed the pixels of @p surface into the running CRC @p crc. */
+uint32 checksumSurface(const Common::CRC32 &crc32, uint32 crc, const Graphics::Surface &surface) {
+	const uint rowSize = surface.w * surface.format.bytesPerPixel;
+	for (int y = 0; y < surface.h; y++) {
+		const byte *row = (const byte *)surface.getBasePtr(0, y);
+		for (uint x = 0; x < rowSize; x++)
+			crc = crc32.processByte(row[x], crc);
+	}
+
+	return crc;
+}
+
+uint32 checksumPalette(const Common::CRC32 &crc32, uint32 crc, const byte *palette) {
+	for (uint i = 0; i < 256 * 3; i++)
+		crc = crc32.processByte(palette[i], crc);
+
+	return crc;
+}
+
+void printUsage() {
+	printf("Usage: videobench [-t type] [-n frames] [-c] [-j threads] [-a frames] <file>\n\n");
+	printf("  -t type     Decoder to use instead of guessing it from the file extension\n");
+	printf("  -n frames   Stop after decoding this many frames\n");
+	printf("  -c          Print the checksum of every frame\n");
+	printf("  -j threads  Number of threads decoding, 0 for one per CPU (default: 1)\n");
+	printf("  -a frames   Decode this many frames ahead on the worker threads\n\n");
+	printf("Decoders:");
+	for (uint i = 0; i < ARRAYSIZE(decoderTypes); i++)
+		printf(" %s", decoderTypes[i].name);
+	printf("\n");
+}
+
+int runBenchmark(Video::VideoDecoder *decoder, uint maxFrames, bool printFrameChecksums, uint decodeAhead) {
+	// YUV based codecs convert to this format, so that checksums do not
+	// depend on the screen format of the backend
+	decoder->setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+
+	printf("Threads:     %u\n", ThreadPoolMan.getThreadCount() + 1);
+	if (decodeAhead) {
+		if (decoder->setDecodeAhead(decodeAhead))
+			printf("Decode ahead: %u frames\n", decodeAhead);
+		else
+			printf("Decode ahead: not supported\n");
+	}
+
+	const uint frameCount = decoder->getFrameCount();
+	const uint32 durationMs = decoder->getDuration().msecs();
+	printf("Video: %dx%d, %d bpp, %u frames, %u.%03u s\n", decoder->getWidth(), decoder->getHeight(),
+	       decoder->getPixelFormat().bytesPerPixel * 8, frameCount, durationMs / 1000, durationMs % 1000);
+
+	Audio::MixerImpl *mixer = (Audio::MixerImpl *)g_system->getMixer();
+	const uint32 outputRate = mixer->getOutputRate();
+	Common::Array<byte> audioBuffer;
+	uint64 mixedSamples = 0;
+
+	Common::CRC32 crc32;
+	uint32 crc = crc32.getInitRemainder();
+	Common::Array<uint32> frameTimes;
+
+	decoder->start();
+
+	const uint64 startTime = getMicros();
+	while (frameTimes.size() < maxFrames && !decoder->endOfVideo()) {
+		if (frameCount && (uint)(decoder->getCurFrame() + 1) >= frameCount)
+			break;
+
+		const uint64 frameStart = getMicros();
+		const Graphics::Surface *surface = decoder->decodeNextFrame();
+		const uint64 frameEnd = getMicros();
+
+		if (!surface)
+			break;
+
+		frameTimes.push_back((uint32)(frameEnd - frameStart));
+
+		uint32 frameCrc = checksumSurface(crc32, crc32.getInitRemainder(), *surface);
+		crc = checksumSurface(crc32, crc, *surface);
+		if (decoder->hasDirtyPalette()) {
+			const byte *palette = decoder->getPalette();
+			frameCrc = checksumPalette(crc32, frameCrc, palette);
+			crc = checksumPalette(crc32, crc, palette);
+		}
+
+		if (printFrameChecksums)
+			printf("Frame %5d: %08x %8u us\n", decoder->getCurFrame(), crc32.finalize(frameCrc), frameTimes.back());
+
+		// Consume the audio up to the end of this frame, as playback would
+		if (frameCount && durationMs) {
+			const uint64 targetSamples = (uint64)outputRate * durationMs * (decoder->getCurFrame() + 1) / frameCount / 1000;
+			if (targetSamples > mixedSamples) {
+				audioBuffer.resize((uint)(targetSamples - mixedSamples) * 4);
+				mixer->mixCallback(audioBuffer.data(), audioBuffer.size());
+				mixedSamples = targetSamples;
+			}
+		}
+	}
+	const uint64 totalTime = getMicros() - startTime;
+
+	if (frameTimes.empty()) {
+		fprintf(stderr, "No frames were decoded\n");
+		return 1;
+	}
+
+	uint64 decodeTime = 0;
+	for (uint i = 0; i < frameTimes.size(); i++)
+		decodeTime += frameTimes[i];
+
+	Common::sort(frameTimes.begin(), frameTimes.end());
+	const uint count = frameTimes.size();
+
+	printf("Frames:      %u\n", count);
+	printf("Decode time: %u.%03u ms (%u.%03u ms including checksums and audio)\n",
+	       (uint)(decodeTime / 1000), (uint)(decodeTime % 1000), (uint)(totalTime / 1000), (uint)(totalTime % 1000));
+	printf("Throughput:  %.2f frames/s\n", decodeTime ? count * 1000000.0 / decodeTime : 0.0);
+	printf("Frame time:  mean %u us, p50 %u us, p90 %u us, p99 %u us, max %u us\n",
+	       (uint)(decodeTime / count), frameTimes[count / 2], frameTimes[count * 9 / 10],
+	       frameTimes[count * 99 / 100], frameTimes[count - 1]);
+
+	const uint64 peakMemory = getPeakMemory();
+	if (peakMemory)
+		printf("Peak memory: %u KiB\n", (uint)peakMemory);
+	else
+		printf("Peak memory: unknown\n");
+
+	printf("Checksum:    %08x\n", crc32.finalize(crc));
+	return 0;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	const DecoderType *type = nullptr;
+	uint maxFrames = 0xFFFFFFFF;
+	bool printFrameChecksums = false;
+	int threads = 1;
+	uint decodeAhead = 0;
+	const char *fileName = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+			type = findTypeByName(argv[++i]);
+			if (!type) {
+				fprintf(stderr, "Unknown decoder '%s'\n", argv[i]);
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+			maxFrames = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-c")) {
+			printFrameChecksums = true;
+		} else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+			threads = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-a") && i + 1 < argc) {
+			decodeAhead = atoi(argv[++i]);
+		} else if (argv[i][0] != '-' && !fileName) {
+			fileName = argv[i];
+		} else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (!fileName) {
+		printUsage();
+		return 1;
+	}
+
+	if (!type)
+		type = findTypeByFileName(fileName);
+	if (!type) {
+		fprintf(stderr, "Cannot guess the decoder for '%s', use -t\n", fileName);
+		return 1;
+	}
+
+	BenchmarkOSystem *system = new BenchmarkOSystem();
+	g_system = system;
+	system->initMixer();
+
+	// The thread pool is created on first use, and takes its size from here
+	if (threads > 0)
+		ConfMan.setInt("worker_threads", threads);
+
+	int result = 1;
+	Common::SeekableReadStream *stream = Common::FSNode(Common::Path::fromConfig(fileName)).createReadStream();
+	if (!stream) {
+		fprintf(stderr, "Cannot open '%s'\n", fileName);
+	} else {
+		printf("Decoder: %s\n", type->name);
+
+		Video::VideoDecoder *decoder = type->create();
+		if (!decoder->loadStream(stream))
+			fprintf(stderr, "Cannot load '%s' with the %s decoder\n", fileName, type->name);
+		else
+			result = runBenchmark(decoder, maxFrames, printFrameChecksums, decodeAhead);
+		delete decoder;
+	}
+
+	g_system->destroy();
+	return result;
+}
@@ -0,0 +1,54 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/scummsys.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class FSNodeTestSuite : public CxxTest::TestSuite {
+public:
+	void test_mapped_read_stream() {
+		Common::install_null_g_system();
+
+		// Large enough to be worth mapping
+		const uint32 size = 256 * 1024;
+		Common::FSNode node(Common::Path("fsnode-test.tmp"));
+		Common::WriteStream *out = node.createWriteStream();
+		TS_ASSERT(out);
+		if (!out)
+			return;
+		for (uint32 i = 0; i < size; i++)
+			out->writeByte(i * 7);
+		out->finalize();
+		delete out;
+
+		// Plain streams are never mapped, as files like saved games may
+		// be rewritten while they are open
+		node = Common::FSNode(Common::Path("fsnode-test.tmp"));
+		Common::SeekableReadStream *in = node.createReadStream();
+		TS_ASSERT(in);
+		if (in) {
+			TS_ASSERT(!in->getBufferPtr());
+			TS_ASSERT_EQUALS(in->size(), size);
+			delete in;
+		}
+
+		// Mapping depends on the file system, but the contents must match
+		in = node.createMappedReadStream();
+		TS_ASSERT(in);
+		if (in) {
+			TS_ASSERT_EQUALS(in->size(), size);
+			const byte *buffer = in->getBufferPtr();
+			bool match = true;
+			for (uint32 i = 0; i < size; i++) {
+				byte b = in->readByte();
+				if (b != (byte)(i * 7) || (buffer && buffer[i] != b))
+					match = false;
+			}
+			TS_ASSERT(match);
+			delete in;
+		}
+	}
+};
@@ -1,6 +1,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "common/hash-str.h"
 
 class HashMapTestSuite : public CxxTest::TestSuite
@@ -230,5 +231,131 @@ class HashMapTestSuite : public CxxTest::TestSuite
 		TS_ASSERT(found == 16+8+4);
 }
 
+	void test_flat_add_remove() {
+		Common::FlatHashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container;
+		TS_ASSERT(container.empty());
+		container["foo"] = 1;
+		container["BAR"] = 2;
+		TS_ASSERT(container.contains("FOO"));
+		TS_ASSERT(container.contains("bar"));
+		TS_ASSERT(!container.contains("baz"));
+		TS_ASSERT_EQUALS(container.size(), 2U);
+		TS_ASSERT_EQUALS(container.getVal("Bar"), 2);
+		TS_ASSERT_EQUALS(container.getValOrDefault("baz"), 0);
+		TS_ASSERT_EQUALS(container.getValOrDefault("baz", 7), 7);
+
+		int val = 0;
+		TS_ASSERT(container.tryGetVal("foo", val));
+		TS_ASSERT_EQUALS(val, 1);
+		TS_ASSERT(!container.tryGetVal("baz", val));
+
+		container.erase("foo");
+		TS_ASSERT(!container.contains("foo"));
+		TS_ASSERT_EQUALS(container.size(), 1U);
+		container.setVal("foo", 3);
+		TS_ASSERT_EQUALS(container["foo"], 3);
+
+		Common::FlatHashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> copy(container);
+		container.clear(true);
+		TS_ASSERT(container.empty());
+		TS_ASSERT(copy.find("foo") != copy.end());
+		TS_ASSERT(copy.find("baz") == copy.end());
+		TS_ASSERT_EQUALS(copy.size(), 2U);
+	}
+
+	void test_flat_erase_iterator() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; i++)
+			container[i] = i * 2;
+
+		// Erasing while iterating leaves the other entries in place
+		int visited = 0;
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT_EQUALS(i->_value, i->_key * 2);
+			if (i->_key & 1)
+				container.erase(i);
+			visited++;
+		}
+		TS_ASSERT_EQUALS(visited, 100);
+		TS_ASSERT_EQUALS(container.size(), 50U);
+
+		for (Common::FlatHashMap<int, int>::const_iterator i = container.begin(); i != container.end(); ++i)
+			TS_ASSERT(!(i->_key & 1));
+	}
+
+	void test_flat_matches_hashmap() {
+		// Random inserts and erases, which also exercises growing and
+		// reusing erased slots
+		Common::HashMap<uint, uint> reference;
+		Common::FlatHashMap<uint, uint> flat;
+		uint32 seed = 1;
+
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint key = (seed >> 8) % 3000;
+			if (seed & 0x80000000) {
+				reference.erase(key);
+				flat.erase(key);
+			} else {
+				reference[key] = i;
+				flat[key] = i;
+			}
+			TS_ASSERT_EQUALS(flat.size(), reference.size());
+		}
+
+		for (Common::HashMap<uint, uint>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i->_key, (uint)-1), i->_value);
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint, uint>::const_iterator i = flat.begin(); i != flat.end(); ++i, ++count)
+			TS_ASSERT(reference.contains(i->_key));
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	struct CountingEqualTo {
+		static uint comparisons;
+		bool operator()(uint x, uint y) const { comparisons++; return x == y; }
+	};
+
+	void test_flat_aligned_keys() {
+		// Keys which only differ in their high bits, like aligned pointers,
+		// must still spread over the table
+		Common::FlatHashMap<uint, uint, Common::Hash<uint>, CountingEqualTo> flat;
+		const uint numKeys = 20000;
+		for (uint i = 0; i < numKeys; i++)
+			flat[i << 12] = i;
+
+		CountingEqualTo::comparisons = 0;
+		for (uint i = 0; i < numKeys; i++) {
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i << 12, (uint)-1), i);
+			TS_ASSERT(!flat.contains((i << 12) | 0x800));
+		}
+
+		// The tags let almost all mismatching slots be skipped
+		TS_ASSERT_LESS_THAN(CountingEqualTo::comparisons, numKeys * 11 / 10);
+	}
+
+	void test_flat_setval_self_reference() {
+		// Fill the table up to the point where the next insertion grows it
+		Common::FlatHashMap<Common::String, Common::String> flat;
+		for (int i = 0; i < 12; i++)
+			flat[Common::String::format("a long enough key number %d", i)] = Common::String::format("a long enough value number %d", i);
+
+		// Insert using a key and a value which are stored in the table
+		flat.setVal(flat["a long enough key number 0"], flat["a long enough key number 1"]);
+		TS_ASSERT_EQUALS(flat.size(), 13U);
+		TS_ASSERT_EQUALS(flat.getValOrDefault("a long enough value number 0"), "a long enough value number 1");
+
+		// The same through operator[]
+		for (int i = 13; i < 24; i++)
+			flat[Common::String::format("a long enough key number %d", i)] = Common::String::format("a long enough value number %d", i);
+		TS_ASSERT_EQUALS(flat.size(), 24U);
+		flat[flat["a long enough key number 2"]] = "new";
+		TS_ASSERT_EQUALS(flat.size(), 25U);
+		TS_ASSERT_EQUALS(flat.getValOrDefault("a long enough value number 2"), "new");
+	}
+
 	// TODO: Add test cases for iterators, find, ...
 };
+
+uint HashMapTestSuite::CountingEqualTo::comparisons = 0;
@@ -104,4 +104,19 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_buffer_ptr() {
+		byte contents[] = { 'a', 'b', 'c', 'd', 'e' };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		// The buffer always starts at the beginning of the stream
+		TS_ASSERT_EQUALS(ms.getBufferPtr(), contents);
+		ms.readByte();
+		ms.readByte();
+		TS_ASSERT_EQUALS(ms.getBufferPtr(), contents);
+		ms.seek(0, SEEK_END);
+		ms.readByte();
+		TS_ASSERT(ms.eos());
+		TS_ASSERT_EQUALS(ms.getBufferPtr(), contents);
+	}
 };
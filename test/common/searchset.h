@@ -0,0 +1,169 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+
+#include "../null_osystem.h"
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+	// Archive containing a single file, which counts how often it is asked
+	class CountingArchive : public Common::Archive {
+	public:
+		CountingArchive(const char *name) : _name(name), _lookups(0), _failedStreams(0) {}
+
+		bool hasFile(const Common::Path &path) const override {
+			_lookups++;
+			return path.equalsIgnoreCase(_name);
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_name, *this)));
+			return 1;
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+			if (!path.equalsIgnoreCase(_name))
+				return Common::ArchiveMemberPtr();
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_name, *this));
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+			if (!hasFile(path))
+				return nullptr;
+			if (_failedStreams > 0) {
+				_failedStreams--;
+				return nullptr;
+			}
+			return new Common::MemoryReadStream(_data, sizeof(_data));
+		}
+
+		Common::Path _name;
+		mutable int _lookups;
+		mutable int _failedStreams;
+		byte _data[4] = { 1, 2, 3, 4 };
+	};
+
+public:
+	void test_lookup_cache() {
+		Common::SearchSet set;
+		CountingArchive *low = new CountingArchive("a.dat");
+		CountingArchive *high = new CountingArchive("b.dat");
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+
+		// Found files are only checked in the archive which has them
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(high->_lookups, 1);
+		TS_ASSERT_EQUALS(low->_lookups, 2);
+
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("a.dat");
+		TS_ASSERT(stream != nullptr);
+		delete stream;
+		stream = set.createReadStreamForMember("a.dat");
+		TS_ASSERT(stream != nullptr);
+		delete stream;
+		TS_ASSERT_EQUALS(high->_lookups, 2);
+		TS_ASSERT_EQUALS(low->_lookups, 4);
+
+		// Missing files are looked up in every archive each time
+		TS_ASSERT(!set.hasFile("missing.dat"));
+		TS_ASSERT(!set.hasFile("missing.dat"));
+		TS_ASSERT_EQUALS(high->_lookups, 4);
+		TS_ASSERT_EQUALS(low->_lookups, 6);
+
+		set.clearLookupCache();
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(high->_lookups, 5);
+		TS_ASSERT_EQUALS(low->_lookups, 7);
+	}
+
+	void test_failed_stream() {
+		Common::SearchSet set;
+		CountingArchive *archive = new CountingArchive("a.dat");
+		set.add("a", archive);
+
+		// A file which could not be opened once is not hidden afterwards
+		archive->_failedStreams = 1;
+		TS_ASSERT(set.createReadStreamForMember("a.dat") == nullptr);
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("a.dat");
+		TS_ASSERT(stream != nullptr);
+		delete stream;
+
+		// Nor when it was found before, for which the cached archive and
+		// the search through all archives both fail
+		archive->_failedStreams = 2;
+		TS_ASSERT(set.createReadStreamForMember("a.dat") == nullptr);
+		stream = set.createReadStreamForMember("a.dat");
+		TS_ASSERT(stream != nullptr);
+		delete stream;
+	}
+
+	void test_invalidation() {
+		Common::SearchSet set;
+		set.add("a", new CountingArchive("a.dat"));
+		TS_ASSERT(!set.hasFile("b.dat"));
+
+		set.add("b", new CountingArchive("b.dat"));
+		TS_ASSERT(set.hasFile("b.dat"));
+
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("b.dat");
+		TS_ASSERT(stream != nullptr);
+		delete stream;
+
+		set.remove("b");
+		TS_ASSERT(!set.hasFile("b.dat"));
+		TS_ASSERT(set.createReadStreamForMember("b.dat") == nullptr);
+
+		// A change to a nested search set is noticed as well
+		Common::SearchSet *nested = new Common::SearchSet();
+		set.add("nested", nested);
+		TS_ASSERT(!set.hasFile("c.dat"));
+		nested->add("c", new CountingArchive("c.dat"));
+		TS_ASSERT(set.hasFile("c.dat"));
+
+		Common::Archive *container = nullptr;
+		TS_ASSERT(set.getMember("c.dat", &container));
+		TS_ASSERT_EQUALS(container, nested);
+	}
+
+	void test_priority() {
+		Common::SearchSet set;
+		CountingArchive *low = new CountingArchive("a.dat");
+		CountingArchive *high = new CountingArchive("a.dat");
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+
+		Common::Archive *container = nullptr;
+		set.getMember("a.dat", &container);
+		TS_ASSERT_EQUALS(container, high);
+
+		set.setPriority("low", 2);
+		set.getMember("a.dat", &container);
+		TS_ASSERT_EQUALS(container, low);
+	}
+
+	void test_file_system_change() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::SearchSet set;
+		CountingArchive *low = new CountingArchive("a.dat");
+		CountingArchive *high = new CountingArchive("b.dat");
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(high->_lookups, 1);
+
+		// Writing any file may add it to an archive of higher priority
+		Common::WriteStream *stream = Common::FSNode(Common::Path("searchset-test.tmp")).createWriteStream();
+		TS_ASSERT(stream);
+		delete stream;
+
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(high->_lookups, 2);
+#endif
+	}
+};
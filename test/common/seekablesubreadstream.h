@@ -70,4 +70,25 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_buffer_ptr() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		TS_ASSERT_EQUALS(ms.getBufferPtr(), contents);
+
+		// The pointer addresses the start of the substream, wherever it is read
+		Common::SeekableSubReadStream ssrs(&ms, 1, 9);
+		ssrs.seek(3);
+		TS_ASSERT_EQUALS(ssrs.getBufferPtr(), contents + 1);
+
+		Common::SeekableSubReadStream nested(&ssrs, 2, 6);
+		TS_ASSERT_EQUALS(nested.getBufferPtr(), contents + 3);
+
+		// Wrappers forward the buffer of the stream they wrap
+		ms.seek(4);
+		Common::SeekableReadStream *data = ms.readStream(5);
+		Common::SeekableReadStreamEndianWrapper wrapper(data, true, DisposeAfterUse::YES);
+		TS_ASSERT(wrapper.getBufferPtr() != nullptr);
+		TS_ASSERT_EQUALS(wrapper.getBufferPtr()[0], 4);
+	}
 };
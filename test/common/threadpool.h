@@ -0,0 +1,190 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "../null_osystem.h"
+
+#ifdef POSIX
+#include "backends/threads/pthread/pthread-threadpool.h"
+#endif
+
+static void countRange(uint begin, uint end, void *data) {
+	uint *hits = (uint *)data;
+	for (uint i = begin; i < end; ++i)
+		hits[i]++;
+}
+
+static void incrementValue(void *data) {
+	(*(uint *)data)++;
+}
+
+struct ConcurrencyData {
+	uint count;
+	Common::Atomic<uint> started;
+	Common::Atomic<uint> timeouts;
+};
+
+// Wait until every range has started, which only happens when they run
+// on different threads
+static void waitForAllRanges(uint begin, uint end, void *data) {
+	ConcurrencyData *concurrency = (ConcurrencyData *)data;
+	concurrency->started.fetchAdd(1);
+
+	for (uint i = 0; concurrency->started.load() < concurrency->count; ++i) {
+		if (i == 5000) {
+			concurrency->timeouts.fetchAdd(1);
+			break;
+		}
+		g_system->delayMillis(1);
+	}
+}
+
+struct NestedData {
+	Common::ThreadPool *pool;
+	Common::Atomic<uint> count;
+};
+
+static void incrementAtomic(void *data) {
+	((NestedData *)data)->count.fetchAdd(1);
+}
+
+struct BlockerData {
+	Common::Atomic<uint> started;
+	Common::Atomic<uint> released;
+};
+
+// Keep a worker busy until the test releases it
+static void blockWorker(void *data) {
+	BlockerData *blocker = (BlockerData *)data;
+	blocker->started.store(1);
+	for (uint i = 0; i < 5000 && !blocker->released.load(); ++i)
+		g_system->delayMillis(1);
+}
+
+static void runNestedGroup(void *data) {
+	NestedData *nested = (NestedData *)data;
+	Common::TaskGroup group(*nested->pool);
+	for (uint i = 0; i < 8; ++i)
+		group.run(incrementAtomic, nested);
+	group.wait();
+}
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void test_parallel_for() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint counts[] = { 0, 1, 7, 64, 1001 };
+		for (uint c = 0; c < ARRAYSIZE(counts); ++c) {
+			for (uint threads = 1; threads <= 4; ++threads) {
+				Common::ThreadPool pool(threads);
+				uint hits[1001] = { 0 };
+
+				pool.parallelFor(counts[c], countRange, hits, 3);
+
+				for (uint i = 0; i < ARRAYSIZE(hits); ++i)
+					TS_ASSERT_EQUALS(hits[i], i < counts[c] ? 1U : 0U);
+			}
+		}
+#endif
+	}
+
+	void test_task_group() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ThreadPool pool(4);
+		uint values[16] = { 0 };
+		{
+			Common::TaskGroup group(pool);
+			for (uint i = 0; i < ARRAYSIZE(values); ++i)
+				group.run(incrementValue, &values[i]);
+			group.wait();
+
+			for (uint i = 0; i < ARRAYSIZE(values); ++i)
+				TS_ASSERT_EQUALS(values[i], 1U);
+
+			for (uint i = 0; i < ARRAYSIZE(values); ++i)
+				group.run(incrementValue, &values[i]);
+		}
+
+		// The group destructor waits for the second batch.
+		for (uint i = 0; i < ARRAYSIZE(values); ++i)
+			TS_ASSERT_EQUALS(values[i], 2U);
+#endif
+	}
+
+	void test_worker_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX)
+		Common::install_null_g_system();
+
+		Common::ThreadPool pool(createPthreadThreadPoolInternal(3));
+		TS_ASSERT(pool.isMultiThreaded());
+		TS_ASSERT_EQUALS(pool.getThreadCount(), 3U);
+
+		uint hits[1001] = { 0 };
+		pool.parallelFor(ARRAYSIZE(hits), countRange, hits);
+		for (uint i = 0; i < ARRAYSIZE(hits); ++i)
+			TS_ASSERT_EQUALS(hits[i], 1U);
+
+		ConcurrencyData concurrency;
+		concurrency.count = 4;
+		concurrency.started.store(0);
+		concurrency.timeouts.store(0);
+		pool.parallelFor(concurrency.count, waitForAllRanges, &concurrency);
+		TS_ASSERT_EQUALS(concurrency.started.load(), 4U);
+		TS_ASSERT_EQUALS(concurrency.timeouts.load(), 0U);
+
+		// Jobs waiting for their own jobs must not deadlock the pool
+		NestedData nested;
+		nested.pool = &pool;
+		nested.count.store(0);
+		{
+			Common::TaskGroup group(pool);
+			for (uint i = 0; i < 16; ++i)
+				group.run(runNestedGroup, &nested);
+		}
+		TS_ASSERT_EQUALS(nested.count.load(), 16U * 8U);
+#endif
+	}
+
+	void test_cancel() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX)
+		Common::install_null_g_system();
+
+		// With its only worker busy, all other jobs stay queued
+		Common::ThreadPool pool(createPthreadThreadPoolInternal(1));
+		BlockerData blocker;
+		blocker.started.store(0);
+		blocker.released.store(0);
+		Common::TaskGroup busy(pool);
+		busy.run(blockWorker, &blocker);
+		while (!blocker.started.load())
+			g_system->delayMillis(1);
+
+		NestedData kept, canceled;
+		kept.count.store(0);
+		canceled.count.store(0);
+		Common::TaskGroup other(pool);
+		{
+			Common::TaskGroup group(pool);
+			for (uint i = 0; i < 4; ++i) {
+				group.run(incrementAtomic, &canceled);
+				other.run(incrementAtomic, &kept);
+			}
+			group.cancel();
+		}
+		TS_ASSERT_EQUALS(canceled.count.load(), 0U);
+
+		// Jobs of other groups still run
+		blocker.released.store(1);
+		busy.wait();
+		other.wait();
+		TS_ASSERT_EQUALS(kept.count.load(), 4U);
+		TS_ASSERT_EQUALS(canceled.count.load(), 0U);
+#endif
+	}
+};
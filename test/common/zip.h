@@ -0,0 +1,126 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/threadpool.h"
+#include "common/compression/unzip.h"
+
+#include "../null_osystem.h"
+#include "../worker_threads.h"
+
+class ZipArchiveTestSuite : public CxxTest::TestSuite {
+	// a.txt (deflated, "hello zip " 20 times) and dir/b.txt (stored, "stored data")
+	static const byte *zipData() {
+		static const byte data[] = {
+		0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x50, 0xc7, 0x80,
+		0x3a, 0x36, 0x0f, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x61, 0x2e,
+		0x74, 0x78, 0x74, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0xa8, 0xca, 0x2c, 0x50, 0xc8, 0x18, 0xd2,
+		0x2c, 0x00, 0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x50,
+		0x11, 0x55, 0xd7, 0x99, 0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
+		0x64, 0x69, 0x72, 0x2f, 0x62, 0x2e, 0x74, 0x78, 0x74, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x20,
+		0x64, 0x61, 0x74, 0x61, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00,
+		0x00, 0x00, 0x21, 0x50, 0xc7, 0x80, 0x3a, 0x36, 0x0f, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x00,
+		0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa4, 0x81, 0x00, 0x00,
+		0x00, 0x00, 0x61, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x50, 0x11, 0x55, 0xd7, 0x99, 0x0b, 0x00, 0x00, 0x00, 0x0b,
+		0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa4,
+		0x81, 0x32, 0x00, 0x00, 0x00, 0x64, 0x69, 0x72, 0x2f, 0x62, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b,
+		0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 0x6a, 0x00, 0x00, 0x00, 0x64, 0x00,
+		0x00, 0x00, 0x00, 0x00
+		};
+		return data;
+	}
+
+	static const uint32 zipSize = 228;
+
+	static Common::String readMember(Common::Archive *archive, const char *name) {
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember(Common::Path(name));
+		if (!stream)
+			return Common::String();
+
+		Common::String contents = stream->readString(0, stream->size());
+		delete stream;
+		return contents;
+	}
+
+	static Common::Archive *open(bool flattenTree, uint32 preloadSize = 0) {
+		return Common::makeZipArchive(new Common::MemoryReadStream(zipData(), zipSize), flattenTree, preloadSize);
+	}
+
+	static Common::String expectedA() {
+		Common::String expected;
+		for (int i = 0; i < 20; i++)
+			expected += "hello zip ";
+		return expected;
+	}
+
+public:
+	void test_read_members() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Archive *archive = open(false);
+		TS_ASSERT(archive != nullptr);
+		TS_ASSERT(archive->hasFile("A.TXT"));
+		TS_ASSERT(archive->hasFile("dir/b.txt"));
+		TS_ASSERT(!archive->hasFile("b.txt"));
+
+		TS_ASSERT_EQUALS(readMember(archive, "a.txt"), expectedA());
+		TS_ASSERT_EQUALS(readMember(archive, "dir/b.txt"), "stored data");
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(archive->listMembers(list), 2);
+		delete archive;
+#endif
+	}
+
+	void test_reopen() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Archives with identical contents share their index, which must
+		// still respect how the tree was flattened
+		Common::Archive *first = open(false);
+		Common::Archive *second = open(false);
+		Common::Archive *flat = open(true);
+
+		delete first;
+		TS_ASSERT_EQUALS(readMember(second, "dir/b.txt"), "stored data");
+		TS_ASSERT(!second->hasFile("b.txt"));
+		TS_ASSERT_EQUALS(readMember(flat, "b.txt"), "stored data");
+		TS_ASSERT(!flat->hasFile("dir/b.txt"));
+
+		delete second;
+		delete flat;
+#endif
+	}
+
+	void test_preload() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Without worker threads, preloading does nothing
+		Common::Archive *archive = open(false, 1024);
+		TS_ASSERT_EQUALS(readMember(archive, "a.txt"), expectedA());
+		TS_ASSERT_EQUALS(readMember(archive, "dir/b.txt"), "stored data");
+		delete archive;
+#endif
+	}
+
+	void test_worker_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE && WORKER_THREADS_ARE_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ScopedWorkerThreads workers(3);
+
+		// Members may be taken and the archive closed while the workers are
+		// still preloading, or after they are done
+		for (int i = 0; i < 20; i++) {
+			Common::Archive *archive = open(false, 1024);
+			if (i & 1)
+				TS_ASSERT_EQUALS(readMember(archive, "a.txt"), expectedA());
+			delete archive;
+		}
+#endif
+	}
+};
@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+#include "engines/detectioncache.h"
+
+class DetectionCacheTestSuite : public CxxTest::TestSuite {
+	// Write the cache out and read it back, which starts a new run
+	static void reload(PersistentDetectionCache &cache) {
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		TS_ASSERT(cache.save(out));
+		TS_ASSERT(!cache.isDirty());
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		cache.load(in);
+	}
+
+	static bool hasEntry(PersistentDetectionCache &cache, const Common::String &key, int64 fileSize = 100, int64 modificationTime = 12345) {
+		int64 size;
+		Common::String md5;
+		return cache.lookup(key, fileSize, modificationTime, size, md5);
+	}
+
+public:
+	void test_save_load() {
+		PersistentDetectionCache cache;
+		TS_ASSERT(!cache.isDirty());
+
+		cache.store("d:5000:/games/monkey/000.lfl", 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+		cache.store("t:0:/games/with\ttab/file", 200, 1700000000123456789LL, 200, "fedcba9876543210fedcba9876543210");
+		cache.store("d:0:/games/line\nbreak\\file", 300, 12345, 300, "00112233445566778899aabbccddeeff");
+		TS_ASSERT(cache.isDirty());
+
+		reload(cache);
+		TS_ASSERT_EQUALS(cache.size(), 3u);
+
+		int64 size = -1;
+		Common::String md5;
+		TS_ASSERT(cache.lookup("d:5000:/games/monkey/000.lfl", 100, 12345, size, md5));
+		TS_ASSERT_EQUALS(size, 100);
+		TS_ASSERT_EQUALS(md5, "0123456789abcdef0123456789abcdef");
+
+		// Keys may contain tabs, and modification times need the full 64 bits
+		TS_ASSERT(cache.lookup("t:0:/games/with\ttab/file", 200, 1700000000123456789LL, size, md5));
+		TS_ASSERT_EQUALS(size, 200);
+		TS_ASSERT_EQUALS(md5, "fedcba9876543210fedcba9876543210");
+
+		// Line breaks in keys do not split their entry
+		TS_ASSERT(cache.lookup("d:0:/games/line\nbreak\\file", 300, 12345, size, md5));
+		TS_ASSERT_EQUALS(md5, "00112233445566778899aabbccddeeff");
+		TS_ASSERT(!hasEntry(cache, "d:0:/games/line", 300));
+	}
+
+	void test_invalidation() {
+		PersistentDetectionCache cache;
+		cache.store("a", 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+		cache.store("b", 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+		reload(cache);
+
+		// A file rewritten with the same size, but a different time
+		TS_ASSERT(!hasEntry(cache, "a", 100, 12346));
+		// A file whose size changed
+		TS_ASSERT(!hasEntry(cache, "b", 101, 12345));
+		TS_ASSERT(!hasEntry(cache, "c"));
+
+		// Stale entries are removed for good
+		TS_ASSERT(cache.isDirty());
+		TS_ASSERT_EQUALS(cache.size(), 0u);
+		TS_ASSERT(!hasEntry(cache, "a"));
+	}
+
+	void test_other_format() {
+		const char data[] = "# ScummVM detection cache v1\n"
+		                    "100\t12345\t100\t0123456789abcdef0123456789abcdef\ta\n";
+		Common::MemoryReadStream in((const byte *)data, sizeof(data) - 1);
+
+		PersistentDetectionCache cache;
+		cache.load(in);
+		TS_ASSERT_EQUALS(cache.size(), 0u);
+	}
+
+	void test_malformed_lines() {
+		const char data[] = "# ScummVM detection cache v3\n"
+		                    "7\n"
+		                    "100\t12345\t100\n"
+		                    "100\t12345\t100\t7\t0123456789abcdef0123456789abcdef\t\n"
+		                    "100\t12345\t100\t7\t0123456789abcdef0123456789abcdef\tbad\\escape\n"
+		                    "100\t12345\t100\t7\t0123456789abcdef0123456789abcdef\tgood\n";
+		Common::MemoryReadStream in((const byte *)data, sizeof(data) - 1);
+
+		PersistentDetectionCache cache;
+		cache.load(in);
+		TS_ASSERT_EQUALS(cache.size(), 1u);
+		TS_ASSERT(hasEntry(cache, "good"));
+	}
+
+	void test_unused_entries_expire() {
+		PersistentDetectionCache cache;
+		cache.store("used", 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+		cache.store("unused", 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+
+		for (uint run = 1; run <= PersistentDetectionCache::kMaxUnusedRuns; run++) {
+			reload(cache);
+			TS_ASSERT(hasEntry(cache, "used"));
+		}
+		TS_ASSERT_EQUALS(cache.size(), 2u);
+
+		// One more run without using it and the entry is dropped
+		reload(cache);
+		TS_ASSERT_EQUALS(cache.size(), 1u);
+		TS_ASSERT(hasEntry(cache, "used"));
+		TS_ASSERT(!hasEntry(cache, "unused"));
+	}
+
+	void test_size_limit() {
+		PersistentDetectionCache cache;
+		for (int i = 0; i < 10; i++)
+			cache.store(Common::String::format("old%d", i), 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+		reload(cache);
+
+		for (int i = 0; i < PersistentDetectionCache::kMaxEntries; i++)
+			cache.store(Common::String::format("new%d", i), 100, 12345, 100, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT_EQUALS(cache.size(), (uint)PersistentDetectionCache::kMaxEntries + 10);
+
+		// The least recently used entries are evicted first
+		reload(cache);
+		TS_ASSERT_EQUALS(cache.size(), (uint)PersistentDetectionCache::kMaxEntries);
+		for (int i = 0; i < 10; i++)
+			TS_ASSERT(!hasEntry(cache, Common::String::format("old%d", i)));
+		TS_ASSERT(hasEntry(cache, "new0"));
+		TS_ASSERT(hasEntry(cache, Common::String::format("new%d", PersistentDetectionCache::kMaxEntries - 1)));
+	}
+};
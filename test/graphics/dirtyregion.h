@@ -0,0 +1,107 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyregion.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 320;
+	static const int kHeight = 200;
+
+	// Check that the rects of @p region cover @p rect
+	static bool covers(Graphics::DirtyRegion &region, const Common::Rect &rect) {
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		for (int y = rect.top; y < rect.bottom; y++) {
+			for (int x = rect.left; x < rect.right; x++) {
+				bool found = false;
+				for (uint i = 0; i < rects.size() && !found; i++)
+					found = rects[i].contains(x, y);
+				if (!found)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	static int totalArea(Graphics::DirtyRegion &region) {
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		int area = 0;
+		for (uint i = 0; i < rects.size(); i++)
+			area += rects[i].width() * rects[i].height();
+		return area;
+	}
+
+public:
+	void test_merge() {
+		Graphics::DirtyRegion region;
+		region.setSize(kWidth, kHeight);
+		TS_ASSERT(region.empty());
+
+		// Contained rects are dropped
+		region.add(Common::Rect(10, 10, 50, 50));
+		region.add(Common::Rect(20, 20, 30, 30));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+
+		// Adjacent rects of the same height are merged
+		region.add(Common::Rect(50, 10, 60, 50));
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(10, 10, 60, 50));
+
+		// Distant rects are kept apart
+		region.add(Common::Rect(200, 150, 210, 160));
+		TS_ASSERT_EQUALS(region.getRects().size(), 2U);
+
+		// Rects are clipped to the screen
+		region.add(Common::Rect(300, 190, 400, 300));
+		TS_ASSERT(covers(region, Common::Rect(300, 190, 320, 200)));
+		TS_ASSERT_EQUALS(totalArea(region), 50 * 40 + 10 * 10 + 20 * 10);
+
+		region.clear();
+		TS_ASSERT(region.empty());
+		TS_ASSERT_EQUALS(region.getRects().size(), 0U);
+	}
+
+	void test_tiles() {
+		Graphics::DirtyRegion region;
+		region.setSize(kWidth, kHeight);
+
+		// A scattered grid of small rects overflows the rect list
+		Common::Array<Common::Rect> added;
+		for (int y = 3; y + 4 < kHeight; y += 29) {
+			for (int x = 5; x + 4 < kWidth; x += 21) {
+				added.push_back(Common::Rect(x, y, x + 4, y + 4));
+				region.add(added.back());
+			}
+		}
+		TS_ASSERT_LESS_THAN(Graphics::DirtyRegion::kMaxRects, added.size());
+		TS_ASSERT(region.isTiled());
+		TS_ASSERT(!region.empty());
+
+		for (uint i = 0; i < added.size(); i++)
+			TS_ASSERT(covers(region, added[i]));
+
+		// At most the touched tiles are redrawn, never the whole screen
+		const int tileArea = Graphics::DirtyRegion::kTileSize * Graphics::DirtyRegion::kTileSize;
+		TS_ASSERT_LESS_THAN_EQUALS(totalArea(region), (int)added.size() * 4 * tileArea);
+		TS_ASSERT_LESS_THAN(totalArea(region), kWidth * kHeight);
+
+		// The tile rects do not overlap
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		for (uint i = 0; i < rects.size(); i++) {
+			for (uint j = i + 1; j < rects.size(); j++)
+				TS_ASSERT(!rects[i].intersects(rects[j]));
+		}
+
+		// Runs of tiles spanning the same columns are joined vertically
+		region.clear();
+		for (int i = 0; i <= (int)Graphics::DirtyRegion::kMaxRects; i++)
+			region.add(Common::Rect(i % 2 ? 64 : 0, i, i % 2 ? 96 : 32, i + 1));
+		TS_ASSERT(region.isTiled());
+		TS_ASSERT_EQUALS(region.getRects().size(), 2U);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 32, 112));
+		TS_ASSERT_EQUALS(region.getRects()[1], Common::Rect(64, 0, 96, 112));
+
+		// Clearing leaves the tile mode
+		region.clear();
+		TS_ASSERT(!region.isTiled());
+		TS_ASSERT(region.empty());
+	}
+};
@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/rendercache.h"
+
+class RenderCacheTestSuite : public CxxTest::TestSuite {
+	// Stand-in for a drawing operation which blends with the background
+	static void draw(Graphics::Surface &surface, const Common::Rect &area) {
+		for (int y = area.top; y < area.bottom; ++y) {
+			for (int x = area.left; x < area.right; ++x) {
+				byte *pixel = (byte *)surface.getBasePtr(x, y);
+				*pixel = *pixel / 2 + 100;
+			}
+		}
+	}
+
+	static void fill(Graphics::Surface &surface, byte value) {
+		memset(surface.getPixels(), value, surface.pitch * surface.h);
+	}
+
+	// Draw through the cache, returns true on a hit
+	static bool drawCached(Graphics::RenderCache &cache, Graphics::Surface &surface, const Common::Rect &bounds) {
+		Common::Rect area = bounds;
+		area.grow(-2);
+
+		const Graphics::RenderCacheKey key(1, 0, bounds, area);
+		if (cache.lookUp(key, surface, bounds))
+			return true;
+
+		Graphics::Surface before;
+		before.create(bounds.width(), bounds.height(), surface.format);
+		before.copyRectToSurface(surface, 0, 0, bounds);
+		draw(surface, area);
+		if (cache.wantsStore(key))
+			cache.store(key, before, surface, bounds);
+		before.free();
+		return false;
+	}
+
+public:
+	void test_reuse() {
+		Graphics::Surface surface, expected;
+		surface.create(64, 64, Graphics::PixelFormat::createFormatCLUT8());
+		expected.create(64, 64, Graphics::PixelFormat::createFormatCLUT8());
+		fill(surface, 20);
+		fill(expected, 20);
+
+		Graphics::RenderCache cache;
+		TS_ASSERT(!drawCached(cache, surface, Common::Rect(2, 2, 18, 12)));
+		draw(expected, Common::Rect(4, 4, 16, 10));
+		TS_ASSERT_EQUALS(cache.size(), 1U);
+
+		// Same background elsewhere
+		TS_ASSERT(drawCached(cache, surface, Common::Rect(30, 40, 46, 50)));
+		draw(expected, Common::Rect(32, 42, 44, 48));
+		TS_ASSERT_EQUALS(memcmp(surface.getPixels(), expected.getPixels(), 64 * 64), 0);
+
+		// Dithered drawing depends on the parity of the position
+		TS_ASSERT(!drawCached(cache, surface, Common::Rect(31, 2, 47, 12)));
+		TS_ASSERT_EQUALS(cache.size(), 2U);
+
+		surface.free();
+		expected.free();
+	}
+
+	void test_background_changes() {
+		Graphics::Surface surface;
+		surface.create(64, 64, Graphics::PixelFormat::createFormatCLUT8());
+		fill(surface, 20);
+
+		Graphics::RenderCache cache;
+		const Common::Rect bounds(0, 0, 16, 10);
+		drawCached(cache, surface, bounds);
+
+		// The result of drawing onto a different background is not reused
+		fill(surface, 50);
+		TS_ASSERT(!drawCached(cache, surface, bounds));
+		TS_ASSERT_EQUALS(*(byte *)surface.getBasePtr(5, 5), 50 / 2 + 100);
+
+		// Keys which keep missing stop being stored
+		for (uint i = 0; i < Graphics::RenderCache::kMaxMisses; ++i) {
+			fill(surface, i);
+			drawCached(cache, surface, bounds);
+		}
+		Common::Rect area = bounds;
+		area.grow(-2);
+		TS_ASSERT(!cache.wantsStore(Graphics::RenderCacheKey(1, 0, bounds, area)));
+
+		// A hit on the last background which was stored makes them eligible again
+		fill(surface, Graphics::RenderCache::kMaxMisses - 3);
+		TS_ASSERT(drawCached(cache, surface, bounds));
+		TS_ASSERT(cache.wantsStore(Graphics::RenderCacheKey(1, 0, bounds, area)));
+
+		surface.free();
+	}
+
+	void test_eviction() {
+		Graphics::Surface surface;
+		surface.create(64, 64, Graphics::PixelFormat::createFormatCLUT8());
+		fill(surface, 20);
+
+		// Room for two of the entries below
+		Graphics::RenderCache cache(1100);
+		drawCached(cache, surface, Common::Rect(0, 0, 16, 16));
+		drawCached(cache, surface, Common::Rect(0, 0, 16, 18));
+		TS_ASSERT(drawCached(cache, surface, Common::Rect(20, 20, 36, 36)));
+		drawCached(cache, surface, Common::Rect(0, 0, 18, 16));
+		TS_ASSERT_EQUALS(cache.size(), 2U);
+		TS_ASSERT(cache.getBytes() <= 1100U);
+
+		// The least recently used entry is gone
+		fill(surface, 20);
+		TS_ASSERT(drawCached(cache, surface, Common::Rect(0, 0, 16, 16)));
+		TS_ASSERT(!drawCached(cache, surface, Common::Rect(0, 0, 16, 18)));
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.size(), 0U);
+		TS_ASSERT_EQUALS(cache.getBytes(), 0U);
+
+		surface.free();
+	}
+};
@@ -0,0 +1,261 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "common/array.h"
+#include "graphics/pixelformat.h"
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#ifdef USE_EDGE_SCALERS
+#include "graphics/scaler/edge.h"
+#endif
+
+#include "../null_osystem.h"
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+	static const unsigned kMaxCount = 69;
+	static const int kWidth = 45;
+	static const int kHeight = 7;
+	static const int kBandWidth = 24;
+	static const int kBandHeight = 72;
+	static const int kBandPadding = 4;
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8 ^ seed << 13;
+	}
+
+	// Rows of a few colours, so that neighbours are often equal. The colours
+	// have their top bits set to catch sign problems while interleaving.
+	template<typename T>
+	static void fillRows(T (*rows)[kMaxCount + 2], int rowCount, uint32 &seed) {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0x80018001, 0x12345678 };
+		for (int y = 0; y < rowCount; y++) {
+			for (unsigned x = 0; x < kMaxCount + 2; x++)
+				rows[y][x] = (T)colors[nextRandom(seed) % ARRAYSIZE(colors)];
+		}
+	}
+
+	template<typename T>
+	void checkScale2x(void (*reference)(T *, T *, const T *, const T *, const T *, unsigned),
+	                  void (*kernel)(T *, T *, const T *, const T *, const T *, unsigned)) {
+		uint32 seed = 1;
+		for (unsigned count = 0; count <= kMaxCount; count++) {
+			T src[3][kMaxCount + 2];
+			fillRows(src, 3, seed);
+
+			// The guard values after the rows catch overlong writes
+			T expected[2][2 * kMaxCount + 1], actual[2][2 * kMaxCount + 1];
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+
+			reference(expected[0], expected[1], src[0] + 1, src[1] + 1, src[2] + 1, count);
+			kernel(actual[0], actual[1], src[0] + 1, src[1] + 1, src[2] + 1, count);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+		}
+	}
+
+	template<typename T>
+	void checkScale3x(void (*reference)(T *, T *, T *, const T *, const T *, const T *, unsigned),
+	                  void (*kernel)(T *, T *, T *, const T *, const T *, const T *, unsigned)) {
+		uint32 seed = 1;
+		for (unsigned count = 0; count <= kMaxCount; count++) {
+			T src[3][kMaxCount + 2];
+			fillRows(src, 3, seed);
+
+			T expected[3][3 * kMaxCount + 1], actual[3][3 * kMaxCount + 1];
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+
+			reference(expected[0], expected[1], expected[2], src[0] + 1, src[1] + 1, src[2] + 1, count);
+			kernel(actual[0], actual[1], actual[2], src[0] + 1, src[1] + 1, src[2] + 1, count);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+		}
+	}
+
+#ifdef USE_HQ_SCALERS
+	void checkPatterns(void (*kernel)(uint8 *, const uint32 *, const uint32 *, const uint32 *, uint)) {
+		uint32 seed = 1;
+		for (unsigned count = 0; count <= kMaxCount; count++) {
+			// Channels spread around the thresholds of diffYUV(), with garbage above them
+			uint32 yuv[3][kMaxCount + 2];
+			for (int y = 0; y < 3; y++) {
+				for (unsigned x = 0; x < kMaxCount + 2; x++) {
+					const uint32 r = nextRandom(seed);
+					yuv[y][x] = (r & 0xFF000000) | (0x60 + (r >> 16 & 0x7F)) << 16 | (0x60 + (r >> 8 & 0xF)) << 8 | (0x60 + (r & 0xF));
+				}
+			}
+
+			uint8 expected[kMaxCount + 1], actual[kMaxCount + 1];
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+
+			HQPatterns::computeGeneric(expected, yuv[0] + 1, yuv[1] + 1, yuv[2] + 1, count);
+			kernel(actual, yuv[0] + 1, yuv[1] + 1, yuv[2] + 1, count);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+		}
+	}
+
+	// Scale an image through the scaler plugin interface, once with the
+	// generic patterns and once with @p kernel, and compare the results
+	template<typename T>
+	void checkHQScaler(const Graphics::PixelFormat &format, HQPatterns::PatternFunc kernel) {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFF000000, 0xFF204080, 0xFF2A4A8A, 0xFFC08040 };
+
+		// The source has a border of one pixel, which the scaler reads
+		uint32 seed = 1;
+		T src[kHeight + 2][kWidth + 2];
+		for (int y = 0; y < kHeight + 2; y++) {
+			for (int x = 0; x < kWidth + 2; x++) {
+				const uint32 color = colors[nextRandom(seed) % ARRAYSIZE(colors)];
+				src[y][x] = format.ARGBToColor(color >> 24, color >> 16, color >> 8, color);
+			}
+		}
+
+		for (uint factor = 2; factor <= 3; factor++) {
+			T expected[3 * kHeight][3 * kWidth], actual[3 * kHeight][3 * kWidth];
+			memset(expected, 0, sizeof(expected));
+			memset(actual, 0, sizeof(actual));
+
+			HQScaler scaler(format);
+			scaler.setFactor(factor);
+
+			HQPatterns::patternFunc = HQPatterns::computeGeneric;
+			scaler.scale((const uint8 *)&src[1][1], sizeof(src[0]), (uint8 *)expected, sizeof(expected[0]), kWidth, kHeight, 0, 0);
+			HQPatterns::patternFunc = kernel;
+			scaler.scale((const uint8 *)&src[1][1], sizeof(src[0]), (uint8 *)actual, sizeof(actual[0]), kWidth, kHeight, 0, 0);
+			HQPatterns::patternFunc = HQPatterns::computeGeneric;
+
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+		}
+	}
+
+	void checkHQScalers(HQPatterns::PatternFunc kernel) {
+		checkHQScaler<uint16>(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), kernel);
+		checkHQScaler<uint16>(Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0), kernel);
+		checkHQScaler<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), kernel);
+		checkHQScaler<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), kernel);
+		checkHQScaler<uint32>(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), kernel);
+	}
+#endif
+
+	// Scale a padded image and a sub-rect of it with @p serial and with
+	// @p banded, which splits them into bands, and compare the results.
+	// The image is changed between the passes to exercise the old source.
+	template<typename T>
+	void checkBands(Scaler *serial, Scaler *banded, const Graphics::PixelFormat &format, uint factor, bool useSource) {
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFF000000, 0xFF204080, 0xFFC08040 };
+		const int srcWidth = kBandWidth + 2 * kBandPadding;
+		const int srcHeight = kBandHeight + 2 * kBandPadding;
+		const int dstWidth = factor * kBandWidth;
+
+		uint32 seed = 1;
+		Common::Array<T> src(srcWidth * srcHeight);
+		for (uint i = 0; i < src.size(); i++) {
+			const uint32 color = colors[nextRandom(seed) % ARRAYSIZE(colors)];
+			src[i] = format.ARGBToColor(color >> 24, color >> 16, color >> 8, color);
+		}
+
+		serial->setFactor(factor);
+		banded->setFactor(factor);
+		serial->setBands(1);
+		banded->setBands(4);
+		if (useSource) {
+			serial->enableSource(true);
+			banded->enableSource(true);
+			serial->setSource((const byte *)src.data(), srcWidth * sizeof(T), kBandWidth, kBandHeight, kBandPadding);
+			banded->setSource((const byte *)src.data(), srcWidth * sizeof(T), kBandWidth, kBandHeight, kBandPadding);
+		}
+
+		Common::Array<T> expected(dstWidth * factor * kBandHeight), actual(dstWidth * factor * kBandHeight);
+		for (int pass = 0; pass < 2; pass++) {
+			const int x = pass ? 3 : 0;
+			const int y = pass ? 5 : 0;
+			const int width = pass ? kBandWidth - 7 : kBandWidth;
+			const int height = pass ? kBandHeight - 11 : kBandHeight;
+
+			const T *srcPtr = &src[(kBandPadding + y) * srcWidth + kBandPadding + x];
+			const uint dstOffset = y * factor * dstWidth + x * factor;
+			serial->scale((const uint8 *)srcPtr, srcWidth * sizeof(T), (uint8 *)&expected[dstOffset], dstWidth * sizeof(T), width, height, x, y);
+			banded->scale((const uint8 *)srcPtr, srcWidth * sizeof(T), (uint8 *)&actual[dstOffset], dstWidth * sizeof(T), width, height, x, y);
+			TS_ASSERT_SAME_DATA(expected.data(), actual.data(), expected.size() * sizeof(T));
+
+			for (uint i = 0; i < src.size(); i += 7)
+				src[i] = ~src[i];
+		}
+	}
+
+	template<typename ScalerType>
+	void checkBandsFormats(uint maxFactor, bool useSource) {
+		const Graphics::PixelFormat format16(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat format32(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		for (uint factor = 2; factor <= maxFactor; factor++) {
+			ScalerType serial16(format16), banded16(format16);
+			checkBands<uint16>(&serial16, &banded16, format16, factor, useSource);
+			ScalerType serial32(format32), banded32(format32);
+			checkBands<uint32>(&serial32, &banded32, format32, factor, useSource);
+		}
+	}
+
+public:
+	void setUp() {
+#ifdef USE_HQ_SCALERS
+		// The null OSystem used by the tests cannot answer feature queries
+		if (!HQPatterns::patternFunc)
+			HQPatterns::patternFunc = HQPatterns::computeGeneric;
+#endif
+	}
+
+	void test_advmame_simd() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			checkScale2x<scale2x_uint16>(scale2x_16_def, scale2x_16_sse2);
+			checkScale2x<scale2x_uint32>(scale2x_32_def, scale2x_32_sse2);
+			checkScale3x<scale3x_uint16>(scale3x_16_def, scale3x_16_sse2);
+			checkScale3x<scale3x_uint32>(scale3x_32_def, scale3x_32_sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			checkScale2x<scale2x_uint16>(scale2x_16_def, scale2x_16_avx2);
+			checkScale2x<scale2x_uint32>(scale2x_32_def, scale2x_32_avx2);
+			checkScale3x<scale3x_uint16>(scale3x_16_def, scale3x_16_avx2);
+			checkScale3x<scale3x_uint32>(scale3x_32_def, scale3x_32_avx2);
+		}
+#endif
+	}
+
+	void test_hq_simd() {
+#ifdef USE_HQ_SCALERS
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			checkPatterns(HQPatterns::computeSSE2);
+			checkHQScalers(HQPatterns::computeSSE2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			checkPatterns(HQPatterns::computeAVX2);
+			checkHQScalers(HQPatterns::computeAVX2);
+		}
+#endif
+#endif
+	}
+
+	void test_bands() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// The bands run on the thread pool, which needs the OSystem
+		Common::install_null_g_system();
+
+#ifdef USE_HQ_SCALERS
+		checkBandsFormats<HQScaler>(3, false);
+#endif
+#ifdef USE_EDGE_SCALERS
+		checkBandsFormats<EdgeScaler>(3, true);
+#endif
+#endif
+	}
+};
@@ -0,0 +1,368 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/texelbuffer.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zbuffer.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../null_osystem.h"
+#include "test/instrset_detect.h"
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 200;
+	static const int kHeight = 150;
+
+	static void drawScene() {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		tglBegin(TGL_TRIANGLE_STRIP);
+		for (int i = 0; i < 8; i++) {
+			tglColor4f(i / 8.0f, 1.0f - i / 8.0f, 0.5f, 1.0f);
+			tglVertex3f(-0.9f + i * 0.25f, (i & 1) ? 0.8f : -0.7f, 0.1f * (i - 4));
+		}
+		tglEnd();
+
+		// Crosses the screen border, and so gets clipped
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+		tglVertex3f(-1.5f, -0.2f, 0.0f);
+		tglColor4f(0.0f, 1.0f, 0.0f, 1.0f);
+		tglVertex3f(0.4f, -1.3f, 0.0f);
+		tglColor4f(0.0f, 0.0f, 1.0f, 1.0f);
+		tglVertex3f(1.2f, 0.3f, 0.0f);
+		tglColor4f(1.0f, 1.0f, 0.0f, 1.0f);
+		tglVertex3f(-0.3f, 1.4f, 0.0f);
+		tglEnd();
+
+		// Textured and lit, so it goes through the span kernels
+		byte texels[16 * 16 * 4];
+		for (int i = 0; i < 16 * 16 * 4; i++)
+			texels[i] = (i * 37) ^ (i >> 3);
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_NEAREST);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_NEAREST);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 16, 16, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+		tglEnable(TGL_TEXTURE_2D);
+		tglBegin(TGL_TRIANGLES);
+		tglColor4f(1.0f, 0.5f, 0.8f, 1.0f);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(-0.8f, 0.9f, -0.3f);
+		tglColor4f(0.3f, 1.0f, 0.6f, 0.7f);
+		tglTexCoord2f(3.0f, 0.5f);
+		tglVertex3f(0.9f, 0.6f, 0.2f);
+		tglColor4f(0.9f, 0.9f, 0.2f, 1.0f);
+		tglTexCoord2f(1.0f, 2.5f);
+		tglVertex3f(0.1f, -0.9f, -0.1f);
+		tglEnd();
+		tglDisable(TGL_TEXTURE_2D);
+		tglDeleteTextures(1, &texture);
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglBegin(TGL_TRIANGLES);
+		tglColor4f(1.0f, 1.0f, 1.0f, 0.5f);
+		tglVertex3f(-0.5f, -0.5f, -0.5f);
+		tglVertex3f(0.7f, -0.1f, -0.5f);
+		tglVertex3f(0.0f, 0.9f, -0.5f);
+		tglEnd();
+		tglDisable(TGL_BLEND);
+
+		tglBegin(TGL_LINES);
+		tglColor4f(0.0f, 0.0f, 0.0f, 1.0f);
+		tglVertex3f(-1.0f, -1.0f, -0.9f);
+		tglVertex3f(1.0f, 0.9f, -0.9f);
+		tglEnd();
+	}
+
+	// Render the scene twice, after rendering an empty frame to let the tiling setting take effect.
+	// The second frame reuses the rendering contexts of the tiles.
+	static Graphics::Surface *render(bool tiled, bool dirtyRects) {
+		Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, format, 256, false, dirtyRects);
+		TinyGL::enableTiledRendering(tiled);
+		TinyGL::presentBuffer();
+
+		for (int frame = 0; frame < 2; frame++) {
+			drawScene();
+			TinyGL::presentBuffer();
+		}
+
+		Graphics::Surface *surface = TinyGL::copyFromFrameBuffer(format);
+		TinyGL::destroyContext(context);
+		return surface;
+	}
+
+	static TinyGL::ZBufferPoint makePoint(int x, int y, int z, int s, int t, int color) {
+		TinyGL::ZBufferPoint p = {};
+		p.x = x;
+		p.y = y;
+		p.z = z;
+		p.s = s << ZB_POINT_ST_FRAC_BITS;
+		p.t = t << ZB_POINT_ST_FRAC_BITS;
+		p.r = (color & 0xF00) << 4;
+		p.g = (color & 0x0F0) << 8;
+		p.b = (color & 0x00F) << 12;
+		p.a = 0xFF00;
+		return p;
+	}
+
+	// Fill overlapping smooth and textured triangles, some of them crossing the scissor rectangle
+	static void fillTriangles(TinyGL::FrameBuffer &fb, const TinyGL::TexelBuffer *texture) {
+		static const int triangles[][3][6] = {
+			{ { 10, 5, 40000, 0, 0, 0xF00 }, { 190, 30, 20000, 15, 0, 0x0F0 }, { 60, 140, 60000, 0, 15, 0x00F } },
+			{ { 35, 60, 10000, 3, 1, 0xFF0 }, { 150, 10, 50000, 9, 2, 0x0FF }, { 145, 120, 30000, 1, 12, 0xF0F } },
+			{ { 39, 19, 5000, 0, 0, 0x888 }, { 44, 100, 5000, 4, 4, 0x484 }, { 141, 97, 5000, 8, 0, 0x848 } },
+			{ { 120, 40, 45000, 2, 2, 0xC31 }, { 199, 80, 15000, 30, 5, 0x3C1 }, { 100, 149, 25000, 7, 20, 0x13C } }
+		};
+
+		fb.clear(true, 0, true, 10, 20, 30, false, 0);
+		fb.enableBlending(false);
+		fb.enableAlphaTest(false);
+		fb.enableStencilTest(false);
+		fb.setFogEnabled(false);
+		fb.setOffsetStates(0);
+		fb.enableDepthTest(true);
+		fb.setDepthFunc(TGL_LESS);
+		fb.enableDepthWrite(true);
+		fb.setTexture(texture, TGL_REPEAT, TGL_REPEAT);
+
+		for (int i = 0; i < ARRAYSIZE(triangles); i++) {
+			TinyGL::ZBufferPoint points[3];
+			for (int j = 0; j < 3; j++) {
+				const int *v = triangles[i][j];
+				points[j] = makePoint(v[0], v[1], v[2], v[3], v[4], v[5]);
+			}
+			if (i & 1)
+				fb.fillTriangleTextureMappingPerspectiveSmooth(&points[0], &points[1], &points[2]);
+			else
+				fb.fillTriangleSmooth(&points[0], &points[1], &points[2]);
+		}
+	}
+
+	void checkScissoredSpans() {
+		Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		byte texels[16 * 16 * 4];
+		for (int i = 0; i < 16 * 16 * 4; i++)
+			texels[i] = (i * 53) ^ (i >> 2);
+		TinyGL::TexelBuffer *texture = TinyGL::createNearestTexelBuffer(texels, Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+		                                                                TGL_RGBA, TGL_UNSIGNED_BYTE, 16, 16, 256);
+
+		TinyGL::FrameBuffer expected(kWidth, kHeight, format, false);
+		fillTriangles(expected, texture);
+		TinyGL::FrameBuffer cleared(kWidth, kHeight, format, false);
+		cleared.clear(true, 0, true, 10, 20, 30, false, 0);
+		TS_ASSERT_DIFFERS(memcmp(expected.getPixelBuffer(), cleared.getPixelBuffer(), kWidth * kHeight * 4), 0);
+
+		// Edges which are not multiples of the span length
+		const Common::Rect scissors[] = {
+			Common::Rect(37, 20, 141, 97), Common::Rect(0, 0, 3, kHeight), Common::Rect(197, 0, kWidth, kHeight),
+			Common::Rect(90, 50, 91, 140), Common::Rect(kWidth, kHeight)
+		};
+		for (int i = 0; i < ARRAYSIZE(scissors); i++) {
+			TinyGL::FrameBuffer actual(kWidth, kHeight, format, false);
+			actual.setScissorRectangle(scissors[i]);
+			fillTriangles(actual, texture);
+
+			int mismatches = 0;
+			for (int y = 0; y < kHeight; y++) {
+				for (int x = 0; x < kWidth; x++) {
+					TinyGL::FrameBuffer &reference = scissors[i].contains(x, y) ? expected : cleared;
+					const int pixel = y * kWidth + x;
+					if (((const uint32 *)actual.getPixelBuffer())[pixel] != ((const uint32 *)reference.getPixelBuffer())[pixel] ||
+					    actual.getZBuffer()[pixel] != reference.getZBuffer()[pixel])
+						mismatches++;
+				}
+			}
+			TS_ASSERT_EQUALS(mismatches, 0);
+		}
+
+		delete texture;
+	}
+
+	static void checkSameImage(Graphics::Surface *expected, Graphics::Surface *actual) {
+		int mismatches = 0;
+		for (int y = 0; y < kHeight; y++) {
+			if (memcmp(expected->getBasePtr(0, y), actual->getBasePtr(0, y), kWidth * 4) != 0)
+				mismatches++;
+		}
+		TS_ASSERT_EQUALS(mismatches, 0);
+
+		// Make sure something was drawn at all
+		TS_ASSERT_DIFFERS(expected->getPixel(kWidth / 2, kHeight / 2), expected->getPixel(0, 0));
+
+		expected->free();
+		delete expected;
+		actual->free();
+		delete actual;
+	}
+
+	void checkTiledRendering(bool dirtyRects) {
+		Graphics::Surface *expected = render(false, dirtyRects);
+		Graphics::Surface *actual = render(true, dirtyRects);
+		checkSameImage(expected, actual);
+	}
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8 ^ seed << 13;
+	}
+
+	void checkSpanKernels(TinyGL::SpanKernels::DepthTestFunc depthTest, TinyGL::SpanKernels::WriteFunc write) {
+		static const int depthFuncs[] = {
+			TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		const int kMaxSpan = TinyGL::SpanKernels::kMaxSpan;
+		uint32 seed = 1;
+
+		for (int iteration = 0; iteration < 2000; iteration++) {
+			const int count = 1 + iteration % kMaxSpan;
+			uint depth[kMaxSpan + 1];
+			uint32 texels[kMaxSpan];
+			uint32 pixels[kMaxSpan + 1];
+			for (int i = 0; i <= kMaxSpan; i++) {
+				depth[i] = nextRandom(seed);
+				pixels[i] = nextRandom(seed);
+			}
+			for (int i = 0; i < kMaxSpan; i++)
+				texels[i] = nextRandom(seed);
+
+			TinyGL::SpanArgs args;
+			args.count = count;
+			args.depthWrite = (iteration & 1) != 0;
+			// Large depths must survive the trip through a float
+			args.z = (iteration & 2) ? nextRandom(seed) : nextRandom(seed) >> 2;
+			args.dzdx = (int)nextRandom(seed) >> (iteration % 24);
+			args.r = nextRandom(seed) & 0xFFFF;
+			args.g = nextRandom(seed) & 0xFFFF;
+			args.b = nextRandom(seed) & 0xFFFF;
+			args.a = nextRandom(seed) & 0x1FFFF;
+			args.drdx = ((int)nextRandom(seed) >> 20);
+			args.dgdx = ((int)nextRandom(seed) >> 20);
+			args.dbdx = ((int)nextRandom(seed) >> 20);
+			args.dadx = nextRandom(seed) >> 20;
+			args.texels = (iteration & 4) ? texels : nullptr;
+			args.format = &formats[iteration % ARRAYSIZE(formats)];
+
+			// Make some of the depths equal to the interpolated ones
+			if (iteration & 8)
+				depth[1 % count] = args.z + (1 % count) * args.dzdx;
+
+			for (int f = 0; f < ARRAYSIZE(depthFuncs); f++) {
+				const uint32 expectedMask = TinyGL::SpanKernels::depthTestGeneric(depth, args.z, args.dzdx, count, depthFuncs[f]);
+				TS_ASSERT_EQUALS(depthTest(depth, args.z, args.dzdx, count, depthFuncs[f]), expectedMask);
+			}
+
+			const uint32 mask = nextRandom(seed) & 0xFF;
+			uint expectedDepth[kMaxSpan + 1];
+			uint32 expectedPixels[kMaxSpan + 1];
+			memcpy(expectedDepth, depth, sizeof(depth));
+			memcpy(expectedPixels, pixels, sizeof(pixels));
+
+			args.pbuf = expectedPixels;
+			args.pz = expectedDepth;
+			TinyGL::SpanKernels::writeGeneric(args, mask);
+			args.pbuf = pixels;
+			args.pz = depth;
+			write(args, mask);
+
+			// The pixel past the end of the span must stay untouched too
+			TS_ASSERT_SAME_DATA(pixels, expectedPixels, sizeof(pixels));
+			TS_ASSERT_SAME_DATA(depth, expectedDepth, sizeof(depth));
+		}
+	}
+
+public:
+	void setUp() {
+		// The null OSystem used by the tests cannot answer feature queries
+		if (!TinyGL::SpanKernels::writeFunc) {
+			TinyGL::SpanKernels::depthTestFunc = TinyGL::SpanKernels::depthTestGeneric;
+			TinyGL::SpanKernels::writeFunc = TinyGL::SpanKernels::writeGeneric;
+		}
+	}
+
+	void test_tiled_rendering() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		checkTiledRendering(false);
+#endif
+	}
+
+	void test_tiled_rendering_dirty_rects() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		checkTiledRendering(true);
+#endif
+	}
+
+	void test_scissored_spans() {
+		checkScissoredSpans();
+	}
+
+	void test_span_kernels() {
+#ifdef SCUMMVM_NEON
+		checkSpanKernels(TinyGL::SpanKernels::depthTestNEON, TinyGL::SpanKernels::writeNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkSpanKernels(TinyGL::SpanKernels::depthTestSSE2, TinyGL::SpanKernels::writeSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkSpanKernels(TinyGL::SpanKernels::depthTestAVX2, TinyGL::SpanKernels::writeAVX2);
+#endif
+	}
+
+	void test_span_kernels_rendering() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		TinyGL::SpanKernels::DepthTestFunc oldDepthTest = TinyGL::SpanKernels::depthTestFunc;
+		TinyGL::SpanKernels::WriteFunc oldWrite = TinyGL::SpanKernels::writeFunc;
+
+		TinyGL::SpanKernels::depthTestFunc = TinyGL::SpanKernels::depthTestGeneric;
+		TinyGL::SpanKernels::writeFunc = TinyGL::SpanKernels::writeGeneric;
+		Graphics::Surface *expected = render(false, false);
+
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			TinyGL::SpanKernels::depthTestFunc = TinyGL::SpanKernels::depthTestSSE2;
+			TinyGL::SpanKernels::writeFunc = TinyGL::SpanKernels::writeSSE2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			TinyGL::SpanKernels::depthTestFunc = TinyGL::SpanKernels::depthTestAVX2;
+			TinyGL::SpanKernels::writeFunc = TinyGL::SpanKernels::writeAVX2;
+		}
+#endif
+		checkSameImage(expected, render(false, false));
+
+		// Tiles and dirty rectangles clip the spans to a scissor rectangle
+		expected = render(false, false);
+		checkSameImage(expected, render(true, false));
+		expected = render(false, false);
+		checkSameImage(expected, render(true, true));
+		checkScissoredSpans();
+
+		TinyGL::SpanKernels::depthTestFunc = oldDepthTest;
+		TinyGL::SpanKernels::writeFunc = oldWrite;
+#endif
+	}
+};
@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "../null_osystem.h"
+
+#ifdef POSIX
+#include "backends/threads/pthread/pthread-threadpool.h"
+#endif
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	// Not a multiple of the vector sizes, so the tails are checked too
+	static const int kWidth = 52;
+	static const int kHeight = 8;
+	static const int kPitch = 64;
+
+	enum Conversion {
+		kConvert444,
+		kConvert422,
+		kConvert420,
+		kConvert420Alpha,
+		kConvert410
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8;
+	}
+
+	static void convert(Conversion conversion, Graphics::Surface *dst, Graphics::YUVToRGBManager::LuminanceScale scale,
+	                    const byte *y, const byte *u, const byte *v, const byte *a, int width, int height, int pitch) {
+		switch (conversion) {
+		case kConvert444:
+			YUVToRGBMan.convert444(dst, scale, y, u, v, width, height, pitch, pitch);
+			break;
+		case kConvert422:
+			YUVToRGBMan.convert422(dst, scale, y, u, v, width, height, pitch, pitch);
+			break;
+		case kConvert420:
+			YUVToRGBMan.convert420(dst, scale, y, u, v, width, height, pitch, pitch);
+			break;
+		case kConvert420Alpha:
+			YUVToRGBMan.convert420Alpha(dst, scale, y, u, v, a, width, height, pitch, pitch);
+			break;
+		case kConvert410:
+			YUVToRGBMan.convert410(dst, scale, y, u, v, width, height, pitch, pitch);
+			break;
+		}
+	}
+
+	// Convert with the lookup tables and with @p rowFunc, and compare the results
+	static void checkConversion(Graphics::YUVToRGBRows::RowFunc rowFunc, Conversion conversion, const Graphics::PixelFormat &format,
+	                            const byte *y, const byte *u, const byte *v, const byte *a, int width, int height, int pitch) {
+		static const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(scales); i++) {
+			Graphics::Surface expected, actual;
+			expected.create(width, height, format);
+			actual.create(width, height, format);
+
+			Graphics::YUVToRGBRows::rowFunc = Graphics::YUVToRGBRows::convertGeneric;
+			convert(conversion, &expected, scales[i], y, u, v, a, width, height, pitch);
+			Graphics::YUVToRGBRows::rowFunc = rowFunc;
+			convert(conversion, &actual, scales[i], y, u, v, a, width, height, pitch);
+			Graphics::YUVToRGBRows::rowFunc = Graphics::YUVToRGBRows::convertGeneric;
+
+			for (int row = 0; row < height; row++)
+				TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, row), actual.getBasePtr(0, row), width * format.bytesPerPixel), 0);
+
+			expected.free();
+			actual.free();
+		}
+	}
+
+	static void checkRowFunc(Graphics::YUVToRGBRows::RowFunc rowFunc) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		// The 410 conversion reads one row and column past the chroma
+		byte y[kPitch * kHeight], u[kPitch * kHeight], v[kPitch * kHeight], a[kPitch * kHeight];
+		uint32 seed = 1;
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			y[i] = nextRandom(seed);
+			u[i] = nextRandom(seed);
+			v[i] = nextRandom(seed);
+			a[i] = nextRandom(seed);
+		}
+
+		for (uint i = 0; i < ARRAYSIZE(formats); i++) {
+			checkConversion(rowFunc, kConvert444, formats[i], y, u, v, nullptr, kWidth, kHeight, kPitch);
+			checkConversion(rowFunc, kConvert422, formats[i], y, u, v, nullptr, kWidth, kHeight, kPitch);
+			checkConversion(rowFunc, kConvert420, formats[i], y, u, v, nullptr, kWidth, kHeight, kPitch);
+			checkConversion(rowFunc, kConvert420Alpha, formats[i], y, u, v, a, kWidth, kHeight, kPitch);
+			checkConversion(rowFunc, kConvert410, formats[i], y, u, v, nullptr, kWidth, kHeight, kPitch);
+		}
+
+		// Every luminance with a wide range of chroma, wider than the chunks
+		// the rows are converted in
+		const int size = 256 + 8;
+		byte *planes = new byte[3 * size * size];
+		for (int row = 0; row < size; row++) {
+			for (int x = 0; x < size; x++) {
+				planes[0 * size * size + row * size + x] = x;
+				planes[1 * size * size + row * size + x] = row;
+				planes[2 * size * size + row * size + x] = row * 7 + x;
+			}
+		}
+		for (uint i = 0; i < ARRAYSIZE(formats); i++)
+			checkConversion(rowFunc, kConvert444, formats[i], planes, planes + size * size, planes + 2 * size * size, nullptr, size, size, size);
+		delete[] planes;
+	}
+
+	// The generic function is only used for the tails of the vectorized ones.
+	// Wrapping it makes the manager use it for whole rows.
+	static void wrappedGeneric(byte *dst, const Graphics::YUVToRGBRowFormat &format, const byte *ySrc, const byte *aSrc, const int16 *offsets, uint count, uint chromaShift) {
+		Graphics::YUVToRGBRows::convertGeneric(dst, format, ySrc, aSrc, offsets, count, chromaShift);
+	}
+
+	struct Slice {
+		Graphics::Surface dst;
+		const byte *y, *u, *v;
+	};
+
+	static void convertSlice(void *data) {
+		Slice *slice = (Slice *)data;
+		YUVToRGBMan.convert420(&slice->dst, Graphics::YUVToRGBManager::kScaleITU, slice->y, slice->u, slice->v,
+		                       kWidth, slice->dst.h, kPitch, kPitch);
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// The manager needs it for its mutex
+		Common::install_null_g_system();
+#endif
+
+		// The null OSystem used by the tests cannot answer feature queries
+		if (!Graphics::YUVToRGBRows::rowFunc)
+			Graphics::YUVToRGBRows::rowFunc = Graphics::YUVToRGBRows::convertGeneric;
+	}
+
+	void test_simd() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkRowFunc(Graphics::YUVToRGBRows::convertSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkRowFunc(Graphics::YUVToRGBRows::convertAVX2);
+#endif
+	}
+
+	void test_generic() {
+		checkRowFunc(wrappedGeneric);
+	}
+
+	// Slices of an image may be converted on several threads, while other
+	// threads convert to other formats
+	void test_sliced_conversion() {
+#ifdef POSIX
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		byte y[kPitch * kHeight], u[kPitch * kHeight], v[kPitch * kHeight];
+		uint32 seed = 2;
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			y[i] = nextRandom(seed);
+			u[i] = nextRandom(seed);
+			v[i] = nextRandom(seed);
+		}
+
+		Graphics::Surface expected, actual;
+		expected.create(kWidth, kHeight, format);
+		actual.create(kWidth, kHeight, format);
+
+		// Convert with the lookup tables
+		Graphics::YUVToRGBRows::rowFunc = Graphics::YUVToRGBRows::convertGeneric;
+		YUVToRGBMan.convert420(&expected, Graphics::YUVToRGBManager::kScaleITU, y, u, v, kWidth, kHeight, kPitch, kPitch);
+
+		const Graphics::PixelFormat otherFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		Graphics::Surface other;
+		other.create(kWidth, kHeight, otherFormat);
+
+		Slice slices[kHeight / 2];
+		Common::ThreadPoolInternal *pool = createPthreadThreadPoolInternal(3);
+		uint pending = 0;
+		for (int i = 0; i < kHeight / 2; i++) {
+			slices[i].dst.init(kWidth, 2, actual.pitch, actual.getBasePtr(0, i * 2), format);
+			slices[i].y = y + i * 2 * kPitch;
+			slices[i].u = u + i * kPitch;
+			slices[i].v = v + i * kPitch;
+			pool->submit(convertSlice, &slices[i], &pending);
+		}
+		for (int i = 0; i < 20; i++) {
+			const Graphics::YUVToRGBManager::LuminanceScale scale = (i & 1) ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+			YUVToRGBMan.convert420(&other, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+		}
+		pool->wait(&pending);
+		delete pool;
+
+		for (int row = 0; row < kHeight; row++)
+			TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, row), actual.getBasePtr(0, row), kWidth * format.bytesPerPixel), 0);
+
+		expected.free();
+		actual.free();
+		other.free();
+#endif
+	}
+};
@@ -0,0 +1,101 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/str.h"
+#include "common/str-array.h"
+#include "common/system.h"
+
+#include "gui/massadd-scanner.h"
+
+#include "../null_osystem.h"
+
+class MassAddScannerTestSuite : public CxxTest::TestSuite {
+	static void createFile(const Common::FSNode &dir, const char *name) {
+		Common::WriteStream *stream = dir.getChild(name).createWriteStream();
+		TS_ASSERT(stream);
+		if (stream) {
+			stream->writeString(name);
+			stream->finalize();
+			delete stream;
+		}
+	}
+
+	static Common::FSNode createDir(const Common::FSNode &parent, const char *name) {
+		Common::FSNode dir = parent.getChild(name);
+		if (!dir.exists())
+			TS_ASSERT(dir.createDirectory());
+		return parent.getChild(name);
+	}
+
+	// Build a small tree, creating the entries in non-alphabetical order
+	static Common::FSNode createTree() {
+		Common::FSNode root = createDir(Common::FSNode(Common::Path(".")), "massadd-scanner-test.tmp");
+		createFile(root, "zeta.dat");
+		Common::FSNode b = createDir(root, "b");
+		createFile(b, "b2.dat");
+		createFile(b, "b1.dat");
+		createDir(b, "sub");
+		Common::FSNode a = createDir(root, "a");
+		createFile(a, "a1.dat");
+		createFile(root, "alpha.dat");
+		return root;
+	}
+
+	// Visit the whole tree, recording the visited directories and their entries
+	static Common::StringArray scan(const Common::FSNode &root, uint batchSize) {
+		Common::StringArray visited;
+		GUI::MassAddScanner scanner(root, batchSize);
+		while (!scanner.empty()) {
+			Common::FSNode dir;
+			Common::FSList files;
+			if (!scanner.scanNext(dir, files)) {
+				visited.push_back("!" + dir.getName());
+				continue;
+			}
+
+			Common::String entry = dir.getName() + ":";
+			for (uint i = 0; i < files.size(); i++)
+				entry += " " + files[i].getName();
+			visited.push_back(entry);
+		}
+		return visited;
+	}
+
+public:
+	void test_order() {
+		Common::install_null_g_system();
+		Common::FSNode root = createTree();
+
+		Common::StringArray visited = scan(root, 1);
+		TS_ASSERT_EQUALS(visited.size(), 4u);
+		if (visited.size() == 4) {
+			// Directories come first, then files, both sorted by name
+			TS_ASSERT_EQUALS(visited[0], "massadd-scanner-test.tmp: a b alpha.dat zeta.dat");
+			TS_ASSERT_EQUALS(visited[1], "a: a1.dat");
+			TS_ASSERT_EQUALS(visited[2], "b: sub b1.dat b2.dat");
+			TS_ASSERT_EQUALS(visited[3], "sub:");
+		}
+	}
+
+	void test_batch_size() {
+		Common::install_null_g_system();
+		Common::FSNode root = createTree();
+
+		// Listing ahead must not change the results
+		Common::StringArray expected = scan(root, 1);
+		TS_ASSERT(scan(root, 2) == expected);
+		TS_ASSERT(scan(root, 3) == expected);
+		TS_ASSERT(scan(root, 16) == expected);
+		TS_ASSERT(scan(root, 0) == expected);
+	}
+
+	void test_missing_dir() {
+		Common::install_null_g_system();
+		Common::FSNode root = createTree();
+
+		Common::StringArray visited = scan(root.getChild("missing"), 4);
+		TS_ASSERT_EQUALS(visited.size(), 1u);
+		if (visited.size() == 1)
+			TS_ASSERT_EQUALS(visited[0], "!missing");
+	}
+};
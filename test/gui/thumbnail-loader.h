@@ -0,0 +1,220 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/str.h"
+#include "common/threadpool.h"
+
+#include "graphics/managed_surface.h"
+
+#include "gui/thumbnail-loader.h"
+
+#include "../null_osystem.h"
+#include "../worker_threads.h"
+
+#ifdef POSIX
+#include <pthread.h>
+#endif
+
+class ThumbnailLoaderTestSuite : public CxxTest::TestSuite {
+	struct TestResult : public GUI::ThumbnailLoader::Result {
+		Common::String value;
+	};
+
+	struct Counters {
+		Counters() {
+			prepared.store(0);
+			loaded.store(0);
+			wrongThread.store(0);
+		}
+
+		Common::Atomic<uint> prepared;
+		Common::Atomic<uint> loaded;
+		Common::Atomic<uint> wrongThread;
+		Common::String lastPrepared;
+#ifdef POSIX
+		pthread_t guiThread;
+#endif
+	};
+
+	// Keys starting with "-" have no thumbnail
+	static GUI::ThumbnailLoader::Result *prepareProc(const Common::String &key, void *data) {
+		Counters *counters = (Counters *)data;
+		counters->prepared.fetchAdd(1);
+		counters->lastPrepared = key;
+#ifdef POSIX
+		if (!pthread_equal(pthread_self(), counters->guiThread))
+			counters->wrongThread.fetchAdd(1);
+#endif
+		if (key.hasPrefix("-"))
+			return nullptr;
+
+		TestResult *result = new TestResult();
+		result->value = "prepared " + key;
+		return result;
+	}
+
+	static GUI::ThumbnailLoader::Result *loadProc(const Common::String &key, GUI::ThumbnailLoader::Result *prepared, void *data) {
+		Counters *counters = (Counters *)data;
+		counters->loaded.fetchAdd(1);
+		if (key.hasPrefix("-"))
+			return nullptr;
+
+		TestResult *result = prepared ? (TestResult *)prepared : new TestResult();
+		result->surface = new Graphics::ManagedSurface();
+		result->value += " loaded " + key;
+		return result;
+	}
+
+	// Missing thumbnails are plain results without a surface
+	static Common::String value(const GUI::ThumbnailLoader::Result *result) {
+		if (!result)
+			return "pending";
+		if (!result->surface)
+			return "missing";
+		return ((const TestResult *)result)->value;
+	}
+
+	// Wait for the workers to load the thumbnail for key
+	static const GUI::ThumbnailLoader::Result *waitFor(GUI::ThumbnailLoader &loader, const Common::String &key) {
+		const GUI::ThumbnailLoader::Result *result;
+		while (!(result = loader.get(key)))
+			loader.update();
+		return result;
+	}
+
+public:
+	void test_synchronous() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Without worker threads get() loads right away
+		Counters counters;
+		GUI::ThumbnailLoader loader(loadProc, &counters, 4);
+		TS_ASSERT_EQUALS(value(loader.get("a")), " loaded a");
+		TS_ASSERT_EQUALS(value(loader.get("a")), " loaded a");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 1U);
+		TS_ASSERT(!loader.update());
+
+		// Missing thumbnails are remembered
+		TS_ASSERT_EQUALS(value(loader.get("-b")), "missing");
+		TS_ASSERT_EQUALS(value(loader.get("-b")), "missing");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 2U);
+
+		loader.clear();
+		TS_ASSERT_EQUALS(value(loader.get("a")), " loaded a");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 3U);
+#endif
+	}
+
+	void test_eviction() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Counters counters;
+		GUI::ThumbnailLoader loader(loadProc, &counters, 2);
+		loader.get("a");
+		loader.get("b");
+		loader.get("a");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 2U);
+
+		// b is the least recently used one which is not visible anymore
+		loader.cancel();
+		loader.get("c");
+		loader.get("a");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 3U);
+		loader.get("b");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 4U);
+#endif
+	}
+
+	void test_visible_entries() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// More thumbnails are visible than are kept otherwise
+		Counters counters;
+		GUI::ThumbnailLoader loader(loadProc, &counters, 2);
+		loader.get("a");
+		loader.get("b");
+		loader.get("c");
+		loader.get("a");
+		loader.get("b");
+		loader.get("c");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 3U);
+
+		// Once they are not visible anymore, they are evicted
+		loader.cancel();
+		loader.get("d");
+		loader.get("c");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 4U);
+		loader.get("a");
+		TS_ASSERT_EQUALS(counters.loaded.load(), 5U);
+#endif
+	}
+
+	void test_prepare() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Counters counters;
+#ifdef POSIX
+		counters.guiThread = pthread_self();
+#endif
+		GUI::ThumbnailLoader loader(loadProc, &counters, 4, prepareProc);
+		TS_ASSERT_EQUALS(value(loader.get("a")), "prepared a loaded a");
+		TS_ASSERT_EQUALS(counters.prepared.load(), 1U);
+		TS_ASSERT_EQUALS(counters.loaded.load(), 1U);
+
+		// Nothing is loaded when there is nothing prepared
+		TS_ASSERT_EQUALS(value(loader.get("-b")), "missing");
+		TS_ASSERT_EQUALS(counters.prepared.load(), 2U);
+		TS_ASSERT_EQUALS(counters.loaded.load(), 1U);
+		TS_ASSERT_EQUALS(counters.wrongThread.load(), 0U);
+#endif
+	}
+
+	void test_worker_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE && WORKER_THREADS_ARE_AVAILABLE
+		Common::install_null_g_system();
+
+		Counters counters;
+		counters.guiThread = pthread_self();
+		{
+			Common::ScopedWorkerThreads workers(3);
+			GUI::ThumbnailLoader loader(loadProc, &counters, 8, prepareProc);
+
+			// Requests are prepared one per update, newest first
+			TS_ASSERT(!loader.get("a"));
+			TS_ASSERT(!loader.get("b"));
+			TS_ASSERT(!loader.get("-c"));
+			TS_ASSERT_EQUALS(counters.prepared.load(), 0U);
+			loader.update();
+			TS_ASSERT_EQUALS(counters.prepared.load(), 1U);
+			TS_ASSERT_EQUALS(counters.lastPrepared, "-c");
+
+			TS_ASSERT_EQUALS(value(waitFor(loader, "a")), "prepared a loaded a");
+			TS_ASSERT_EQUALS(value(waitFor(loader, "b")), "prepared b loaded b");
+			TS_ASSERT_EQUALS(value(waitFor(loader, "-c")), "missing");
+			TS_ASSERT_EQUALS(counters.prepared.load(), 3U);
+			TS_ASSERT_EQUALS(counters.loaded.load(), 2U);
+
+			// Canceling drops the requests which were not prepared yet,
+			// but the prepared ones are still loaded
+			loader.get("d");
+			loader.get("e");
+			loader.update();
+			loader.cancel();
+			TS_ASSERT_EQUALS(value(waitFor(loader, "e")), "prepared e loaded e");
+			TS_ASSERT_EQUALS(counters.prepared.load(), 4U);
+			TS_ASSERT_EQUALS(value(waitFor(loader, "d")), "prepared d loaded d");
+			TS_ASSERT_EQUALS(counters.prepared.load(), 5U);
+
+			// Clearing waits for the request being loaded
+			loader.get("f");
+			loader.update();
+			loader.clear();
+		}
+		TS_ASSERT_EQUALS(counters.wrongThread.load(), 0U);
+#endif
+	}
+};
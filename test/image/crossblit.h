@@ -0,0 +1,189 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/blit.h"
+#include "graphics/pixelformat.h"
+
+class CrossBlitTestSuite : public CxxTest::TestSuite {
+	static const uint kWidth = 37;
+	static const uint kHeight = 5;
+
+	// Pixel formats of the common backends and engines
+	static Graphics::PixelFormat getFormat(int i) {
+		switch (i) {
+		case 0:
+			return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);   // RGB565
+		case 1:
+			return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);   // XRGB1555
+		case 2:
+			return Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0);   // RGBA4444
+		case 3:
+			return Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0);   // XRGB8888
+		case 4:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);  // ARGB8888
+		case 5:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);  // RGBA8888
+		case 6:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24);  // ABGR8888
+		default:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);  // BGRA8888
+		}
+	}
+	static const int kFormatCount = 8;
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8 ^ seed << 13;
+	}
+
+	static uint32 readPixel(const byte *src, uint bpp) {
+		return (bpp == 2) ? *(const uint16 *)src : *(const uint32 *)src;
+	}
+
+	// Convert a surface one pixel at a time, in the way crossBlit always did
+	static void referenceConvert(byte *dst, const byte *src, uint dstPitch, uint srcPitch,
+	                             const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+		for (uint y = 0; y < kHeight; y++) {
+			for (uint x = 0; x < kWidth; x++) {
+				byte a, r, g, b;
+				srcFmt.colorToARGB(readPixel(src + y * srcPitch + x * srcFmt.bytesPerPixel, srcFmt.bytesPerPixel), a, r, g, b);
+				const uint32 color = dstFmt.ARGBToColor(a, r, g, b);
+				if (dstFmt.bytesPerPixel == 2)
+					*(uint16 *)(dst + y * dstPitch + x * 2) = color;
+				else
+					*(uint32 *)(dst + y * dstPitch + x * 4) = color;
+			}
+		}
+	}
+
+	void checkConvert() {
+		uint32 seed = 1;
+		for (int d = 0; d < kFormatCount; d++) {
+			for (int s = 0; s < kFormatCount; s++) {
+				const Graphics::PixelFormat dstFmt = getFormat(d), srcFmt = getFormat(s);
+				if (dstFmt == srcFmt)
+					continue;
+				TS_ASSERT(Graphics::ConvertBlit::canConvert(dstFmt, srcFmt));
+
+				// Wide enough to convert in place, with some padding at the end of the rows
+				const uint pitch = kWidth * 4 + 12;
+				byte src[pitch * kHeight], expected[pitch * kHeight], actual[pitch * kHeight];
+				for (uint i = 0; i < sizeof(src); i++)
+					src[i] = nextRandom(seed);
+				memcpy(expected, src, sizeof(src));
+				memcpy(actual, src, sizeof(src));
+
+				// Convert in place, with the pitch scaled like the pixel size
+				const uint srcPitch = pitch * srcFmt.bytesPerPixel / 4;
+				const uint dstPitch = pitch * dstFmt.bytesPerPixel / 4;
+				referenceConvert(expected, src, dstPitch, srcPitch, dstFmt, srcFmt);
+				TS_ASSERT(Graphics::crossBlit(actual, actual, dstPitch, srcPitch, kWidth, kHeight, dstFmt, srcFmt));
+				for (uint y = 0; y < kHeight; y++)
+					TS_ASSERT_SAME_DATA(actual + y * dstPitch, expected + y * dstPitch, kWidth * dstFmt.bytesPerPixel);
+			}
+		}
+	}
+
+	void checkMap() {
+		uint32 seed = 2;
+		uint32 map[256];
+		for (int i = 0; i < 256; i++)
+			map[i] = nextRandom(seed);
+
+		for (uint bpp = 2; bpp <= 4; bpp += 2) {
+			const uint pitch = kWidth * 4 + 12;
+			byte src[pitch * kHeight], actual[pitch * kHeight];
+			for (uint i = 0; i < sizeof(src); i++)
+				src[i] = nextRandom(seed);
+			memcpy(actual, src, sizeof(src));
+
+			// Convert in place, with the pitch scaled like the pixel size
+			const uint srcPitch = pitch / 4;
+			const uint dstPitch = pitch * bpp / 4;
+			TS_ASSERT(Graphics::crossBlitMap(actual, actual, dstPitch, srcPitch, kWidth, kHeight, bpp, map));
+			for (uint y = 0; y < kHeight; y++) {
+				for (uint x = 0; x < kWidth; x++) {
+					const uint32 color = map[src[y * srcPitch + x]];
+					TS_ASSERT_EQUALS(readPixel(actual + y * dstPitch + x * bpp, bpp), bpp == 2 ? (uint16)color : color);
+				}
+			}
+		}
+	}
+
+	void checkKernels(Graphics::ConvertBlit::ConvertFunc convertFunc, Graphics::ConvertBlit::MapFunc map16Func, Graphics::ConvertBlit::MapFunc map32Func) {
+		Graphics::ConvertBlit::ConvertFunc oldConvertFunc = Graphics::ConvertBlit::convertFunc;
+		Graphics::ConvertBlit::MapFunc oldMap16Func = Graphics::ConvertBlit::map16Func;
+		Graphics::ConvertBlit::MapFunc oldMap32Func = Graphics::ConvertBlit::map32Func;
+		Graphics::ConvertBlit::convertFunc = convertFunc;
+		Graphics::ConvertBlit::map16Func = map16Func;
+		Graphics::ConvertBlit::map32Func = map32Func;
+
+		checkConvert();
+		checkMap();
+
+		Graphics::ConvertBlit::convertFunc = oldConvertFunc;
+		Graphics::ConvertBlit::map16Func = oldMap16Func;
+		Graphics::ConvertBlit::map32Func = oldMap32Func;
+	}
+
+public:
+	void setUp() {
+		// The null OSystem used by the tests cannot answer feature queries
+		if (!Graphics::ConvertBlit::convertFunc) {
+			Graphics::ConvertBlit::convertFunc = Graphics::ConvertBlit::convertGeneric;
+			Graphics::ConvertBlit::map16Func = Graphics::ConvertBlit::map16Generic;
+			Graphics::ConvertBlit::map32Func = Graphics::ConvertBlit::map32Generic;
+		}
+	}
+
+	void test_cross_blit_generic() {
+		checkKernels(Graphics::ConvertBlit::convertGeneric, Graphics::ConvertBlit::map16Generic, Graphics::ConvertBlit::map32Generic);
+	}
+
+	void test_cross_blit_simd() {
+#ifdef SCUMMVM_NEON
+		checkKernels(Graphics::ConvertBlit::convertNEON, Graphics::ConvertBlit::map16NEON, Graphics::ConvertBlit::map32NEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernels(Graphics::ConvertBlit::convertSSE2, Graphics::ConvertBlit::map16SSE2, Graphics::ConvertBlit::map32SSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernels(Graphics::ConvertBlit::convertAVX2, Graphics::ConvertBlit::map16AVX2, Graphics::ConvertBlit::map32AVX2);
+#endif
+	}
+
+	void test_unsupported_formats() {
+		// Formats with narrow channels keep using the per pixel conversion
+		const Graphics::PixelFormat rgb332(1, 3, 3, 2, 0, 5, 2, 0, 0);
+		const Graphics::PixelFormat rgba5551(2, 5, 5, 5, 1, 11, 6, 1, 0);
+		const Graphics::PixelFormat rgb888(3, 8, 8, 8, 0, 16, 8, 0, 0);
+		TS_ASSERT(!Graphics::ConvertBlit::canConvert(getFormat(3), rgba5551));
+		TS_ASSERT(Graphics::ConvertBlit::canConvert(rgba5551, getFormat(3)));
+		TS_ASSERT(!Graphics::ConvertBlit::canConvert(getFormat(3), rgb888));
+		TS_ASSERT(!Graphics::ConvertBlit::canConvert(rgb332, getFormat(3)));
+	}
+};
@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "image/codecs/idct.h"
+
+#include <math.h>
+
+class IDCTTestSuite : public CxxTest::TestSuite {
+	typedef void (*PutFunc)(byte *dest, uint pitch, const int16 *block);
+
+	static const uint kPitch = 13;
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8;
+	}
+
+	// Sparse blocks like most real ones, dense blocks, and blocks with 12-bit
+	// coefficients which saturate the intermediate values
+	static void fillBlock(int16 *block, uint32 &seed, uint kind) {
+		for (int i = 0; i < 64; i++)
+			block[i] = 0;
+
+		switch (kind % 3) {
+		case 0:
+			block[0] = (int16)((nextRandom(seed) & 0x7FF) - 0x400);
+			for (int i = 0; i < 4; i++)
+				block[nextRandom(seed) & 63] = (int16)((nextRandom(seed) & 0xFF) - 0x80);
+			break;
+		case 1:
+			for (int i = 0; i < 64; i++)
+				block[i] = (int16)((nextRandom(seed) & 0x7FF) - 0x400);
+			break;
+		default:
+			for (int i = 0; i < 64; i++)
+				block[i] = (int16)((nextRandom(seed) & 0xFFF) - 0x800);
+			break;
+		}
+	}
+
+	static void checkFunc(PutFunc put) {
+		uint32 seed = 1;
+
+		for (uint n = 0; n < 300; n++) {
+			int16 block[64];
+			fillBlock(block, seed, n);
+
+			byte expected[8 * kPitch], actual[8 * kPitch];
+			for (uint i = 0; i < ARRAYSIZE(expected); i++)
+				expected[i] = actual[i] = nextRandom(seed) & 0xFF;
+
+			Image::IDCT::putGeneric(expected, kPitch, block);
+			put(actual, kPitch, block);
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+		}
+	}
+
+public:
+	void test_generic_dc() {
+		int16 block[64] = { 0 };
+		block[0] = -20 * 8;
+
+		byte pixels[8 * kPitch];
+		memset(pixels, 0, sizeof(pixels));
+		Image::IDCT::putGeneric(pixels, kPitch, block);
+
+		for (uint y = 0; y < 8; y++) {
+			for (uint x = 0; x < kPitch; x++)
+				TS_ASSERT_EQUALS(pixels[y * kPitch + x], x < 8 ? 108 : 0);
+		}
+	}
+
+	void test_generic_accuracy() {
+		uint32 seed = 2;
+
+		for (uint n = 0; n < 100; n++) {
+			int16 block[64];
+			fillBlock(block, seed, n % 2);
+
+			byte pixels[8 * 8];
+			Image::IDCT::putGeneric(pixels, 8, block);
+
+			for (int y = 0; y < 8; y++) {
+				for (int x = 0; x < 8; x++) {
+					double sum = 0.0;
+					for (int v = 0; v < 8; v++) {
+						for (int u = 0; u < 8; u++) {
+							const double cu = u ? 1.0 : sqrt(0.5);
+							const double cv = v ? 1.0 : sqrt(0.5);
+							sum += cu * cv * block[v * 8 + u] * cos((2 * x + 1) * u * M_PI / 16) * cos((2 * y + 1) * v * M_PI / 16);
+						}
+					}
+
+					const int reference = CLIP<int>((int)floor(sum / 4 + 128.5), 0, 255);
+					TS_ASSERT_LESS_THAN_EQUALS(ABS(pixels[y * 8 + x] - reference), 1);
+				}
+			}
+		}
+	}
+
+	void test_simd() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkFunc(Image::IDCT::putSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkFunc(Image::IDCT::putAVX2);
+#endif
+	}
+};
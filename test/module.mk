@@ -10,6 +10,8 @@ TEST_LIBS    :=
 
 ifdef POSIX
 TEST_LIBS += test/null_osystem.o \
+	backends/mutex/pthread/pthread-mutex.o \
+	backends/threads/pthread/pthread-threadpool.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
@@ -28,8 +30,33 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
+TESTS += $(srcdir)/test/video/decode_ahead.h
+TEST_LIBS += video/libvideo.a
+
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/bink_idct.h
+endif
+
+TESTS += $(srcdir)/test/engines/detectioncache.h
+TEST_LIBS += engines/detectioncache.o
+
+TESTS += $(srcdir)/test/gui/massadd-scanner.h $(srcdir)/test/gui/thumbnail-loader.h
+TEST_LIBS += gui/massadd-scanner.o gui/thumbnail-loader.o
+
 TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
+TESTS += $(srcdir)/test/graphics/dirtyregion.h
+TESTS += $(srcdir)/test/graphics/rendercache.h
+TESTS += $(srcdir)/test/graphics/yuv_to_rgb.h
+
+ifdef USE_TINYGL
+	TESTS += $(srcdir)/test/graphics/tinygl.h
+endif
+
+ifdef USE_SCALERS
+	TESTS += $(srcdir)/test/graphics/scaler.h
+endif
+
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
@@ -79,9 +106,19 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+#
+# Video decoder benchmark, see test/benchmark/videobench.cpp.
+# It shares the null OSystem of the tests and adds a null audio mixer.
+#
+BENCH_LIBS := video/libvideo.a backends/mixer/null/null-mixer.o $(filter-out test/null_osystem.o video/libvideo.a,$(TEST_LIBS)) common/libcommon.a
+
+videobench: test/videobench
+test/videobench: $(srcdir)/test/benchmark/videobench.cpp $(srcdir)/test/null_osystem.cpp $(BENCH_LIBS)
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $(srcdir)/test/benchmark/videobench.cpp $(BENCH_LIBS) $(TEST_LDFLAGS)
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/videobench test/engine-data/encoding.dat test/null_osystem.o
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
@@ -90,4 +127,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test videobench clean-test copy-dat
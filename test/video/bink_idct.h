@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "video/bink_idct.h"
+
+class BinkIDCTTestSuite : public CxxTest::TestSuite {
+	typedef void (*TransformFunc)(int32 *block);
+	typedef void (*PixelFunc)(byte *dest, uint pitch, int32 *block);
+
+	static const uint kPitch = 13;
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 8;
+	}
+
+	// Sparse blocks like most real ones, and blocks with large coefficients
+	// which overflow 16 bits in the transform
+	static void fillBlock(int32 *block, uint32 &seed, uint kind) {
+		for (int i = 0; i < 64; i++)
+			block[i] = 0;
+
+		switch (kind % 3) {
+		case 0:
+			block[0] = (int32)(nextRandom(seed) & 0xFFFF) - 0x8000;
+			for (int i = 0; i < 4; i++)
+				block[nextRandom(seed) & 63] = (int32)(nextRandom(seed) & 0xFFF) - 0x800;
+			break;
+		case 1:
+			for (int i = 0; i < 64; i++)
+				block[i] = (int32)(nextRandom(seed) & 0xFFFF) - 0x8000;
+			break;
+		default:
+			for (int i = 0; i < 64; i++)
+				block[i] = (int32)(nextRandom(seed) & 0xFFFFF) - 0x80000;
+			break;
+		}
+	}
+
+	static void checkFuncs(TransformFunc transform, PixelFunc put, PixelFunc add) {
+		uint32 seed = 1;
+
+		for (uint n = 0; n < 300; n++) {
+			int32 coeffs[64], expected[64], actual[64];
+			fillBlock(coeffs, seed, n);
+
+			memcpy(expected, coeffs, sizeof(coeffs));
+			memcpy(actual, coeffs, sizeof(coeffs));
+			Video::BinkIDCT::transformGeneric(expected);
+			transform(actual);
+			for (int i = 0; i < 64; i++)
+				TS_ASSERT_EQUALS(actual[i], expected[i]);
+
+			byte expectedPixels[8 * kPitch], actualPixels[8 * kPitch];
+			for (uint i = 0; i < ARRAYSIZE(expectedPixels); i++)
+				expectedPixels[i] = actualPixels[i] = nextRandom(seed) & 0xFF;
+
+			memcpy(expected, coeffs, sizeof(coeffs));
+			memcpy(actual, coeffs, sizeof(coeffs));
+			Video::BinkIDCT::putGeneric(expectedPixels, kPitch, expected);
+			put(actualPixels, kPitch, actual);
+			TS_ASSERT_SAME_DATA(actualPixels, expectedPixels, sizeof(actualPixels));
+
+			memcpy(expected, coeffs, sizeof(coeffs));
+			memcpy(actual, coeffs, sizeof(coeffs));
+			Video::BinkIDCT::addGeneric(expectedPixels, kPitch, expected);
+			add(actualPixels, kPitch, actual);
+			TS_ASSERT_SAME_DATA(actualPixels, expectedPixels, sizeof(actualPixels));
+		}
+	}
+
+public:
+	void test_generic_dc() {
+		int32 block[64] = { 0 };
+		block[0] = 10 << 8;
+
+		byte pixels[8 * kPitch];
+		memset(pixels, 0, sizeof(pixels));
+		Video::BinkIDCT::putGeneric(pixels, kPitch, block);
+
+		for (uint y = 0; y < 8; y++) {
+			for (uint x = 0; x < kPitch; x++)
+				TS_ASSERT_EQUALS(pixels[y * kPitch + x], x < 8 ? 10 : 0);
+		}
+	}
+
+	void test_simd() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkFuncs(Video::BinkIDCT::transformSSE2, Video::BinkIDCT::putSSE2, Video::BinkIDCT::addSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkFuncs(Video::BinkIDCT::transformAVX2, Video::BinkIDCT::putAVX2, Video::BinkIDCT::addAVX2);
+#endif
+	}
+};
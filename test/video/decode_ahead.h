@@ -0,0 +1,165 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/rational.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "graphics/surface.h"
+
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+#include "../worker_threads.h"
+
+class DecodeAheadTestSuite : public CxxTest::TestSuite {
+	class TestDecoder : public Video::VideoDecoder {
+	public:
+		// Fills each frame with its frame number
+		class TestTrack : public FixedRateVideoTrack {
+		public:
+			TestTrack(int frameCount) : _frameCount(frameCount) {
+				_curFrame.store(-1);
+				_surface.create(4, 4, Graphics::PixelFormat::createFormatCLUT8());
+			}
+			~TestTrack() { _surface.free(); }
+
+			uint16 getWidth() const override { return _surface.w; }
+			uint16 getHeight() const override { return _surface.h; }
+			Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+			int getCurFrame() const override { return _curFrame.load(); }
+			int getFrameCount() const override { return _frameCount; }
+			bool isSeekable() const override { return true; }
+			bool canDecodeAhead() const override { return true; }
+
+			const Graphics::Surface *decodeNextFrame() override {
+				const int frame = _curFrame.load() + 1;
+				_surface.fillRect(Common::Rect(_surface.w, _surface.h), frame);
+				_curFrame.store(frame);
+				return &_surface;
+			}
+
+			bool seek(const Audio::Timestamp &time) override {
+				_curFrame.store((int)getFrameAtTime(time) - 1);
+				return true;
+			}
+
+		protected:
+			Common::Rational getFrameRate() const override { return 10; }
+
+		private:
+			const int _frameCount;
+			Common::Atomic<int> _curFrame;
+			Graphics::Surface _surface;
+		};
+
+		TestTrack *load(int frameCount) {
+			close();
+			TestTrack *track = new TestTrack(frameCount);
+			addTrack(track);
+			return track;
+		}
+
+		bool loadStream(Common::SeekableReadStream *stream) override {
+			delete stream;
+			return false;
+		}
+	};
+
+	// Return the frame number of a decoded frame, -1 if there is none
+	static int frameNumber(const Graphics::Surface *surface) {
+		return surface ? *(const byte *)surface->getBasePtr(3, 3) : -1;
+	}
+
+	// Wait for the workers to decode up to the given frame of the track
+	static bool waitForTrack(const TestDecoder::TestTrack *track, int frame) {
+		for (int i = 0; i < 5000 && track->getCurFrame() < frame; i++)
+			g_system->delayMillis(1);
+		return track->getCurFrame() == frame;
+	}
+
+public:
+	void test_without_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		TestDecoder decoder;
+		decoder.load(5);
+		TS_ASSERT(!decoder.setDecodeAhead(2));
+		decoder.start();
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 0);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 1);
+#endif
+	}
+
+	void test_queue_bounds() {
+#if NULL_OSYSTEM_IS_AVAILABLE && WORKER_THREADS_ARE_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ScopedWorkerThreads workers(3);
+
+		TestDecoder decoder;
+		TestDecoder::TestTrack *track = decoder.load(20);
+		TS_ASSERT(decoder.setDecodeAhead(3));
+		decoder.start();
+
+		// No more than the requested frames are decoded ahead
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 0);
+		TS_ASSERT(waitForTrack(track, 3));
+		g_system->delayMillis(20);
+		TS_ASSERT_EQUALS(track->getCurFrame(), 3);
+
+		// The caller sees the state of the last frame it was given
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 0);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 1);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 1);
+		TS_ASSERT(waitForTrack(track, 4));
+
+		// Decoding stops at the end of the track
+		for (int i = 2; i < 20; i++) {
+			TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), i);
+			TS_ASSERT_LESS_THAN_EQUALS(track->getCurFrame(), i + 3);
+		}
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT_EQUALS(track->getCurFrame(), 19);
+#endif
+	}
+
+	void test_seek_invalidation() {
+#if NULL_OSYSTEM_IS_AVAILABLE && WORKER_THREADS_ARE_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ScopedWorkerThreads workers(3);
+
+		TestDecoder decoder;
+		TestDecoder::TestTrack *track = decoder.load(20);
+		TS_ASSERT(decoder.setDecodeAhead(4));
+		decoder.start();
+
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 0);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 1);
+		TS_ASSERT(waitForTrack(track, 5));
+
+		// The frames decoded ahead are dropped
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), -1);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 0);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 1);
+
+		TS_ASSERT(decoder.seekToFrame(10));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 9);
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 10);
+		TS_ASSERT(waitForTrack(track, 14));
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 11);
+
+		// Decoding ahead starts over when seeking back after the end
+		for (int i = 12; i < 20; i++)
+			decoder.decodeNextFrame();
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT(decoder.seekToFrame(2));
+		TS_ASSERT(!decoder.endOfVideo());
+		TS_ASSERT_EQUALS(frameNumber(decoder.decodeNextFrame()), 2);
+		TS_ASSERT(waitForTrack(track, 6));
+#endif
+	}
+};
@@ -0,0 +1,35 @@
+#ifndef TEST_WORKER_THREADS
+#define TEST_WORKER_THREADS 1
+
+#ifdef POSIX
+#include "backends/threads/pthread/pthread-threadpool.h"
+
+#define WORKER_THREADS_ARE_AVAILABLE 1
+
+namespace Common {
+
+/**
+ * Pool with pthread workers which replaces ThreadPoolMan while it exists,
+ * as the null OSystem does not create any worker threads.
+ */
+class ScopedWorkerThreads : public ThreadPool {
+public:
+	explicit ScopedWorkerThreads(uint numThreads) : ThreadPool(createPthreadThreadPoolInternal(numThreads)) {
+		_previous = _singleton;
+		_singleton = this;
+	}
+
+	~ScopedWorkerThreads() {
+		_singleton = _previous;
+	}
+
+private:
+	ThreadPool *_previous;
+};
+
+} // End of namespace Common
+
+#else
+#define WORKER_THREADS_ARE_AVAILABLE 0
+#endif
+#endif
@@ -160,6 +160,7 @@ private:
 		bool isSeekable() const  override{ return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
+		bool canDecodeAhead() const override { return true; }
 		void setCurFrame(uint32 frame) { _curFrame = frame; }
 
 		/** Decode a video packet. */
@@ -283,6 +284,13 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Height of the slices of rows converted to RGB in parallel. */
+		static const uint kSliceHeight = 32;
+
+		/** Convert the rows [start, end) of the current planes into the surface. */
+		void convertRows(uint start, uint end);
+		static void convertSlices(uint begin, uint end, void *data);
+
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
@@ -330,11 +338,6 @@ private:
 		void readDCS         (VideoFrame &video, Bundle &bundle);
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
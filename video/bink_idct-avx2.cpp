@@ -0,0 +1,160 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "video/bink_idct.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Video {
+
+/**
+ * Apply the one-dimensional transform to all eight columns at once. The
+ * rows pass additionally rounds the results to the final precision.
+ */
+template<bool isRows>
+static FORCEINLINE void transform_AVX2(__m256i *d, const __m256i *s) {
+	const __m256i a0 = _mm256_add_epi32(s[0], s[4]);
+	const __m256i a1 = _mm256_sub_epi32(s[0], s[4]);
+	const __m256i a2 = _mm256_add_epi32(s[2], s[6]);
+	const __m256i a3 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(s[2], s[6]), _mm256_set1_epi32(kBinkIDCTA1)), 11);
+	const __m256i a4 = _mm256_add_epi32(s[5], s[3]);
+	const __m256i a5 = _mm256_sub_epi32(s[5], s[3]);
+	const __m256i a6 = _mm256_add_epi32(s[1], s[7]);
+	const __m256i a7 = _mm256_sub_epi32(s[1], s[7]);
+	const __m256i b0 = _mm256_add_epi32(a4, a6);
+	const __m256i b1 = _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_add_epi32(a5, a7), _mm256_set1_epi32(kBinkIDCTA3)), 11);
+	const __m256i b2 = _mm256_add_epi32(_mm256_sub_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(a5, _mm256_set1_epi32(kBinkIDCTA4)), 11), b0), b1);
+	const __m256i b3 = _mm256_sub_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(a6, a4), _mm256_set1_epi32(kBinkIDCTA1)), 11), b2);
+	const __m256i b4 = _mm256_sub_epi32(_mm256_add_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(a7, _mm256_set1_epi32(kBinkIDCTA2)), 11), b3), b1);
+
+	const __m256i c0 = _mm256_add_epi32(a0, a2);
+	const __m256i c1 = _mm256_sub_epi32(_mm256_add_epi32(a1, a3), a2);
+	const __m256i c2 = _mm256_add_epi32(_mm256_sub_epi32(a1, a3), a2);
+	const __m256i c3 = _mm256_sub_epi32(a0, a2);
+
+	d[0] = _mm256_add_epi32(c0, b0);
+	d[1] = _mm256_add_epi32(c1, b2);
+	d[2] = _mm256_add_epi32(c2, b3);
+	d[3] = _mm256_sub_epi32(c3, b4);
+	d[4] = _mm256_add_epi32(c3, b4);
+	d[5] = _mm256_sub_epi32(c2, b3);
+	d[6] = _mm256_sub_epi32(c1, b2);
+	d[7] = _mm256_sub_epi32(c0, b0);
+
+	if (isRows) {
+		const __m256i bias = _mm256_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm256_srai_epi32(_mm256_add_epi32(d[i], bias), 8);
+	}
+}
+
+static FORCEINLINE void transpose8_AVX2(__m256i *r) {
+	const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+	r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/** Transform @p block into the rows @p r. */
+static FORCEINLINE void idct_AVX2(__m256i *r, const int32 *block) {
+	__m256i s[8];
+
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm256_loadu_si256((const __m256i *)(block + i * 8));
+	transform_AVX2<false>(r, s);
+
+	transpose8_AVX2(r);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = r[i];
+	transform_AVX2<true>(r, s);
+
+	transpose8_AVX2(r);
+}
+
+/** Return the low 8 bits of the eight values of a row, as scalar code stores them. */
+static FORCEINLINE __m128i packRow_AVX2(__m256i row) {
+	const __m256i masked = _mm256_and_si256(row, _mm256_set1_epi32(0xFF));
+	const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(masked), _mm256_extracti128_si256(masked, 1));
+	return _mm_packus_epi16(words, words);
+}
+
+void BinkIDCT::transformAVX2(int32 *block) {
+	__m256i r[8];
+	idct_AVX2(r, block);
+
+	for (int i = 0; i < 8; i++)
+		_mm256_storeu_si256((__m256i *)(block + i * 8), r[i]);
+}
+
+void BinkIDCT::putAVX2(byte *dest, uint pitch, int32 *block) {
+	__m256i r[8];
+	idct_AVX2(r, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packRow_AVX2(r[i]));
+}
+
+void BinkIDCT::addAVX2(byte *dest, uint pitch, int32 *block) {
+	__m256i r[8];
+	idct_AVX2(r, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+		_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, packRow_AVX2(r[i])));
+	}
+}
+
+} // End of namespace Video
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,172 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "video/bink_idct.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Video {
+
+/**
+ * Apply the one-dimensional transform to four columns at once. The rows
+ * pass additionally rounds the results to the final precision.
+ */
+template<bool isRows>
+static FORCEINLINE void transform_NEON(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(s[2], s[6]), kBinkIDCTA1), 11);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = vshrq_n_s32(vmulq_n_s32(vaddq_s32(a5, a7), kBinkIDCTA3), 11);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(vshrq_n_s32(vmulq_n_s32(a5, kBinkIDCTA4), 11), b0), b1);
+	const int32x4_t b3 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(a6, a4), kBinkIDCTA1), 11), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(a7, kBinkIDCTA2), 11), b3), b1);
+
+	const int32x4_t c0 = vaddq_s32(a0, a2);
+	const int32x4_t c1 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t c2 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	const int32x4_t c3 = vsubq_s32(a0, a2);
+
+	d[0] = vaddq_s32(c0, b0);
+	d[1] = vaddq_s32(c1, b2);
+	d[2] = vaddq_s32(c2, b3);
+	d[3] = vsubq_s32(c3, b4);
+	d[4] = vaddq_s32(c3, b4);
+	d[5] = vsubq_s32(c2, b3);
+	d[6] = vsubq_s32(c1, b2);
+	d[7] = vsubq_s32(c0, b0);
+
+	if (isRows) {
+		const int32x4_t bias = vdupq_n_s32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = vshrq_n_s32(vaddq_s32(d[i], bias), 8);
+	}
+}
+
+static FORCEINLINE void transpose4_NEON(int32x4_t *r) {
+	const int32x4x2_t t01 = vtrnq_s32(r[0], r[1]);
+	const int32x4x2_t t23 = vtrnq_s32(r[2], r[3]);
+	r[0] = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	r[1] = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	r[2] = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	r[3] = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
+
+/**
+ * Transpose an 8x8 matrix whose rows are split into the left halves
+ * @p lo and the right halves @p hi.
+ */
+static FORCEINLINE void transpose8_NEON(int32x4_t *lo, int32x4_t *hi) {
+	transpose4_NEON(lo);
+	transpose4_NEON(lo + 4);
+	transpose4_NEON(hi);
+	transpose4_NEON(hi + 4);
+
+	for (int i = 0; i < 4; i++) {
+		const int32x4_t t = lo[i + 4];
+		lo[i + 4] = hi[i];
+		hi[i] = t;
+	}
+}
+
+/** Transform @p block into the rows @p lo and @p hi. */
+static FORCEINLINE void idct_NEON(int32x4_t *lo, int32x4_t *hi, const int32 *block) {
+	int32x4_t s[8];
+
+	for (int i = 0; i < 8; i++)
+		s[i] = vld1q_s32(block + i * 8);
+	transform_NEON<false>(lo, s);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = vld1q_s32(block + i * 8 + 4);
+	transform_NEON<false>(hi, s);
+
+	transpose8_NEON(lo, hi);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = lo[i];
+	transform_NEON<true>(lo, s);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = hi[i];
+	transform_NEON<true>(hi, s);
+
+	transpose8_NEON(lo, hi);
+}
+
+/** Return the low 8 bits of the eight values of a row, as scalar code stores them. */
+static FORCEINLINE uint8x8_t packRow_NEON(int32x4_t lo, int32x4_t hi) {
+	const int16x8_t words = vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+	return vmovn_u16(vreinterpretq_u16_s16(words));
+}
+
+void BinkIDCT::transformNEON(int32 *block) {
+	int32x4_t lo[8], hi[8];
+	idct_NEON(lo, hi, block);
+
+	for (int i = 0; i < 8; i++) {
+		vst1q_s32(block + i * 8, lo[i]);
+		vst1q_s32(block + i * 8 + 4, hi[i]);
+	}
+}
+
+void BinkIDCT::putNEON(byte *dest, uint pitch, int32 *block) {
+	int32x4_t lo[8], hi[8];
+	idct_NEON(lo, hi, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, packRow_NEON(lo[i], hi[i]));
+}
+
+void BinkIDCT::addNEON(byte *dest, uint pitch, int32 *block) {
+	int32x4_t lo[8], hi[8];
+	idct_NEON(lo, hi, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), packRow_NEON(lo[i], hi[i])));
+}
+
+} // End of namespace Video
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,185 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "video/bink_idct.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Video {
+
+/**
+ * Multiply each 32-bit lane of @p a by @p factor, keeping the low 32 bits
+ * of the products like scalar code does. SSE2 only multiplies two lanes at
+ * a time.
+ */
+static FORCEINLINE __m128i mul_SSE2(__m128i a, int32 factor) {
+	const __m128i f = _mm_set1_epi32(factor);
+	const __m128i even = _mm_mul_epu32(a, f);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), f);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/**
+ * Apply the one-dimensional transform to four columns at once. The rows
+ * pass additionally rounds the results to the final precision.
+ */
+template<bool isRows>
+static FORCEINLINE void transform_SSE2(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mul_SSE2(_mm_sub_epi32(s[2], s[6]), kBinkIDCTA1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mul_SSE2(_mm_add_epi32(a5, a7), kBinkIDCTA3), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mul_SSE2(a5, kBinkIDCTA4), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mul_SSE2(_mm_sub_epi32(a6, a4), kBinkIDCTA1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mul_SSE2(a7, kBinkIDCTA2), 11), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_sub_epi32(a0, a2);
+
+	d[0] = _mm_add_epi32(c0, b0);
+	d[1] = _mm_add_epi32(c1, b2);
+	d[2] = _mm_add_epi32(c2, b3);
+	d[3] = _mm_sub_epi32(c3, b4);
+	d[4] = _mm_add_epi32(c3, b4);
+	d[5] = _mm_sub_epi32(c2, b3);
+	d[6] = _mm_sub_epi32(c1, b2);
+	d[7] = _mm_sub_epi32(c0, b0);
+
+	if (isRows) {
+		const __m128i bias = _mm_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm_srai_epi32(_mm_add_epi32(d[i], bias), 8);
+	}
+}
+
+static FORCEINLINE void transpose4_SSE2(__m128i *r) {
+	const __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+	const __m128i t1 = _mm_unpacklo_epi32(r[2], r[3]);
+	const __m128i t2 = _mm_unpackhi_epi32(r[0], r[1]);
+	const __m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+	r[0] = _mm_unpacklo_epi64(t0, t1);
+	r[1] = _mm_unpackhi_epi64(t0, t1);
+	r[2] = _mm_unpacklo_epi64(t2, t3);
+	r[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+/**
+ * Transpose an 8x8 matrix whose rows are split into the left halves
+ * @p lo and the right halves @p hi.
+ */
+static FORCEINLINE void transpose8_SSE2(__m128i *lo, __m128i *hi) {
+	transpose4_SSE2(lo);
+	transpose4_SSE2(lo + 4);
+	transpose4_SSE2(hi);
+	transpose4_SSE2(hi + 4);
+
+	for (int i = 0; i < 4; i++) {
+		const __m128i t = lo[i + 4];
+		lo[i + 4] = hi[i];
+		hi[i] = t;
+	}
+}
+
+/** Transform @p block into the rows @p lo and @p hi. */
+static FORCEINLINE void idct_SSE2(__m128i *lo, __m128i *hi, const int32 *block) {
+	__m128i s[8];
+
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_loadu_si128((const __m128i *)(block + i * 8));
+	transform_SSE2<false>(lo, s);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_loadu_si128((const __m128i *)(block + i * 8 + 4));
+	transform_SSE2<false>(hi, s);
+
+	transpose8_SSE2(lo, hi);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = lo[i];
+	transform_SSE2<true>(lo, s);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = hi[i];
+	transform_SSE2<true>(hi, s);
+
+	transpose8_SSE2(lo, hi);
+}
+
+/** Return the low 8 bits of the eight values of a row, as scalar code stores them. */
+static FORCEINLINE __m128i packRow_SSE2(__m128i lo, __m128i hi) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+void BinkIDCT::transformSSE2(int32 *block) {
+	__m128i lo[8], hi[8];
+	idct_SSE2(lo, hi, block);
+
+	for (int i = 0; i < 8; i++) {
+		_mm_storeu_si128((__m128i *)(block + i * 8), lo[i]);
+		_mm_storeu_si128((__m128i *)(block + i * 8 + 4), hi[i]);
+	}
+}
+
+void BinkIDCT::putSSE2(byte *dest, uint pitch, int32 *block) {
+	__m128i lo[8], hi[8];
+	idct_SSE2(lo, hi, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packRow_SSE2(lo[i], hi[i]));
+}
+
+void BinkIDCT::addSSE2(byte *dest, uint pitch, int32 *block) {
+	__m128i lo[8], hi[8];
+	idct_SSE2(lo, hi, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+		_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, packRow_SSE2(lo[i], hi[i])));
+	}
+}
+
+} // End of namespace Video
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef VIDEO_BINK_IDCT_H
+#define VIDEO_BINK_IDCT_H
+
+#include "common/scummsys.h"
+
+class BinkIDCTTestSuite;
+
+namespace Video {
+
+/**
+ * The inverse DCT used by Bink video.
+ *
+ * Blocks are 8x8 coefficients in row order, and are overwritten by all
+ * functions. A vectorized implementation is selected at runtime when the
+ * CPU supports one; all of them give the same results as the generic one,
+ * including the wrap-around of pixel values.
+ */
+class BinkIDCT {
+public:
+	/** Transform @p block in place. */
+	static void transform(int32 *block) { transformFunc(block); }
+
+	/** Transform @p block and store the result in the 8x8 pixels at @p dest. */
+	static void put(byte *dest, uint pitch, int32 *block) { putFunc(dest, pitch, block); }
+
+	/** Transform @p block and add the result to the 8x8 pixels at @p dest. */
+	static void add(byte *dest, uint pitch, int32 *block) { addFunc(dest, pitch, block); }
+
+	/** Select the fastest implementation supported by the CPU. */
+	static void init();
+
+private:
+	typedef void (*TransformFunc)(int32 *block);
+	typedef void (*PixelFunc)(byte *dest, uint pitch, int32 *block);
+
+	static void transformGeneric(int32 *block);
+	static void putGeneric(byte *dest, uint pitch, int32 *block);
+	static void addGeneric(byte *dest, uint pitch, int32 *block);
+#ifdef SCUMMVM_NEON
+	static void transformNEON(int32 *block);
+	static void putNEON(byte *dest, uint pitch, int32 *block);
+	static void addNEON(byte *dest, uint pitch, int32 *block);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void transformSSE2(int32 *block);
+	static void putSSE2(byte *dest, uint pitch, int32 *block);
+	static void addSSE2(byte *dest, uint pitch, int32 *block);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void transformAVX2(int32 *block);
+	static void putAVX2(byte *dest, uint pitch, int32 *block);
+	static void addAVX2(byte *dest, uint pitch, int32 *block);
+#endif
+
+	static TransformFunc transformFunc;
+	static PixelFunc putFunc;
+	static PixelFunc addFunc;
+
+	friend class ::BinkIDCTTestSuite;
+};
+
+/**
+ * Fixed point constants of the transform, with 11 fractional bits.
+ */
+enum {
+	kBinkIDCTA1 = 2896, // (1/sqrt(2))<<12
+	kBinkIDCTA2 = 2217,
+	kBinkIDCTA3 = 3784,
+	kBinkIDCTA4 = -5352
+};
+
+} // End of namespace Video
+
+#endif
@@ -30,6 +30,7 @@
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "graphics/yuv_to_rgb.h"
+#include "image/codecs/idct.h"
 
 #include "video/psx_decoder.h"
 
@@ -364,6 +365,8 @@ PSXStreamDecoder::PSXVideoTrack::PSXVideoTrack(Common::SeekableReadStream *first
 	_acHuffman = new HuffmanDecoder(0, AC_CODE_COUNT, s_huffmanACCodes, s_huffmanACLengths, s_huffmanACSymbols);
 	_dcHuffmanChroma = new HuffmanDecoder(0, DC_CODE_COUNT, s_huffmanDCChromaCodes, s_huffmanDCChromaLengths, s_huffmanDCSymbols);
 	_dcHuffmanLuma = new HuffmanDecoder(0, DC_CODE_COUNT, s_huffmanDCLumaCodes, s_huffmanDCLumaLengths, s_huffmanDCSymbols);
+
+	Image::IDCT::init();
 }
 
 PSXStreamDecoder::PSXVideoTrack::~PSXVideoTrack() {
@@ -465,13 +468,15 @@ static const byte s_quantizationTable[8 * 8] = {
 	27, 29, 35, 38, 46, 56, 69, 83
 };
 
-void PSXStreamDecoder::PSXVideoTrack::dequantizeBlock(int *coefficients, float *block, uint16 scale) {
-	// Dequantize the data, un-zig-zagging as we go along
-	for (int i = 0; i < 8 * 8; i++) {
-		if (i == 0) // Special case for the DC coefficient
-			block[i] = coefficients[i] * s_quantizationTable[i];
-		else
-			block[i] = (float)coefficients[s_zigZagTable[i]] * s_quantizationTable[i] * scale / 8;
+void PSXStreamDecoder::PSXVideoTrack::dequantizeBlock(int *coefficients, int16 *block, uint16 scale) {
+	// Dequantize the data, un-zig-zagging as we go along. The AC coefficients
+	// are rounded to the nearest integer, and all of them are saturated to
+	// 11 bits like the MDEC does.
+	block[0] = CLIP(coefficients[0] * s_quantizationTable[0], -1024, 1023);
+
+	for (int i = 1; i < 8 * 8; i++) {
+		const int value = coefficients[s_zigZagTable[i]] * s_quantizationTable[i] * scale;
+		block[i] = CLIP((value + (value < 0 ? -4 : 4)) / 8, -1024, 1023);
 	}
 }
 
@@ -548,59 +553,6 @@ int PSXStreamDecoder::PSXVideoTrack::readSignedCoefficient(Common::BitStreamMemo
 	return (int)(val << shift) >> shift;
 }
 
-// IDCT table built with :
-// _idct8x8[x][y] = cos(((2 * x + 1) * y) * (M_PI / 16.0)) * 0.5;
-// _idct8x8[x][y] /= sqrt(2.0) if y == 0
-static const double s_idct8x8[8][8] = {
-	{ 0.353553390593274,  0.490392640201615,  0.461939766255643,  0.415734806151273,  0.353553390593274,  0.277785116509801,  0.191341716182545,  0.097545161008064 },
-	{ 0.353553390593274,  0.415734806151273,  0.191341716182545, -0.097545161008064, -0.353553390593274, -0.490392640201615, -0.461939766255643, -0.277785116509801 },
-	{ 0.353553390593274,  0.277785116509801, -0.191341716182545, -0.490392640201615, -0.353553390593274,  0.097545161008064,  0.461939766255643,  0.415734806151273 },
-	{ 0.353553390593274,  0.097545161008064, -0.461939766255643, -0.277785116509801,  0.353553390593274,  0.415734806151273, -0.191341716182545, -0.490392640201615 },
-	{ 0.353553390593274, -0.097545161008064, -0.461939766255643,  0.277785116509801,  0.353553390593274, -0.415734806151273, -0.191341716182545,  0.490392640201615 },
-	{ 0.353553390593274, -0.277785116509801, -0.191341716182545,  0.490392640201615, -0.353553390593273, -0.097545161008064,  0.461939766255643, -0.415734806151273 },
-	{ 0.353553390593274, -0.415734806151273,  0.191341716182545,  0.097545161008064, -0.353553390593274,  0.490392640201615, -0.461939766255643,  0.277785116509801 },
-	{ 0.353553390593274, -0.490392640201615,  0.461939766255643, -0.415734806151273,  0.353553390593273, -0.277785116509801,  0.191341716182545, -0.097545161008064 }
-};
-
-void PSXStreamDecoder::PSXVideoTrack::idct(float *dequantData, float *result) {
-	// IDCT code based on JPEG's IDCT code
-	// TODO: Switch to the integer-based one mentioned in the docs
-	// This is by far the costliest operation here
-
-	float tmp[8 * 8];
-
-	// Apply 1D IDCT to rows
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			tmp[y + x * 8] = dequantData[0] * s_idct8x8[x][0]
-							+ dequantData[1] * s_idct8x8[x][1]
-							+ dequantData[2] * s_idct8x8[x][2]
-							+ dequantData[3] * s_idct8x8[x][3]
-							+ dequantData[4] * s_idct8x8[x][4]
-							+ dequantData[5] * s_idct8x8[x][5]
-							+ dequantData[6] * s_idct8x8[x][6]
-							+ dequantData[7] * s_idct8x8[x][7];
-		}
-
-		dequantData += 8;
-	}
-
-	// Apply 1D IDCT to columns
-	for (int x = 0; x < 8; x++) {
-		const float *u = tmp + x * 8;
-		for (int y = 0; y < 8; y++) {
-			result[y * 8 + x] = u[0] * s_idct8x8[y][0]
-								+ u[1] * s_idct8x8[y][1]
-								+ u[2] * s_idct8x8[y][2]
-								+ u[3] * s_idct8x8[y][3]
-								+ u[4] * s_idct8x8[y][4]
-								+ u[5] * s_idct8x8[y][5]
-								+ u[6] * s_idct8x8[y][6]
-								+ u[7] * s_idct8x8[y][7];
-		}
-	}
-}
-
 void PSXStreamDecoder::PSXVideoTrack::decodeBlock(Common::BitStreamMemory16LEMSB *bits, byte *block, int pitch, uint16 scale, uint16 version, PlaneType plane) {
 	// Version 2 just has signed 10 bits for DC
 	// Version 3 has them huffman coded
@@ -609,21 +561,11 @@ void PSXStreamDecoder::PSXVideoTrack::decodeBlock(Common::BitStreamMemory16LEMSB
 	readAC(bits, &coefficients[1]); // Read in the AC
 
 	// Dequantize
-	float dequantData[8 * 8];
+	int16 dequantData[8 * 8];
 	dequantizeBlock(coefficients, dequantData, scale);
 
-	// Perform IDCT
-	float idctData[8 * 8];
-	idct(dequantData, idctData);
-
-	// Now output the data
-	for (int y = 0; y < 8; y++) {
-		byte *dst = block + pitch * y;
-
-		// Convert the result to be in the range [0, 255]
-		for (int x = 0; x < 8; x++)
-			*dst++ = (int)CLIP<float>(idctData[y * 8 + x], -128.0f, 127.0f) + 128;
-	}
+	// Perform IDCT, and output the data in the range [0, 255]
+	Image::IDCT::put(block, pitch, dequantData);
 }
 
 
@@ -123,8 +123,7 @@ private:
 		HuffmanDecoder *_dcHuffmanLuma, *_dcHuffmanChroma;
 		int _lastDC[3];
 
-		void dequantizeBlock(int *coefficients, float *block, uint16 scale);
-		void idct(float *dequantData, float *result);
+		void dequantizeBlock(int *coefficients, int16 *block, uint16 scale);
 		int readSignedCoefficient(Common::BitStreamMemory16LEMSB *bits);
 	};
 
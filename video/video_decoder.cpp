@@ -26,10 +26,270 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/mutex.h"
+#include "common/queue.h"
 #include "common/system.h"
+#include "common/threadpool.h"
+
+#include "graphics/blit.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * Frames of a single video track, decoded ahead of playback by jobs on
+ * the shared thread pool. Each job decodes a single frame and then queues
+ * the next one, since a thread waiting for its own jobs may run a job of
+ * this queue in the meantime. The caller sees the state of the track as of the
+ * last frame returned by decodeNextFrame(), while the track itself may
+ * already be several frames further.
+ *
+ * While suspended, nothing is decoded ahead and the track is used directly.
+ */
+class VideoDecoder::DecodeAheadQueue {
+public:
+	DecodeAheadQueue(VideoDecoder *decoder, VideoTrack *track, uint frameCount);
+	~DecodeAheadQueue();
+
+	VideoTrack *getTrack() const { return _track; }
+
+	int getCurFrame() const { return _suspended ? _track->getCurFrame() : _curFrame; }
+	uint32 getNextFrameStartTime() const { return _suspended ? _track->getNextFrameStartTime() : _nextFrameStartTime; }
+	bool endOfTrack() const { return _suspended ? _track->endOfTrack() : _endOfTrack; }
+
+	/** Return the next frame, decoding it on the calling thread if it is not ready yet. */
+	const Graphics::Surface *decodeNextFrame();
+	const byte *getPalette() const { return _palette; }
+	bool hasDirtyPalette() const { return _current && _current->dirtyPalette; }
+
+	/** Drop all frames decoded ahead, and leave the track to the caller until resume(). */
+	void suspend();
+	void resume();
+	bool isSuspended() const { return _suspended; }
+
+private:
+	struct Frame {
+		Frame() : decoded(false), hasSurface(false), dirtyPalette(false), curFrame(-1), nextFrameStartTime(0), endOfTrack(false) {}
+		~Frame() { surface.free(); }
+
+		bool decoded;
+		Graphics::Surface surface;
+		bool hasSurface;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		int curFrame;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+	};
+
+	static void decodeAheadProc(void *data);
+	void decodeFrame(Frame *frame);
+	void startDecoding();
+
+	// Must be called with _mutex held
+	bool needsFrames() const { return !_stopRequested && !_decodedEnd && (uint)_ready.size() < _frameCount; }
+	Frame *allocFrame();
+	void freeFrame(Frame *frame);
+
+	VideoDecoder *_decoder;
+	VideoTrack *_track;
+	const uint _frameCount;
+	Common::TaskGroup _tasks;
+
+	// Shared with the decoding job
+	Common::Mutex _mutex;
+	Common::Queue<Frame *> _ready;
+	Common::Array<Frame *> _unused;
+	bool _running;
+	bool _stopRequested;
+	bool _decodedEnd;
+
+	// State as of the last frame returned
+	bool _suspended;
+	Frame *_current;
+	byte _palette[256 * 3];
+	int _curFrame;
+	uint32 _nextFrameStartTime;
+	bool _endOfTrack;
+};
+
+VideoDecoder::DecodeAheadQueue::DecodeAheadQueue(VideoDecoder *decoder, VideoTrack *track, uint frameCount) :
+		_decoder(decoder), _track(track), _frameCount(frameCount), _tasks(ThreadPoolMan),
+		_running(false), _stopRequested(false), _decodedEnd(false), _suspended(false), _current(nullptr) {
+	memset(_palette, 0, sizeof(_palette));
+	resume();
+}
+
+VideoDecoder::DecodeAheadQueue::~DecodeAheadQueue() {
+	suspend();
+
+	delete _current;
+	for (uint i = 0; i < _unused.size(); i++)
+		delete _unused[i];
+}
+
+const Graphics::Surface *VideoDecoder::DecodeAheadQueue::decodeNextFrame() {
+	assert(!_suspended);
+
+	bool waitForJob = false;
+	{
+		Common::StackLock lock(_mutex);
+		// The job is decoding the frame needed right now, so make it stop
+		// after that one instead of filling the whole queue first
+		if (_ready.empty() && _running) {
+			_stopRequested = true;
+			waitForJob = true;
+		}
+	}
+
+	if (waitForJob)
+		_tasks.wait();
+
+	Frame *frame = nullptr;
+	{
+		Common::StackLock lock(_mutex);
+		_stopRequested = false;
+
+		if (!_ready.empty())
+			frame = _ready.pop();
+		else
+			frame = allocFrame();
+	}
+
+	// Nothing was decoded ahead, and no job is running at this point
+	if (!frame->decoded) {
+		decodeFrame(frame);
+
+		Common::StackLock lock(_mutex);
+		_decodedEnd = frame->endOfTrack;
+	}
+
+	{
+		Common::StackLock lock(_mutex);
+		if (_current)
+			freeFrame(_current);
+	}
+
+	_current = frame;
+	_curFrame = frame->curFrame;
+	_nextFrameStartTime = frame->nextFrameStartTime;
+	_endOfTrack = frame->endOfTrack;
+
+	if (frame->dirtyPalette)
+		memcpy(_palette, frame->palette, sizeof(_palette));
+
+	startDecoding();
+	return frame->hasSurface ? &frame->surface : nullptr;
+}
+
+void VideoDecoder::DecodeAheadQueue::suspend() {
+	{
+		Common::StackLock lock(_mutex);
+		_stopRequested = true;
+	}
+
+	_tasks.wait();
+
+	Common::StackLock lock(_mutex);
+	_stopRequested = false;
+	_decodedEnd = false;
+
+	while (!_ready.empty())
+		freeFrame(_ready.pop());
+
+	_suspended = true;
+}
+
+void VideoDecoder::DecodeAheadQueue::resume() {
+	_suspended = false;
+	_curFrame = _track->getCurFrame();
+	_nextFrameStartTime = _track->getNextFrameStartTime();
+	_endOfTrack = _track->endOfTrack();
+}
+
+void VideoDecoder::DecodeAheadQueue::decodeAheadProc(void *data) {
+	DecodeAheadQueue *queue = (DecodeAheadQueue *)data;
+
+	Frame *frame;
+	{
+		Common::StackLock lock(queue->_mutex);
+		if (!queue->needsFrames()) {
+			queue->_running = false;
+			return;
+		}
+
+		frame = queue->allocFrame();
+	}
+
+	queue->decodeFrame(frame);
+
+	{
+		Common::StackLock lock(queue->_mutex);
+		queue->_ready.push(frame);
+		queue->_decodedEnd = frame->endOfTrack;
+
+		if (!queue->needsFrames()) {
+			queue->_running = false;
+			return;
+		}
+	}
+
+	// The group's counter is only zero once no job is left, so wait()
+	// also waits for the job queued here
+	queue->_tasks.run(decodeAheadProc, queue);
+}
+
+void VideoDecoder::DecodeAheadQueue::decodeFrame(Frame *frame) {
+	_decoder->readNextPacket();
+
+	// The track reuses its surface, so the frame needs a copy of it
+	const Graphics::Surface *surface = _track->decodeNextFrame();
+	frame->hasSurface = surface != nullptr;
+	if (surface) {
+		if (frame->surface.w != surface->w || frame->surface.h != surface->h || frame->surface.format != surface->format)
+			frame->surface.create(surface->w, surface->h, surface->format);
+
+		Graphics::copyBlit((byte *)frame->surface.getPixels(), (const byte *)surface->getPixels(),
+				frame->surface.pitch, surface->pitch, surface->w, surface->h, surface->format.bytesPerPixel);
+	}
+
+	const byte *palette = _track->hasDirtyPalette() ? _track->getPalette() : nullptr;
+	frame->dirtyPalette = palette != nullptr;
+	if (palette)
+		memcpy(frame->palette, palette, sizeof(frame->palette));
+
+	frame->curFrame = _track->getCurFrame();
+	frame->nextFrameStartTime = _track->getNextFrameStartTime();
+	frame->endOfTrack = _track->endOfTrack();
+	frame->decoded = true;
+}
+
+void VideoDecoder::DecodeAheadQueue::startDecoding() {
+	{
+		Common::StackLock lock(_mutex);
+		if (_running || !needsFrames())
+			return;
+
+		_running = true;
+	}
+
+	_tasks.run(decodeAheadProc, this);
+}
+
+VideoDecoder::DecodeAheadQueue::Frame *VideoDecoder::DecodeAheadQueue::allocFrame() {
+	if (_unused.empty())
+		return new Frame();
+
+	Frame *frame = _unused.back();
+	_unused.pop_back();
+	return frame;
+}
+
+void VideoDecoder::DecodeAheadQueue::freeFrame(Frame *frame) {
+	frame->decoded = false;
+	_unused.push_back(frame);
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -47,12 +307,21 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	_decodeAhead = nullptr;
+}
+
+VideoDecoder::~VideoDecoder() {
+	delete _decodeAhead;
 }
 
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	// Stop decoding before the tracks go away
+	delete _decodeAhead;
+	_decodeAhead = nullptr;
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -204,6 +473,21 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_decodeAhead && !_decodeAhead->isSuspended()) {
+		if (!_nextVideoTrack)
+			return 0;
+
+		const Graphics::Surface *frame = _decodeAhead->decodeNextFrame();
+
+		if (_decodeAhead->hasDirtyPalette()) {
+			_palette = _decodeAhead->getPalette();
+			_dirtyPalette = true;
+		}
+
+		findNextVideoTrack();
+		return frame;
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -229,6 +513,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames decoded ahead are always in forward order
+	if (reverse && _decodeAhead)
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -253,7 +541,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
+			frame += getTrackCurFrame((VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -294,7 +582,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -315,8 +603,8 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -343,10 +631,18 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	// Frames decoded ahead are stale after rewinding. On failure, decoding
+	// simply stays synchronous.
+	if (_decodeAhead)
+		_decodeAhead->suspend();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->rewind())
 			return false;
 
+	if (_decodeAhead)
+		_decodeAhead->resume();
+
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
 		startAudio();
@@ -377,6 +673,12 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	// Frames decoded ahead are stale after seeking, and seekIntern() may
+	// need to decode frames itself. On failure, decoding simply stays
+	// synchronous.
+	if (_decodeAhead)
+		_decodeAhead->suspend();
+
 	// Do the actual seeking
 	if (!seekIntern(time))
 		return false;
@@ -395,6 +697,9 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 		_startTime = g_system->getMillis() - (time.msecs() / _playbackRate).toInt();
 	}
 
+	if (_decodeAhead)
+		_decodeAhead->resume();
+
 	resetPauseStartTime();
 	findNextVideoTrack();
 	_needsUpdate = true;
@@ -560,6 +865,40 @@ bool VideoDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
 	return result;
 }
 
+bool VideoDecoder::setDecodeAhead(uint frameCount) {
+	// If a frame was already decoded, the tracks may not be accessed from
+	// another thread yet.
+	if (!_canSetDefaultFormat)
+		return false;
+
+	delete _decodeAhead;
+	_decodeAhead = nullptr;
+
+	if (frameCount == 0)
+		return true;
+
+	if (!ThreadPoolMan.isMultiThreaded())
+		return false;
+
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// We only allow decoding ahead when one video track is present
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (!track || !track->canDecodeAhead() || track->isReversed())
+		return false;
+
+	_decodeAhead = new DecodeAheadQueue(this, track, frameCount);
+	return true;
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -939,7 +1278,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack())
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !isTrackEnded(*it))
 			return false;
 
 	return true;
@@ -950,9 +1289,9 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 	uint32 bestTime = 0xFFFFFFFF;
 
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack()) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !isTrackEnded(*it)) {
 			VideoTrack *track = (VideoTrack *)*it;
-			uint32 time = track->getNextFrameStartTime();
+			uint32 time = getTrackNextFrameStartTime(track);
 
 			if (time < bestTime) {
 				bestTime = time;
@@ -1006,8 +1345,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -1023,7 +1362,33 @@ bool VideoDecoder::hasAudio() const {
 	return false;
 }
 
+int VideoDecoder::getTrackCurFrame(const VideoTrack *track) const {
+	if (_decodeAhead && _decodeAhead->getTrack() == track)
+		return _decodeAhead->getCurFrame();
+
+	return track->getCurFrame();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	if (_decodeAhead && _decodeAhead->getTrack() == track)
+		return _decodeAhead->getNextFrameStartTime();
+
+	return track->getNextFrameStartTime();
+}
+
+bool VideoDecoder::isTrackEnded(const Track *track) const {
+	if (_decodeAhead && _decodeAhead->getTrack() == track)
+		return _decodeAhead->endOfTrack();
+
+	return track->endOfTrack();
+}
+
 void VideoDecoder::eraseTrack(Track *track) {
+	if (_decodeAhead && _decodeAhead->getTrack() == track) {
+		delete _decodeAhead;
+		_decodeAhead = nullptr;
+	}
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
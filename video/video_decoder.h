@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -395,6 +395,26 @@ public:
 	 */
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
 
+	/**
+	 * Decode frames ahead of playback on a worker thread.
+	 *
+	 * Up to the given number of frames are kept ready, so decodeNextFrame()
+	 * usually only has to hand out a frame which was decoded in the
+	 * background. Seeking and rewinding drop the frames decoded ahead.
+	 *
+	 * This only works for videos with a single video track that supports it,
+	 * and on backends which provide worker threads. It cannot be combined
+	 * with reverse playback.
+	 *
+	 * This should be called after loadStream(), but before a decodeNextFrame()
+	 * call. This is enforced.
+	 *
+	 * @param frameCount The number of frames to decode ahead, 0 to disable
+	 * @return true on success, false otherwise
+	 * @see VideoTrack::canDecodeAhead()
+	 */
+	bool setDecodeAhead(uint frameCount);
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -654,6 +674,19 @@ protected:
 		 * Activate dithering mode with a palette
 		 */
 		virtual void setDither(const byte *palette) {}
+
+		/**
+		 * Can frames of this track be decoded on a worker thread?
+		 *
+		 * When this returns true, the decoder's readNextPacket() and this
+		 * track's decodeNextFrame() may be called from another thread than
+		 * the rest of the decoder. They must only touch state owned by the
+		 * decoder and pass any audio on through thread-safe streams, such as
+		 * Audio::QueuingAudioStream.
+		 *
+		 * @see VideoDecoder::setDecodeAhead()
+		 */
+		virtual bool canDecodeAhead() const { return false; }
 	};
 
 	/**
@@ -959,6 +992,14 @@ protected:
 	virtual AudioTrack *getAudioTrack(int index) { return 0; }
 
 private:
+	class DecodeAheadQueue;
+
+	// The state of a video track as seen by the caller, which lags behind
+	// the track itself while frames are decoded ahead
+	int getTrackCurFrame(const VideoTrack *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
+	bool isTrackEnded(const Track *track) const;
+
 	// Tracks owned by this VideoDecoder
 	TrackList _tracks;
 	TrackList _internalTracks;
@@ -979,6 +1020,9 @@ private:
 	bool _canSetDither;
 	bool _canSetDefaultFormat;
 
+	// Frames decoded ahead of playback, if enabled
+	DecodeAheadQueue *_decodeAhead;
+
 protected:
 	// Internal helper functions
 	void stopAudio();